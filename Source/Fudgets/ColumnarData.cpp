@@ -0,0 +1,454 @@
+#include "ColumnarData.h"
+
+#include "Engine/Core/Types/Variant.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Platform/StringUtils.h"
+
+#include <sstream>
+#include <locale>
+
+
+namespace
+{
+    // Parses a double in the C locale, so the decimal separator is always a dot. Like StringUtils::Parse, the whole
+    // text must be a number, apart from whitespace around it.
+    bool ParseDouble(const StringView &value, double &result)
+    {
+        std::istringstream stream(std::string(StringAnsi(value).Get()));
+        stream.imbue(std::locale::classic());
+        stream >> result;
+        if (stream.fail())
+            return false;
+        stream >> std::ws;
+        return stream.eof();
+    }
+}
+
+
+FudgetColumnarDataProvider::FudgetColumnarDataProvider(const SpawnParams &params) : Base(params), _row_count(0), _text_column(0)
+{
+    _consumers = New<FudgetDataConsumerRegistry>(SpawnParams(Guid::New(), FudgetDataConsumerRegistry::TypeInitializer));
+    _strings.Add(String::Empty);
+    _string_ids[String::Empty] = 0;
+}
+
+FudgetColumnarDataProvider::~FudgetColumnarDataProvider()
+{
+    Delete(_consumers);
+}
+
+int FudgetColumnarDataProvider::AddColumn(FudgetColumnType type)
+{
+    Column &column = _columns.AddOne();
+    column.Type = type;
+    column.Data.Resize(_row_count * ElementSize(type));
+    Platform::MemoryClear(column.Data.Get(), column.Data.Count());
+    return _columns.Count() - 1;
+}
+
+void FudgetColumnarDataProvider::SetTextColumn(int value)
+{
+    if (_text_column == value || value < 0 || value >= _columns.Count())
+        return;
+    _consumers->BeginDataReset();
+    _text_column = value;
+    _consumers->EndDataReset();
+}
+
+int FudgetColumnarDataProvider::AddRows(int count)
+{
+    if (count <= 0 || !_consumers->AddBegin(count))
+        return -1;
+
+    for (Column &column : _columns)
+    {
+        int size = ElementSize(column.Type);
+        int old_size = column.Data.Count();
+        column.Data.Resize(old_size + count * size);
+        Platform::MemoryClear(column.Data.Get() + old_size, count * size);
+    }
+    int first = _row_count;
+    _row_count += count;
+
+    _consumers->AddEnd(count);
+    return first;
+}
+
+int FudgetColumnarDataProvider::InsertRows(int index, int count)
+{
+    if (count <= 0)
+        return -1;
+    index = Math::Clamp(index, 0, _row_count);
+    if (index == _row_count)
+        return AddRows(count);
+
+    if (!_consumers->InsertBegin(index, count))
+        return -1;
+
+    for (Column &column : _columns)
+    {
+        int size = ElementSize(column.Type);
+        int old_size = column.Data.Count();
+        column.Data.Resize(old_size + count * size);
+        byte *data = column.Data.Get();
+        Platform::MemoryMove(data + (index + count) * size, data + index * size, old_size - index * size);
+        Platform::MemoryClear(data + index * size, count * size);
+    }
+    _row_count += count;
+
+    _consumers->InsertEnd(index, count);
+    return index;
+}
+
+void FudgetColumnarDataProvider::RemoveRows(int index, int count)
+{
+    if (index < 0)
+    {
+        count += index;
+        index = 0;
+    }
+    count = Math::Min(count, _row_count - index);
+    if (count <= 0 || !_consumers->RemoveBegin(index, count))
+        return;
+
+    for (Column &column : _columns)
+    {
+        int size = ElementSize(column.Type);
+        byte *data = column.Data.Get();
+        Platform::MemoryMove(data + index * size, data + (index + count) * size, (_row_count - index - count) * size);
+        column.Data.Resize((_row_count - count) * size);
+    }
+    _row_count -= count;
+
+    _consumers->RemoveEnd(index, count);
+}
+
+void FudgetColumnarDataProvider::SetInt32(int row, int column, int32 value)
+{
+    SetCell(row, column, &value, sizeof(value));
+}
+
+void FudgetColumnarDataProvider::SetInt64(int row, int column, int64 value)
+{
+    SetCell(row, column, &value, sizeof(value));
+}
+
+void FudgetColumnarDataProvider::SetFloat(int row, int column, float value)
+{
+    SetCell(row, column, &value, sizeof(value));
+}
+
+void FudgetColumnarDataProvider::SetDouble(int row, int column, double value)
+{
+    SetCell(row, column, &value, sizeof(value));
+}
+
+void FudgetColumnarDataProvider::SetBool(int row, int column, bool value)
+{
+    byte b = value ? 1 : 0;
+    SetCell(row, column, &b, sizeof(b));
+}
+
+void FudgetColumnarDataProvider::SetString(int row, int column, const StringView &value)
+{
+    int32 id = InternString(value);
+    SetCell(row, column, &id, sizeof(id));
+}
+
+int FudgetColumnarDataProvider::InternString(const StringView &value)
+{
+    String str(value);
+    int id;
+    if (_string_ids.TryGet(str, id))
+        return id;
+
+    id = _strings.Count();
+    _strings.Add(str);
+    _string_ids[str] = id;
+    return id;
+}
+
+uint64 FudgetColumnarDataProvider::GetValueBits(int row, int column) const
+{
+    const Column &col = _columns[column];
+    switch (col.Type)
+    {
+        case FudgetColumnType::Int32:
+        case FudgetColumnType::Float:
+        case FudgetColumnType::String:
+            return ((const uint32*)col.Data.Get())[row];
+        case FudgetColumnType::Int64:
+        case FudgetColumnType::Double:
+            return ((const uint64*)col.Data.Get())[row];
+        case FudgetColumnType::Bool:
+            return col.Data[row];
+        default:
+            return 0;
+    }
+}
+
+String FudgetColumnarDataProvider::FormatValue(int row, int column) const
+{
+    if (column < 0 || column >= _columns.Count())
+        return String::Empty;
+
+    switch (_columns[column].Type)
+    {
+        case FudgetColumnType::Int32:
+            return StringUtils::ToString(GetInt32(row, column));
+        case FudgetColumnType::Int64:
+            return StringUtils::ToString(GetInt64(row, column));
+        case FudgetColumnType::Float:
+            return StringUtils::ToString(GetFloat(row, column));
+        case FudgetColumnType::Double:
+            return StringUtils::ToString(GetDouble(row, column));
+        case FudgetColumnType::Bool:
+            return GetBool(row, column) ? TEXT("true") : TEXT("false");
+        case FudgetColumnType::String:
+            return GetString(row, column);
+        default:
+            return String::Empty;
+    }
+}
+
+int FudgetColumnarDataProvider::ElementSize(FudgetColumnType type)
+{
+    switch (type)
+    {
+        case FudgetColumnType::Int64:
+        case FudgetColumnType::Double:
+            return 8;
+        case FudgetColumnType::Bool:
+            return 1;
+        default:
+            return 4;
+    }
+}
+
+void FudgetColumnarDataProvider::Clear()
+{
+    if (_row_count == 0 && _strings.Count() == 1)
+        return;
+
+    _consumers->ClearBegin();
+    for (Column &column : _columns)
+        column.Data.Clear();
+    _row_count = 0;
+    _strings.Resize(1);
+    _string_ids.Clear();
+    _string_ids[String::Empty] = 0;
+    _consumers->ClearEnd();
+}
+
+Variant FudgetColumnarDataProvider::GetValue(int index)
+{
+    if (!HasTextColumn())
+        return Variant::Null;
+
+    switch (_columns[_text_column].Type)
+    {
+        case FudgetColumnType::Int32:
+            return Variant(GetInt32(index, _text_column));
+        case FudgetColumnType::Int64:
+            return Variant(GetInt64(index, _text_column));
+        case FudgetColumnType::Float:
+            return Variant(GetFloat(index, _text_column));
+        case FudgetColumnType::Double:
+            return Variant(GetDouble(index, _text_column));
+        case FudgetColumnType::Bool:
+            return Variant(GetBool(index, _text_column));
+        case FudgetColumnType::String:
+            return Variant(GetString(index, _text_column));
+        default:
+            return Variant::Null;
+    }
+}
+
+void FudgetColumnarDataProvider::SetValue(int index, Variant value)
+{
+    if (!HasTextColumn())
+        return;
+
+    switch (_columns[_text_column].Type)
+    {
+        case FudgetColumnType::Int32:
+            SetInt32(index, _text_column, (int32)value);
+            break;
+        case FudgetColumnType::Int64:
+            SetInt64(index, _text_column, (int64)value);
+            break;
+        case FudgetColumnType::Float:
+            SetFloat(index, _text_column, (float)value);
+            break;
+        case FudgetColumnType::Double:
+            SetDouble(index, _text_column, (double)value);
+            break;
+        case FudgetColumnType::Bool:
+            SetBool(index, _text_column, (bool)value);
+            break;
+        case FudgetColumnType::String:
+            SetString(index, _text_column, value.ToString());
+            break;
+    }
+}
+
+void FudgetColumnarDataProvider::SetText(int index, const StringView &value)
+{
+    if (!HasTextColumn())
+        return;
+
+    switch (_columns[_text_column].Type)
+    {
+        case FudgetColumnType::Int32:
+        {
+            int32 result = 0;
+            if (!StringUtils::Parse(value.Get(), value.Length(), &result))
+                SetInt32(index, _text_column, result);
+            break;
+        }
+        case FudgetColumnType::Int64:
+        {
+            int64 result = 0;
+            if (!StringUtils::Parse(value.Get(), value.Length(), &result))
+                SetInt64(index, _text_column, result);
+            break;
+        }
+        case FudgetColumnType::Float:
+        {
+            float result = 0;
+            if (!StringUtils::Parse(String(value).Get(), &result))
+                SetFloat(index, _text_column, result);
+            break;
+        }
+        case FudgetColumnType::Double:
+        {
+            // Parsed separately, because going through a float would lose precision.
+            double result = 0;
+            if (ParseDouble(value, result))
+                SetDouble(index, _text_column, result);
+            break;
+        }
+        case FudgetColumnType::Bool:
+            SetBool(index, _text_column, value.Compare(StringView(TEXT("true")), StringSearchCase::IgnoreCase) == 0 || value.Compare(StringView(TEXT("1"))) == 0);
+            break;
+        case FudgetColumnType::String:
+            SetString(index, _text_column, value);
+            break;
+    }
+}
+
+int FudgetColumnarDataProvider::GetInt(int index)
+{
+    if (!HasTextColumn())
+        return 0;
+
+    switch (_columns[_text_column].Type)
+    {
+        case FudgetColumnType::Int32:
+            return GetInt32(index, _text_column);
+        case FudgetColumnType::Int64:
+            return (int)GetInt64(index, _text_column);
+        case FudgetColumnType::Float:
+            return (int)GetFloat(index, _text_column);
+        case FudgetColumnType::Double:
+            return (int)GetDouble(index, _text_column);
+        case FudgetColumnType::Bool:
+            return GetBool(index, _text_column) ? 1 : 0;
+        default:
+            return 0;
+    }
+}
+
+void FudgetColumnarDataProvider::SetInt(int index, int value)
+{
+    if (!HasTextColumn())
+        return;
+
+    switch (_columns[_text_column].Type)
+    {
+        case FudgetColumnType::Int32:
+            SetInt32(index, _text_column, value);
+            break;
+        case FudgetColumnType::Int64:
+            SetInt64(index, _text_column, value);
+            break;
+        case FudgetColumnType::Float:
+            SetFloat(index, _text_column, (float)value);
+            break;
+        case FudgetColumnType::Double:
+            SetDouble(index, _text_column, value);
+            break;
+        case FudgetColumnType::Bool:
+            SetBool(index, _text_column, value != 0);
+            break;
+    }
+}
+
+void FudgetColumnarDataProvider::SetCell(int row, int column, const void *value, int size)
+{
+    if (row < 0 || row >= _row_count || ElementSize(_columns[column].Type) != size)
+        return;
+
+    byte *cell = _columns[column].Data.Get() + row * size;
+    if (Platform::MemoryCompare(cell, value, size) == 0)
+        return;
+
+    // Consumers only see the text column, other columns are read by painters that check the value bits.
+    if (column != _text_column)
+    {
+        Platform::MemoryCopy(cell, value, size);
+        return;
+    }
+
+    if (!_consumers->SetBegin(row))
+        return;
+    Platform::MemoryCopy(cell, value, size);
+    _consumers->SetEnd(row);
+}
+
+
+// FudgetCellTextCache
+
+
+FudgetCellTextCache::FudgetCellTextCache() : _data(nullptr)
+{
+}
+
+const String& FudgetCellTextCache::GetText(FudgetColumnarDataProvider *data, int row, int column)
+{
+    if (data->GetColumnType(column) == FudgetColumnType::String)
+        return data->GetString(row, column);
+
+    if (_data != data)
+    {
+        _entries.Clear();
+        _data = data;
+    }
+
+    uint64 key = ((uint64)(uint32)row << 32) | (uint32)column;
+    uint64 bits = data->GetValueBits(row, column);
+    Entry *entry = _entries.TryGet(key);
+    if (entry != nullptr)
+    {
+        if (entry->Bits != bits)
+        {
+            entry->Bits = bits;
+            entry->Text = data->FormatValue(row, column);
+        }
+        return entry->Text;
+    }
+
+    if (_entries.Count() >= MaxEntries)
+        _entries.Clear();
+
+    Entry &added = _entries[key];
+    added.Bits = bits;
+    added.Text = data->FormatValue(row, column);
+    return added.Text;
+}
+
+void FudgetCellTextCache::Clear()
+{
+    _entries.Clear();
+    _data = nullptr;
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "DataInterfaces.h"
+
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Types/Span.h"
+#include "Engine/Core/Types/String.h"
+
+
+/// <summary>
+/// Type of the values stored in a column of FudgetColumnarDataProvider.
+/// </summary>
+API_ENUM()
+enum class FudgetColumnType
+{
+    /// <summary>
+    /// 32 bit signed integers.
+    /// </summary>
+    Int32,
+    /// <summary>
+    /// 64 bit signed integers.
+    /// </summary>
+    Int64,
+    /// <summary>
+    /// Single precision floating point numbers.
+    /// </summary>
+    Float,
+    /// <summary>
+    /// Double precision floating point numbers.
+    /// </summary>
+    Double,
+    /// <summary>
+    /// Boolean values.
+    /// </summary>
+    Bool,
+    /// <summary>
+    /// Strings stored once in the provider and referenced by their index in each row.
+    /// </summary>
+    String,
+};
+
+/// <summary>
+/// Data provider that stores rows of values in typed columns. Each column is a contiguous array of its type, so values
+/// can be read without converting them to a Variant or formatting them to a new String. Strings are interned: every
+/// distinct string is stored once and cells hold its index.
+/// The IFudgetDataProvider functions access the column set as the text column, so the provider can be used by list
+/// controls directly. Use FudgetCellTextCache to draw numeric values as text without formatting them on every draw.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetColumnarDataProvider : public ScriptingObject, public IFudgetDataProvider
+{
+    using Base = ScriptingObject;
+    DECLARE_SCRIPTING_TYPE(FudgetColumnarDataProvider);
+public:
+    ~FudgetColumnarDataProvider();
+
+    /// <summary>
+    /// Adds a column to every row. The new values are zero, false or the empty string.
+    /// </summary>
+    /// <param name="type">Type of values in the column</param>
+    /// <returns>Index of the new column</returns>
+    API_FUNCTION() int AddColumn(FudgetColumnType type);
+
+    /// <summary>
+    /// Gets the number of columns.
+    /// </summary>
+    API_PROPERTY() int GetColumnCount() const { return _columns.Count(); }
+
+    /// <summary>
+    /// Returns the type of values in a column.
+    /// </summary>
+    /// <param name="column">Index of the column</param>
+    /// <returns>Type of the values</returns>
+    API_FUNCTION() FudgetColumnType GetColumnType(int column) const { return _columns[column].Type; }
+
+    /// <summary>
+    /// Gets the column accessed by GetValue, GetText and GetInt and the matching setters.
+    /// </summary>
+    API_PROPERTY() int GetTextColumn() const { return _text_column; }
+    /// <summary>
+    /// Sets the column accessed by GetValue, GetText and GetInt and the matching setters. Consumers are notified with
+    /// a data reset.
+    /// </summary>
+    /// <param name="value">Index of an existing column</param>
+    API_PROPERTY() void SetTextColumn(int value);
+
+    /// <summary>
+    /// Adds rows at the end. The new values are zero, false or the empty string.
+    /// </summary>
+    /// <param name="count">Number of rows to add</param>
+    /// <returns>Index of the first added row or -1 if nothing was added</returns>
+    API_FUNCTION() int AddRows(int count);
+    /// <summary>
+    /// Inserts rows at a position. The new values are zero, false or the empty string.
+    /// </summary>
+    /// <param name="index">Position to insert at. It will be clamped between 0 and count</param>
+    /// <param name="count">Number of rows to insert</param>
+    /// <returns>Index of the first inserted row or -1 if nothing was inserted</returns>
+    API_FUNCTION() int InsertRows(int index, int count);
+    /// <summary>
+    /// Removes rows.
+    /// </summary>
+    /// <param name="index">Index of the first row to remove</param>
+    /// <param name="count">Number of rows to remove. Rows out of range are ignored</param>
+    API_FUNCTION() void RemoveRows(int index, int count);
+
+    /// <summary>
+    /// Returns a value of an Int32 column.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE int32 GetInt32(int row, int column) const { return ((const int32*)_columns[column].Data.Get())[row]; }
+    /// <summary>
+    /// Returns a value of an Int64 column.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE int64 GetInt64(int row, int column) const { return ((const int64*)_columns[column].Data.Get())[row]; }
+    /// <summary>
+    /// Returns a value of a Float column.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE float GetFloat(int row, int column) const { return ((const float*)_columns[column].Data.Get())[row]; }
+    /// <summary>
+    /// Returns a value of a Double column.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE double GetDouble(int row, int column) const { return ((const double*)_columns[column].Data.Get())[row]; }
+    /// <summary>
+    /// Returns a value of a Bool column.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE bool GetBool(int row, int column) const { return _columns[column].Data[row] != 0; }
+    /// <summary>
+    /// Returns the index of the interned string in a String column. Cells with the same string have the same index.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE int GetStringId(int row, int column) const { return ((const int32*)_columns[column].Data.Get())[row]; }
+    /// <summary>
+    /// Returns a string of a String column without copying it.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE const String& GetString(int row, int column) const { return _strings[GetStringId(row, column)]; }
+    /// <summary>
+    /// Returns an interned string by its index.
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE const String& GetInternedString(int id) const { return _strings[id]; }
+
+    /// <summary>
+    /// Returns the values of a column as a contiguous array. T must match the column's type: int32, int64, float or
+    /// double, uint8 for Bool and int32 string indexes for String columns.
+    /// </summary>
+    template<typename T>
+    Span<const T> GetColumnData(int column) const
+    {
+        ASSERT(ElementSize(_columns[column].Type) == sizeof(T));
+        return Span<const T>((const T*)_columns[column].Data.Get(), _row_count);
+    }
+
+    /// <summary>
+    /// Changes a value of an Int32 column.
+    /// </summary>
+    API_FUNCTION() void SetInt32(int row, int column, int32 value);
+    /// <summary>
+    /// Changes a value of an Int64 column.
+    /// </summary>
+    API_FUNCTION() void SetInt64(int row, int column, int64 value);
+    /// <summary>
+    /// Changes a value of a Float column.
+    /// </summary>
+    API_FUNCTION() void SetFloat(int row, int column, float value);
+    /// <summary>
+    /// Changes a value of a Double column.
+    /// </summary>
+    API_FUNCTION() void SetDouble(int row, int column, double value);
+    /// <summary>
+    /// Changes a value of a Bool column.
+    /// </summary>
+    API_FUNCTION() void SetBool(int row, int column, bool value);
+    /// <summary>
+    /// Changes a value of a String column. The string is interned if it's not stored yet.
+    /// </summary>
+    API_FUNCTION() void SetString(int row, int column, const StringView &value);
+
+    /// <summary>
+    /// Returns the index of a string in the interned strings, adding it if it's not stored yet. Interned strings are
+    /// only removed when the provider is cleared.
+    /// </summary>
+    /// <param name="value">The string to look up</param>
+    /// <returns>Index of the interned string</returns>
+    API_FUNCTION() int InternString(const StringView &value);
+
+    /// <summary>
+    /// Returns the bits of a value in any column, zero extended to 64 bits. Two values in the same column are the same
+    /// if their bits are the same.
+    /// </summary>
+    /// <param name="row">Index of the row</param>
+    /// <param name="column">Index of the column</param>
+    /// <returns>Bits of the value</returns>
+    uint64 GetValueBits(int row, int column) const;
+
+    /// <summary>
+    /// Formats a value in any column to text.
+    /// </summary>
+    /// <param name="row">Index of the row</param>
+    /// <param name="column">Index of the column</param>
+    /// <returns>The value as text</returns>
+    API_FUNCTION() String FormatValue(int row, int column) const;
+
+    /// <summary>
+    /// Returns the size in bytes of a single value of a column type.
+    /// </summary>
+    static int ElementSize(FudgetColumnType type);
+
+    // IFudgetDataProvider
+
+    /// <inheritdoc />
+    void BeginChange() override { _consumers->BeginChange(); }
+    /// <inheritdoc />
+    void EndChange() override { _consumers->EndChange(); }
+    /// <inheritdoc />
+    void BeginDataReset() override { _consumers->BeginDataReset(); }
+    /// <inheritdoc />
+    void EndDataReset() override { _consumers->EndDataReset(); }
+    /// <inheritdoc />
+    int GetCount() const override { return _row_count; }
+    /// <summary>
+    /// Removes every row and interned string. The columns are kept.
+    /// </summary>
+    void Clear() override;
+    /// <inheritdoc />
+    Variant GetValue(int index) override;
+    /// <inheritdoc />
+    void SetValue(int index, Variant value) override;
+    /// <inheritdoc />
+    String GetText(int index) override { return FormatValue(index, _text_column); }
+    /// <summary>
+    /// Sets the value in the text column. Numbers are parsed from the text.
+    /// </summary>
+    void SetText(int index, const StringView &value) override;
+    /// <inheritdoc />
+    int GetInt(int index) override;
+    /// <inheritdoc />
+    void SetInt(int index, int value) override;
+    /// <inheritdoc />
+    void RegisterDataConsumer(IFudgetDataConsumer *consumer) override { _consumers->RegisterDataConsumer(consumer); }
+    /// <inheritdoc />
+    void UnregisterDataConsumer(IFudgetDataConsumer *consumer) override { _consumers->UnregisterDataConsumer(consumer); }
+private:
+    struct Column
+    {
+        FudgetColumnType Type;
+        // Values of the column packed by their type.
+        Array<byte> Data;
+    };
+
+    // Writes the bytes of a value to a cell, notifying the consumers if the row is in the text column.
+    void SetCell(int row, int column, const void *value, int size);
+
+    // Whether the text column refers to an existing column. Rows can be added before any column is.
+    bool HasTextColumn() const { return _text_column >= 0 && _text_column < _columns.Count(); }
+
+    Array<Column> _columns;
+    int _row_count;
+    int _text_column;
+
+    // Interned strings. Index 0 is always the empty string.
+    Array<String> _strings;
+    Dictionary<String, int> _string_ids;
+
+    FudgetDataConsumerRegistry *_consumers;
+};
+
+/// <summary>
+/// Cache of cells of FudgetColumnarDataProvider formatted as text, for painters that draw the same cells on every
+/// frame. A value is only formatted again when its bits change. Strings are returned from the provider without
+/// copying or caching them.
+/// </summary>
+class FUDGETS_API FudgetCellTextCache
+{
+public:
+    FudgetCellTextCache();
+
+    /// <summary>
+    /// Returns the text of a cell, formatting it only if it changed since the last call for the same cell. The
+    /// returned reference is valid until the next call.
+    /// </summary>
+    /// <param name="data">The provider holding the cell</param>
+    /// <param name="row">Index of the row</param>
+    /// <param name="column">Index of the column</param>
+    /// <returns>The value of the cell as text</returns>
+    const String& GetText(FudgetColumnarDataProvider *data, int row, int column);
+
+    /// <summary>
+    /// Removes every formatted value.
+    /// </summary>
+    void Clear();
+private:
+    struct Entry
+    {
+        uint64 Bits;
+        String Text;
+    };
+
+    // The cache is cleared when it grows larger than this, which is more cells than a view shows at once.
+    static constexpr int MaxEntries = 1 << 15;
+
+    FudgetColumnarDataProvider *_data;
+    // Formatted cells by row in the upper and column in the lower 32 bits.
+    Dictionary<uint64, Entry> _entries;
+};
@@ -1,16 +1,19 @@
 #include "Container.h"
 #include "Fudget.h"
+#include "GUIRoot.h"
 #include "Layouts/Layout.h"
 #include "Layouts/ContainerLayout.h"
 #include "Engine/Core/Math/Rectangle.h"
 #include "Utils/Utils.h"
 #include "Engine/Core/Log.h"
+#include "Engine/Core/Collections/HashSet.h"
 #include "Engine/Serialization/JsonTools.h"
 
 #include "Styling/Painters/PartPainters.h"
 
 FudgetContainer::FudgetContainer(const SpawnParams &params) : Base(params),
-    FillColor(1.0f), DrawFilledBackground(false), _layout(nullptr), _dummy_layout(true), _size_overrides(FudgetSizeOverride::AllUnrestricted), _changing(false)
+    FillColor(1.0f), DrawFilledBackground(false), _layout(nullptr), _dummy_layout(true), _size_overrides(FudgetSizeOverride::AllUnrestricted), _changing(false),
+    _update_count(0), _stale_index(-1), _slots_pending(false)
 {
     CreateDummyLayout();
 }
@@ -41,9 +44,7 @@ int FudgetContainer::AddChild(FudgetControl *control, int index)
 
     if (control->GetParent() == this)
     {
-        int result = control->_index;
-        if (result == -1)
-            result = ChildIndex(control);
+        int result = ChildIndex(control);
         if (result != -1)
             return result;
     }
@@ -53,8 +54,13 @@ int FudgetContainer::AddChild(FudgetControl *control, int index)
     if (index >= 0 && index < _children.Count())
     {
         _children.Insert(index, control);
-        for (int ix = index + 1, siz = _children.Count(); ix < siz; ++ix)
-            _children[ix]->_index = ix;
+        if (_update_count != 0)
+            MarkIndexesStale(index + 1);
+        else
+        {
+            for (int ix = index + 1, siz = _children.Count(); ix < siz; ++ix)
+                _children[ix]->_index = ix;
+        }
     }
     else
     {
@@ -68,7 +74,12 @@ int FudgetContainer::AddChild(FudgetControl *control, int index)
     control->_index = index;
 
     if (_layout != nullptr)
-        _layout->ChildAdded(control, index);
+    {
+        if (_update_count != 0)
+            _slots_pending = true;
+        else
+            _layout->ChildAdded(control, index);
+    }
 
     control->DoParentChanged(old_parent);
 
@@ -84,19 +95,30 @@ int FudgetContainer::RemoveChild(FudgetControl *control)
 
     _changing = true;
 
-    int index = control->_index;
+    int index = ChildIndex(control);
     _children.RemoveAtKeepOrder(index);
     control->_parent = nullptr;
     control->_index = -1;
+    control->_state_flags &= ~FudgetControlState::LayoutSizesPending;
 
     //control->SetState(FudgetControlState::ParentDisabled, false);
     //control->SetState(FudgetControlState::ParentHidden, false);
 
-    for (int ix = index, siz = _children.Count(); ix < siz; ++ix)
-        _children[ix]->_index = ix;
+    if (_update_count != 0)
+        MarkIndexesStale(index);
+    else
+    {
+        for (int ix = index, siz = _children.Count(); ix < siz; ++ix)
+            _children[ix]->_index = ix;
+    }
 
     if (_layout != nullptr)
-        _layout->ChildRemoved(index);
+    {
+        if (_update_count != 0)
+            _slots_pending = true;
+        else
+            _layout->ChildRemoved(index);
+    }
 
     control->DoParentChanged(nullptr);
 
@@ -130,11 +152,22 @@ bool FudgetContainer::MoveChildToIndex(int from, int to)
     FudgetControl *control = _children[from];
     MoveInArray(_children, from, to);
 
-    for (int ix = Math::Min(from, to), siz = Math::Max(from, to) + 1; ix < siz; ++ix)
-        _children[ix]->_index = ix;
+    if (_guiRoot != nullptr)
+        _guiRoot->InvalidateHitTestCache();
 
-    if (_layout != nullptr)
-        _layout->ChildMoved(from, to);
+    if (_update_count != 0)
+    {
+        MarkIndexesStale(Math::Min(from, to));
+        _slots_pending = _layout != nullptr;
+    }
+    else
+    {
+        for (int ix = Math::Min(from, to), siz = Math::Max(from, to) + 1; ix < siz; ++ix)
+            _children[ix]->_index = ix;
+
+        if (_layout != nullptr)
+            _layout->ChildMoved(from, to);
+    }
 
     _changing = false;
 
@@ -153,20 +186,15 @@ int FudgetContainer::GetChildCount() const
     return _children.Count();
 }
 
-int FudgetContainer::ChildIndex(FudgetControl *control) const
+int FudgetContainer::ChildIndex(const FudgetControl *control) const
 {
-    if (control->GetParent() != this)
+    if (control == nullptr || control->GetParent() != this)
         return -1;
-    int o = control->GetIndexInParent();
-    if (o >= 0 && o < _children.Count() && _children[o] == control)
-        return o;
-
-    for (int ix = 0, siz = _children.Count(); ix < siz; ++ix)
-    {
-        if (_children[ix] == control)
-            return ix;
-    }
-    return -1;
+    // Indexes below _stale_index are always valid. The rest are updated together, which is done at most
+    // once between changes even when many indexes are queried during a bulk update.
+    if (_stale_index != -1 && control->_index >= _stale_index)
+        UpdateStaleIndexes();
+    return control->_index;
 }
 
 void FudgetContainer::DeleteAll()
@@ -183,6 +211,79 @@ void FudgetContainer::DeleteAll()
         _layout->AllDeleted();
 }
 
+void FudgetContainer::BeginUpdate()
+{
+    ++_update_count;
+}
+
+void FudgetContainer::EndUpdate()
+{
+    if (_update_count == 0)
+    {
+        LOG(Warning, "EndUpdate called on container without a matching BeginUpdate.");
+        return;
+    }
+    if (--_update_count == 0)
+        FlushChildChanges();
+}
+
+void FudgetContainer::ReplaceChildren(const Span<FudgetControl*> &controls, bool delete_removed)
+{
+    if (_changing)
+        return;
+
+    HashSet<FudgetControl*> wanted;
+    for (int ix = 0, siz = controls.Length(); ix < siz; ++ix)
+    {
+        if (controls[ix] != nullptr)
+            wanted.Add(controls[ix]);
+    }
+
+    BeginUpdate();
+
+    // Removing from the back keeps the indexes of the controls not visited yet valid.
+    for (int ix = _children.Count() - 1; ix >= 0; --ix)
+    {
+        FudgetControl *control = _children[ix];
+        if (wanted.Contains(control))
+            continue;
+        RemoveChild(control);
+        if (delete_removed)
+            Delete(control);
+    }
+
+    Array<FudgetControl*> ordered(wanted.Count());
+    for (int ix = 0, siz = controls.Length(); ix < siz; ++ix)
+    {
+        FudgetControl *control = controls[ix];
+        if (control == nullptr || !wanted.Remove(control))
+            continue;
+        if (control->_parent != this)
+            AddChild(control);
+        if (control->_parent == this)
+            ordered.Add(control);
+    }
+
+    // The children are now the same controls as in ordered, but new controls were added to the end.
+    int first_changed = -1;
+    for (int ix = 0, siz = ordered.Count(); ix < siz; ++ix)
+    {
+        if (_children[ix] == ordered[ix])
+            continue;
+        if (first_changed == -1)
+            first_changed = ix;
+        _children[ix] = ordered[ix];
+    }
+
+    if (first_changed != -1)
+    {
+        MarkIndexesStale(first_changed);
+        _slots_pending = _layout != nullptr;
+    }
+
+    EndUpdate();
+}
+
 void FudgetContainer::SetEnabled(bool value)
 {
     Base::SetEnabled(value);
@@ -276,10 +377,19 @@ void FudgetContainer::MarkLayoutDirty(FudgetLayoutDirtyReason dirt_flags, Fudget
     if (control != nullptr && control->GetParent() != this)
         return;
 
+    if (_guiRoot != nullptr)
+        _guiRoot->InvalidateHitTestCache();
+
     bool self = (dirt_flags & FudgetLayoutDirtyReason::Container) == FudgetLayoutDirtyReason::Container;
     bool size_change = _layout->MarkDirty(dirt_flags) && !IgnoresLayoutSizes();
     if (control != nullptr && (dirt_flags & FudgetLayoutDirtyReason::Size) == FudgetLayoutDirtyReason::Size)
-        _layout->MarkControlSizesDirty(control->GetIndexInParent());
+    {
+        // The slots don't match the child indexes until the bulk update ends.
+        if (_slots_pending)
+            control->_state_flags |= FudgetControlState::LayoutSizesPending;
+        else
+            _layout->MarkControlSizesDirty(ChildIndex(control));
+    }
 
     if (_parent == nullptr)
         return;
@@ -325,6 +435,8 @@ bool FudgetContainer::OnMeasure(Int2 available, API_PARAM(Out) Int2 &wanted, API
     bool result = false;
     if (!IgnoresLayoutSizes())
     {
+        if (_update_count != 0)
+            FlushChildChanges();
         _layout->DoLayoutChildren(available);
         if (_layout->HasAllFlags(FudgetLayoutFlag::CanProvideSizes))
             result = _layout->SizeDependsOnSpace();
@@ -628,6 +740,8 @@ FudgetControlFlag FudgetContainer::GetInitFlags() const
 
 void FudgetContainer::RequestLayout()
 {
+    if (_update_count != 0)
+        FlushChildChanges();
     _layout->RequestLayoutChildren(false);
     Base::RequestLayout();
     for (FudgetControl *c : _children)
@@ -739,3 +853,53 @@ void FudgetContainer::CreateDummyLayout()
     _layout = New<FudgetContainerLayout>(SpawnParams(Guid::New(), FudgetContainerLayout::TypeInitializer));
     _layout->SetOwnerInternal(this);
 }
+
+void FudgetContainer::FlushChildChanges()
+{
+    UpdateStaleIndexes();
+
+    if (!_slots_pending)
+        return;
+    _slots_pending = false;
+
+    if (_layout != nullptr)
+        _layout->SyncSlots();
+
+    for (int ix = 0, siz = _children.Count(); ix < siz; ++ix)
+    {
+        FudgetControl *control = _children[ix];
+        if ((control->_state_flags & FudgetControlState::LayoutSizesPending) != FudgetControlState::LayoutSizesPending)
+            continue;
+        control->_state_flags &= ~FudgetControlState::LayoutSizesPending;
+        if (_layout != nullptr)
+            _layout->MarkControlSizesDirty(ix);
+    }
+}
+
+void FudgetContainer::FlushChildChangesRecursive()
+{
+    FlushChildChanges();
+    for (FudgetControl *control : _children)
+    {
+        if (!control->HasAnyFlag(FudgetControlFlag::ContainerControl))
+            continue;
+        FudgetContainer *container = dynamic_cast<FudgetContainer*>(control);
+        if (container != nullptr)
+            container->FlushChildChangesRecursive();
+    }
+}
+
+void FudgetContainer::UpdateStaleIndexes() const
+{
+    if (_stale_index == -1)
+        return;
+    for (int ix = _stale_index, siz = _children.Count(); ix < siz; ++ix)
+        _children[ix]->_index = ix;
+    _stale_index = -1;
+}
+
+void FudgetContainer::MarkIndexesStale(int index)
+{
+    if (_stale_index == -1 || index < _stale_index)
+        _stale_index = index;
+}
@@ -233,13 +233,40 @@ public:
     /// </summary>
     /// <param name="control">The control to look for</param>
     /// <returns>The index if found, -1 if not</returns>
-    API_FUNCTION() int ChildIndex(FudgetControl *control) const;
+    API_FUNCTION() int ChildIndex(const FudgetControl *control) const;
 
     /// <summary>
     /// Deletes all the controls added to the layout. Any reference to the controls becomes invalid.
     /// </summary>
     API_FUNCTION() void DeleteAll();
 
+    /// <summary>
+    /// Starts a bulk edit of the child controls. Until the matching EndUpdate call, adding, removing and moving
+    /// child controls won't renumber the following children and won't update the layout's slots. These are
+    /// fixed in a single pass when the last EndUpdate is called. Calls can be nested.
+    /// </summary>
+    API_FUNCTION() void BeginUpdate();
+
+    /// <summary>
+    /// Ends a bulk edit started with BeginUpdate. When the outermost bulk edit ends, the child indexes and the
+    /// layout's slots are updated to match the child controls.
+    /// </summary>
+    API_FUNCTION() void EndUpdate();
+
+    /// <summary>
+    /// Whether BeginUpdate was called without a matching EndUpdate.
+    /// </summary>
+    API_PROPERTY() bool IsInBulkUpdate() const { return _update_count != 0; }
+
+    /// <summary>
+    /// Changes the child controls of this container to the passed controls in the same order. Child controls not
+    /// in the list are removed, and new controls are added, taking them from their old parent. The work is done
+    /// as a single bulk update.
+    /// </summary>
+    /// <param name="controls">The new child controls. Null values and duplicates are skipped</param>
+    /// <param name="delete_removed">Whether the old child controls that are not in the list should be deleted</param>
+    API_FUNCTION() virtual void ReplaceChildren(const Span<FudgetControl*> &controls, bool delete_removed = false);
+
     /// <inheritdoc />
     void SetEnabled(bool value) override;
 
@@ -476,6 +503,19 @@ private:
     /// </summary>
     void CreateDummyLayout();
 
+    // Updates the child indexes and layout slots that were left behind during a bulk update.
+    void FlushChildChanges();
+
+    // Calls FlushChildChanges on this container and every container inside it, so measuring them doesn't
+    // change the layouts. Used before measuring the container on the job system.
+    void FlushChildChangesRecursive();
+
+    // Sets the _index of the children from _stale_index to the end, if any of them might be invalid.
+    void UpdateStaleIndexes() const;
+
+    // Called during a bulk update when the children at the index and above have an invalid _index.
+    void MarkIndexesStale(int index);
+
     Array<FudgetControl*> _children;
     FudgetLayout *_layout;
     // Using a FudgetContainerLayout that lets its child controls determine their own position and size
@@ -485,4 +525,13 @@ private:
 
     // Used locally to avoid double calling functions from child controls.
     bool _changing;
+
+    // Number of BeginUpdate calls without a matching EndUpdate.
+    int _update_count;
+    // First child index that might be invalid due to changes during a bulk update, or -1 if all are valid.
+    mutable int _stale_index;
+    // The layout's slots don't match the child controls, because of changes during a bulk update.
+    bool _slots_pending;
+
+    friend class FudgetLayout;
 };
@@ -10,6 +10,8 @@
 #include "Styling/Painters/PartPainters.h"
 #include "Styling/Painters/DrawablePainter.h"
 #include "Layouts/Layout.h"
+#include "DrawSink.h"
+#include "Utils/DrawGeometry.h"
 
 
 #include "Engine/Render2D/Render2D.h"
@@ -20,13 +22,14 @@
 #include "Engine/Scripting/ManagedCLR/MClass.h"
 #include "Engine/Scripting/Types.h"
 #include "Engine/Render2D/SpriteAtlas.h"
+#include "Engine/Engine/Engine.h"
 
 
 FudgetControl::FudgetControl(const SpawnParams &params) : ScriptingObject(params),
     _guiRoot(nullptr), _parent(nullptr), _index(-1), _flags(FudgetControlFlag::ResetFlags), _cursor(CursorType::Default),
     _pos(0), _size(0), _hint_size(120, 60), _min_size(0), _max_size(MAX_int32),
     _state_flags(FudgetControlState::Enabled), _visual_state(0), _cached_global_to_local_translation(0.f), _clipping_count(0), _changing(false),
-    _style(nullptr), _cached_style(nullptr), _theme(nullptr), _cached_theme(nullptr)
+    _update_interval(0.0f), _update_timer_index(-1), _navigation_index(-1), _navigation_dirty_index(-1), _geometry_cache(nullptr), _style(nullptr), _cached_style(nullptr), _theme(nullptr), _cached_theme(nullptr)
 {
     _data_proxy = New<FudgetControlDataConsumerProxy>();
     _data_proxy->_owner = this;
@@ -35,6 +38,11 @@ FudgetControl::FudgetControl(const SpawnParams &params) : ScriptingObject(params
 FudgetControl::~FudgetControl()
 {
     RegisterToUpdate(false);
+    CancelScheduledUpdate();
+    if (_guiRoot != nullptr && _guiRoot != this)
+        _guiRoot->ControlUpdateDestroyed(this);
+    if (_guiRoot != nullptr && (_navigation_index != -1 || _navigation_dirty_index != -1))
+        _guiRoot->NavigationControlRemoved(this, false);
 
     for (auto p : _painters)
         p->_owner = nullptr;
@@ -45,6 +53,9 @@ FudgetControl::~FudgetControl()
     _drawables.Clear();
 
     Delete(_data_proxy);
+
+    if (_geometry_cache != nullptr)
+        Delete(_geometry_cache);
 }
 
 void FudgetControl::SetParent(FudgetContainer *value)
@@ -67,12 +78,22 @@ void FudgetControl::SetParent(FudgetContainer *value, int order)
     _changing = false;
 }
 
+int FudgetControl::GetIndexInParent() const
+{
+    if (_parent == nullptr)
+        return -1;
+    return _parent->ChildIndex(this);
+}
+
 void FudgetControl::SetIndexInParent(int value)
 {
-    if (_changing || _parent == nullptr || value == _index || value < 0 || value >= _parent->GetChildCount())
+    if (_changing || _parent == nullptr || value < 0 || value >= _parent->GetChildCount())
+        return;
+    int index = GetIndexInParent();
+    if (value == index)
         return;
     _changing = true;
-    _parent->MoveChildToIndex(_index, value);
+    _parent->MoveChildToIndex(index, value);
     _changing = false;
 }
 
@@ -174,6 +195,38 @@ void FudgetControl::RegisterToUpdate(bool value)
         SetState(FudgetControlState::Updating, value);
 }
 
+void FudgetControl::SetUpdateInterval(float value)
+{
+    value = Math::Max(0.0f, value);
+    if (Math::NearEqual(_update_interval, value))
+        return;
+
+    float old_interval = _update_interval;
+    _update_interval = value;
+
+    // The root keeps controls updating on each frame separate from those with an interval.
+    auto gui = GetGUIRoot();
+    if (gui != nullptr && IsUpdateRegistered())
+        gui->MoveControlUpdateGroup(this, old_interval);
+}
+
+bool FudgetControl::ScheduleUpdate(float delay)
+{
+    auto gui = GetGUIRoot();
+    if (gui == nullptr || (_parent == nullptr && gui != this))
+        return false;
+    return gui->ScheduleControlUpdate(this, delay);
+}
+
+void FudgetControl::CancelScheduledUpdate()
+{
+    if (_update_timer_index == -1)
+        return;
+    auto gui = GetGUIRoot();
+    if (gui != nullptr)
+        gui->CancelControlUpdate(this);
+}
+
 Float2 FudgetControl::LocalToGlobal(Float2 local) const
 {
     if (_parent != nullptr)
@@ -521,19 +574,19 @@ void FudgetControl::FillRectangle(Int2 pos, Int2 size, Color color)
     CacheGlobalToLocal();
     pos = CachedLocalToGlobal(pos);
 
-    Render2D::FillRectangle(Rectangle(pos, size), color);
+    FudgetDrawSink::GetCurrent()->FillRectangle(Rectangle(pos, size), color, color, color, color);
 }
 
 void FudgetControl::FillRectangle(const Rectangle &rect, Color color)
 {
     CacheGlobalToLocal();
-    Render2D::FillRectangle(CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->FillRectangle(CachedLocalToGlobal(rect), color, color, color, color);
 }
 
 void FudgetControl::FillRectangle(const Rectangle& rect, const Color& color1, const Color& color2, const Color& color3, const Color& color4)
 {
     CacheGlobalToLocal();
-    Render2D::FillRectangle(CachedLocalToGlobal(rect), color1, color2, color3, color4);
+    FudgetDrawSink::GetCurrent()->FillRectangle(CachedLocalToGlobal(rect), color1, color2, color3, color4);
 }
 
 void FudgetControl::DrawRectangle(Float2 pos, Float2 size, Color color, float thickness)
@@ -541,43 +594,56 @@ void FudgetControl::DrawRectangle(Float2 pos, Float2 size, Color color, float th
     CacheGlobalToLocal();
     pos = CachedLocalToGlobal(pos) + Float2(0.5f);
 
-    Render2D::DrawRectangle(Rectangle(pos, size), color, color, color, color, thickness);
+    FudgetDrawSink::GetCurrent()->DrawRectangle(Rectangle(pos, size), color, color, color, color, thickness);
 }
 
 void FudgetControl::DrawRectangle(const Rectangle &rect, Color color, float thickness)
 {
     CacheGlobalToLocal();
-    Render2D::DrawRectangle(CachedLocalToGlobal(rect, Float2(0.5f)), color, color, color, color, thickness);
+    FudgetDrawSink::GetCurrent()->DrawRectangle(CachedLocalToGlobal(rect, Float2(0.5f)), color, color, color, color, thickness);
 }
 
 void FudgetControl::DrawRectangle(const Rectangle& rect, const Color& color1, const Color& color2, const Color& color3, const Color& color4, float thickness)
 {
     CacheGlobalToLocal();
-    Render2D::DrawRectangle(CachedLocalToGlobal(rect, Float2(0.5f)), color1, color2, color3, color4, thickness);
+    FudgetDrawSink::GetCurrent()->DrawRectangle(CachedLocalToGlobal(rect, Float2(0.5f)), color1, color2, color3, color4, thickness);
 }
 
 void FudgetControl::Draw9SlicingTexture(TextureBase *t, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color)
 {
     CacheGlobalToLocal();
-    Render2D::Draw9SlicingTexture(t, CachedLocalToGlobal(rect), border, borderUVs, color);
+    GPUTexture *gpu_texture = t != nullptr ? t->GetTexture() : nullptr;
+    if (gpu_texture != nullptr)
+    {
+        DrawCachedGeometry(gpu_texture, false, rect, border, borderUVs, Rectangle(0.f, 0.f, 1.f, 1.f), color);
+        return;
+    }
+    FudgetDrawSink::GetCurrent()->Draw9SlicingTexture(t, CachedLocalToGlobal(rect), border, borderUVs, color, false);
 }
 
 void FudgetControl::Draw9SlicingTexturePoint(TextureBase *t, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color)
 {
     CacheGlobalToLocal();
-    Render2D::Draw9SlicingTexturePoint(t, CachedLocalToGlobal(rect), border, borderUVs, color);
+    FudgetDrawSink::GetCurrent()->Draw9SlicingTexture(t, CachedLocalToGlobal(rect), border, borderUVs, color, true);
 }
 
 void FudgetControl::Draw9SlicingSprite(const SpriteHandle& spriteHandle, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color)
 {
     CacheGlobalToLocal();
-    Render2D::Draw9SlicingSprite(spriteHandle, CachedLocalToGlobal(rect), border, borderUVs, color);
+    Sprite sprite;
+    GPUTexture *gpu_texture = spriteHandle.GetSprite(&sprite) ? spriteHandle.Atlas->GetTexture() : nullptr;
+    if (gpu_texture != nullptr)
+    {
+        DrawCachedGeometry(gpu_texture, false, rect, border, borderUVs, sprite.Area, color);
+        return;
+    }
+    FudgetDrawSink::GetCurrent()->Draw9SlicingSprite(spriteHandle, CachedLocalToGlobal(rect), border, borderUVs, color, false);
 }
 
 void FudgetControl::Draw9SlicingSpritePoint(const SpriteHandle& spriteHandle, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color)
 {
     CacheGlobalToLocal();
-    Render2D::Draw9SlicingSpritePoint(spriteHandle, CachedLocalToGlobal(rect), border, borderUVs, color);
+    FudgetDrawSink::GetCurrent()->Draw9SlicingSprite(spriteHandle, CachedLocalToGlobal(rect), border, borderUVs, color, true);
 }
 
 void FudgetControl::Draw9SlicingPrecalculatedTexture(TextureBase *t, const Rectangle &rect, const FudgetPadding &borderWidths, const Color &color, FudgetImageAlignment alignment)
@@ -603,55 +669,55 @@ void FudgetControl::Draw9SlicingPrecalculatedSpritePoint(const SpriteHandle& spr
 void FudgetControl::DrawBezier(const Float2& p1, const Float2& p2, const Float2& p3, const Float2& p4, const Color& color, float thickness)
 {
     CacheGlobalToLocal();
-    Render2D::DrawBezier(CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), CachedLocalToGlobal(p3), CachedLocalToGlobal(p4), color, thickness);
+    FudgetDrawSink::GetCurrent()->DrawBezier(CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), CachedLocalToGlobal(p3), CachedLocalToGlobal(p4), color, thickness);
 }
 
 void FudgetControl::DrawBlur(const Rectangle& rect, float blurStrength)
 {
     CacheGlobalToLocal();
-    Render2D::DrawBlur(CachedLocalToGlobal(rect), blurStrength);
+    FudgetDrawSink::GetCurrent()->DrawBlur(CachedLocalToGlobal(rect), blurStrength);
 }
 
 void FudgetControl::DrawLine(const Float2& p1, const Float2& p2, const Color& color, float thickness)
 {
     CacheGlobalToLocal();
-    Render2D::DrawLine(CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), color, color, thickness);
+    FudgetDrawSink::GetCurrent()->DrawLine(CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), color, color, thickness);
 }
 
 void FudgetControl::DrawLine(const Float2& p1, const Float2& p2, const Color& color1, const Color& color2, float thickness)
 {
     CacheGlobalToLocal();
-    Render2D::DrawLine(CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), color1, color2, thickness);
+    FudgetDrawSink::GetCurrent()->DrawLine(CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), color1, color2, thickness);
 }
 
 void FudgetControl::DrawMaterial(MaterialBase* material, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::DrawMaterial(material, CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->DrawMaterial(material, CachedLocalToGlobal(rect), color);
 }
 
 void FudgetControl::DrawSprite(const SpriteHandle& spriteHandle, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::DrawSprite(spriteHandle, CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->DrawSprite(spriteHandle, CachedLocalToGlobal(rect), color, false);
 }
 
 void FudgetControl::DrawSpritePoint(const SpriteHandle& spriteHandle, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::DrawSpritePoint(spriteHandle, CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->DrawSprite(spriteHandle, CachedLocalToGlobal(rect), color, true);
 }
 
 void FudgetControl::DrawText(Font* font, const StringView& text, const Color& color, const Int2& location, MaterialBase* customMaterial)
 {
     CacheGlobalToLocal();
-    Render2D::DrawText(font, text, color, CachedLocalToGlobal(location), customMaterial);
+    FudgetDrawSink::GetCurrent()->DrawText(font, text, nullptr, color, Float2(CachedLocalToGlobal(location)), customMaterial);
 }
 
 void FudgetControl::DrawText(Font* font, const StringView& text, API_PARAM(Ref) const TextRange& textRange, const Color& color, const Int2& location, MaterialBase* customMaterial)
 {
     CacheGlobalToLocal();
-    Render2D::DrawText(font, text, textRange, color, CachedLocalToGlobal(location), customMaterial);
+    FudgetDrawSink::GetCurrent()->DrawText(font, text, &textRange, color, Float2(CachedLocalToGlobal(location)), customMaterial);
 }
 
 void FudgetControl::DrawText(Font* font, const StringView& text, const Color& color, API_PARAM(Ref) TextLayoutOptions& layout, MaterialBase* customMaterial)
@@ -659,7 +725,7 @@ void FudgetControl::DrawText(Font* font, const StringView& text, const Color& co
     CacheGlobalToLocal();
     TextLayoutOptions tmp = layout;
     tmp.Bounds = CachedLocalToGlobal(layout.Bounds);
-    Render2D::DrawText(font, text, color, tmp, customMaterial);
+    FudgetDrawSink::GetCurrent()->DrawText(font, text, nullptr, color, tmp, customMaterial);
 }
 
 void FudgetControl::DrawText(Font* font, const StringView& text, API_PARAM(Ref) const TextRange& textRange, const Color& color, API_PARAM(Ref) TextLayoutOptions& layout, MaterialBase* customMaterial)
@@ -667,55 +733,55 @@ void FudgetControl::DrawText(Font* font, const StringView& text, API_PARAM(Ref)
     CacheGlobalToLocal();
     TextLayoutOptions tmp = layout;
     tmp.Bounds = CachedLocalToGlobal(layout.Bounds);
-    Render2D::DrawText(font, text, textRange, color, tmp, customMaterial);
+    FudgetDrawSink::GetCurrent()->DrawText(font, text, &textRange, color, tmp, customMaterial);
 }
 
 void FudgetControl::DrawTexture(GPUTextureView* rt, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::DrawTexture(rt, CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->DrawTexture(rt, CachedLocalToGlobal(rect), color);
 }
 
 void FudgetControl::DrawTexture(GPUTexture* t, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::DrawTexture(t, CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->DrawTexture(t, CachedLocalToGlobal(rect), color, false);
 }
 
 void FudgetControl::DrawTexture(TextureBase* t, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::DrawTexture(t, CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->DrawTexture(t, CachedLocalToGlobal(rect), color);
 }
 
 void FudgetControl::DrawSpriteTiled(const SpriteHandle& spriteHandle, Float2 size, Float2 offset, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    DrawTiled(nullptr, spriteHandle, false, size, offset, CachedLocalToGlobal(rect), color);
+    DrawTiled(nullptr, spriteHandle, false, size, offset, rect, color);
 }
 
 void FudgetControl::DrawSpritePointTiled(const SpriteHandle& spriteHandle, Float2 size, Float2 offset, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    DrawTiled(nullptr, spriteHandle, true, size, offset, CachedLocalToGlobal(rect), color);
+    DrawTiled(nullptr, spriteHandle, true, size, offset, rect, color);
 }
 
 void FudgetControl::DrawTextureTiled(GPUTexture *t, Float2 size, Float2 offset, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    DrawTiled(t, SpriteHandle(), false, size, offset, CachedLocalToGlobal(rect), color);
+    DrawTiled(t, SpriteHandle(), false, size, offset, rect, color);
 }
 
 void FudgetControl::DrawTexturePointTiled(GPUTexture *t, Float2 size, Float2 offset, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    DrawTiled(t, SpriteHandle(), true, size, offset, CachedLocalToGlobal(rect), color);
+    DrawTiled(t, SpriteHandle(), true, size, offset, rect, color);
 }
 
 void FudgetControl::DrawTexturePoint(GPUTexture* t, const Rectangle& rect, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::DrawTexturePoint(t, CachedLocalToGlobal(rect), color);
+    FudgetDrawSink::GetCurrent()->DrawTexture(t, CachedLocalToGlobal(rect), color, true);
 }
 
 void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<Float2>& vertices, const Span<Float2>& uvs)
@@ -727,7 +793,7 @@ void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<Float2>& ver
         copy.Add(CachedLocalToGlobal(vertices[ix]));
     }
 
-    Render2D::DrawTexturedTriangles(t, Span<Float2>(copy.Get(), copy.Count()), uvs);
+    FudgetDrawSink::GetCurrent()->DrawTexturedTriangles(t, Span<uint16>(), Span<Float2>(copy.Get(), copy.Count()), uvs, Span<Color>());
 }
 
 void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<Float2>& vertices, const Span<Float2>& uvs, const Color& color)
@@ -739,7 +805,7 @@ void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<Float2>& ver
         copy.Add(CachedLocalToGlobal(vertices[ix]));
     }
 
-    Render2D::DrawTexturedTriangles(t, Span<Float2>(copy.Get(), copy.Count()), uvs);
+    FudgetDrawSink::GetCurrent()->DrawTexturedTriangles(t, Span<uint16>(), Span<Float2>(copy.Get(), copy.Count()), uvs, Span<Color>());
 }
 
 void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<Float2>& vertices, const Span<Float2>& uvs, const Span<Color>& colors)
@@ -751,7 +817,7 @@ void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<Float2>& ver
         copy.Add(CachedLocalToGlobal(vertices[ix]));
     }
 
-    Render2D::DrawTexturedTriangles(t, Span<Float2>(copy.Get(), copy.Count()), uvs, colors);
+    FudgetDrawSink::GetCurrent()->DrawTexturedTriangles(t, Span<uint16>(), Span<Float2>(copy.Get(), copy.Count()), uvs, colors);
 }
 
 void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<uint16>& indices, const Span<Float2>& vertices, const Span<Float2>& uvs, const Span<Color>& colors)
@@ -763,7 +829,7 @@ void FudgetControl::DrawTexturedTriangles(GPUTexture* t, const Span<uint16>& ind
         copy.Add(CachedLocalToGlobal(vertices[ix]));
     }
 
-    Render2D::DrawTexturedTriangles(t, indices, Span<Float2>(copy.Get(), copy.Count()), uvs, colors);
+    FudgetDrawSink::GetCurrent()->DrawTexturedTriangles(t, indices, Span<Float2>(copy.Get(), copy.Count()), uvs, colors);
 }
 
 void FudgetControl::FillTriangles(const Span<Float2>& vertices, const Span<Color>& colors, bool useAlpha)
@@ -775,13 +841,13 @@ void FudgetControl::FillTriangles(const Span<Float2>& vertices, const Span<Color
         copy.Add(CachedLocalToGlobal(vertices[ix]));
     }
 
-    Render2D::FillTriangles(Span<Float2>(copy.Get(), copy.Count()), colors, useAlpha);
+    FudgetDrawSink::GetCurrent()->FillTriangles(Span<Float2>(copy.Get(), copy.Count()), colors, useAlpha);
 }
 
 void FudgetControl::FillTriangle(const Float2& p0, const Float2& p1, const Float2& p2, const Color& color)
 {
     CacheGlobalToLocal();
-    Render2D::FillTriangle(CachedLocalToGlobal(p0), CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), color);
+    FudgetDrawSink::GetCurrent()->FillTriangle(CachedLocalToGlobal(p0), CachedLocalToGlobal(p1), CachedLocalToGlobal(p2), color);
 }
 
 void FudgetControl::DrawArea(const FudgetDrawArea &area, const Rectangle &rect, const Color &tint)
@@ -929,7 +995,7 @@ void FudgetControl::DrawDrawable(FudgetDrawable *drawable, int stateindex, Float
 void FudgetControl::PushClip(const Rectangle &rect)
 {
     CacheGlobalToLocal();
-    Render2D::PushClip(CachedLocalToGlobal(rect));
+    FudgetDrawSink::GetCurrent()->PushClip(CachedLocalToGlobal(rect));
 
     ++_clipping_count;
 }
@@ -939,7 +1005,7 @@ void FudgetControl::PopClip()
     if (_clipping_count == 0)
         return;
     --_clipping_count;
-    Render2D::PopClip();
+    FudgetDrawSink::GetCurrent()->PopClip();
 }
 
 bool FudgetControl::ClearStyleCache(bool forced)
@@ -1430,12 +1496,13 @@ void FudgetControl::Serialize(SerializeStream& stream, const void* otherObj)
     SERIALIZE_MEMBER(MaxSize, _max_size);
 
     FudgetLayout* layout = _parent ? _parent->GetLayout() : nullptr;
-    if (layout)
+    FudgetLayoutSlot* slot = layout ? layout->GetSlot(GetIndexInParent()) : nullptr;
+    if (slot)
     {
         stream.JKEY("SlotProperties");
         stream.StartObject();
         // Serialize slot
-        layout->GetSlot(GetIndexInParent())->Serialize(stream, nullptr);
+        slot->Serialize(stream, nullptr);
         stream.EndObject();
     }
 }
@@ -1475,9 +1542,10 @@ void FudgetControl::Deserialize(DeserializeStream& stream, ISerializeModifier* m
     {
         DeserializeStream& slotProperties = layoutSlotMember->value;
         FudgetLayout* layout = _parent ? _parent->GetLayout() : nullptr;
-        if (layout)
+        FudgetLayoutSlot* slot = layout ? layout->GetSlot(GetIndexInParent()) : nullptr;
+        if (slot)
         {
-            layout->GetSlot(GetIndexInParent())->Deserialize(slotProperties, modifier);
+            slot->Deserialize(slotProperties, modifier);
         }
     }
 }
@@ -1536,6 +1604,8 @@ void FudgetControl::DoEnabledChanged()
 void FudgetControl::DoVirtuallyEnabledChanged()
 {
     SetVisualState(FudgetVisualControlState::Disabled, !VirtuallyEnabled());
+    if (_guiRoot != nullptr)
+        _guiRoot->NavigationControlChanged(this);
     OnVirtuallyEnabledChanged();
 }
 
@@ -1553,12 +1623,16 @@ void FudgetControl::DoFocusChanged(bool focused, FudgetControl *other)
 void FudgetControl::DoShow()
 {
     VisibilityModified();
+    if (_guiRoot != nullptr)
+        _guiRoot->NavigationControlChanged(this);
     OnShow();
 }
 
 void FudgetControl::DoHide()
 {
     VisibilityModified();
+    if (_guiRoot != nullptr)
+        _guiRoot->NavigationControlChanged(this);
     OnHide();
 }
 
@@ -1778,9 +1852,20 @@ void FudgetControl::SetParentVisibility(bool value)
         OnHide();
 }
 
+void FudgetControl::OnReset()
+{
+    if (_guiRoot != nullptr && _guiRoot != this)
+        _guiRoot->ReleaseControlInput(this);
+    RegisterToUpdate(false);
+    CancelScheduledUpdate();
+    SetState(FudgetControlState::MouseIsCaptured, false);
+    SetVisualState(FudgetVisualControlState::Pressed | FudgetVisualControlState::Down | FudgetVisualControlState::Focused | FudgetVisualControlState::Hovered, false);
+}
+
 void FudgetControl::DoRootChanging(FudgetGUIRoot *new_root)
 {
     RegisterToUpdate(false);
+    CancelScheduledUpdate();
     OnRootChanging(new_root);
 }
 
@@ -1795,8 +1880,11 @@ void FudgetControl::DoParentChanged(FudgetContainer *old_parent)
     if (_parent == nullptr)
     {
         RegisterToUpdate(false);
+        CancelScheduledUpdate();
         DoParentStateChanged();
         SetState(FudgetControlState::StyleInitialized, false);
+        if (_guiRoot != nullptr)
+            _guiRoot->NavigationControlRemoved(this, true);
         _guiRoot = nullptr;
         return;
     }
@@ -1807,8 +1895,12 @@ void FudgetControl::DoParentChanged(FudgetContainer *old_parent)
     bool root_change = old_parent == nullptr || old_parent->GetGUIRoot() != _parent->GetGUIRoot();
     if (root_change)
         DoRootChanging(_parent->GetGUIRoot());
+    if (root_change && old_parent != nullptr && old_parent->GetGUIRoot() != nullptr)
+        old_parent->GetGUIRoot()->NavigationControlRemoved(this, true);
 
     _guiRoot = _parent->GetGUIRoot();
+    if (_guiRoot != nullptr)
+        _guiRoot->NavigationControlChanged(this);
 
     if (/*_guiRoot != nullptr &&*/ !HasAnyState(FudgetControlState::Initialized) /*&& (_parent == nullptr || _parent->HasAnyState(FudgetControlState::Initialized))*/)
     {
@@ -1872,7 +1964,9 @@ void FudgetControl::DrawTextureInner(TextureBase *t, SpriteHandle sprite_handle,
     if (t == nullptr && !sprite_handle.GetSprite(&sprite))
         return;
 
-    Int2 siz = (t != nullptr ? t->Size() : sprite.Area.Size) * scale;
+    // Sprite areas are in texture coordinates of the atlas.
+    Float2 sprite_size = t == nullptr ? sprite.Area.Size * sprite_handle.Atlas->Size() : Float2::Zero;
+    Int2 siz = (t != nullptr ? t->Size() : sprite_size) * scale;
     AlignDrawRectangle(siz, alignment, rect);
 
     if (t != nullptr)
@@ -1898,9 +1992,9 @@ void FudgetControl::DrawTextureInner(TextureBase *t, SpriteHandle sprite_handle,
     if ((alignment & FudgetImageAlignment::Tiled) == FudgetImageAlignment::Tiled)
     {
         if (!point)
-            DrawSpriteTiled(sprite_handle, sprite.Area.Size * scale, offset, rect, tint);
+            DrawSpriteTiled(sprite_handle, sprite_size * scale, offset, rect, tint);
         else
-            DrawSpritePointTiled(sprite_handle, sprite.Area.Size * scale, offset, rect, tint);
+            DrawSpritePointTiled(sprite_handle, sprite_size * scale, offset, rect, tint);
     }
     else
     {
@@ -1912,8 +2006,28 @@ void FudgetControl::DrawTextureInner(TextureBase *t, SpriteHandle sprite_handle,
     }
 }
 
-void FudgetControl::DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool point, Float2 size, Float2 offset, const Rectangle& rect, const Color& color)
+void FudgetControl::DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool point, Float2 size, Float2 offset, const Rectangle& local_rect, const Color& color)
 {
+    // Render2D has no point sampled triangles, so only linear sampled tiles are drawn as one list.
+    if (!point)
+    {
+        GPUTexture *gpu_texture = t;
+        Rectangle uv_area(0.f, 0.f, 1.f, 1.f);
+        Sprite sprite;
+        if (t == nullptr && sprite_handle.GetSprite(&sprite))
+        {
+            gpu_texture = sprite_handle.Atlas->GetTexture();
+            uv_area = sprite.Area;
+        }
+        if (gpu_texture != nullptr)
+        {
+            DrawCachedGeometry(gpu_texture, true, local_rect, Float4(size.X, size.Y, 0.f, 0.f), Float4::Zero, uv_area, color);
+            return;
+        }
+    }
+
+    Rectangle rect = CachedLocalToGlobal(local_rect);
+
     // Number of textures to draw along the x axis, including the half drawn one
     float cnt_x_f = rect.Size.X / size.X;
     // Number of textures to draw along the y axis, including the half drawn one
@@ -1922,7 +2036,7 @@ void FudgetControl::DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool po
     // Integer number of textures to draw along the x axis
     int cnt_x = (int)Math::Floor(cnt_x_f);
     // Integer number of textures to draw along the y axis
-    int cnt_y = (int)Math::Floor(cnt_x_f);
+    int cnt_y = (int)Math::Floor(cnt_y_f);
 
     // Get the actual number of textures
 
@@ -1931,7 +2045,8 @@ void FudgetControl::DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool po
     if (Math::NotNearEqual(cnt_y_f, (float)cnt_y))
         ++cnt_y;
 
-    Render2D::PushClip(rect);
+    FudgetDrawSink *sink = FudgetDrawSink::GetCurrent();
+    sink->PushClip(rect);
 
     float posx = rect.Location.X;
     float posy = rect.Location.Y;
@@ -1939,14 +2054,10 @@ void FudgetControl::DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool po
     {
         for (int ix = 0; ix < cnt_x; ++ix)
         {
-            if (t != nullptr && !point)
-                Render2D::DrawTexture(t, Rectangle(Float2(posx, posy), size), color);
-            if (t != nullptr && point)
-                Render2D::DrawTexturePoint(t, Rectangle(Float2(posx, posy), size), color);
-            if (t == nullptr && !point)
-                Render2D::DrawSprite(sprite_handle, Rectangle(Float2(posx, posy), size), color);
-            if (t == nullptr && point)
-                Render2D::DrawSpritePoint(sprite_handle, Rectangle(Float2(posx, posy), size), color);
+            if (t != nullptr)
+                sink->DrawTexture(t, Rectangle(Float2(posx, posy), size), color, point);
+            else
+                sink->DrawSprite(sprite_handle, Rectangle(Float2(posx, posy), size), color, point);
 
             posx += size.X;
         }
@@ -1954,7 +2065,21 @@ void FudgetControl::DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool po
         posx = rect.Location.X;
     }
 
-    Render2D::PopClip();
+    sink->PopClip();
+}
+
+void FudgetControl::DrawCachedGeometry(GPUTexture *t, bool tiled, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Rectangle &uv_area, const Color &color)
+{
+    if (_geometry_cache == nullptr)
+        _geometry_cache = New<FudgetDrawGeometryCache>();
+
+    FudgetDrawGeometryCache::Key key = { tiled, rect, border, borderUVs, uv_area, color };
+    const FudgetDrawGeometryCache::Entry &geometry = _geometry_cache->Get(key, Engine::FrameCount);
+    if (geometry.Vertices.IsEmpty())
+        return;
+
+    FudgetDrawSink::GetCurrent()->DrawTexturedTriangles(t, Span<uint16>(), _geometry_cache->GetTranslatedVertices(geometry, CachedLocalToGlobal(Float2::Zero)),
+        Span<Float2>((Float2*)geometry.UVs.Get(), geometry.UVs.Count()), Span<Color>((Color*)geometry.Colors.Get(), geometry.Colors.Count()));
 }
 
 void FudgetControl::Draw9SlicingPrecalculatedInner(TextureBase *t, SpriteHandle sprite_handle, Rectangle rect, const FudgetPadding &borderWidths, const Color &color, FudgetImageAlignment alignment, bool point)
@@ -1964,7 +2089,7 @@ void FudgetControl::Draw9SlicingPrecalculatedInner(TextureBase *t, SpriteHandle
 
     Int4 border;
     Float4 borderUV;
-    Float2 siz = t != nullptr ? t->Size() : sprite_handle.Atlas->GetSprite(sprite_handle.Index).Area.Size;
+    Float2 siz = t != nullptr ? t->Size() : sprite_handle.Atlas->GetSprite(sprite_handle.Index).Area.Size * sprite_handle.Atlas->Size();
     border = borderWidths.AsInt4();
     borderUV = Float4(border.X / siz.X, border.Y / siz.X, border.Z / siz.Y, border.W / siz.Y);
 
@@ -2064,6 +2189,9 @@ bool FudgetControl::IsDirectSizeChangePermitted() const
 
 void FudgetControl::LayoutUpdate(Int2 pos, Int2 size)
 {
+    if (pos == _pos && size == _size)
+        return;
+
     if (pos != _pos)
     {
         _pos = pos;
@@ -2073,6 +2201,14 @@ void FudgetControl::LayoutUpdate(Int2 pos, Int2 size)
     {
         _size = size;
         SetState(FudgetControlState::SizeUpdated, true);
+        // The cached geometry was made for the old size and won't be drawn again.
+        if (_geometry_cache != nullptr)
+            _geometry_cache->Clear();
+    }
+    if (_guiRoot != nullptr)
+    {
+        _guiRoot->InvalidateHitTestCache();
+        _guiRoot->NavigationControlChanged(this);
     }
 }
 
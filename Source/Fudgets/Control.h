@@ -78,6 +78,7 @@ struct FudgetDrawColors;
 class FudgetPartPainter;
 struct FudgetDrawInstructionList;
 class FudgetDrawable;
+class FudgetDrawGeometryCache;
 class FudgetControlDataConsumerProxy;
 
 enum class FudgetVisualControlState : uint64;
@@ -216,6 +217,11 @@ enum class FudgetControlState : uint16
     /// The control has a painter created to draw its frame.
     /// </summary>
     BackgroundCreated = 1 << 13,
+    /// <summary>
+    /// The control's sizes changed while its parent was in a bulk update. The measurements in the layout slot
+    /// of the control are invalidated when the update ends.
+    /// </summary>
+    LayoutSizesPending = 1 << 14,
 };
 DECLARE_ENUM_OPERATORS(FudgetControlState);
 
@@ -340,6 +346,19 @@ enum class FudgetControlFlag : uint32
     /// TODO: make the layouts and controls respect the frame's padding automatically.
     /// </summary>
     Framed = 1 << 15,
+    /// <summary>
+    /// The container can be measured in its parent's layout without depending on its siblings. When more than one
+    /// such sibling needs measuring, they are measured concurrently on the job system. The OnMeasure calls of the
+    /// container and its contents must not change styles, the control tree or anything outside the container,
+    /// and must use FudgetFont::MeasureLocker when measuring text with fonts directly. The text measurement caches
+    /// lock it themselves.
+    /// </summary>
+    LayoutIsolated = 1 << 16,
+    /// <summary>
+    /// The control receives every mouse move event reported by the system while it's hovered or captures the mouse.
+    /// Without this flag, mouse moves are merged to a single move to the latest position once per frame.
+    /// </summary>
+    RawMouseMove = 1 << 17,
 
 };
 DECLARE_ENUM_OPERATORS(FudgetControlFlag);
@@ -562,7 +581,7 @@ public:
     /// and which control's methods are called first. The control with the highest index is drawn last, covering others below.
     /// </summary>
     /// <returns>The order inside the parent that determines when drawing and callbacks are called.</returns>
-    API_PROPERTY() int GetIndexInParent() const { return _index; }
+    API_PROPERTY() int GetIndexInParent() const;
 
     /// <summary>
     /// Sets the control's order among other controls in its parent. The index determines the control's drawing order
@@ -749,6 +768,8 @@ public:
     /// to report the same results for the same space. This result should be below the available space if it's
     /// possible.
     /// If any dimension of the available space is negative, the control is unrestricted in that dimension.
+    /// Inside containers with the LayoutIsolated flag this can be called from a job thread. See the flag for what
+    /// is allowed in that case.
     /// </summary>
     /// <param name="available">Available space in the parent layout or negative if the space is not restricted.</param>
     /// <param name="wanted">The dimensions the control requests that's enough to fit it properly</param>
@@ -785,6 +806,15 @@ public:
     /// <param name="old_parent">The previous parent which can be null</param>
     API_PROPERTY() virtual void OnParentChanged(FudgetContainer *old_parent) {}
 
+    /// <summary>
+    /// Called when the control is returned to a FudgetControlPool, right before it's removed from its parent.
+    /// Releases the mouse capture, focus and hover, clears the visual and update states and unregisters the control
+    /// from updates. Override to clear the state that shouldn't be seen by the next user of the control, and call
+    /// the base implementation.
+    /// Script references to the control will refer to the reused control after it's acquired from the pool again.
+    /// </summary>
+    API_FUNCTION() virtual void OnReset();
+
     /// <summary>
     /// Called before the root changes. The control might not be initialized yet at this point.
     /// </summary>
@@ -800,7 +830,8 @@ public:
     // Update callback
 
     /// <summary>
-    /// Called on each frame if the control is registered to receive events
+    /// Called on each frame if the control is registered to receive events, or less often if it has an update interval.
+    /// Also called once for every update requested with ScheduleUpdate.
     /// </summary>
     /// <param name="delta_time">The time passed since the last update</param>
     API_FUNCTION() virtual void OnUpdate(float delta_time) {}
@@ -816,6 +847,42 @@ public:
     /// </summary>
     API_PROPERTY() bool IsUpdateRegistered() const { return (_state_flags & FudgetControlState::Updating) == FudgetControlState::Updating; }
 
+    /// <summary>
+    /// The time in seconds between two OnUpdate calls while the control is registered to receive updates. When it's
+    /// zero, OnUpdate is called on every frame. Controls that don't need to animate smoothly can set a larger value
+    /// to avoid being called on every frame.
+    /// </summary>
+    API_PROPERTY() float GetUpdateInterval() const { return _update_interval; }
+
+    /// <summary>
+    /// Sets the time in seconds between two OnUpdate calls while the control is registered to receive updates. Set it to
+    /// zero to get OnUpdate called on every frame. Negative values are treated as zero.
+    /// </summary>
+    /// <param name="value">The time between updates in seconds</param>
+    API_PROPERTY() void SetUpdateInterval(float value);
+
+    /// <summary>
+    /// Requests a single OnUpdate call after the given time passed, even if the control is not registered to receive
+    /// updates. Calling this again before the update happens replaces the previous request. The delta_time passed to
+    /// OnUpdate is the time since the update was scheduled. Controls registered with a non-zero update interval will
+    /// continue updating with their interval after the scheduled update.
+    /// </summary>
+    /// <param name="delay">Time in seconds until OnUpdate is called. Zero calls it on the next update tick.</param>
+    /// <returns>Whether the update could be scheduled. It fails if the control is not in a running UI.</returns>
+    API_FUNCTION() bool ScheduleUpdate(float delay);
+
+    /// <summary>
+    /// Cancels a pending update requested with ScheduleUpdate. Controls registered with a non-zero update interval
+    /// won't get their next update either until they are registered again.
+    /// </summary>
+    API_FUNCTION() void CancelScheduledUpdate();
+
+    /// <summary>
+    /// Whether the control has an OnUpdate call pending that was requested with ScheduleUpdate, or because it is
+    /// registered to receive updates with a non-zero update interval.
+    /// </summary>
+    API_PROPERTY() bool IsUpdateScheduled() const { return _update_timer_index != -1; }
+
     // Point transformation
 
     /// <summary>
@@ -2389,8 +2456,11 @@ private:
 
     void DrawDrawableInstructions(const FudgetDrawInstructionList &area, const Rectangle &rect, const Color &tint = Color::White);
     void DrawTextureInner(TextureBase *t, SpriteHandle sprite_handle, Float2 scale, Float2 offset, Rectangle rect, Color tint, FudgetImageAlignment alignment, bool point);
-    void DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool point, Float2 size, Float2 offset, const Rectangle& rect, const Color& color);
+    void DrawTiled(GPUTexture *t, SpriteHandle sprite_handle, bool point, Float2 size, Float2 offset, const Rectangle& local_rect, const Color& color);
     void Draw9SlicingPrecalculatedInner(TextureBase *t, SpriteHandle sprite_handle, Rectangle rect, const FudgetPadding &borderWidths, const Color &color, FudgetImageAlignment alignment, bool point);
+    // Draws a nine-sliced or tiled texture in local coordinates as a single list of triangles, which is cached until
+    // the values it's made from change. Call CacheGlobalToLocal first.
+    void DrawCachedGeometry(GPUTexture *t, bool tiled, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Rectangle &uv_area, const Color &color);
 
     // Modifies the rectangle based on the texture/sprite size and the alignment
     void AlignDrawRectangle(Int2 tex_size, FudgetImageAlignment alignment, /*modified*/ Rectangle &rect);
@@ -2489,6 +2559,21 @@ private:
     // Used locally to avoid double calling functions from the parent.
     bool _changing;
 
+    // Seconds between OnUpdate calls while registered to updates. Zero means every frame.
+    float _update_interval;
+
+    // Position of this control's timer in the gui root's update timer heap or -1 if no update is scheduled.
+    int _update_timer_index;
+
+    // Position of this control's entry in the gui root's navigation index or -1 if it's not in the index.
+    int _navigation_index;
+    // Position of this control in the dirty list of the gui root's navigation index, or -1 if it's not waiting to
+    // be updated there.
+    int _navigation_dirty_index;
+
+    // Geometry of the last nine-sliced and tiled draws of the control. Created on the first such draw.
+    FudgetDrawGeometryCache *_geometry_cache;
+
     // Null or the style used to decide the look of the control. When null, the active style is based on the type
     // or the default style name.
     FudgetStyle *_style;
@@ -2525,6 +2610,7 @@ private:
     friend class FudgetLayout;
     friend class FudgetContainer;
     friend class FudgetGUIRoot;
+    friend class FudgetNavigationIndex;
     friend class FudgetPartPainter;
     friend class FudgetDrawable;
     friend class FudgetControlDataConsumerProxy;
@@ -0,0 +1,91 @@
+#include "ControlPool.h"
+#include "Control.h"
+
+#include "Engine/Scripting/Scripting.h"
+
+
+FudgetControlPool::FudgetControlPool(const SpawnParams &params) : Base(params), _max_per_type(256)
+{
+}
+
+FudgetControlPool::~FudgetControlPool()
+{
+    Clear();
+}
+
+FudgetControl* FudgetControlPool::Acquire(const StringAnsiView &type_name)
+{
+    const ScriptingTypeHandle type = Scripting::FindScriptingType(type_name);
+    if (!type)
+        return nullptr;
+
+    if (!FudgetControl::TypeInitializer.IsAssignableFrom(type))
+        return nullptr;
+
+    FudgetControl *control = TakePooled(type);
+    if (control != nullptr)
+        return control;
+
+    return (FudgetControl*)type.GetType().Script.Spawn(ScriptingObjectSpawnParams(Guid::New(), type));
+}
+
+void FudgetControlPool::Release(FudgetControl *control)
+{
+    if (control == nullptr)
+        return;
+
+    Array<FudgetControl*> &list = _pooled[control->GetTypeHandle()];
+    if (list.Contains(control))
+        return;
+    if (list.Count() >= _max_per_type)
+    {
+        control->SetParent(nullptr);
+        Delete(control);
+        return;
+    }
+
+    // Reset while the control is still in the tree, so its root can release the input from it.
+    control->OnReset();
+    control->SetParent(nullptr);
+    list.Add(control);
+}
+
+void FudgetControlPool::SetMaxPerType(int value)
+{
+    _max_per_type = Math::Max(0, value);
+    for (auto &p : _pooled)
+    {
+        Array<FudgetControl*> &list = p.Value;
+        while (list.Count() > _max_per_type)
+        {
+            Delete(list.Last());
+            list.RemoveLast();
+        }
+    }
+}
+
+int FudgetControlPool::GetPooledCount() const
+{
+    int result = 0;
+    for (const auto &p : _pooled)
+        result += p.Value.Count();
+    return result;
+}
+
+void FudgetControlPool::Clear()
+{
+    for (auto &p : _pooled)
+        p.Value.ClearDelete();
+    _pooled.Clear();
+}
+
+FudgetControl* FudgetControlPool::TakePooled(const ScriptingTypeHandle &type)
+{
+    Array<FudgetControl*> *list = _pooled.TryGet(type);
+    if (list == nullptr || list->IsEmpty())
+        return nullptr;
+
+    FudgetControl *control = list->Last();
+    list->RemoveLast();
+    return control;
+}
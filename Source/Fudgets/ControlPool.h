@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Engine/Scripting/ScriptingObject.h"
+#include "Engine/Scripting/ScriptingType.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Types/StringView.h"
+
+class FudgetControl;
+
+/// <summary>
+/// Keeps controls that are no longer used so they can be handed out again instead of creating new ones. Controls are
+/// stored per type in free lists. Released controls are removed from their parent and reset with OnReset, and keep
+/// their painters and other resources, which makes controls frequently created and destroyed, like items of views,
+/// cheaper to get.
+/// Released controls keep their object id, and references held by scripts still point to the same object, which
+/// becomes a different control once it's acquired again. Drop such references when releasing a control.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetControlPool : public ScriptingObject
+{
+    using Base = ScriptingObject;
+    DECLARE_SCRIPTING_TYPE(FudgetControlPool);
+public:
+    ~FudgetControlPool();
+
+    /// <summary>
+    /// Gets a control of a type from the pool or creates a new one if no control of the type is pooled.
+    /// </summary>
+    /// <returns>The control</returns>
+    template<typename T>
+    T* Acquire()
+    {
+        FudgetControl *control = TakePooled(T::TypeInitializer);
+        if (control != nullptr)
+            return (T*)control;
+        return New<T>(SpawnParams(Guid::New(), T::TypeInitializer));
+    }
+
+    /// <summary>
+    /// Gets a control of a type from the pool or creates a new one if no control of the type is pooled.
+    /// </summary>
+    /// <param name="type_name">Full name of a type derived from FudgetControl</param>
+    /// <returns>The control or null if the type is not found or is not a control type</returns>
+    API_FUNCTION() FudgetControl* Acquire(const StringAnsiView &type_name);
+
+    /// <summary>
+    /// Resets a control with OnReset, removes it from its parent and puts it in the pool. The
+    /// control is deleted instead if the pool already holds the maximum number of controls of its type.
+    /// </summary>
+    /// <param name="control">The control to return to the pool</param>
+    API_FUNCTION() void Release(FudgetControl *control);
+
+    /// <summary>
+    /// Gets the maximum number of controls of a single type kept in the pool.
+    /// </summary>
+    API_PROPERTY() int GetMaxPerType() const { return _max_per_type; }
+    /// <summary>
+    /// Sets the maximum number of controls of a single type kept in the pool. Controls over the new limit are deleted.
+    /// </summary>
+    /// <param name="value">The maximum number of controls per type</param>
+    API_PROPERTY() void SetMaxPerType(int value);
+
+    /// <summary>
+    /// Gets the number of controls waiting in the pool.
+    /// </summary>
+    API_PROPERTY() int GetPooledCount() const;
+
+    /// <summary>
+    /// Deletes every control in the pool.
+    /// </summary>
+    API_FUNCTION() void Clear();
+private:
+    // Removes a control of the type from its free list or returns null if the list is empty.
+    FudgetControl* TakePooled(const ScriptingTypeHandle &type);
+
+    Dictionary<ScriptingTypeHandle, Array<FudgetControl*>> _pooled;
+    int _max_per_type;
+};
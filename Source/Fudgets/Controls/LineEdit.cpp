@@ -106,6 +106,10 @@ void FudgetLineEdit::OnDraw()
         return;
     }
 
+    // The caret only needs updates while it's blinking. OnUpdate keeps scheduling the next one until the focus is lost.
+    if (!IsUpdateScheduled())
+        ScheduleUpdate(_caret_blink_time);
+
     // Draw caret
     if (_blink_passed < _caret_blink_time)
     {
@@ -116,8 +120,6 @@ void FudgetLineEdit::OnDraw()
         DrawDrawable(_caret_draw, 0, Rectangle(Float2((float)caret_left - 1.0f + bounds.GetLeft(), bounds.Location.Y), Float2((float)_caret_width, bounds.GetHeight())));
         PopClip();
     }
-    while (_blink_passed >= _caret_blink_time * 2.0f)
-        _blink_passed -= _caret_blink_time * 2.0f;
 }
 
 void FudgetLineEdit::OnSizeChanged()
@@ -154,7 +156,7 @@ int FudgetLineEdit::CharIndexAt(Int2 pos)
 
 void FudgetLineEdit::DoPositionChanged(int old_caret_pos, int old_sel_pos)
 {
-    _blink_passed = 0.0f;
+    ResetCaretBlink();
     ScrollToPos();
 
     Base::DoPositionChanged(old_caret_pos, old_sel_pos);
@@ -162,7 +164,7 @@ void FudgetLineEdit::DoPositionChanged(int old_caret_pos, int old_sel_pos)
 
 void FudgetLineEdit::DoTextEdited(int old_caret_pos, int old_sel_pos)
 {
-    _blink_passed = 0.0f;
+    ResetCaretBlink();
     FixScrollPos();
     ScrollToPos();
     Base::DoTextEdited(old_caret_pos, old_sel_pos);
@@ -170,7 +172,17 @@ void FudgetLineEdit::DoTextEdited(int old_caret_pos, int old_sel_pos)
 
 void FudgetLineEdit::OnUpdate(float delta_time)
 {
-    _blink_passed += delta_time;
+    // Updates are scheduled at the caret blink time, each one switching between the visible and hidden caret.
+    _blink_passed = _blink_passed < _caret_blink_time ? _caret_blink_time : 0.0f;
+    if (VirtuallyFocused())
+        ScheduleUpdate(_caret_blink_time);
+}
+
+void FudgetLineEdit::ResetCaretBlink()
+{
+    _blink_passed = 0.0f;
+    if (IsUpdateScheduled())
+        ScheduleUpdate(_caret_blink_time);
 }
 
 //void FudgetLineEdit::OnFocusChanged(bool focused, FudgetControl *other)
@@ -306,7 +318,7 @@ void FudgetLineEdit::Process(const StringView &value)
 
 FudgetControlFlag FudgetLineEdit::GetInitFlags() const
 {
-    return FudgetControlFlag::RegisterToUpdates | FudgetControlFlag::Framed | Base::GetInitFlags();
+    return FudgetControlFlag::Framed | Base::GetInitFlags();
 }
 
 void FudgetLineEdit::SetTextInternal(const StringView &value)
@@ -101,6 +101,8 @@ private:
     //FudgetPadding GetInnerPadding() const;
 
     void ScrollToPos();
+    // Restarts the caret blinking with the caret visible.
+    void ResetCaretBlink();
     void FixScrollPos();
 
     void Process(const StringView &value);
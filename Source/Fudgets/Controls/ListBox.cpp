@@ -5,13 +5,18 @@
 #include "../Styling/PartPainterIds.h"
 #include "../ItemSelection.h"
 
-FudgetStringListProvider::FudgetStringListProvider(const SpawnParams &params) : Base(params), _allow_duplicates(false)
+#include "Engine/Engine/Engine.h"
+
+FudgetStringListProvider::FudgetStringListProvider(const SpawnParams &params) : Base(params), _allow_duplicates(false),
+    _has_next_change(false), _max_queued_per_update(256), _update_bound(false)
 {
     _consumers = New<FudgetDataConsumerRegistry>(SpawnParams(Guid::New(), FudgetDataConsumerRegistry::TypeInitializer));
 }
 
 FudgetStringListProvider::~FudgetStringListProvider()
 {
+    if (_update_bound.load())
+        Engine::Update.Unbind<FudgetStringListProvider, &FudgetStringListProvider::OnEngineUpdate>(this);
     Delete(_consumers);
 }
 
@@ -22,16 +27,35 @@ void FudgetStringListProvider::Clear()
 
     _consumers->ClearBegin();
     _items.Clear();
+    _values.Clear();
     _consumers->ClearEnd();
 }
 
+void FudgetStringListProvider::Reset()
+{
+    QueuedChange change;
+    while (_queue.Pop(change))
+        ;
+    _has_next_change = false;
+    _next_change.Value.Clear();
+    _max_queued_per_update = 256;
+    _allow_duplicates = false;
+    Clear();
+}
+
 void FudgetStringListProvider::SetText(int index, const StringView &value)
 {
     if (!_consumers->SetBegin(index))
         return;
 
-    if (_allow_duplicates || !IsDuplicate(value))
+    if (_allow_duplicates)
         _items[index] = value;
+    else if (!IsDuplicate(value))
+    {
+        _values.Remove(_items[index]);
+        _items[index] = value;
+        _values.Add(_items[index]);
+    }
 
     _consumers->SetEnd(index);
 }
@@ -45,6 +69,8 @@ int FudgetStringListProvider::AddItem(const StringView &value)
         return -1;
 
     _items.Add(value);
+    if (!_allow_duplicates)
+        _values.Add(_items.Last());
 
     _consumers->AddEnd(1);
 
@@ -65,6 +91,8 @@ int FudgetStringListProvider::InsertItem(int index, const StringView &value)
         return -1;
 
     _items.Insert(index, value);
+    if (!_allow_duplicates)
+        _values.Add(_items[index]);
     _consumers->InsertEnd(index, 1);
 
     return index;
@@ -78,6 +106,8 @@ void FudgetStringListProvider::DeleteItem(int index)
     if (!_consumers->RemoveBegin(index, 1))
         return;
 
+    if (!_allow_duplicates)
+        _values.Remove(_items[index]);
     _items.RemoveAtKeepOrder(index);
 
     _consumers->RemoveEnd(index, 1);
@@ -89,7 +119,9 @@ void FudgetStringListProvider::SetAllowDuplicates(bool value)
         return;
     _allow_duplicates = value;
 
-    if (!_allow_duplicates)
+    if (_allow_duplicates)
+        _values.Clear();
+    else
     {
         int first_duplicate = -1;
 
@@ -130,12 +162,199 @@ void FudgetStringListProvider::SetAllowDuplicates(bool value)
 
             _consumers->EndDataReset();
         }
+
+        // Every value left in _items was added to found by now.
+        _values = MoveTemp(found);
+    }
+}
+
+void FudgetStringListProvider::QueueAddItem(const StringView &value)
+{
+    Enqueue(QueuedChange::Kinds::Add, -1, value);
+}
+
+void FudgetStringListProvider::QueueInsertItem(int index, const StringView &value)
+{
+    Enqueue(QueuedChange::Kinds::Insert, index, value);
+}
+
+void FudgetStringListProvider::QueueSetText(int index, const StringView &value)
+{
+    Enqueue(QueuedChange::Kinds::Set, index, value);
+}
+
+void FudgetStringListProvider::QueueDeleteItem(int index)
+{
+    Enqueue(QueuedChange::Kinds::Delete, index, StringView::Empty);
+}
+
+void FudgetStringListProvider::SetMaxQueuedPerUpdate(int value)
+{
+    _max_queued_per_update = Math::Max(1, value);
+}
+
+int FudgetStringListProvider::ProcessQueue(int max_count)
+{
+    if (max_count <= 0 || (!_has_next_change && _queue.IsEmpty()))
+        return 0;
+
+    _consumers->BeginChange();
+
+    int processed = 0;
+    QueuedChange change;
+    Array<String> run;
+    while (processed < max_count)
+    {
+        if (_has_next_change)
+        {
+            change = MoveTemp(_next_change);
+            _has_next_change = false;
+        }
+        else if (!_queue.Pop(change))
+            break;
+        ++processed;
+
+        int count = _items.Count();
+        if (change.Kind == QueuedChange::Kinds::Set)
+        {
+            if (change.Index >= 0 && change.Index < count)
+                SetText(change.Index, change.Value);
+            continue;
+        }
+
+        if (change.Kind == QueuedChange::Kinds::Delete)
+        {
+            if (change.Index < 0 || change.Index >= count)
+                continue;
+
+            // Deleting at the same index repeatedly or at the index before the previous one removes a single range.
+            int index = change.Index;
+            int run_count = 1;
+            while (processed < max_count && _queue.Pop(_next_change))
+            {
+                if (_next_change.Kind == QueuedChange::Kinds::Delete && _next_change.Index == index && index + run_count < count)
+                    ++run_count;
+                else if (_next_change.Kind == QueuedChange::Kinds::Delete && _next_change.Index == index - 1 && index > 0)
+                {
+                    --index;
+                    ++run_count;
+                }
+                else
+                {
+                    _has_next_change = true;
+                    break;
+                }
+                ++processed;
+            }
+
+            if (!_consumers->RemoveBegin(index, run_count))
+                continue;
+            if (!_allow_duplicates)
+            {
+                for (int ix = index; ix < index + run_count; ++ix)
+                    _values.Remove(_items[ix]);
+            }
+            for (int ix = index; ix + run_count < count; ++ix)
+                _items[ix] = MoveTemp(_items[ix + run_count]);
+            _items.Resize(count - run_count);
+            _consumers->RemoveEnd(index, run_count);
+            continue;
+        }
+
+        // Adding after the previous added item or inserting right after the previous inserted item adds a single range.
+        int index = change.Kind == QueuedChange::Kinds::Add ? count : Math::Clamp(change.Index, 0, count);
+        run.Clear();
+        if (AcceptRunValue(change.Value))
+            run.Add(MoveTemp(change.Value));
+        while (processed < max_count && _queue.Pop(_next_change))
+        {
+            bool next_in_run = false;
+            if (_next_change.Kind == QueuedChange::Kinds::Add)
+                next_in_run = index == count;
+            else if (_next_change.Kind == QueuedChange::Kinds::Insert)
+                next_in_run = Math::Clamp(_next_change.Index, 0, count + run.Count()) == index + run.Count();
+            if (!next_in_run)
+            {
+                _has_next_change = true;
+                break;
+            }
+            if (AcceptRunValue(_next_change.Value))
+                run.Add(MoveTemp(_next_change.Value));
+            ++processed;
+        }
+
+        int run_count = run.Count();
+        if (run_count == 0)
+            continue;
+        if (index == count)
+        {
+            if (!_consumers->AddBegin(run_count))
+            {
+                ForgetRunValues(run);
+                continue;
+            }
+            _items.Add(run.Get(), run_count);
+            _consumers->AddEnd(run_count);
+            continue;
+        }
+
+        if (!_consumers->InsertBegin(index, run_count))
+        {
+            ForgetRunValues(run);
+            continue;
+        }
+        _items.Resize(count + run_count);
+        for (int ix = count - 1; ix >= index; --ix)
+            _items[ix + run_count] = MoveTemp(_items[ix]);
+        for (int ix = 0; ix < run_count; ++ix)
+            _items[index + ix] = MoveTemp(run[ix]);
+        _consumers->InsertEnd(index, run_count);
     }
 
+    _consumers->EndChange();
+    return processed;
+}
+
+void FudgetStringListProvider::Enqueue(QueuedChange::Kinds kind, int index, const StringView &value)
+{
+    QueuedChange change;
+    change.Kind = kind;
+    change.Index = index;
+    change.Value = value;
+    _queue.Push(MoveTemp(change));
+
+    bool expected = false;
+    if (_update_bound.compare_exchange_strong(expected, true))
+        Engine::Update.Bind<FudgetStringListProvider, &FudgetStringListProvider::OnEngineUpdate>(this);
+}
+
+void FudgetStringListProvider::OnEngineUpdate()
+{
+    ProcessQueue(_max_queued_per_update);
+}
+
+bool FudgetStringListProvider::AcceptRunValue(const String &value)
+{
+    if (_allow_duplicates)
+        return true;
+    if (_values.Contains(value))
+        return false;
+    _values.Add(value);
+    return true;
+}
+
+void FudgetStringListProvider::ForgetRunValues(const Array<String> &run)
+{
+    if (_allow_duplicates)
+        return;
+    for (int ix = 0, siz = run.Count(); ix < siz; ++ix)
+        _values.Remove(run[ix]);
 }
 
 bool FudgetStringListProvider::IsDuplicate(const StringView &value) const
 {
+    if (!_allow_duplicates)
+        return _values.Contains(value);
     for (int ix = 0, siz = GetCount(); ix < siz; ++ix)
         if (_items[ix] == value)
             return true;
@@ -288,18 +507,43 @@ FudgetInputResult FudgetListBox::OnKeyDown(KeyboardKeys key)
     return FudgetInputResult::Consume;
 }
 
+void FudgetListBox::OnReset()
+{
+    Base::OnReset();
+
+    // The owned provider is reused. A provider set by the user is replaced, because it's not for the next user.
+    _data->UnregisterDataConsumer(_data_proxy);
+    if (_owned_data)
+        _data->Reset();
+    else
+    {
+        _data = New<FudgetStringListProvider>(SpawnParams(Guid::New(), FudgetStringListProvider::TypeInitializer));
+        _owned_data = true;
+    }
+    _data->RegisterDataConsumer(_data_proxy);
+
+    _selection->DeselectAll();
+    _current = -1;
+    _hovered_index = -1;
+    _top_item = 0;
+    _top_item_pos = Int2::Zero;
+    DataReset();
+}
+
 void FudgetListBox::OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64 old_scroll_pos, bool tracking)
 {
     if (_default_size.Y == -1 || scrollbar != GetVerticalScrollBar())
         return;
     
     int32 scroll_pos = (int32)scrollbar->GetScrollPos();
+    // Moving contents are not snapped, so the motion is smooth. The snap position is reached when the motion ends.
+    bool snap = _snap_top_item && !IsScrollInMotion();
     if (_fixed_item_size)
     {
         
         _top_item = scroll_pos / _default_size.Y;
         _top_item_pos.Y = _top_item * _default_size.Y;
-        if (_snap_top_item)
+        if (snap)
             _scroll_pos.Y = _top_item_pos.Y;
         else
             _scroll_pos.Y = int32(scroll_pos);
@@ -308,6 +552,8 @@ void FudgetListBox::OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64
 
     int count = _data->GetCount();
 
+    // Only walks over the items between the old and new top item, using their known or default sizes. Items are not
+    // measured here, so flinging over many items costs no more than the distance moved in a frame.
     while (_top_item > 0 && _top_item_pos.Y > scroll_pos)
     {
         _top_item_pos.Y -= GetItemSize(--_top_item).Y;
@@ -320,7 +566,7 @@ void FudgetListBox::OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64
         item_size = GetItemSize(++_top_item).Y;
     }
 
-    if (_snap_top_item)
+    if (snap)
         _scroll_pos.Y = _top_item_pos.Y;
     else
         _scroll_pos.Y = int32(scroll_pos);
@@ -844,9 +1090,27 @@ void FudgetListBox::RequestScrollExtents()
 
     if (vbar != nullptr)
     {
+        vbar->SetLineSize(_default_size.Y);
         vbar->SetScrollRange(_list_extents.Y + expand);
         vbar->SetPageSize((int)bounds_size.Y);
         vbar->SetScrollPos(_scroll_pos.Y);
     }
 }
 
+int64 FudgetListBox::GetScrollSnapPosition(FudgetScrollBarComponent *scrollbar, int64 scroll_pos)
+{
+    if (!_snap_top_item || _data == nullptr || _default_size.Y <= 0 || scrollbar != GetVerticalScrollBar())
+        return scroll_pos;
+
+    // The top item was updated for the last position set on the scrollbar. Its neighbors are close enough to check
+    // without walking the list.
+    int count = _data->GetCount();
+    if (count == 0)
+        return scroll_pos;
+
+    int top_height = GetItemSize(_top_item).Y;
+    int64 top_pos = _top_item_pos.Y;
+    if (scroll_pos - top_pos > top_height / 2 && _top_item < count - 1)
+        return top_pos + top_height;
+    return top_pos;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ListControl.h"
+#include "../Utils/ProducerQueue.h"
 
 #include <vector>
 
@@ -38,6 +39,11 @@ public:
     /// <inheritdoc />
     void Clear() override;
 
+    /// <summary>
+    /// Removes every item, drops the queued changes that weren't applied yet and restores the default settings.
+    /// </summary>
+    API_FUNCTION() void Reset();
+
     /// <inheritdoc />
     Variant GetValue(int index) override { return _items[index]; }
 
@@ -96,6 +102,59 @@ public:
     /// and only the first occurrence of each value will be kept.
     /// </summary>
     API_PROPERTY() void SetAllowDuplicates(bool value);
+
+    /// <summary>
+    /// Queues adding a string to the end of the list. Safe to call from any thread. Queued changes are applied on the
+    /// game thread at the next update, in the order they were queued.
+    /// </summary>
+    /// <param name="value">String to add</param>
+    API_FUNCTION() void QueueAddItem(const StringView &value);
+    /// <summary>
+    /// Queues inserting a string at the specified position in the list. Safe to call from any thread. The position is
+    /// clamped between 0 and count when the change is applied.
+    /// </summary>
+    /// <param name="index">Position to insert</param>
+    /// <param name="value">String to insert</param>
+    API_FUNCTION() void QueueInsertItem(int index, const StringView &value);
+    /// <summary>
+    /// Queues changing the string at index. Safe to call from any thread. Nothing is changed if the index is out of
+    /// range when the change is applied.
+    /// </summary>
+    /// <param name="index">Position of the item to change</param>
+    /// <param name="value">The new string</param>
+    API_FUNCTION() void QueueSetText(int index, const StringView &value);
+    /// <summary>
+    /// Queues removing the string at index. Safe to call from any thread. Nothing is removed if the index is out of
+    /// range when the change is applied.
+    /// </summary>
+    /// <param name="index">Position of the item to remove</param>
+    API_FUNCTION() void QueueDeleteItem(int index);
+
+    /// <summary>
+    /// Gets the number of queued changes that are waiting to be applied. Only an estimate while other threads are
+    /// queueing changes.
+    /// </summary>
+    API_PROPERTY() int GetQueuedCount() const { return _queue.Count() + (_has_next_change ? 1 : 0); }
+
+    /// <summary>
+    /// Gets the maximum number of queued changes applied in a single update. The rest is left for the following updates.
+    /// </summary>
+    API_PROPERTY() int GetMaxQueuedPerUpdate() const { return _max_queued_per_update; }
+    /// <summary>
+    /// Sets the maximum number of queued changes applied in a single update. The rest is left for the following updates,
+    /// so a burst of changes from other threads doesn't stall a frame.
+    /// </summary>
+    /// <param name="value">Maximum number of changes to apply in an update. Values below 1 are changed to 1</param>
+    API_PROPERTY() void SetMaxQueuedPerUpdate(int value);
+
+    /// <summary>
+    /// Applies queued changes on the calling thread, which must be the game thread. Consumers are notified once for each
+    /// run of added, inserted or removed items, inside a single BeginChange and EndChange. This is called automatically
+    /// at every update once something was queued.
+    /// </summary>
+    /// <param name="max_count">Maximum number of queued changes to apply</param>
+    /// <returns>Number of queued changes applied</returns>
+    API_FUNCTION() int ProcessQueue(int max_count);
 protected:
     /// <summary>
     /// Checks whether an item exists in the stored list of strings.
@@ -104,10 +163,39 @@ protected:
     /// <returns>Whether the value was found in the stored list of strings.</returns>
     API_FUNCTION() bool IsDuplicate(const StringView &value) const;
 private:
+    // Change queued by another thread.
+    struct QueuedChange
+    {
+        enum class Kinds { Add, Insert, Set, Delete };
+
+        Kinds Kind;
+        int Index;
+        String Value;
+    };
+
+    void Enqueue(QueuedChange::Kinds kind, int index, const StringView &value);
+    void OnEngineUpdate();
+
+    // Whether the value can be added next to the values in a run of added or inserted items that's not yet in _items.
+    // The accepted value is added to _values, so later values of the same run are checked against it as well.
+    bool AcceptRunValue(const String &value);
+    // Removes the values of a run from _values when the run couldn't be added to _items.
+    void ForgetRunValues(const Array<String> &run);
+
     Array<String> _items;
+    // The values in _items for quick duplicate checks. Only filled while duplicates are not allowed.
+    HashSet<String> _values;
     bool _allow_duplicates;
 
     FudgetDataConsumerRegistry *_consumers;
+
+    FudgetProducerQueue<QueuedChange> _queue;
+    // Change taken from the queue that couldn't be merged into the previous run and is applied first next time.
+    QueuedChange _next_change;
+    bool _has_next_change;
+    int _max_queued_per_update;
+    // Set by the first thread that queues a change, to bind OnEngineUpdate to the engine's update only once.
+    std::atomic<bool> _update_bound;
 };
 
 /// <summary>
@@ -144,6 +232,9 @@ public:
     /// <inheritdoc />
     FudgetInputResult OnKeyDown(KeyboardKeys key) override;
 
+    /// <inheritdoc />
+    void OnReset() override;
+
     /// <inheritdoc />
     void OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64 old_scroll_pos, bool tracking) override;
     ///// <inheritdoc />
@@ -316,6 +407,8 @@ protected:
 
     /// <inheritdoc />
     void RequestScrollExtents() override;
+    /// <inheritdoc />
+    int64 GetScrollSnapPosition(FudgetScrollBarComponent *scrollbar, int64 scroll_pos) override;
 private:
     void EnsureDefaultSize();
 
@@ -336,7 +429,8 @@ private:
     int _top_item;
     // Position of the first visible item at the top, relative to the virtual origin of the contents.
     Int2 _top_item_pos;
-    // Scrolling keeps the top item fully in view.
+    // Scrolling keeps the top item fully in view. Snapping is suspended while a fling or scroll animation is running and
+    // is applied when the motion comes to rest.
     bool _snap_top_item;
 
     // Whether every item has the same size
@@ -7,7 +7,7 @@
 
 FudgetScrollBarComponent::FudgetScrollBarComponent(const SpawnParams &params) : Base(params), _owner(nullptr), _event_owner(nullptr),
     _painter(nullptr), _orientation(FudgetScrollBarOrientation::Horizontal), style_inited(false), _bounds(Rectangle::Empty), _rects_dirty(true),
-    _track_rect(Rectangle::Empty), _before_track_rect(Rectangle::Empty), _after_track_rect(Rectangle::Empty), _thumb_rect(Rectangle::Empty),
+    _rects_bounds(Rectangle::Empty), _rects_range(0), _rects_page_size(0), _rects_scroll_pos(0), _thumb_size(0), _track_rect(Rectangle::Empty), _before_track_rect(Rectangle::Empty), _after_track_rect(Rectangle::Empty), _thumb_rect(Rectangle::Empty),
     _range_min(0), _range_max(0), _scroll_pos(0), _page_size(0), _line_size(1), _visible(false), _mouse_capture(MouseCapture::None), _old_mouse_pos(-1.f), _thumb_mouse_pos(-1.f),
     _visibility_mode(FudgetScrollBarVisibilityMode::Visible)
 {
@@ -39,6 +39,7 @@ void FudgetScrollBarComponent::StyleInitialize()
     _painter = _owner->CreateStylePainter<FudgetScrollBarPainter>(_painter,
         _orientation == FudgetScrollBarOrientation::Horizontal ? (int)FudgetScrollBarPartIds::HorzPainter :
                                                                  (int)FudgetScrollBarPartIds::VertPainter);
+    _rects_dirty = true;
     UpdateVisibility();
 }
 
@@ -177,12 +178,11 @@ void FudgetScrollBarComponent::SetScrollRange(int64 value)
 
 void FudgetScrollBarComponent::SetScrollPos(int64 value)
 {
-    value = Math::Clamp(value, _range_min, Math::Max(0LL, _range_max + 1 - _page_size));
+    value = Math::Clamp(value, _range_min, GetMaxScrollPos());
     if (_scroll_pos == value)
         return;
     int64 old_pos = _scroll_pos;
     _scroll_pos = value;
-    _rects_dirty = true;
     if (old_pos != _scroll_pos && _event_owner != nullptr)
         _event_owner->OnScrollBarScroll(this, old_pos, false);
 }
@@ -207,6 +207,7 @@ bool FudgetScrollBarComponent::MouseMove(Float2 pos, Float2 global_pos)
     int old_pos = (int)_scroll_pos;
     if (_mouse_capture == MouseCapture::Thumb)
     {
+        RecalculateRectangles();
         double track_height = Relevant(_track_rect.Size) - Relevant(_thumb_rect.Size);
         if (track_height <= 0 || Math::NearEqual(track_height, 0))
             _scroll_pos = _range_min;
@@ -219,12 +220,8 @@ bool FudgetScrollBarComponent::MouseMove(Float2 pos, Float2 global_pos)
 
     _old_mouse_pos = pos;
 
-    if (old_pos != _scroll_pos)
-    {
-        _rects_dirty = true;
-        if (_event_owner != nullptr)
-            _event_owner->OnScrollBarScroll(this, old_pos, true);
-    }
+    if (old_pos != _scroll_pos && _event_owner != nullptr)
+        _event_owner->OnScrollBarScroll(this, old_pos, true);
 
     if (MouseIsCaptured())
         return true;
@@ -241,6 +238,7 @@ bool FudgetScrollBarComponent::MouseDown(Float2 pos, Float2 global_pos, MouseBut
     MouseCapture old_capture = _mouse_capture;
     if (!MouseIsCaptured() && button == MouseButton::Left)
     {
+        RecalculateRectangles();
         if (RectContains(_before_track_rect, pos))
             _mouse_capture = MouseCapture::BeforeTrack;
         else if (RectContains(_after_track_rect, pos))
@@ -405,7 +403,7 @@ void FudgetScrollBarComponent::HandleRole(int role)
             SetScrollPos(0LL);
             break;
         case (int)FudgetScrollBarButtonRole::JumpToEnd:
-            SetScrollPos(_range_max + 1 - _page_size);
+            SetScrollPos(GetMaxScrollPos());
             break;
     }
 }
@@ -452,11 +450,24 @@ void FudgetScrollBarComponent::UpdateVisibility()
 
 void FudgetScrollBarComponent::RecalculateRectangles()
 {
-    if (_painter == nullptr || _rects_dirty == false)
+    if (_painter == nullptr)
         return;
-    int btn_cnt = _painter->GetButtonCount();
-    _painter->GetPartBounds(_owner, _bounds, _range_max - _range_min + 1, _page_size, _scroll_pos, _track_rect, _before_track_rect, _after_track_rect, _thumb_rect, _btn_rects);
 
-    _rects_dirty = false;
+    int64 range = _range_max - _range_min + 1;
+    bool track_changed = _rects_dirty || _rects_bounds != _bounds || _rects_range != range || _rects_page_size != _page_size;
+    if (track_changed)
+    {
+        _painter->GetTrackBounds(_owner, _bounds, range, _page_size, _track_rect, _thumb_size, _btn_rects);
+        _rects_bounds = _bounds;
+        _rects_range = range;
+        _rects_page_size = _page_size;
+        _rects_dirty = false;
+    }
+
+    if (track_changed || _rects_scroll_pos != _scroll_pos)
+    {
+        _painter->GetThumbBounds(_owner, _track_rect, _thumb_size, range, _page_size, _scroll_pos, _before_track_rect, _after_track_rect, _thumb_rect);
+        _rects_scroll_pos = _scroll_pos;
+    }
 }
 
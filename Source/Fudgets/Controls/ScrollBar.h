@@ -225,7 +225,7 @@ public:
     /// Updates the bounds of the scrollbar where drawing and input handling will take place.
     /// </summary>
     /// <param name="bounds">The new bounding rectangle of the scrollbar.</param>
-    API_PROPERTY() FORCE_INLINE void SetBounds(const Rectangle &bounds) { _bounds = bounds; _rects_dirty = true; }
+    API_PROPERTY() FORCE_INLINE void SetBounds(const Rectangle &bounds) { _bounds = bounds; }
 
     /// <summary>
     /// Draws the scrollbar. The scrollbar should already have a bounding rectangle by calling SetBounds.
@@ -304,6 +304,11 @@ public:
     /// <param name="value">The new range size to set</param>
     API_PROPERTY(Attributes="HideInEditor") void SetScrollRange(int64 value);
 
+    /// <summary>
+    /// Gets the highest position the scrollbar can scroll to, which is the end of the range minus the page size.
+    /// </summary>
+    API_PROPERTY() int64 GetMaxScrollPos() const { return Math::Max(0LL, _range_max + 1 - _page_size); }
+
     /// <summary>
     /// Gets the current position in the scrollbar between the minimum and maximum range.
     /// </summary>
@@ -401,7 +406,9 @@ private:
     FORCE_INLINE float &OppositeRef(Float2 &size) const { return _orientation == FudgetScrollBarOrientation::Horizontal ? size.Y : size.X; }
 
     void UpdateVisibility();
-    // Call when a change makes one of the rectangles for drawing and input handling dirty.
+    // Updates the rectangles for drawing and input handling that are out of date. The track and buttons are only
+    // recalculated when the bounds, range or page size changed, the thumb and the track around it when the scroll
+    // position changed as well.
     void RecalculateRectangles();
 
     FudgetControl *_owner;
@@ -418,10 +425,31 @@ private:
     Rectangle _bounds;
 
     /// <summary>
-    /// Whether the rectangles for each part of the scrollbar need to be calculated again.
+    /// Whether the rectangles for each part of the scrollbar need to be calculated again, even if the values they
+    /// depend on didn't change. Set when the painter's style changes.
     /// </summary>
     bool _rects_dirty;
     /// <summary>
+    /// Bounds of the scrollbar when the track and button rectangles were last calculated.
+    /// </summary>
+    Rectangle _rects_bounds;
+    /// <summary>
+    /// Scroll range when the track and button rectangles were last calculated.
+    /// </summary>
+    int64 _rects_range;
+    /// <summary>
+    /// Page size when the track and button rectangles were last calculated.
+    /// </summary>
+    int64 _rects_page_size;
+    /// <summary>
+    /// Scroll position when the thumb and the track before and after it were last calculated.
+    /// </summary>
+    int64 _rects_scroll_pos;
+    /// <summary>
+    /// Calculated size of the thumb button along the track.
+    /// </summary>
+    int _thumb_size;
+    /// <summary>
     /// Calculated rectangle of the track for the whole scrollbar.
     /// </summary>
     Rectangle _track_rect;
@@ -0,0 +1,625 @@
+#include "TableView.h"
+#include "../ColumnarData.h"
+#include "../ItemSelection.h"
+#include "../Styling/Painters/PartPainters.h"
+#include "../Styling/PartPainterIds.h"
+
+
+FudgetTableView::FudgetTableView(const SpawnParams &params) : Base(params), _cell_painter(nullptr), _data(nullptr), _owned_data(true),
+    _selection(nullptr), _row_height(-1), _row_height_measured(true), _header_height(-1), _header_height_measured(true), _show_header(true),
+    _scroll_x(0), _scroll_y(0), _hovered_row(-1), _current(-1)
+{
+    _data = New<FudgetColumnarDataProvider>(SpawnParams(Guid::New(), FudgetColumnarDataProvider::TypeInitializer));
+    _data->RegisterDataConsumer(_data_proxy);
+
+    _selection = New<FudgetItemSelection>(SpawnParams(Guid::New(), FudgetItemSelection::TypeInitializer));
+
+    _column_pos.Add(0);
+
+    SetScrollBars(FudgetScrollBars::Both);
+}
+
+FudgetTableView::~FudgetTableView()
+{
+    if (_data != nullptr && _owned_data)
+        Delete(_data);
+    Delete(_selection);
+}
+
+void FudgetTableView::OnStyleInitialize()
+{
+    Base::OnStyleInitialize();
+
+    _cell_painter = CreateStylePainter<FudgetTableCellPainter>(_cell_painter, (int)FudgetTableViewPartIds::CellPainter);
+
+    if (!GetStylePadding((int)FudgetFieldPartIds::Padding, _content_padding))
+        _content_padding = FudgetPadding(0);
+
+    if (_row_height_measured)
+        _row_height = -1;
+    if (_header_height_measured)
+        _header_height = -1;
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::OnDraw()
+{
+    Base::OnDraw();
+
+    int column_count = _columns.Count();
+    if (_data == nullptr || column_count == 0)
+        return;
+
+    EnsureSizes();
+
+    Rectangle bounds = GetCombinedPadding().Padded(GetBounds());
+    FudgetVisualControlState state = GetVisualStateAsEnum();
+    FudgetVisualControlState disabled_state = state & FudgetVisualControlState::Disabled;
+    FudgetVisualControlState focused_state = state & FudgetVisualControlState::Focused;
+
+    // Only the columns overlapping the visible width are visited.
+    int first_column = Math::Max(0, ColumnIndexAt(_scroll_x));
+    float left = bounds.GetLeft() - (float)_scroll_x;
+
+    int header_height = GetVisibleHeaderHeight();
+    if (header_height > 0)
+    {
+        Rectangle header_bounds = Rectangle(bounds.Location, Float2(bounds.Size.X, (float)header_height));
+        PushClip(header_bounds);
+        for (int col = first_column; col < column_count && left + _column_pos[col] < bounds.GetRight(); ++col)
+        {
+            FudgetTableCellPainter *painter = GetColumnPainter(col);
+            if (painter == nullptr)
+                continue;
+            Rectangle r = Rectangle(Float2(left + _column_pos[col], header_bounds.GetTop()), Float2((float)GetColumnWidth(col), (float)header_height));
+            painter->DrawHeader(this, r, _columns[col].Title, uint64(focused_state | disabled_state));
+        }
+        PopClip();
+    }
+
+    int count = _data->GetCount();
+    if (count == 0 || _row_height <= 0)
+        return;
+
+    Rectangle rows_bounds = GetRowsBounds();
+    PushClip(rows_bounds);
+
+    // Only the rows overlapping the visible height are visited, found directly from the scroll position.
+    int first_row = (int)Math::Min(_scroll_y / _row_height, (int64)count - 1);
+    float top = rows_bounds.GetTop() - (float)(_scroll_y - (int64)first_row * _row_height);
+    for (int row = first_row; row < count && top < rows_bounds.GetBottom(); ++row, top += _row_height)
+    {
+        FudgetVisualControlState hover_state = (_hovered_row == row ? FudgetVisualControlState::Hovered : (FudgetVisualControlState)0);
+        FudgetVisualControlState select_state = (IsItemSelected(row) ? FudgetVisualControlState::Selected : (FudgetVisualControlState)0);
+        uint64 row_state = uint64(focused_state | disabled_state | hover_state | select_state);
+
+        for (int col = first_column; col < column_count && left + _column_pos[col] < rows_bounds.GetRight(); ++col)
+        {
+            FudgetTableCellPainter *painter = GetColumnPainter(col);
+            if (painter == nullptr)
+                continue;
+            Rectangle r = Rectangle(Float2(left + _column_pos[col], top), Float2((float)GetColumnWidth(col), (float)_row_height));
+            painter->Draw(this, r, row, _columns[col].DataColumn, _data, row_state);
+        }
+    }
+
+    PopClip();
+}
+
+void FudgetTableView::OnSizeChanged()
+{
+    Base::OnSizeChanged();
+    MarkExtentsDirty();
+}
+
+FudgetInputResult FudgetTableView::OnMouseDown(Float2 pos, Float2 global_pos, MouseButton button, bool double_click)
+{
+    if (button != MouseButton::Left)
+        return FudgetInputResult::Consume;
+
+    int index = ItemIndexAt(pos);
+    if (index != -1)
+        SetCurrentRow(index);
+
+    return FudgetInputResult::Consume;
+}
+
+void FudgetTableView::OnMouseMove(Float2 pos, Float2 global_pos)
+{
+    int index = ItemIndexAt(pos);
+    if (MouseIsCaptured())
+    {
+        if (index != -1)
+            SetCurrentRow(index);
+        return;
+    }
+    _hovered_row = index;
+}
+
+void FudgetTableView::OnMouseLeave()
+{
+    _hovered_row = -1;
+}
+
+bool FudgetTableView::WantsNavigationKey(KeyboardKeys key)
+{
+    return key == KeyboardKeys::ArrowUp || key == KeyboardKeys::ArrowDown;
+}
+
+FudgetInputResult FudgetTableView::OnKeyDown(KeyboardKeys key)
+{
+    int count = _data != nullptr ? _data->GetCount() : 0;
+    if (count == 0)
+        return FudgetInputResult::Consume;
+
+    if (key == KeyboardKeys::ArrowUp)
+        SetCurrentRow(Math::Max(0, _current - 1));
+    else if (key == KeyboardKeys::ArrowDown)
+        SetCurrentRow(Math::Min(count - 1, _current + 1));
+    return FudgetInputResult::Consume;
+}
+
+void FudgetTableView::OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64 old_scroll_pos, bool tracking)
+{
+    if (scrollbar == GetVerticalScrollBar())
+        _scroll_y = scrollbar->GetScrollPos();
+    else if (scrollbar == GetHorizontalScrollBar())
+        _scroll_x = (int)scrollbar->GetScrollPos();
+}
+
+void FudgetTableView::SetDataProvider(FudgetColumnarDataProvider *value)
+{
+    if (_data == value || (_owned_data && value == nullptr))
+        return;
+
+    _data->UnregisterDataConsumer(_data_proxy);
+
+    if (_owned_data)
+        Delete(_data);
+
+    if (value == nullptr)
+    {
+        _data = New<FudgetColumnarDataProvider>(SpawnParams(Guid::New(), FudgetColumnarDataProvider::TypeInitializer));
+        _owned_data = true;
+    }
+    else
+    {
+        _owned_data = false;
+        _data = value;
+    }
+
+    _data->RegisterDataConsumer(_data_proxy);
+    DataReset();
+}
+
+int FudgetTableView::AddColumn(const FudgetTableColumn &column)
+{
+    _columns.Add(column);
+    _column_painters.Add(nullptr);
+    _column_pos.Add(_column_pos.Last());
+    if (_header_height_measured)
+        _header_height = -1;
+    MarkExtentsDirty();
+    return _columns.Count() - 1;
+}
+
+void FudgetTableView::RemoveColumn(int index)
+{
+    if (index < 0 || index >= _columns.Count())
+        return;
+    _columns.RemoveAtKeepOrder(index);
+    _column_painters.RemoveAtKeepOrder(index);
+    _column_pos.RemoveLast();
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::SetColumn(int index, const FudgetTableColumn &column)
+{
+    if (index < 0 || index >= _columns.Count())
+        return;
+    _columns[index] = column;
+    if (_header_height_measured)
+        _header_height = -1;
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::SetColumnPainter(int index, FudgetTableCellPainter *painter)
+{
+    if (index < 0 || index >= _columns.Count())
+        return;
+    _column_painters[index] = painter;
+    if (_row_height_measured)
+        _row_height = -1;
+    if (_header_height_measured)
+        _header_height = -1;
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::SetRowHeight(int value)
+{
+    _row_height_measured = value <= 0;
+    _row_height = _row_height_measured ? -1 : value;
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::SetShowHeader(bool value)
+{
+    if (_show_header == value)
+        return;
+    _show_header = value;
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::SetHeaderHeight(int value)
+{
+    _header_height_measured = value < 0;
+    _header_height = _header_height_measured ? -1 : value;
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::SetCurrentRow(int value)
+{
+    int count = _data != nullptr ? _data->GetCount() : 0;
+    value = Math::Clamp(value, -1, count - 1);
+    if (_current == value && (value == -1 || (_selection->Count() == 1 && _selection->IsSelected(value))))
+        return;
+
+    _current = value;
+    _selection->DeselectAll();
+    if (_current != -1)
+    {
+        _selection->SetSelected(_current, 1, true);
+        ScrollToRow(_current);
+    }
+}
+
+void FudgetTableView::ScrollToRow(int index)
+{
+    EnsureSizes();
+    if (_data == nullptr || index < 0 || index >= _data->GetCount() || _row_height <= 0)
+        return;
+
+    int64 page = (int64)GetRowsBounds().Size.Y;
+    int64 top = (int64)index * _row_height;
+    int64 pos = _scroll_y;
+    if (top < pos)
+        pos = top;
+    else if (top + _row_height > pos + page)
+        pos = top + _row_height - page;
+    if (pos == _scroll_y)
+        return;
+
+    FudgetScrollBarComponent *vbar = GetVerticalScrollBar();
+    if (vbar != nullptr)
+        vbar->SetScrollPos(pos);
+    else
+        _scroll_y = pos;
+}
+
+bool FudgetTableView::CellAt(Float2 pos, API_PARAM(Out) int &row, API_PARAM(Out) int &column)
+{
+    row = ItemIndexAt(pos);
+    column = -1;
+    if (row == -1)
+        return false;
+
+    column = ColumnIndexAt((int)(pos.X - GetRowsBounds().GetLeft()) + _scroll_x);
+    if (column == -1)
+        row = -1;
+    return column != -1;
+}
+
+int FudgetTableView::ItemIndexAt(Float2 pos)
+{
+    EnsureSizes();
+    if (_data == nullptr || _row_height <= 0)
+        return -1;
+
+    Rectangle rows_bounds = GetRowsBounds();
+    if (!RectContains(rows_bounds, pos))
+        return -1;
+
+    int64 y = (int64)(pos.Y - rows_bounds.GetTop()) + _scroll_y;
+    int64 index = y / _row_height;
+    return index < _data->GetCount() ? (int)index : -1;
+}
+
+bool FudgetTableView::IsItemSelected(int item_index) const
+{
+    return _selection->IsSelected(item_index);
+}
+
+Int2 FudgetTableView::GetItemSize(int item_index)
+{
+    EnsureSizes();
+    return Int2(_column_pos.Last(), Math::Max(0, _row_height));
+}
+
+Rectangle FudgetTableView::GetItemRect(int item_index)
+{
+    EnsureSizes();
+    if (_data == nullptr || item_index < 0 || item_index >= _data->GetCount() || _row_height <= 0)
+        return Rectangle::Empty;
+
+    Rectangle rows_bounds = GetRowsBounds();
+    return Rectangle(Float2(rows_bounds.GetLeft() - (float)_scroll_x, rows_bounds.GetTop() + (float)((int64)item_index * _row_height - _scroll_y)),
+        Float2((float)_column_pos.Last(), (float)_row_height));
+}
+
+void FudgetTableView::DataToBeReset()
+{
+    _hovered_row = -1;
+}
+
+void FudgetTableView::DataReset()
+{
+    _hovered_row = -1;
+    _current = -1;
+    _scroll_y = 0;
+    if (_row_height_measured)
+        _row_height = -1;
+
+    _selection->Clear();
+    _selection->SetSize(_data != nullptr ? _data->GetCount() : 0);
+
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::DataCleared()
+{
+    _hovered_row = -1;
+    _current = -1;
+    _scroll_y = 0;
+
+    _selection->SetSize(0);
+
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::DataAdded(int count)
+{
+    _selection->ItemsInserted(_selection->GetSize(), count);
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::DataRemoved(int index, int count)
+{
+    _selection->ItemsRemoved(index, count);
+    if (_current >= index + count)
+        _current -= count;
+    else if (_current >= index)
+        _current = -1;
+    _hovered_row = -1;
+    MarkExtentsDirty();
+}
+
+void FudgetTableView::DataInserted(int index, int count)
+{
+    _selection->ItemsInserted(index, count);
+    if (_current >= index)
+        _current += count;
+    _hovered_row = -1;
+    MarkExtentsDirty();
+}
+
+FudgetControlFlag FudgetTableView::GetInitFlags() const
+{
+    return FudgetControlFlag::CanHandleMouseMove | FudgetControlFlag::CanHandleMouseEnterLeave | FudgetControlFlag::CanHandleMouseUpDown |
+        FudgetControlFlag::CaptureReleaseMouseLeft | FudgetControlFlag::FocusOnMouseLeft |
+        FudgetControlFlag::CanHandleKeyEvents | FudgetControlFlag::CanHandleNavigationKeys | FudgetControlFlag::Framed | Base::GetInitFlags();
+}
+
+FudgetPadding FudgetTableView::GetCombinedPadding() const
+{
+    return _content_padding + GetFramePadding();
+}
+
+void FudgetTableView::RequestScrollExtents()
+{
+    EnsureSizes();
+
+    Rectangle bounds = GetCombinedPadding().Padded(GetBounds());
+    bounds.Size += GetScrollBarWidths();
+    FudgetScrollBarComponent *vbar = GetVerticalScrollBar();
+    FudgetScrollBarComponent *hbar = GetHorizontalScrollBar();
+
+    int64 rows_height = _data != nullptr && _row_height > 0 ? (int64)_row_height * _data->GetCount() : 0;
+    int header_height = GetVisibleHeaderHeight();
+
+    // The width left for the columns depends on the vertical scrollbar, and the height left for the rows depends on the
+    // horizontal scrollbar, which depends on the width of the columns.
+    bool vvis = vbar != nullptr && rows_height > (int64)bounds.Size.Y - header_height;
+    LayoutColumns((int)bounds.Size.X - GetScrollBarWidths(false, vvis).X);
+    bool hvis = hbar != nullptr && _column_pos.Last() > (int)bounds.Size.X - GetScrollBarWidths(false, vvis).X;
+    if (hvis && !vvis && vbar != nullptr && rows_height > (int64)bounds.Size.Y - header_height - GetScrollBarWidths(true, false).Y)
+    {
+        vvis = true;
+        LayoutColumns((int)bounds.Size.X - GetScrollBarWidths(true, true).X);
+    }
+    Int2 view_size = Int2((int)bounds.Size.X, (int)bounds.Size.Y - header_height) - GetScrollBarWidths(hvis, vvis);
+
+    if (vbar != nullptr)
+    {
+        vbar->SetLineSize(Math::Max(1, _row_height));
+        vbar->SetScrollRange(rows_height);
+        vbar->SetPageSize(Math::Max(0, view_size.Y));
+        vbar->SetScrollPos(_scroll_y);
+    }
+    else
+        _scroll_y = Math::Clamp(_scroll_y, (int64)0, Math::Max((int64)0, rows_height - view_size.Y));
+
+    if (hbar != nullptr)
+    {
+        hbar->SetLineSize(Math::Max(1, _row_height));
+        hbar->SetScrollRange(_column_pos.Last());
+        hbar->SetPageSize(Math::Max(0, view_size.X));
+        hbar->SetScrollPos(_scroll_x);
+    }
+    else
+        _scroll_x = Math::Clamp(_scroll_x, 0, Math::Max(0, _column_pos.Last() - view_size.X));
+}
+
+void FudgetTableView::EnsureSizes()
+{
+    int column_count = _columns.Count();
+    if (column_count == 0)
+        return;
+
+    if (_header_height < 0 && _header_height_measured)
+    {
+        int height = 0;
+        for (int col = 0; col < column_count; ++col)
+        {
+            FudgetTableCellPainter *painter = GetColumnPainter(col);
+            if (painter != nullptr)
+                height = Math::Max(height, painter->MeasureHeader(this, _columns[col].Title, 0).Y);
+        }
+        if (height > 0)
+        {
+            _header_height = height;
+            MarkExtentsDirty();
+        }
+    }
+
+    // Rows have the same height, so only the first row is measured.
+    if (_row_height < 0 && _row_height_measured && _data != nullptr && _data->GetCount() > 0)
+    {
+        int height = 0;
+        for (int col = 0; col < column_count; ++col)
+        {
+            FudgetTableCellPainter *painter = GetColumnPainter(col);
+            if (painter != nullptr)
+                height = Math::Max(height, painter->Measure(this, 0, _columns[col].DataColumn, _data, 0).Y);
+        }
+        if (height > 0)
+        {
+            _row_height = height;
+            MarkExtentsDirty();
+        }
+    }
+}
+
+void FudgetTableView::LayoutColumns(int available)
+{
+    int count = _columns.Count();
+    _column_pos.Resize(count + 1);
+    _column_pos[0] = 0;
+    if (count == 0)
+        return;
+
+    // Widths are collected in the position array shifted by one, and summed up at the end.
+    int *widths = _column_pos.Get() + 1;
+    int total = 0;
+    bool has_rule[(int)FudgetDistributedSizingRule::Minimal + 1] = { };
+    for (int ix = 0; ix < count; ++ix)
+    {
+        const FudgetTableColumn &col = _columns[ix];
+        widths[ix] = Math::Clamp(col.Width, col.MinWidth, Math::Max(col.MinWidth, col.MaxWidth));
+        total += widths[ix];
+        has_rule[(int)col.SizingRule] = true;
+    }
+
+    if (total < available)
+    {
+        // The columns that grow are chosen the same way as slots in FudgetListLayout.
+        auto grows = [&has_rule](FudgetDistributedSizingRule rule) {
+            if (has_rule[(int)FudgetDistributedSizingRule::Expanding])
+                return rule == FudgetDistributedSizingRule::Expanding || rule == FudgetDistributedSizingRule::GrowExpanding;
+            if (has_rule[(int)FudgetDistributedSizingRule::GrowExpanding] || has_rule[(int)FudgetDistributedSizingRule::GrowExact])
+                return rule == FudgetDistributedSizingRule::GrowExpanding || rule == FudgetDistributedSizingRule::GrowExact;
+            if (has_rule[(int)FudgetDistributedSizingRule::Exact])
+                return rule == FudgetDistributedSizingRule::Exact;
+            if (has_rule[(int)FudgetDistributedSizingRule::Shrink])
+                return rule == FudgetDistributedSizingRule::Shrink;
+            return true;
+        };
+
+        // Columns reaching their maximum width drop out, and the rest is distributed again between the others.
+        int remaining = available - total;
+        while (remaining > 0)
+        {
+            float weight_sum = 0.f;
+            int last = -1;
+            for (int ix = 0; ix < count; ++ix)
+            {
+                const FudgetTableColumn &col = _columns[ix];
+                if (!grows(col.SizingRule) || widths[ix] >= col.MaxWidth)
+                    continue;
+                weight_sum += Math::Max(0.f, col.Weight);
+                last = ix;
+            }
+            if (last == -1)
+                break;
+
+            int given = 0;
+            for (int ix = 0; ix <= last; ++ix)
+            {
+                const FudgetTableColumn &col = _columns[ix];
+                if (!grows(col.SizingRule) || widths[ix] >= col.MaxWidth)
+                    continue;
+                int add = weight_sum > 0.f ? (int)(remaining * (Math::Max(0.f, col.Weight) / weight_sum)) : 0;
+                // The rounding error goes to the last column.
+                if (ix == last)
+                    add = remaining - given;
+                add = Math::Min(add, col.MaxWidth - widths[ix]);
+                widths[ix] += add;
+                given += add;
+            }
+            if (given == 0)
+                break;
+            remaining -= given;
+        }
+    }
+    else if (total > available)
+    {
+        // Minimal and then Shrink columns give up their width. If that's not enough the columns can be scrolled.
+        FudgetDistributedSizingRule shrinking[] = { FudgetDistributedSizingRule::Minimal, FudgetDistributedSizingRule::Shrink };
+        for (FudgetDistributedSizingRule rule : shrinking)
+        {
+            for (int ix = 0; ix < count && total > available; ++ix)
+            {
+                const FudgetTableColumn &col = _columns[ix];
+                if (col.SizingRule != rule)
+                    continue;
+                int take = Math::Min(widths[ix] - col.MinWidth, total - available);
+                widths[ix] -= take;
+                total -= take;
+            }
+        }
+    }
+
+    for (int ix = 1; ix <= count; ++ix)
+        _column_pos[ix] += _column_pos[ix - 1];
+}
+
+int FudgetTableView::ColumnIndexAt(int x) const
+{
+    int count = _columns.Count();
+    if (x < 0 || count == 0 || x >= _column_pos[count])
+        return -1;
+
+    // Binary search for the last column starting at or before x.
+    int low = 0;
+    int high = count - 1;
+    while (low < high)
+    {
+        int mid = (low + high + 1) / 2;
+        if (_column_pos[mid] <= x)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    return low;
+}
+
+FudgetTableCellPainter* FudgetTableView::GetColumnPainter(int index) const
+{
+    return _column_painters[index] != nullptr ? _column_painters[index] : _cell_painter;
+}
+
+Rectangle FudgetTableView::GetRowsBounds() const
+{
+    Rectangle bounds = GetCombinedPadding().Padded(GetBounds());
+    float header_height = Math::Min((float)GetVisibleHeaderHeight(), bounds.Size.Y);
+    return Rectangle(bounds.Location + Float2(0.f, header_height), Float2(bounds.Size.X, bounds.Size.Y - header_height));
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "ListControl.h"
+#include "../Layouts/ListLayout.h"
+
+class FudgetColumnarDataProvider;
+class FudgetTableCellPainter;
+class FudgetItemSelection;
+
+/// <summary>
+/// Description of a column in FudgetTableView.
+/// </summary>
+API_STRUCT()
+struct FUDGETS_API FudgetTableColumn
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(FudgetTableColumn);
+
+    /// <summary>
+    /// Text shown in the header of the column.
+    /// </summary>
+    API_FIELD() String Title;
+    /// <summary>
+    /// Index of the column in the data provider that the table column shows.
+    /// </summary>
+    API_FIELD() int DataColumn = 0;
+    /// <summary>
+    /// Width of the column when there is no space to distribute or take away from it.
+    /// </summary>
+    API_FIELD() int Width = 100;
+    /// <summary>
+    /// The column is never narrower than this.
+    /// </summary>
+    API_FIELD() int MinWidth = 0;
+    /// <summary>
+    /// The column is never wider than this.
+    /// </summary>
+    API_FIELD() int MaxWidth = MAX_int32;
+    /// <summary>
+    /// How the column takes part in distributing the width of the table. When the columns are wider than the table,
+    /// Minimal and then Shrink columns give up their width down to their minimum, and the rest can be scrolled.
+    /// </summary>
+    API_FIELD() FudgetDistributedSizingRule SizingRule = FudgetDistributedSizingRule::Exact;
+    /// <summary>
+    /// Share of the extra width the column gets, compared to other columns that grow.
+    /// </summary>
+    API_FIELD() float Weight = 1.f;
+};
+
+/// <summary>
+/// Table control that shows rows of a FudgetColumnarDataProvider in columns, with a header strip above the rows. Rows
+/// have the same height, so only the rows and columns in view are measured and drawn, and tables of millions of rows
+/// scroll as fast as small ones. The columns share the width of the table based on their sizing rules, and can be
+/// scrolled horizontally when they don't fit.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetTableView : public FudgetListControl
+{
+    using Base = FudgetListControl;
+    DECLARE_SCRIPTING_TYPE(FudgetTableView);
+public:
+    ~FudgetTableView();
+
+    /// <inheritdoc />
+    void OnStyleInitialize() override;
+
+    /// <inheritdoc />
+    void OnDraw() override;
+
+    /// <inheritdoc />
+    void OnSizeChanged() override;
+
+    /// <inheritdoc />
+    FudgetInputResult OnMouseDown(Float2 pos, Float2 global_pos, MouseButton button, bool double_click) override;
+    /// <inheritdoc />
+    void OnMouseMove(Float2 pos, Float2 global_pos) override;
+    /// <inheritdoc />
+    void OnMouseLeave() override;
+    /// <inheritdoc />
+    bool WantsNavigationKey(KeyboardKeys key) override;
+    /// <inheritdoc />
+    FudgetInputResult OnKeyDown(KeyboardKeys key) override;
+
+    /// <inheritdoc />
+    void OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64 old_scroll_pos, bool tracking) override;
+
+    /// <summary>
+    /// Gets the data provider currently set for this table.
+    /// </summary>
+    API_PROPERTY() FudgetColumnarDataProvider* GetDataProvider() const { return _data; }
+    /// <summary>
+    /// Sets a data provider for this table, replacing the default or previously set provider. Data providers created
+    /// by the user must be manually destroyed when they are no longer needed.
+    /// </summary>
+    /// <param name="value">The new data provider</param>
+    API_PROPERTY() void SetDataProvider(FudgetColumnarDataProvider *value);
+
+    /// <summary>
+    /// Gets the number of columns in the table.
+    /// </summary>
+    API_PROPERTY() int GetColumnCount() const { return _columns.Count(); }
+    /// <summary>
+    /// Adds a column to the right side of the table.
+    /// </summary>
+    /// <param name="column">Description of the column</param>
+    /// <returns>Index of the new column</returns>
+    API_FUNCTION() int AddColumn(const FudgetTableColumn &column);
+    /// <summary>
+    /// Removes a column from the table.
+    /// </summary>
+    /// <param name="index">Index of the column</param>
+    API_FUNCTION() void RemoveColumn(int index);
+    /// <summary>
+    /// Returns the description of a column.
+    /// </summary>
+    /// <param name="index">Index of the column</param>
+    API_FUNCTION() const FudgetTableColumn& GetColumn(int index) const { return _columns[index]; }
+    /// <summary>
+    /// Changes the description of a column.
+    /// </summary>
+    /// <param name="index">Index of the column</param>
+    /// <param name="column">The new description</param>
+    API_FUNCTION() void SetColumn(int index, const FudgetTableColumn &column);
+    /// <summary>
+    /// Sets a painter to draw the cells and header of a column instead of the painter from the style. The painter is
+    /// not owned by the table and must be destroyed separately.
+    /// </summary>
+    /// <param name="index">Index of the column</param>
+    /// <param name="painter">Painter of the column or null to use the style's painter</param>
+    API_FUNCTION() void SetColumnPainter(int index, FudgetTableCellPainter *painter);
+
+    /// <summary>
+    /// Returns the width of a column after the width of the table was distributed between the columns.
+    /// </summary>
+    /// <param name="index">Index of the column</param>
+    /// <returns>Width of the column</returns>
+    API_FUNCTION() int GetColumnWidth(int index) const { return _column_pos[index + 1] - _column_pos[index]; }
+
+    /// <summary>
+    /// Gets the height of the rows. A value of -1 means the height is measured from the first row.
+    /// </summary>
+    API_PROPERTY() int GetRowHeight() const { return _row_height; }
+    /// <summary>
+    /// Sets the height of the rows. A value of -1 measures the height from the first row.
+    /// </summary>
+    /// <param name="value">Height of rows</param>
+    API_PROPERTY() void SetRowHeight(int value);
+
+    /// <summary>
+    /// Gets whether the header strip with the column titles is shown.
+    /// </summary>
+    API_PROPERTY() bool GetShowHeader() const { return _show_header; }
+    /// <summary>
+    /// Sets whether the header strip with the column titles is shown.
+    /// </summary>
+    /// <param name="value">Whether to show the header</param>
+    API_PROPERTY() void SetShowHeader(bool value);
+
+    /// <summary>
+    /// Gets the height of the header strip. A value of -1 means the height is measured from the column titles.
+    /// </summary>
+    API_PROPERTY() int GetHeaderHeight() const { return _header_height; }
+    /// <summary>
+    /// Sets the height of the header strip. A value of -1 measures the height from the column titles.
+    /// </summary>
+    /// <param name="value">Height of the header</param>
+    API_PROPERTY() void SetHeaderHeight(int value);
+
+    /// <summary>
+    /// Gets the index of the current row, which is the one last clicked or moved to with the keyboard.
+    /// </summary>
+    API_PROPERTY() int GetCurrentRow() const { return _current; }
+    /// <summary>
+    /// Sets the current row, selecting it and deselecting every other row, and scrolls it into view.
+    /// </summary>
+    /// <param name="value">Index of the row or -1 to deselect everything</param>
+    API_PROPERTY() void SetCurrentRow(int value);
+
+    /// <summary>
+    /// Scrolls the rows vertically to make a row fully visible, unless it's already fully shown.
+    /// </summary>
+    /// <param name="index">Index of the row</param>
+    API_FUNCTION() void ScrollToRow(int index);
+
+    /// <summary>
+    /// Finds the cell at a position in the control.
+    /// </summary>
+    /// <param name="pos">Position relative to the control</param>
+    /// <param name="row">Receives the index of the row or -1</param>
+    /// <param name="column">Receives the index of the column or -1</param>
+    /// <returns>Whether a cell was found at the position</returns>
+    API_FUNCTION() bool CellAt(Float2 pos, API_PARAM(Out) int &row, API_PARAM(Out) int &column);
+
+    /// <inheritdoc />
+    int ItemIndexAt(Float2 pos) override;
+    /// <inheritdoc />
+    bool IsItemSelected(int item_index) const override;
+    /// <inheritdoc />
+    Int2 GetItemSize(int item_index) override;
+    /// <inheritdoc />
+    Rectangle GetItemRect(int item_index) override;
+protected:
+    /// <inheritdoc />
+    void DataToBeReset() override;
+    /// <inheritdoc />
+    void DataReset() override;
+    /// <inheritdoc />
+    void DataCleared() override;
+    /// <inheritdoc />
+    void DataAdded(int count) override;
+    /// <inheritdoc />
+    void DataRemoved(int index, int count) override;
+    /// <inheritdoc />
+    void DataInserted(int index, int count) override;
+
+    /// <inheritdoc />
+    FudgetControlFlag GetInitFlags() const override;
+
+    /// <summary>
+    /// Padding of the cells with the frame padding.
+    /// </summary>
+    API_PROPERTY() FudgetPadding GetCombinedPadding() const;
+
+    /// <inheritdoc />
+    void RequestScrollExtents() override;
+private:
+    // Measures the row and header heights if they are not set.
+    void EnsureSizes();
+    // Distributes the available width between the columns and updates _column_pos.
+    void LayoutColumns(int available);
+    // Index of the column under x, measured from the left edge of the first column. Returns -1 if there is none.
+    int ColumnIndexAt(int x) const;
+    // Painter of a column, which is the column's own painter if it has one.
+    FudgetTableCellPainter* GetColumnPainter(int index) const;
+    // Height of the header strip, or 0 if it's hidden.
+    int GetVisibleHeaderHeight() const { return _show_header ? Math::Max(0, _header_height) : 0; }
+    // Area of the rows below the header.
+    Rectangle GetRowsBounds() const;
+
+    FudgetTableCellPainter *_cell_painter;
+
+    FudgetColumnarDataProvider *_data;
+    bool _owned_data;
+
+    FudgetItemSelection *_selection;
+
+    FudgetPadding _content_padding;
+
+    Array<FudgetTableColumn> _columns;
+    // Painters set for single columns or null for columns drawn with _cell_painter.
+    Array<FudgetTableCellPainter*> _column_painters;
+    // Left edge of each column measured from the left edge of the first, with the right edge of the last column at the end.
+    Array<int> _column_pos;
+
+    // Set by the user or measured. -1 when it should be measured.
+    int _row_height;
+    bool _row_height_measured;
+    int _header_height;
+    bool _header_height_measured;
+    bool _show_header;
+
+    int _scroll_x;
+    int64 _scroll_y;
+
+    int _hovered_row;
+    int _current;
+};
@@ -96,6 +96,10 @@ void FudgetTextBox::OnDraw()
         return;
     }
 
+    // The caret only needs updates while it's blinking. OnUpdate keeps scheduling the next one until the focus is lost.
+    if (!IsUpdateScheduled())
+        ScheduleUpdate(_caret_blink_time);
+
     // Draw caret
     if (_blink_passed < _caret_blink_time)
     {
@@ -106,8 +110,6 @@ void FudgetTextBox::OnDraw()
             Int2(_caret_width, _text_painter->GetCharacterLineHeight(GetMeasurements(), GetCaretPos()) )));
         PopClip();
     }
-    while (_blink_passed >= _caret_blink_time * 2.0f)
-        _blink_passed -= _caret_blink_time * 2.0f;
 }
 
 void FudgetTextBox::OnSizeChanged()
@@ -133,7 +135,7 @@ int FudgetTextBox::CharIndexAt(Int2 pos)
 
 void FudgetTextBox::DoPositionChanged(int old_caret_pos, int old_sel_pos)
 {
-    _blink_passed = 0.0f;
+    ResetCaretBlink();
     if (CaretChangeReason != FudgetTextBoxCaretChangeReason::Up && CaretChangeReason != FudgetTextBoxCaretChangeReason::Down &&
         CaretChangeReason != FudgetTextBoxCaretChangeReason::PageUp && CaretChangeReason != FudgetTextBoxCaretChangeReason::PageDown)
         _caret_updown_x = -1;
@@ -145,7 +147,7 @@ void FudgetTextBox::DoPositionChanged(int old_caret_pos, int old_sel_pos)
 
 void FudgetTextBox::DoTextEdited(int old_caret_pos, int old_sel_pos)
 {
-    _blink_passed = 0.0f;
+    ResetCaretBlink();
     _caret_updown_x = -1;
 
     MarkTextDirty();
@@ -158,7 +160,17 @@ void FudgetTextBox::DoTextEdited(int old_caret_pos, int old_sel_pos)
 
 void FudgetTextBox::OnUpdate(float delta_time)
 {
-    _blink_passed += delta_time;
+    // Updates are scheduled at the caret blink time, each one switching between the visible and hidden caret.
+    _blink_passed = _blink_passed < _caret_blink_time ? _caret_blink_time : 0.0f;
+    if (VirtuallyFocused())
+        ScheduleUpdate(_caret_blink_time);
+}
+
+void FudgetTextBox::ResetCaretBlink()
+{
+    _blink_passed = 0.0f;
+    if (IsUpdateScheduled())
+        ScheduleUpdate(_caret_blink_time);
 }
 
 //void FudgetTextBox::OnFocusChanged(bool focused, FudgetControl *other)
@@ -501,7 +513,7 @@ void FudgetTextBox::SnapTopLine()
 
 FudgetControlFlag FudgetTextBox::GetInitFlags() const
 {
-    return FudgetControlFlag::RegisterToUpdates | FudgetControlFlag::Framed | Base::GetInitFlags();
+    return FudgetControlFlag::Framed | Base::GetInitFlags();
 }
 
 void FudgetTextBox::SetTextInternal(const StringView &value)
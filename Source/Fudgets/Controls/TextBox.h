@@ -212,6 +212,8 @@ private:
     void MarkTextDirty();
 
     void ScrollToPos();
+    // Restarts the caret blinking with the caret visible.
+    void ResetCaretBlink();
     void FixScrollPos();
 
     FORCE_INLINE FudgetMultilineTextMeasurements& GetMeasurements() { if (_lines_dirty) Process(); return _text_measurements; }
@@ -226,7 +228,7 @@ private:
 
     FudgetPadding _content_padding;
 
-    // Time passed in seconds since caret blink started. The caret is visible when this value is below
+    // Phase of the caret blinking, updated in scheduled updates. The caret is visible when this value is below
     // _caret_blink_time and hidden when it is over it.
     float _blink_passed;
 
@@ -247,6 +247,16 @@ bool FudgetTextBoxBase::OnKeyUp(KeyboardKeys key)
     return true;
 }
 
+void FudgetTextBoxBase::OnReset()
+{
+    Base::OnReset();
+    _key_selecting = false;
+    _mouse_selecting = false;
+    _word_skip = false;
+    SetText(StringView());
+    SetCaretPos(0);
+}
+
 void FudgetTextBoxBase::DeleteSelected()
 {
     if (GetSelLength() == 0)
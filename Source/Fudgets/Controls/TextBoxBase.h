@@ -240,6 +240,9 @@ public:
     /// <inheritdoc />
     bool OnKeyUp(KeyboardKeys key) override;
 
+    /// <inheritdoc />
+    void OnReset() override;
+
     /// <summary>
     /// Deletes the selected part of the edited text
     /// </summary>
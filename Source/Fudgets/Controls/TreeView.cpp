@@ -0,0 +1,414 @@
+#include "TreeView.h"
+#include "../TreeData.h"
+#include "../ItemSelection.h"
+#include "../Styling/Painters/PartPainters.h"
+#include "../Styling/PartPainterIds.h"
+
+
+FudgetTreeView::FudgetTreeView(const SpawnParams &params) : Base(params), _item_painter(nullptr), _data(nullptr), _owned_data(true),
+    _selection(nullptr), _indentation(0), _row_height(-1), _row_height_measured(true), _scroll_y(0), _hovered_row(-1), _current(-1)
+{
+    _data = New<FudgetTreeDataProvider>(SpawnParams(Guid::New(), FudgetTreeDataProvider::TypeInitializer));
+    _data->RegisterDataConsumer(_data_proxy);
+
+    _selection = New<FudgetItemSelection>(SpawnParams(Guid::New(), FudgetItemSelection::TypeInitializer));
+
+    SetScrollBars(FudgetScrollBars::Vertical);
+}
+
+FudgetTreeView::~FudgetTreeView()
+{
+    if (_data != nullptr && _owned_data)
+        Delete(_data);
+    Delete(_selection);
+}
+
+void FudgetTreeView::OnStyleInitialize()
+{
+    Base::OnStyleInitialize();
+
+    _item_painter = CreateStylePainter<FudgetTreeItemPainter>(_item_painter, (int)FudgetTreeViewPartIds::ItemPainter);
+
+    if (!GetStylePadding((int)FudgetFieldPartIds::Padding, _content_padding))
+        _content_padding = FudgetPadding(0);
+    if (!GetStyleInt((int)FudgetTreeViewPartIds::Indentation, _indentation))
+        _indentation = 16;
+
+    if (_row_height_measured)
+        _row_height = -1;
+    MarkExtentsDirty();
+}
+
+void FudgetTreeView::OnDraw()
+{
+    Base::OnDraw();
+
+    if (_item_painter == nullptr || _data == nullptr)
+        return;
+
+    EnsureRowHeight();
+    int count = _data->GetCount();
+    if (count == 0 || _row_height <= 0)
+        return;
+
+    Rectangle bounds = GetCombinedPadding().Padded(GetBounds());
+    PushClip(bounds);
+
+    FudgetVisualControlState state = GetVisualStateAsEnum();
+    FudgetVisualControlState disabled_state = state & FudgetVisualControlState::Disabled;
+    FudgetVisualControlState focused_state = state & FudgetVisualControlState::Focused;
+
+    // The top row is looked up once, the rows below are reached by stepping to the next visible node.
+    int row = (int)Math::Min(_scroll_y / _row_height, (int64)count - 1);
+    float top = bounds.GetTop() - (float)(_scroll_y - (int64)row * _row_height);
+    int node = _data->GetNodeAtRow(row);
+    int depth = _data->GetDepth(node);
+    for (; node != -1 && top < bounds.GetBottom(); ++row, top += _row_height)
+    {
+        FudgetVisualControlState hover_state = (_hovered_row == row ? FudgetVisualControlState::Hovered : (FudgetVisualControlState)0);
+        FudgetVisualControlState select_state = (IsItemSelected(row) ? FudgetVisualControlState::Selected : (FudgetVisualControlState)0);
+        FudgetVisualControlState expand_state = (_data->IsExpanded(node) ? FudgetVisualControlState::Expanded : (FudgetVisualControlState)0);
+
+        Rectangle r = Rectangle(Float2(bounds.GetLeft(), top), Float2(bounds.Size.X, (float)_row_height));
+        _item_painter->Draw(this, r, GetExpanderRect(node, depth, top), node, _data, uint64(focused_state | disabled_state | hover_state | select_state | expand_state));
+
+        node = _data->GetNextVisibleNode(node, depth);
+    }
+
+    PopClip();
+}
+
+void FudgetTreeView::OnSizeChanged()
+{
+    Base::OnSizeChanged();
+    MarkExtentsDirty();
+}
+
+FudgetInputResult FudgetTreeView::OnMouseDown(Float2 pos, Float2 global_pos, MouseButton button, bool double_click)
+{
+    if (button != MouseButton::Left)
+        return FudgetInputResult::Consume;
+
+    int index = ItemIndexAt(pos);
+    if (index == -1)
+        return FudgetInputResult::Consume;
+
+    int node = _data->GetNodeAtRow(index);
+    Rectangle expander = GetExpanderRect(node, _data->GetDepth(node), GetItemRect(index).GetTop());
+    if (double_click || (expander.Size.X > 0.f && pos.X >= expander.GetLeft() && pos.X < expander.GetRight()))
+    {
+        if (_data->GetChildCount(node) > 0)
+            SetNodeExpanded(node, !_data->IsExpanded(node));
+        return FudgetInputResult::Consume;
+    }
+
+    SetCurrentRow(index);
+    return FudgetInputResult::Consume;
+}
+
+void FudgetTreeView::OnMouseMove(Float2 pos, Float2 global_pos)
+{
+    int index = ItemIndexAt(pos);
+    if (MouseIsCaptured())
+    {
+        if (index != -1)
+            SetCurrentRow(index);
+        return;
+    }
+    _hovered_row = index;
+}
+
+void FudgetTreeView::OnMouseLeave()
+{
+    _hovered_row = -1;
+}
+
+bool FudgetTreeView::WantsNavigationKey(KeyboardKeys key)
+{
+    return key == KeyboardKeys::ArrowUp || key == KeyboardKeys::ArrowDown || key == KeyboardKeys::ArrowLeft || key == KeyboardKeys::ArrowRight;
+}
+
+FudgetInputResult FudgetTreeView::OnKeyDown(KeyboardKeys key)
+{
+    int count = _data != nullptr ? _data->GetCount() : 0;
+    if (count == 0)
+        return FudgetInputResult::Consume;
+
+    int node = GetCurrentNode();
+    switch (key)
+    {
+        case KeyboardKeys::ArrowUp:
+            SetCurrentRow(Math::Max(0, _current - 1));
+            break;
+        case KeyboardKeys::ArrowDown:
+            SetCurrentRow(Math::Min(count - 1, _current + 1));
+            break;
+        case KeyboardKeys::ArrowLeft:
+            // Collapses the current node or moves to its parent.
+            if (node == -1)
+                break;
+            if (_data->IsExpanded(node) && _data->GetChildCount(node) > 0)
+                SetNodeExpanded(node, false);
+            else if (_data->GetParent(node) != -1)
+                SetCurrentRow(_data->GetRowOfNode(_data->GetParent(node)));
+            break;
+        case KeyboardKeys::ArrowRight:
+            // Expands the current node or moves to its first child.
+            if (node == -1 || _data->GetChildCount(node) == 0)
+                break;
+            if (!_data->IsExpanded(node))
+                SetNodeExpanded(node, true);
+            else
+                SetCurrentRow(_current + 1);
+            break;
+        default:
+            break;
+    }
+    return FudgetInputResult::Consume;
+}
+
+void FudgetTreeView::OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64 old_scroll_pos, bool tracking)
+{
+    if (scrollbar == GetVerticalScrollBar())
+        _scroll_y = scrollbar->GetScrollPos();
+}
+
+void FudgetTreeView::SetDataProvider(FudgetTreeDataProvider *value)
+{
+    if (_data == value || (_owned_data && value == nullptr))
+        return;
+
+    _data->UnregisterDataConsumer(_data_proxy);
+
+    if (_owned_data)
+        Delete(_data);
+
+    if (value == nullptr)
+    {
+        _data = New<FudgetTreeDataProvider>(SpawnParams(Guid::New(), FudgetTreeDataProvider::TypeInitializer));
+        _owned_data = true;
+    }
+    else
+    {
+        _owned_data = false;
+        _data = value;
+    }
+
+    _data->RegisterDataConsumer(_data_proxy);
+    DataReset();
+}
+
+void FudgetTreeView::SetNodeExpanded(int node, bool value)
+{
+    if (_data == nullptr || _data->IsExpanded(node) == value)
+        return;
+
+    int row = _data->GetRowOfNode(node);
+    int old_current = _current;
+    int old_count = _data->GetCount();
+
+    _data->BeginChange();
+    _data->SetExpanded(node, value);
+    _data->EndChange();
+
+    // The rows of the children were removed right below the node.
+    int removed = old_count - _data->GetCount();
+    if (!value && row != -1 && old_current > row && old_current <= row + removed)
+        SetCurrentRow(row);
+}
+
+void FudgetTreeView::SetRowHeight(int value)
+{
+    _row_height_measured = value <= 0;
+    _row_height = _row_height_measured ? -1 : value;
+    MarkExtentsDirty();
+}
+
+void FudgetTreeView::SetCurrentRow(int value)
+{
+    int count = _data != nullptr ? _data->GetCount() : 0;
+    value = Math::Clamp(value, -1, count - 1);
+    if (_current == value && (value == -1 || (_selection->Count() == 1 && _selection->IsSelected(value))))
+        return;
+
+    _current = value;
+    _selection->DeselectAll();
+    if (_current != -1)
+    {
+        _selection->SetSelected(_current, 1, true);
+        ScrollToRow(_current);
+    }
+}
+
+int FudgetTreeView::GetCurrentNode()
+{
+    if (_data == nullptr || _current == -1)
+        return -1;
+    return _data->GetNodeAtRow(_current);
+}
+
+void FudgetTreeView::ScrollToRow(int index)
+{
+    EnsureRowHeight();
+    if (_data == nullptr || index < 0 || index >= _data->GetCount() || _row_height <= 0)
+        return;
+
+    int64 page = (int64)GetCombinedPadding().Padded(GetBounds()).Size.Y;
+    int64 top = (int64)index * _row_height;
+    int64 pos = _scroll_y;
+    if (top < pos)
+        pos = top;
+    else if (top + _row_height > pos + page)
+        pos = top + _row_height - page;
+    if (pos == _scroll_y)
+        return;
+
+    FudgetScrollBarComponent *vbar = GetVerticalScrollBar();
+    if (vbar != nullptr)
+        vbar->SetScrollPos(pos);
+    else
+        _scroll_y = pos;
+}
+
+int FudgetTreeView::ItemIndexAt(Float2 pos)
+{
+    EnsureRowHeight();
+    if (_data == nullptr || _row_height <= 0)
+        return -1;
+
+    Rectangle bounds = GetCombinedPadding().Padded(GetBounds());
+    if (!RectContains(bounds, pos))
+        return -1;
+
+    int64 index = ((int64)(pos.Y - bounds.GetTop()) + _scroll_y) / _row_height;
+    return index < _data->GetCount() ? (int)index : -1;
+}
+
+bool FudgetTreeView::IsItemSelected(int item_index) const
+{
+    return _selection->IsSelected(item_index);
+}
+
+Int2 FudgetTreeView::GetItemSize(int item_index)
+{
+    EnsureRowHeight();
+    return Int2((int)GetCombinedPadding().Padded(GetBounds()).Size.X, Math::Max(0, _row_height));
+}
+
+Rectangle FudgetTreeView::GetItemRect(int item_index)
+{
+    EnsureRowHeight();
+    if (_data == nullptr || item_index < 0 || item_index >= _data->GetCount() || _row_height <= 0)
+        return Rectangle::Empty;
+
+    Rectangle bounds = GetCombinedPadding().Padded(GetBounds());
+    return Rectangle(Float2(bounds.GetLeft(), bounds.GetTop() + (float)((int64)item_index * _row_height - _scroll_y)), Float2(bounds.Size.X, (float)_row_height));
+}
+
+void FudgetTreeView::DataToBeReset()
+{
+    _hovered_row = -1;
+}
+
+void FudgetTreeView::DataReset()
+{
+    _hovered_row = -1;
+    _current = -1;
+    _scroll_y = 0;
+    if (_row_height_measured)
+        _row_height = -1;
+
+    _selection->Clear();
+    _selection->SetSize(_data != nullptr ? _data->GetCount() : 0);
+
+    MarkExtentsDirty();
+}
+
+void FudgetTreeView::DataCleared()
+{
+    _hovered_row = -1;
+    _current = -1;
+    _scroll_y = 0;
+
+    _selection->SetSize(0);
+
+    MarkExtentsDirty();
+}
+
+void FudgetTreeView::DataAdded(int count)
+{
+    _selection->ItemsInserted(_selection->GetSize(), count);
+    MarkExtentsDirty();
+}
+
+void FudgetTreeView::DataRemoved(int index, int count)
+{
+    _selection->ItemsRemoved(index, count);
+    if (_current >= index + count)
+        _current -= count;
+    else if (_current >= index)
+        _current = -1;
+    _hovered_row = -1;
+    MarkExtentsDirty();
+}
+
+void FudgetTreeView::DataInserted(int index, int count)
+{
+    _selection->ItemsInserted(index, count);
+    if (_current >= index)
+        _current += count;
+    _hovered_row = -1;
+    MarkExtentsDirty();
+}
+
+FudgetControlFlag FudgetTreeView::GetInitFlags() const
+{
+    return FudgetControlFlag::CanHandleMouseMove | FudgetControlFlag::CanHandleMouseEnterLeave | FudgetControlFlag::CanHandleMouseUpDown |
+        FudgetControlFlag::CaptureReleaseMouseLeft | FudgetControlFlag::FocusOnMouseLeft |
+        FudgetControlFlag::CanHandleKeyEvents | FudgetControlFlag::CanHandleNavigationKeys | FudgetControlFlag::Framed | Base::GetInitFlags();
+}
+
+FudgetPadding FudgetTreeView::GetCombinedPadding() const
+{
+    return _content_padding + GetFramePadding();
+}
+
+void FudgetTreeView::RequestScrollExtents()
+{
+    EnsureRowHeight();
+
+    int64 rows_height = _data != nullptr && _row_height > 0 ? (int64)_row_height * _data->GetCount() : 0;
+    int64 page = (int64)GetCombinedPadding().Padded(GetBounds()).Size.Y;
+
+    FudgetScrollBarComponent *vbar = GetVerticalScrollBar();
+    if (vbar != nullptr)
+    {
+        vbar->SetLineSize(Math::Max(1, _row_height));
+        vbar->SetScrollRange(rows_height);
+        vbar->SetPageSize(Math::Max((int64)0, page));
+        vbar->SetScrollPos(_scroll_y);
+    }
+    else
+        _scroll_y = Math::Clamp(_scroll_y, (int64)0, Math::Max((int64)0, rows_height - page));
+}
+
+void FudgetTreeView::EnsureRowHeight()
+{
+    if (_row_height >= 0 || !_row_height_measured || _item_painter == nullptr || _data == nullptr || _data->GetCount() == 0)
+        return;
+
+    int height = _item_painter->Measure(this, _data->GetNodeAtRow(0), _data, 0).Y;
+    if (height > 0)
+    {
+        _row_height = height;
+        MarkExtentsDirty();
+    }
+}
+
+Rectangle FudgetTreeView::GetExpanderRect(int node, int depth, float top) const
+{
+    float left = GetCombinedPadding().Padded(GetBounds()).GetLeft() + (float)(depth * _indentation);
+    if (_data->GetChildCount(node) == 0)
+        return Rectangle(Float2(left + _indentation, top), Float2(0.f, (float)_row_height));
+    return Rectangle(Float2(left, top), Float2((float)_indentation, (float)_row_height));
+}
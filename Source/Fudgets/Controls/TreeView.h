@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ListControl.h"
+
+class FudgetTreeDataProvider;
+class FudgetTreeItemPainter;
+class FudgetItemSelection;
+
+/// <summary>
+/// Tree control that shows the nodes of a FudgetTreeDataProvider. The provider flattens the expanded nodes to rows, and
+/// the tree view only measures and draws the rows in view. Nodes are painted by an item painter, not created as child
+/// controls, so collapsed nodes take no resources in the view. Rows have the same height, which makes finding the top
+/// row when scrolling a single lookup in the provider.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetTreeView : public FudgetListControl
+{
+    using Base = FudgetListControl;
+    DECLARE_SCRIPTING_TYPE(FudgetTreeView);
+public:
+    ~FudgetTreeView();
+
+    /// <inheritdoc />
+    void OnStyleInitialize() override;
+
+    /// <inheritdoc />
+    void OnDraw() override;
+
+    /// <inheritdoc />
+    void OnSizeChanged() override;
+
+    /// <inheritdoc />
+    FudgetInputResult OnMouseDown(Float2 pos, Float2 global_pos, MouseButton button, bool double_click) override;
+    /// <inheritdoc />
+    void OnMouseMove(Float2 pos, Float2 global_pos) override;
+    /// <inheritdoc />
+    void OnMouseLeave() override;
+    /// <inheritdoc />
+    bool WantsNavigationKey(KeyboardKeys key) override;
+    /// <inheritdoc />
+    FudgetInputResult OnKeyDown(KeyboardKeys key) override;
+
+    /// <inheritdoc />
+    void OnScrollBarScroll(FudgetScrollBarComponent *scrollbar, int64 old_scroll_pos, bool tracking) override;
+
+    /// <summary>
+    /// Gets the data provider currently set for this tree.
+    /// </summary>
+    API_PROPERTY() FudgetTreeDataProvider* GetDataProvider() const { return _data; }
+    /// <summary>
+    /// Sets a data provider for this tree, replacing the default or previously set provider. Data providers created
+    /// by the user must be manually destroyed when they are no longer needed.
+    /// </summary>
+    /// <param name="value">The new data provider</param>
+    API_PROPERTY() void SetDataProvider(FudgetTreeDataProvider *value);
+
+    /// <summary>
+    /// Expands or collapses a node. If the current row is hidden by collapsing the node, the node becomes current.
+    /// </summary>
+    /// <param name="node">Id of the node in the data provider</param>
+    /// <param name="value">Whether to expand the node</param>
+    API_FUNCTION() void SetNodeExpanded(int node, bool value);
+
+    /// <summary>
+    /// Gets the height of the rows. A value of -1 means the height is measured from the first row.
+    /// </summary>
+    API_PROPERTY() int GetRowHeight() const { return _row_height; }
+    /// <summary>
+    /// Sets the height of the rows. A value of -1 measures the height from the first row.
+    /// </summary>
+    /// <param name="value">Height of rows</param>
+    API_PROPERTY() void SetRowHeight(int value);
+
+    /// <summary>
+    /// Gets the index of the current row, which is the one last clicked or moved to with the keyboard.
+    /// </summary>
+    API_PROPERTY() int GetCurrentRow() const { return _current; }
+    /// <summary>
+    /// Sets the current row, selecting it and deselecting every other row, and scrolls it into view.
+    /// </summary>
+    /// <param name="value">Index of the row or -1 to deselect everything</param>
+    API_PROPERTY() void SetCurrentRow(int value);
+    /// <summary>
+    /// Gets the id of the node in the current row or -1 if there is no current row.
+    /// </summary>
+    API_PROPERTY() int GetCurrentNode();
+
+    /// <summary>
+    /// Scrolls the rows to make a row fully visible, unless it's already fully shown.
+    /// </summary>
+    /// <param name="index">Index of the row</param>
+    API_FUNCTION() void ScrollToRow(int index);
+
+    /// <inheritdoc />
+    int ItemIndexAt(Float2 pos) override;
+    /// <inheritdoc />
+    bool IsItemSelected(int item_index) const override;
+    /// <inheritdoc />
+    Int2 GetItemSize(int item_index) override;
+    /// <inheritdoc />
+    Rectangle GetItemRect(int item_index) override;
+protected:
+    /// <inheritdoc />
+    void DataToBeReset() override;
+    /// <inheritdoc />
+    void DataReset() override;
+    /// <inheritdoc />
+    void DataCleared() override;
+    /// <inheritdoc />
+    void DataAdded(int count) override;
+    /// <inheritdoc />
+    void DataRemoved(int index, int count) override;
+    /// <inheritdoc />
+    void DataInserted(int index, int count) override;
+
+    /// <inheritdoc />
+    FudgetControlFlag GetInitFlags() const override;
+
+    /// <summary>
+    /// Padding of the rows with the frame padding.
+    /// </summary>
+    API_PROPERTY() FudgetPadding GetCombinedPadding() const;
+
+    /// <inheritdoc />
+    void RequestScrollExtents() override;
+private:
+    // Measures the row height if it's not set.
+    void EnsureRowHeight();
+    // Bounds of the expander button of a node drawn at top. The width is zero for nodes without children.
+    Rectangle GetExpanderRect(int node, int depth, float top) const;
+
+    FudgetTreeItemPainter *_item_painter;
+
+    FudgetTreeDataProvider *_data;
+    bool _owned_data;
+
+    FudgetItemSelection *_selection;
+
+    FudgetPadding _content_padding;
+    // Width of one level of indentation, which is also the width of the expander buttons.
+    int _indentation;
+
+    // Set by the user or measured. -1 when it should be measured.
+    int _row_height;
+    bool _row_height_measured;
+
+    int64 _scroll_y;
+
+    int _hovered_row;
+    int _current;
+};
@@ -0,0 +1,535 @@
+#include "DataView.h"
+
+#include <algorithm>
+
+
+FudgetDataView::FudgetDataView(const SpawnParams &params) : Base(params), _source(nullptr), _source_count(0), _updating_row(-1),
+    _sort(FudgetDataViewSort::None), _filter_mode(FudgetDataViewFilterMode::Contains)
+{
+    _consumers = New<FudgetDataConsumerRegistry>(SpawnParams(Guid::New(), FudgetDataConsumerRegistry::TypeInitializer));
+}
+
+FudgetDataView::~FudgetDataView()
+{
+    SetSource(nullptr);
+    Delete(_consumers);
+}
+
+void FudgetDataView::SetSource(IFudgetDataProvider *value)
+{
+    if (_source == value)
+        return;
+
+    _consumers->BeginDataReset();
+    if (_source != nullptr)
+    {
+        _source->UnregisterDataConsumer(this);
+        ScriptingObject *obj = FromInterface(_source, IFudgetDataProvider::TypeInitializer);
+        if (obj != nullptr)
+            obj->Deleted.Unbind<FudgetDataView, &FudgetDataView::SourceDestroyed>(this);
+    }
+    _source = value;
+    if (_source != nullptr)
+    {
+        _source->RegisterDataConsumer(this);
+        ScriptingObject *obj = FromInterface(_source, IFudgetDataProvider::TypeInitializer);
+        if (obj != nullptr)
+            obj->Deleted.Bind<FudgetDataView, &FudgetDataView::SourceDestroyed>(this);
+    }
+    Rebuild();
+    _consumers->EndDataReset();
+}
+
+void FudgetDataView::SetSort(FudgetDataViewSort value)
+{
+    if (_sort == value)
+        return;
+    _sort = value;
+    ResetView();
+}
+
+void FudgetDataView::SetComparer(const Function<int(IFudgetDataProvider*, int, int)> &comparer)
+{
+    _comparer = comparer;
+    if (_sort == FudgetDataViewSort::Custom)
+        ResetView();
+}
+
+void FudgetDataView::SetFilterText(const StringView &value)
+{
+    if (_filter_text.Compare(value) == 0)
+        return;
+
+    // Every item matching the new text also matches the old one if the old text is part of it in the same way.
+    bool refinement = _filter_mode == FudgetDataViewFilterMode::Contains ? StringView(value).Contains(_filter_text, StringSearchCase::IgnoreCase) :
+        StringView(value).StartsWith(_filter_text, StringSearchCase::IgnoreCase);
+    _filter_text = value;
+    if (refinement)
+        Refine();
+    else
+        ResetView();
+}
+
+void FudgetDataView::SetFilterMode(FudgetDataViewFilterMode value)
+{
+    if (_filter_mode == value)
+        return;
+    _filter_mode = value;
+    if (_filter_text.HasChars())
+        ResetView();
+}
+
+void FudgetDataView::SetFilter(const Function<bool(IFudgetDataProvider*, int)> &filter, bool refinement)
+{
+    _filter = filter;
+    if (refinement)
+        Refine();
+    else
+        ResetView();
+}
+
+void FudgetDataView::RefineFilter()
+{
+    Refine();
+}
+
+void FudgetDataView::RefreshFilter()
+{
+    ResetView();
+}
+
+int FudgetDataView::GetViewIndex(int source_index)
+{
+    int row = LowerBound(source_index);
+    if (row < _rows.Count() && _rows[row] == source_index)
+        return row;
+    return -1;
+}
+
+void FudgetDataView::BeginChange()
+{
+    if (_source != nullptr)
+        _source->BeginChange();
+}
+
+void FudgetDataView::EndChange()
+{
+    if (_source != nullptr)
+        _source->EndChange();
+}
+
+void FudgetDataView::BeginDataReset()
+{
+    if (_source != nullptr)
+        _source->BeginDataReset();
+}
+
+void FudgetDataView::EndDataReset()
+{
+    if (_source != nullptr)
+        _source->EndDataReset();
+}
+
+void FudgetDataView::Clear()
+{
+    if (_source != nullptr)
+        _source->Clear();
+}
+
+Variant FudgetDataView::GetValue(int index)
+{
+    return _source->GetValue(_rows[index]);
+}
+
+void FudgetDataView::SetValue(int index, Variant value)
+{
+    _source->SetValue(_rows[index], value);
+}
+
+String FudgetDataView::GetText(int index)
+{
+    return _source->GetText(_rows[index]);
+}
+
+void FudgetDataView::SetText(int index, const StringView &value)
+{
+    _source->SetText(_rows[index], value);
+}
+
+int FudgetDataView::GetInt(int index)
+{
+    return _source->GetInt(_rows[index]);
+}
+
+void FudgetDataView::SetInt(int index, int value)
+{
+    _source->SetInt(_rows[index], value);
+}
+
+void FudgetDataView::DataChangeBegin()
+{
+    _consumers->BeginChange();
+}
+
+void FudgetDataView::DataChangeEnd(bool changed)
+{
+    _consumers->EndChange();
+}
+
+void FudgetDataView::DataToBeReset()
+{
+    _consumers->BeginDataReset();
+}
+
+void FudgetDataView::DataReset()
+{
+    Rebuild();
+    _consumers->EndDataReset();
+}
+
+void FudgetDataView::DataToBeCleared()
+{
+    _consumers->ClearBegin();
+}
+
+void FudgetDataView::DataCleared()
+{
+    _rows.Clear();
+    _source_count = 0;
+    _consumers->ClearEnd();
+}
+
+void FudgetDataView::DataToBeUpdated(int index)
+{
+    // The item is looked up while it still compares with its old value.
+    _updating_row = GetViewIndex(index);
+}
+
+void FudgetDataView::DataUpdated(int index)
+{
+    int row = _updating_row;
+    _updating_row = -1;
+
+    bool passes = PassesFilter(index);
+    if (row != -1)
+    {
+        // Stays in place if it's still between its neighbors.
+        if (passes && (row == 0 || RowLess(_rows[row - 1], index)) && (row == _rows.Count() - 1 || RowLess(index, _rows[row + 1])))
+        {
+            if (_consumers->SetBegin(row))
+                _consumers->SetEnd(row);
+            return;
+        }
+        RemoveRow(row);
+    }
+    if (passes)
+        InsertRow(index);
+}
+
+void FudgetDataView::DataToBeAdded(int count)
+{
+}
+
+void FudgetDataView::DataAdded(int count)
+{
+    int first = _source_count;
+    _source_count += count;
+    for (int ix = first; ix < _source_count; ++ix)
+    {
+        if (PassesFilter(ix))
+            InsertRow(ix);
+    }
+}
+
+void FudgetDataView::DataToBeRemoved(int index, int count)
+{
+    // The rows are found while the removed items can still be compared.
+    _removed_rows.Clear();
+    if (InSourceOrder())
+        return;
+    for (int ix = index; ix < index + count; ++ix)
+    {
+        int row = GetViewIndex(ix);
+        if (row != -1)
+            _removed_rows.Add(row);
+    }
+    std::sort(_removed_rows.Get(), _removed_rows.Get() + _removed_rows.Count(), [](int a, int b) { return a > b; });
+}
+
+void FudgetDataView::DataRemoved(int index, int count)
+{
+    _source_count -= count;
+    if (InSourceOrder())
+    {
+        // The removed items are a single range of rows, and only the rows after it change.
+        int first = FirstRowFrom(index);
+        int last = FirstRowFrom(index + count);
+        for (int ix = last, siz = _rows.Count(); ix < siz; ++ix)
+            _rows[ix] -= count;
+        if (last > first)
+            RemoveRows(first, last - first);
+        return;
+    }
+
+    // Sorted rows are not ordered by their source index, so each one has to be checked.
+    for (int ix = 0, siz = _rows.Count(); ix < siz; ++ix)
+    {
+        if (_rows[ix] >= index + count)
+            _rows[ix] -= count;
+    }
+
+    for (int row : _removed_rows)
+        RemoveRow(row);
+    _removed_rows.Clear();
+}
+
+void FudgetDataView::DataToBeInserted(int index, int count)
+{
+}
+
+void FudgetDataView::DataInserted(int index, int count)
+{
+    _source_count += count;
+    if (InSourceOrder())
+    {
+        // The inserted items are placed together before the first row that comes after them in the source.
+        int row = FirstRowFrom(index);
+        for (int ix = row, siz = _rows.Count(); ix < siz; ++ix)
+            _rows[ix] += count;
+
+        Array<int> inserted;
+        for (int ix = index; ix < index + count; ++ix)
+        {
+            if (PassesFilter(ix))
+                inserted.Add(ix);
+        }
+        if (inserted.HasItems())
+            InsertRows(row, inserted);
+        return;
+    }
+
+    // Sorted rows are not ordered by their source index, so each one has to be checked.
+    for (int ix = 0, siz = _rows.Count(); ix < siz; ++ix)
+    {
+        if (_rows[ix] >= index)
+            _rows[ix] += count;
+    }
+
+    for (int ix = index; ix < index + count; ++ix)
+    {
+        if (PassesFilter(ix))
+            InsertRow(ix);
+    }
+}
+
+void FudgetDataView::SourceDestroyed(ScriptingObject *obj)
+{
+    _source = nullptr;
+    _consumers->BeginDataReset();
+    Rebuild();
+    _consumers->EndDataReset();
+}
+
+bool FudgetDataView::PassesFilter(int source_index)
+{
+    if (_filter.IsBinded() && !_filter(_source, source_index))
+        return false;
+    if (_filter_text.IsEmpty())
+        return true;
+
+    String text = _source->GetText(source_index);
+    if (_filter_mode == FudgetDataViewFilterMode::StartsWith)
+        return text.StartsWith(_filter_text, StringSearchCase::IgnoreCase);
+    return text.Contains(_filter_text, StringSearchCase::IgnoreCase);
+}
+
+bool FudgetDataView::RowLess(int a, int b)
+{
+    int result = 0;
+    if (_sort == FudgetDataViewSort::TextAscending || _sort == FudgetDataViewSort::TextDescending)
+    {
+        result = _source->GetText(a).Compare(_source->GetText(b), StringSearchCase::IgnoreCase);
+        if (_sort == FudgetDataViewSort::TextDescending)
+            result = -result;
+    }
+    else if (_sort == FudgetDataViewSort::Custom && _comparer.IsBinded())
+        result = _comparer(_source, a, b);
+
+    // Equal items keep the source order, so every item has a single place in the view.
+    if (result == 0)
+        return a < b;
+    return result < 0;
+}
+
+int FudgetDataView::LowerBound(int source_index)
+{
+    int low = 0;
+    int high = _rows.Count();
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (RowLess(_rows[mid], source_index))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+bool FudgetDataView::InSourceOrder() const
+{
+    // RowLess compares the source indexes when there is no comparer.
+    return _sort == FudgetDataViewSort::None || (_sort == FudgetDataViewSort::Custom && !_comparer.IsBinded());
+}
+
+int FudgetDataView::FirstRowFrom(int source_index) const
+{
+    int low = 0;
+    int high = _rows.Count();
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (_rows[mid] < source_index)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+void FudgetDataView::Rebuild()
+{
+    _rows.Clear();
+    _source_count = _source != nullptr ? _source->GetCount() : 0;
+    for (int ix = 0; ix < _source_count; ++ix)
+    {
+        if (PassesFilter(ix))
+            _rows.Add(ix);
+    }
+
+    if (_sort == FudgetDataViewSort::None || _rows.Count() < 2)
+        return;
+
+    if (_sort == FudgetDataViewSort::Custom)
+    {
+        if (_comparer.IsBinded())
+            std::sort(_rows.Get(), _rows.Get() + _rows.Count(), [this](int a, int b) { return RowLess(a, b); });
+        return;
+    }
+
+    // Text is fetched once per item instead of on every comparison.
+    Array<String> texts;
+    texts.Resize(_source_count);
+    for (int ix : _rows)
+        texts[ix] = _source->GetText(ix);
+    bool descending = _sort == FudgetDataViewSort::TextDescending;
+    std::sort(_rows.Get(), _rows.Get() + _rows.Count(), [&texts, descending](int a, int b) {
+        int result = texts[a].Compare(texts[b], StringSearchCase::IgnoreCase);
+        if (result == 0)
+            return a < b;
+        return descending ? result > 0 : result < 0;
+        });
+}
+
+void FudgetDataView::ResetView()
+{
+    _consumers->BeginDataReset();
+    Rebuild();
+    _consumers->EndDataReset();
+}
+
+void FudgetDataView::Refine()
+{
+    // Only the items in the view are checked again. Their order doesn't change, so nothing is sorted.
+    Array<int> removed;
+    for (int ix = _rows.Count() - 1; ix >= 0; --ix)
+    {
+        if (!PassesFilter(_rows[ix]))
+            removed.Add(ix);
+    }
+    if (removed.IsEmpty())
+        return;
+
+    // Too many separate removals would cost more than a reset for the consumers.
+    if (removed.Count() > 64)
+    {
+        _consumers->BeginDataReset();
+        int pos = 0;
+        for (int ix = 0, next = removed.Count() - 1, siz = _rows.Count(); ix < siz; ++ix)
+        {
+            if (next >= 0 && removed[next] == ix)
+            {
+                --next;
+                continue;
+            }
+            _rows[pos++] = _rows[ix];
+        }
+        _rows.Resize(pos);
+        _consumers->EndDataReset();
+        return;
+    }
+
+    _consumers->BeginChange();
+    for (int row : removed)
+        RemoveRow(row);
+    _consumers->EndChange();
+}
+
+void FudgetDataView::InsertRow(int source_index)
+{
+    int row = LowerBound(source_index);
+    if (row == _rows.Count())
+    {
+        if (!_consumers->AddBegin(1))
+            return;
+        _rows.Add(source_index);
+        _consumers->AddEnd(1);
+        return;
+    }
+
+    if (!_consumers->InsertBegin(row, 1))
+        return;
+    _rows.Insert(row, source_index);
+    _consumers->InsertEnd(row, 1);
+}
+
+void FudgetDataView::InsertRows(int row, const Array<int> &source_indexes)
+{
+    int count = source_indexes.Count();
+    int rows_count = _rows.Count();
+    if (row == rows_count)
+    {
+        if (!_consumers->AddBegin(count))
+            return;
+        _rows.Add(source_indexes.Get(), count);
+        _consumers->AddEnd(count);
+        return;
+    }
+
+    if (!_consumers->InsertBegin(row, count))
+        return;
+    _rows.Resize(rows_count + count);
+    for (int ix = rows_count - 1; ix >= row; --ix)
+        _rows[ix + count] = _rows[ix];
+    for (int ix = 0; ix < count; ++ix)
+        _rows[row + ix] = source_indexes[ix];
+    _consumers->InsertEnd(row, count);
+}
+
+void FudgetDataView::RemoveRow(int row)
+{
+    if (!_consumers->RemoveBegin(row, 1))
+        return;
+    _rows.RemoveAtKeepOrder(row);
+    _consumers->RemoveEnd(row, 1);
+}
+
+void FudgetDataView::RemoveRows(int row, int count)
+{
+    if (!_consumers->RemoveBegin(row, count))
+        return;
+    for (int ix = row, siz = _rows.Count(); ix + count < siz; ++ix)
+        _rows[ix] = _rows[ix + count];
+    _rows.Resize(_rows.Count() - count);
+    _consumers->RemoveEnd(row, count);
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "DataInterfaces.h"
+
+#include "Engine/Core/Delegate.h"
+#include "Engine/Core/Types/String.h"
+
+
+/// <summary>
+/// Order of the items in a FudgetDataView.
+/// </summary>
+API_ENUM()
+enum class FudgetDataViewSort
+{
+    /// <summary>
+    /// Items are in the same order as in the source.
+    /// </summary>
+    None,
+    /// <summary>
+    /// Items are sorted by their text in increasing order, ignoring case.
+    /// </summary>
+    TextAscending,
+    /// <summary>
+    /// Items are sorted by their text in decreasing order, ignoring case.
+    /// </summary>
+    TextDescending,
+    /// <summary>
+    /// Items are sorted by the comparer set with SetComparer. Falls back to None if no comparer is set.
+    /// </summary>
+    Custom,
+};
+
+/// <summary>
+/// How the filter text of a FudgetDataView is matched against the text of items.
+/// </summary>
+API_ENUM()
+enum class FudgetDataViewFilterMode
+{
+    /// <summary>
+    /// Items containing the filter text are shown.
+    /// </summary>
+    Contains,
+    /// <summary>
+    /// Items starting with the filter text are shown.
+    /// </summary>
+    StartsWith,
+};
+
+/// <summary>
+/// Data provider that shows a filtered and sorted subset of the items in another data provider without copying
+/// them. The view keeps a list of source indexes in the displayed order, and registers as a consumer in the source
+/// to update this list when the source changes. Inserted and updated items are placed with binary search, so the
+/// list is never sorted again after it was built. When the filter changes in a way that can only hide items, like
+/// typing one more character in a search box, only the items currently in the view are checked again.
+/// Changes made through the view are forwarded to the source.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetDataView : public ScriptingObject, public IFudgetDataProvider, public IFudgetDataConsumer
+{
+    using Base = ScriptingObject;
+    DECLARE_SCRIPTING_TYPE(FudgetDataView);
+public:
+    ~FudgetDataView();
+
+    /// <summary>
+    /// Gets the data provider the view shows items from.
+    /// </summary>
+    API_PROPERTY() IFudgetDataProvider* GetSource() const { return _source; }
+    /// <summary>
+    /// Sets the data provider the view shows items from. The view doesn't own the source, it must be destroyed
+    /// separately when it's no longer needed.
+    /// </summary>
+    /// <param name="value">The new source or null to show nothing</param>
+    API_PROPERTY() void SetSource(IFudgetDataProvider *value);
+
+    /// <summary>
+    /// Gets the order of the items in the view.
+    /// </summary>
+    API_PROPERTY() FudgetDataViewSort GetSort() const { return _sort; }
+    /// <summary>
+    /// Sets the order of the items in the view. The items are sorted again with the new order.
+    /// </summary>
+    /// <param name="value">The new order</param>
+    API_PROPERTY() void SetSort(FudgetDataViewSort value);
+
+    /// <summary>
+    /// Sets the function used to compare items when the sort is Custom. The function receives the source and two source
+    /// indexes, and returns a negative value if the first item comes first, a positive value if the second item does,
+    /// or zero if their order doesn't matter. Items comparing equal keep their order in the source.
+    /// </summary>
+    /// <param name="comparer">The function to compare items with</param>
+    void SetComparer(const Function<int(IFudgetDataProvider*, int, int)> &comparer);
+
+    /// <summary>
+    /// Gets the text items must match to be shown. Empty text shows every item.
+    /// </summary>
+    API_PROPERTY() const String& GetFilterText() const { return _filter_text; }
+    /// <summary>
+    /// Sets the text items must match to be shown. Empty text shows every item. If items matching the new text also
+    /// match the old one, only the items in the view are checked.
+    /// </summary>
+    /// <param name="value">The new filter text</param>
+    API_PROPERTY() void SetFilterText(const StringView &value);
+
+    /// <summary>
+    /// Gets how the filter text is matched against the text of items.
+    /// </summary>
+    API_PROPERTY() FudgetDataViewFilterMode GetFilterMode() const { return _filter_mode; }
+    /// <summary>
+    /// Sets how the filter text is matched against the text of items.
+    /// </summary>
+    /// <param name="value">The new filter mode</param>
+    API_PROPERTY() void SetFilterMode(FudgetDataViewFilterMode value);
+
+    /// <summary>
+    /// Sets a function that decides which items to show, in addition to the filter text. The function receives the
+    /// source and a source index, and returns whether the item should be in the view.
+    /// </summary>
+    /// <param name="filter">The filter function. Pass an unbound function to remove the filter</param>
+    /// <param name="refinement">Set to true if every item hidden by the previous filter is also hidden by the new one.
+    /// Only the items currently in the view are checked in that case</param>
+    void SetFilter(const Function<bool(IFudgetDataProvider*, int)> &filter, bool refinement);
+
+    /// <summary>
+    /// Checks the items in the view again with the filter, hiding those that don't pass anymore. Call when something
+    /// the filter function depends on changed and it can only hide more items.
+    /// </summary>
+    API_FUNCTION() void RefineFilter();
+
+    /// <summary>
+    /// Checks every item of the source again with the filter and rebuilds the view.
+    /// </summary>
+    API_FUNCTION() void RefreshFilter();
+
+    /// <summary>
+    /// Returns the index in the source of an item in the view.
+    /// </summary>
+    /// <param name="index">Index of the item in the view</param>
+    /// <returns>Index of the item in the source</returns>
+    API_FUNCTION() int GetSourceIndex(int index) const { return _rows[index]; }
+
+    /// <summary>
+    /// Returns the index in the view of an item in the source.
+    /// </summary>
+    /// <param name="source_index">Index of the item in the source</param>
+    /// <returns>Index of the item in the view, or -1 if it's filtered out</returns>
+    API_FUNCTION() int GetViewIndex(int source_index);
+
+    // IFudgetDataProvider
+
+    /// <inheritdoc />
+    void BeginChange() override;
+    /// <inheritdoc />
+    void EndChange() override;
+    /// <inheritdoc />
+    void BeginDataReset() override;
+    /// <inheritdoc />
+    void EndDataReset() override;
+    /// <inheritdoc />
+    int GetCount() const override { return _rows.Count(); }
+    /// <summary>
+    /// Clears the source.
+    /// </summary>
+    void Clear() override;
+    /// <inheritdoc />
+    Variant GetValue(int index) override;
+    /// <inheritdoc />
+    void SetValue(int index, Variant value) override;
+    /// <inheritdoc />
+    String GetText(int index) override;
+    /// <inheritdoc />
+    void SetText(int index, const StringView &value) override;
+    /// <inheritdoc />
+    int GetInt(int index) override;
+    /// <inheritdoc />
+    void SetInt(int index, int value) override;
+    /// <inheritdoc />
+    void RegisterDataConsumer(IFudgetDataConsumer *consumer) override { _consumers->RegisterDataConsumer(consumer); }
+    /// <inheritdoc />
+    void UnregisterDataConsumer(IFudgetDataConsumer *consumer) override { _consumers->UnregisterDataConsumer(consumer); }
+
+    // IFudgetDataConsumer
+
+    /// <inheritdoc />
+    void DataChangeBegin() override;
+    /// <inheritdoc />
+    void DataChangeEnd(bool changed) override;
+    /// <inheritdoc />
+    void DataToBeReset() override;
+    /// <inheritdoc />
+    void DataReset() override;
+    /// <inheritdoc />
+    void DataToBeCleared() override;
+    /// <inheritdoc />
+    void DataCleared() override;
+    /// <inheritdoc />
+    void DataToBeUpdated(int index) override;
+    /// <inheritdoc />
+    void DataUpdated(int index) override;
+    /// <inheritdoc />
+    void DataToBeAdded(int count) override;
+    /// <inheritdoc />
+    void DataAdded(int count) override;
+    /// <inheritdoc />
+    void DataToBeRemoved(int index, int count) override;
+    /// <inheritdoc />
+    void DataRemoved(int index, int count) override;
+    /// <inheritdoc />
+    void DataToBeInserted(int index, int count) override;
+    /// <inheritdoc />
+    void DataInserted(int index, int count) override;
+private:
+    void SourceDestroyed(ScriptingObject *obj);
+
+    // Whether the item at a source index passes the filter text and the filter function.
+    bool PassesFilter(int source_index);
+    // Whether the item at source index a comes before the one at b in the view.
+    bool RowLess(int a, int b);
+    // Index in _rows where an item at the source index is or would be placed.
+    int LowerBound(int source_index);
+    // Whether _rows holds the source indexes in increasing order, because the view is not sorted.
+    bool InSourceOrder() const;
+    // First index in _rows holding a source index that's not less than the passed one. Only valid in source order.
+    int FirstRowFrom(int source_index) const;
+    // Fills _rows from the source and sorts it, without notifying the consumers.
+    void Rebuild();
+    // Rebuilds the view and notifies the consumers with a data reset.
+    void ResetView();
+    // Removes the items in the view that don't pass the filter anymore.
+    void Refine();
+    // Places a new or updated item of the source in the view if it passes the filter, notifying the consumers.
+    void InsertRow(int source_index);
+    // Places items of the source at a single position in the view, notifying the consumers once.
+    void InsertRows(int row, const Array<int> &source_indexes);
+    // Removes an item from the view, notifying the consumers.
+    void RemoveRow(int row);
+    // Removes a range of items from the view, notifying the consumers once.
+    void RemoveRows(int row, int count);
+
+    IFudgetDataProvider *_source;
+    FudgetDataConsumerRegistry *_consumers;
+
+    // Source indexes of the items in the view, in the displayed order.
+    Array<int> _rows;
+    // Number of items in the source after the last notification.
+    int _source_count;
+    // Row of the item being updated in the source, found before the update while its old value can still be compared.
+    int _updating_row;
+    // Rows to remove after the source finished removing items, in decreasing order.
+    Array<int> _removed_rows;
+
+    FudgetDataViewSort _sort;
+    Function<int(IFudgetDataProvider*, int, int)> _comparer;
+
+    String _filter_text;
+    FudgetDataViewFilterMode _filter_mode;
+    Function<bool(IFudgetDataProvider*, int)> _filter;
+};
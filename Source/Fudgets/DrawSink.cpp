@@ -0,0 +1,876 @@
+#include "DrawSink.h"
+#include "GUIRoot.h"
+#include "Styling/TextMeasureCache.h"
+
+#include "Engine/Render2D/Render2D.h"
+#include "Engine/Render2D/Font.h"
+#include "Engine/Render2D/TextLayoutOptions.h"
+#include "Engine/Render2D/SpriteAtlas.h"
+
+
+namespace
+{
+    FudgetRender2DDrawSink Render2DSink;
+    FudgetDrawSink *CurrentSink = &Render2DSink;
+
+    Rectangle InfiniteRect()
+    {
+        return Rectangle(Float2(-MAX_float * 0.5f), Float2(MAX_float));
+    }
+
+    // Commands that can't be reordered with the commands around them.
+    bool IsBatchBarrier(FudgetDrawCommandType type)
+    {
+        return type == FudgetDrawCommandType::PushClip || type == FudgetDrawCommandType::PopClip || type == FudgetDrawCommandType::DrawBlur;
+    }
+
+    // What decides whether two commands can be drawn in the same batch.
+    struct BatchKey
+    {
+        // 0 for untextured fills, 1 for textures, 2 for text and 3 for materials.
+        int Kind;
+        void *Resource;
+        void *Material;
+        bool Point;
+
+        bool operator==(const BatchKey &other) const
+        {
+            return Kind == other.Kind && Resource == other.Resource && Material == other.Material && Point == other.Point;
+        }
+    };
+
+    BatchKey GetBatchKey(const FudgetDrawCommand &cmd)
+    {
+        BatchKey key = { 0, nullptr, nullptr, false };
+        switch (cmd.Type)
+        {
+            case FudgetDrawCommandType::Draw9SlicingTexture:
+            case FudgetDrawCommandType::Draw9SlicingSprite:
+            case FudgetDrawCommandType::DrawSprite:
+            case FudgetDrawCommandType::DrawGPUTexture:
+                key.Kind = 1;
+                key.Resource = cmd.Resource;
+                key.Point = cmd.Flag;
+                break;
+            case FudgetDrawCommandType::DrawTextureView:
+            case FudgetDrawCommandType::DrawTexture:
+            case FudgetDrawCommandType::DrawTexturedTriangles:
+                key.Kind = 1;
+                key.Resource = cmd.Resource;
+                break;
+            case FudgetDrawCommandType::DrawText:
+            case FudgetDrawCommandType::DrawTextLayout:
+                key.Kind = 2;
+                key.Resource = cmd.Resource;
+                key.Material = cmd.Material;
+                break;
+            case FudgetDrawCommandType::DrawMaterial:
+                key.Kind = 3;
+                key.Material = cmd.Resource;
+                break;
+            default:
+                break;
+        }
+        return key;
+    }
+
+    // Area a command can touch, grown by the line thickness and a pixel for antialiasing. Text that wasn't measured
+    // when recorded can touch anything, and text drawn in a layout can overflow its bounds, unless it was found to
+    // fit. Measured text is grown by a part of its height, because glyphs can reach outside their advances.
+    Rectangle GetOverlapBounds(const FudgetDrawCommand &cmd, const float *data)
+    {
+        float grow = 1.f;
+        switch (cmd.Type)
+        {
+            case FudgetDrawCommandType::DrawRectangle:
+                grow += data[20];
+                break;
+            case FudgetDrawCommandType::DrawLine:
+            case FudgetDrawCommandType::DrawBezier:
+                grow += data[12];
+                break;
+            case FudgetDrawCommandType::DrawText:
+                if (!cmd.Flag)
+                    return InfiniteRect();
+                grow += cmd.Bounds.Size.Y * 0.25f;
+                break;
+            case FudgetDrawCommandType::DrawTextLayout:
+                if (!cmd.Flag)
+                    return InfiniteRect();
+                break;
+            default:
+                break;
+        }
+        return Rectangle(cmd.Bounds.Location - Float2(grow), cmd.Bounds.Size + Float2(grow * 2.f));
+    }
+
+    bool HasLineBreak(const StringView &text)
+    {
+        for (int ix = 0, siz = text.Length(); ix < siz; ++ix)
+            if (text[ix] == L'\n')
+                return true;
+        return false;
+    }
+
+    bool BoundsOverlap(const Rectangle &a, const Rectangle &b)
+    {
+        return a.GetLeft() < b.GetRight() && b.GetLeft() < a.GetRight() && a.GetTop() < b.GetBottom() && b.GetTop() < a.GetBottom();
+    }
+
+    Rectangle BoundsUnion(const Rectangle &a, const Rectangle &b)
+    {
+        Float2 min = Float2::Min(a.GetUpperLeft(), b.GetUpperLeft());
+        Float2 max = Float2::Max(a.GetBottomRight(), b.GetBottomRight());
+        return Rectangle(min, max - min);
+    }
+}
+
+
+FudgetDrawSink* FudgetDrawSink::GetCurrent()
+{
+    return CurrentSink;
+}
+
+FudgetDrawSink* FudgetDrawSink::SetCurrent(FudgetDrawSink *sink)
+{
+    FudgetDrawSink *old = CurrentSink;
+    CurrentSink = sink != nullptr ? sink : &Render2DSink;
+    return old;
+}
+
+
+// FudgetRender2DDrawSink
+
+
+void FudgetRender2DDrawSink::FillRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4)
+{
+    Render2D::FillRectangle(rect, color1, color2, color3, color4);
+}
+
+void FudgetRender2DDrawSink::DrawRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4, float thickness)
+{
+    Render2D::DrawRectangle(rect, color1, color2, color3, color4, thickness);
+}
+
+void FudgetRender2DDrawSink::Draw9SlicingTexture(TextureBase *t, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point)
+{
+    if (point)
+        Render2D::Draw9SlicingTexturePoint(t, rect, border, borderUVs, color);
+    else
+        Render2D::Draw9SlicingTexture(t, rect, border, borderUVs, color);
+}
+
+void FudgetRender2DDrawSink::Draw9SlicingSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point)
+{
+    if (point)
+        Render2D::Draw9SlicingSpritePoint(spriteHandle, rect, border, borderUVs, color);
+    else
+        Render2D::Draw9SlicingSprite(spriteHandle, rect, border, borderUVs, color);
+}
+
+void FudgetRender2DDrawSink::DrawBezier(const Float2 &p1, const Float2 &p2, const Float2 &p3, const Float2 &p4, const Color &color, float thickness)
+{
+    Render2D::DrawBezier(p1, p2, p3, p4, color, thickness);
+}
+
+void FudgetRender2DDrawSink::DrawBlur(const Rectangle &rect, float blurStrength)
+{
+    Render2D::DrawBlur(rect, blurStrength);
+}
+
+void FudgetRender2DDrawSink::DrawLine(const Float2 &p1, const Float2 &p2, const Color &color1, const Color &color2, float thickness)
+{
+    Render2D::DrawLine(p1, p2, color1, color2, thickness);
+}
+
+void FudgetRender2DDrawSink::DrawMaterial(MaterialBase *material, const Rectangle &rect, const Color &color)
+{
+    Render2D::DrawMaterial(material, rect, color);
+}
+
+void FudgetRender2DDrawSink::DrawSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Color &color, bool point)
+{
+    if (point)
+        Render2D::DrawSpritePoint(spriteHandle, rect, color);
+    else
+        Render2D::DrawSprite(spriteHandle, rect, color);
+}
+
+void FudgetRender2DDrawSink::DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const Float2 &location, MaterialBase *customMaterial)
+{
+    if (textRange != nullptr)
+        Render2D::DrawText(font, text, *textRange, color, location, customMaterial);
+    else
+        Render2D::DrawText(font, text, color, location, customMaterial);
+}
+
+void FudgetRender2DDrawSink::DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const TextLayoutOptions &layout, MaterialBase *customMaterial)
+{
+    if (textRange != nullptr)
+        Render2D::DrawText(font, text, *textRange, color, layout, customMaterial);
+    else
+        Render2D::DrawText(font, text, color, layout, customMaterial);
+}
+
+void FudgetRender2DDrawSink::DrawTexture(GPUTextureView *rt, const Rectangle &rect, const Color &color)
+{
+    Render2D::DrawTexture(rt, rect, color);
+}
+
+void FudgetRender2DDrawSink::DrawTexture(GPUTexture *t, const Rectangle &rect, const Color &color, bool point)
+{
+    if (point)
+        Render2D::DrawTexturePoint(t, rect, color);
+    else
+        Render2D::DrawTexture(t, rect, color);
+}
+
+void FudgetRender2DDrawSink::DrawTexture(TextureBase *t, const Rectangle &rect, const Color &color)
+{
+    Render2D::DrawTexture(t, rect, color);
+}
+
+void FudgetRender2DDrawSink::DrawTexturedTriangles(GPUTexture *t, const Span<uint16> &indices, const Span<Float2> &vertices, const Span<Float2> &uvs, const Span<Color> &colors)
+{
+    if (indices.Length() != 0)
+        Render2D::DrawTexturedTriangles(t, indices, vertices, uvs, colors);
+    else if (colors.Length() != 0)
+        Render2D::DrawTexturedTriangles(t, vertices, uvs, colors);
+    else
+        Render2D::DrawTexturedTriangles(t, vertices, uvs);
+}
+
+void FudgetRender2DDrawSink::FillTriangles(const Span<Float2> &vertices, const Span<Color> &colors, bool useAlpha)
+{
+    Render2D::FillTriangles(vertices, colors, useAlpha);
+}
+
+void FudgetRender2DDrawSink::FillTriangle(const Float2 &p0, const Float2 &p1, const Float2 &p2, const Color &color)
+{
+    Render2D::FillTriangle(p0, p1, p2, color);
+}
+
+void FudgetRender2DDrawSink::PushClip(const Rectangle &rect)
+{
+    Render2D::PushClip(rect);
+}
+
+void FudgetRender2DDrawSink::PopClip()
+{
+    Render2D::PopClip();
+}
+
+
+// FudgetDrawRecorder
+
+
+FudgetDrawRecorder::FudgetDrawRecorder() : _drawn_area(0.f)
+{
+    Clear();
+}
+
+FudgetDrawRecorder::~FudgetDrawRecorder()
+{
+    if (FudgetDrawSink::GetCurrent() == this)
+        FudgetDrawSink::SetCurrent(nullptr);
+}
+
+void FudgetDrawRecorder::Record(FudgetGUIRoot *root)
+{
+    Clear();
+    if (root == nullptr)
+        return;
+
+    FudgetDrawSink *old = FudgetDrawSink::SetCurrent(this);
+    root->DoLayout();
+    root->DoDraw();
+    FudgetDrawSink::SetCurrent(old);
+}
+
+void FudgetDrawRecorder::Clear()
+{
+    _commands.Clear();
+    _data.Clear();
+    _text.Clear();
+    _indices.Clear();
+    for (int ix = 0; ix < (int)FudgetDrawCommandType::Count; ++ix)
+        _type_counts[ix] = 0;
+    _clip_stack.Clear();
+    _clip_stack.Add(InfiniteRect());
+    _drawn_area = 0.f;
+}
+
+void FudgetDrawRecorder::Replay(FudgetDrawSink *sink) const
+{
+    if (sink == nullptr || sink == this)
+        return;
+
+    for (const FudgetDrawCommand &cmd : _commands)
+    {
+        const float *data = _data.Get() + cmd.DataStart;
+        const Float2 *points = (const Float2*)data;
+        const Float4 *vectors = (const Float4*)data;
+        const Color *colors = (const Color*)data;
+        StringView text(_text.Get() + cmd.ExtraStart, cmd.ExtraCount);
+
+        switch (cmd.Type)
+        {
+            case FudgetDrawCommandType::FillRectangle:
+                sink->FillRectangle(cmd.Bounds, colors[1], colors[2], colors[3], colors[4]);
+                break;
+            case FudgetDrawCommandType::DrawRectangle:
+                sink->DrawRectangle(cmd.Bounds, colors[1], colors[2], colors[3], colors[4], data[20]);
+                break;
+            case FudgetDrawCommandType::Draw9SlicingTexture:
+                sink->Draw9SlicingTexture((TextureBase*)cmd.Resource, cmd.Bounds, vectors[1], vectors[2], colors[3], cmd.Flag);
+                break;
+            case FudgetDrawCommandType::Draw9SlicingSprite:
+                sink->Draw9SlicingSprite(SpriteHandle((SpriteAtlas*)cmd.Resource, cmd.SpriteIndex), cmd.Bounds, vectors[1], vectors[2], colors[3], cmd.Flag);
+                break;
+            case FudgetDrawCommandType::DrawBezier:
+                sink->DrawBezier(points[0], points[1], points[2], points[3], colors[2], data[12]);
+                break;
+            case FudgetDrawCommandType::DrawBlur:
+                sink->DrawBlur(cmd.Bounds, data[4]);
+                break;
+            case FudgetDrawCommandType::DrawLine:
+                sink->DrawLine(points[0], points[1], colors[1], colors[2], data[12]);
+                break;
+            case FudgetDrawCommandType::DrawMaterial:
+                sink->DrawMaterial((MaterialBase*)cmd.Resource, cmd.Bounds, colors[1]);
+                break;
+            case FudgetDrawCommandType::DrawSprite:
+                sink->DrawSprite(SpriteHandle((SpriteAtlas*)cmd.Resource, cmd.SpriteIndex), cmd.Bounds, colors[1], cmd.Flag);
+                break;
+            case FudgetDrawCommandType::DrawText:
+            case FudgetDrawCommandType::DrawTextLayout:
+            {
+                // Color, range flag, range start and end, then the location or the layout.
+                TextRange range;
+                range.StartIndex = (int32)data[5];
+                range.EndIndex = (int32)data[6];
+                const TextRange *range_ptr = data[4] != 0.f ? &range : nullptr;
+                if (cmd.Type == FudgetDrawCommandType::DrawText)
+                {
+                    sink->DrawText((Font*)cmd.Resource, text, range_ptr, colors[0], cmd.Bounds.Location, (MaterialBase*)cmd.Material);
+                    break;
+                }
+                TextLayoutOptions layout;
+                layout.Bounds = cmd.Bounds;
+                layout.HorizontalAlignment = (TextAlignment)(int)data[7];
+                layout.VerticalAlignment = (TextAlignment)(int)data[8];
+                layout.TextWrapping = (TextWrapping)(int)data[9];
+                layout.Scale = data[10];
+                layout.BaseLinesGapScale = data[11];
+                sink->DrawText((Font*)cmd.Resource, text, range_ptr, colors[0], layout, (MaterialBase*)cmd.Material);
+                break;
+            }
+            case FudgetDrawCommandType::DrawTextureView:
+                sink->DrawTexture((GPUTextureView*)cmd.Resource, cmd.Bounds, colors[1]);
+                break;
+            case FudgetDrawCommandType::DrawGPUTexture:
+                sink->DrawTexture((GPUTexture*)cmd.Resource, cmd.Bounds, colors[1], cmd.Flag);
+                break;
+            case FudgetDrawCommandType::DrawTexture:
+                sink->DrawTexture((TextureBase*)cmd.Resource, cmd.Bounds, colors[1]);
+                break;
+            case FudgetDrawCommandType::DrawTexturedTriangles:
+            {
+                // Vertex, uv and color counts, then the vertices, uvs and colors.
+                int vcnt = (int)data[0];
+                int uvcnt = (int)data[1];
+                int ccnt = (int)data[2];
+                const float *pos = data + 3;
+                Span<Float2> vertices((Float2*)pos, vcnt);
+                pos += vcnt * 2;
+                Span<Float2> uvs((Float2*)pos, uvcnt);
+                pos += uvcnt * 2;
+                Span<Color> tri_colors((Color*)pos, ccnt);
+                Span<uint16> indices((uint16*)_indices.Get() + cmd.ExtraStart, cmd.ExtraCount);
+                sink->DrawTexturedTriangles((GPUTexture*)cmd.Resource, indices, vertices, uvs, tri_colors);
+                break;
+            }
+            case FudgetDrawCommandType::FillTriangles:
+            {
+                // Vertex and color counts, then the vertices and colors.
+                int vcnt = (int)data[0];
+                int ccnt = (int)data[1];
+                Span<Float2> vertices((Float2*)(data + 2), vcnt);
+                Span<Color> tri_colors((Color*)(data + 2 + vcnt * 2), ccnt);
+                sink->FillTriangles(vertices, tri_colors, cmd.Flag);
+                break;
+            }
+            case FudgetDrawCommandType::FillTriangle:
+                sink->FillTriangle(points[0], points[1], points[2], Color(data[6], data[7], data[8], data[9]));
+                break;
+            case FudgetDrawCommandType::PushClip:
+                sink->PushClip(cmd.Bounds);
+                break;
+            case FudgetDrawCommandType::PopClip:
+                sink->PopClip();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+int FudgetDrawRecorder::GetDrawCallCount() const
+{
+    return _commands.Count() - _type_counts[(int)FudgetDrawCommandType::PushClip] - _type_counts[(int)FudgetDrawCommandType::PopClip];
+}
+
+bool FudgetDrawRecorder::CommandEquals(int index, const FudgetDrawRecorder &other, int other_index) const
+{
+    if (index < 0 || index >= _commands.Count() || other_index < 0 || other_index >= other._commands.Count())
+        return false;
+
+    const FudgetDrawCommand &a = _commands[index];
+    const FudgetDrawCommand &b = other._commands[other_index];
+    if (a.Type != b.Type || a.Flag != b.Flag || a.Resource != b.Resource || a.Material != b.Material || a.SpriteIndex != b.SpriteIndex ||
+        a.Bounds != b.Bounds || a.DataCount != b.DataCount || a.ExtraCount != b.ExtraCount)
+        return false;
+
+    for (int ix = 0; ix < a.DataCount; ++ix)
+    {
+        if (_data[a.DataStart + ix] != other._data[b.DataStart + ix])
+            return false;
+    }
+
+    bool text = a.Type == FudgetDrawCommandType::DrawText || a.Type == FudgetDrawCommandType::DrawTextLayout;
+    for (int ix = 0; ix < a.ExtraCount; ++ix)
+    {
+        if (text ? _text[a.ExtraStart + ix] != other._text[b.ExtraStart + ix] : _indices[a.ExtraStart + ix] != other._indices[b.ExtraStart + ix])
+            return false;
+    }
+    return true;
+}
+
+int FudgetDrawRecorder::FindFirstDifference(const FudgetDrawRecorder &other) const
+{
+    int cnt = Math::Min(_commands.Count(), other._commands.Count());
+    for (int ix = 0; ix < cnt; ++ix)
+    {
+        if (!CommandEquals(ix, other, ix))
+            return ix;
+    }
+    return _commands.Count() != other._commands.Count() ? cnt : -1;
+}
+
+int FudgetDrawRecorder::GetBatchCount() const
+{
+    int result = 0;
+    bool in_batch = false;
+    BatchKey last_key = { 0, nullptr, nullptr, false };
+    for (const FudgetDrawCommand &cmd : _commands)
+    {
+        if (IsBatchBarrier(cmd.Type))
+        {
+            in_batch = false;
+            continue;
+        }
+        BatchKey key = GetBatchKey(cmd);
+        if (!in_batch || !(key == last_key))
+            ++result;
+        in_batch = true;
+        last_key = key;
+    }
+    return result;
+}
+
+FudgetDrawBatchStats FudgetDrawRecorder::ReorderForBatching(int max_lookback)
+{
+    FudgetDrawBatchStats stats;
+    stats.BatchesBefore = GetBatchCount();
+
+    struct Batch
+    {
+        BatchKey Key;
+        // Union of the overlap bounds of the commands in the batch.
+        Rectangle Bounds;
+        int Count;
+    };
+
+    int cnt = _commands.Count();
+    Array<FudgetDrawCommand> result(cnt);
+    Array<Batch> batches;
+    Array<int> batch_of;
+    Array<int> positions;
+
+    int start = 0;
+    while (start < cnt)
+    {
+        int end = start;
+        while (end < cnt && !IsBatchBarrier(_commands[end].Type))
+            ++end;
+
+        // Sort the commands between two barriers into batches. A command joins the latest batch with the same key,
+        // unless a batch after that one overlaps it.
+        batches.Clear();
+        batch_of.Clear();
+        for (int ix = start; ix < end; ++ix)
+        {
+            const FudgetDrawCommand &cmd = _commands[ix];
+            BatchKey key = GetBatchKey(cmd);
+            Rectangle bounds = GetOverlapBounds(cmd, _data.Get() + cmd.DataStart);
+
+            int found = -1;
+            for (int b = batches.Count() - 1, last = Math::Max(0, batches.Count() - max_lookback); b >= last; --b)
+            {
+                if (batches[b].Key == key)
+                {
+                    found = b;
+                    break;
+                }
+                if (BoundsOverlap(batches[b].Bounds, bounds))
+                    break;
+            }
+
+            if (found < 0)
+            {
+                found = batches.Count();
+                batches.Add({ key, bounds, 0 });
+            }
+            else
+            {
+                if (found != batches.Count() - 1)
+                    ++stats.MovedCommands;
+                batches[found].Bounds = BoundsUnion(batches[found].Bounds, bounds);
+            }
+            ++batches[found].Count;
+            batch_of.Add(found);
+        }
+
+        // Place the commands batch by batch, keeping their recorded order inside the batches.
+        int pos = result.Count();
+        result.Resize(pos + end - start);
+        positions.Clear();
+        for (const Batch &batch : batches)
+        {
+            positions.Add(pos);
+            pos += batch.Count;
+        }
+        for (int ix = start; ix < end; ++ix)
+            result[positions[batch_of[ix - start]]++] = _commands[ix];
+
+        if (end < cnt)
+            result.Add(_commands[end]);
+        start = end + 1;
+    }
+
+    _commands.Swap(result);
+    stats.BatchesAfter = GetBatchCount();
+    return stats;
+}
+
+void FudgetDrawRecorder::FillRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4)
+{
+    // The rectangle is written too, to keep the colors aligned for the replay.
+    AddCommand(FudgetDrawCommandType::FillRectangle, rect);
+    Write(rect);
+    Write(color1);
+    Write(color2);
+    Write(color3);
+    Write(color4);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4, float thickness)
+{
+    AddCommand(FudgetDrawCommandType::DrawRectangle, rect);
+    Write(rect);
+    Write(color1);
+    Write(color2);
+    Write(color3);
+    Write(color4);
+    Write(thickness);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::Draw9SlicingTexture(TextureBase *t, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point)
+{
+    AddCommand(FudgetDrawCommandType::Draw9SlicingTexture, rect, t, point);
+    Write(rect);
+    Write(border);
+    Write(borderUVs);
+    Write(color);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::Draw9SlicingSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point)
+{
+    FudgetDrawCommand &cmd = AddCommand(FudgetDrawCommandType::Draw9SlicingSprite, rect, spriteHandle.Atlas.Get(), point);
+    cmd.SpriteIndex = spriteHandle.Index;
+    Write(rect);
+    Write(border);
+    Write(borderUVs);
+    Write(color);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawBezier(const Float2 &p1, const Float2 &p2, const Float2 &p3, const Float2 &p4, const Color &color, float thickness)
+{
+    Float2 points[4] = { p1, p2, p3, p4 };
+    Rectangle bounds = PointBounds(Span<Float2>(points, 4));
+    AddCommand(FudgetDrawCommandType::DrawBezier, bounds);
+    Write(p1);
+    Write(p2);
+    Write(p3);
+    Write(p4);
+    Write(color);
+    Write(thickness);
+    AddDrawnArea(bounds);
+}
+
+void FudgetDrawRecorder::DrawBlur(const Rectangle &rect, float blurStrength)
+{
+    AddCommand(FudgetDrawCommandType::DrawBlur, rect);
+    Write(rect);
+    Write(blurStrength);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawLine(const Float2 &p1, const Float2 &p2, const Color &color1, const Color &color2, float thickness)
+{
+    Float2 points[2] = { p1, p2 };
+    Rectangle bounds = PointBounds(Span<Float2>(points, 2));
+    AddCommand(FudgetDrawCommandType::DrawLine, bounds);
+    Write(p1);
+    Write(p2);
+    Write(color1);
+    Write(color2);
+    Write(thickness);
+    AddDrawnArea(bounds);
+}
+
+void FudgetDrawRecorder::DrawMaterial(MaterialBase *material, const Rectangle &rect, const Color &color)
+{
+    AddCommand(FudgetDrawCommandType::DrawMaterial, rect, material);
+    Write(rect);
+    Write(color);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Color &color, bool point)
+{
+    FudgetDrawCommand &cmd = AddCommand(FudgetDrawCommandType::DrawSprite, rect, spriteHandle.Atlas.Get(), point);
+    cmd.SpriteIndex = spriteHandle.Index;
+    Write(rect);
+    Write(color);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const Float2 &location, MaterialBase *customMaterial)
+{
+    // Single lines are measured with the shared cache. Text with line breaks is left unmeasured.
+    StringView measured = textRange != nullptr ? StringView(text.Get() + textRange->StartIndex, textRange->Length()) : text;
+    Int2 size = Int2::Zero;
+    bool has_size = font != nullptr && !HasLineBreak(measured);
+    if (has_size && !FudgetTextMeasureCache::TryGet(font, 1.f, measured, size))
+    {
+        size = font->MeasureText(measured);
+        FudgetTextMeasureCache::Add(font, 1.f, measured, size);
+    }
+
+    Rectangle bounds(location, Float2(size));
+    FudgetDrawCommand &cmd = AddCommand(FudgetDrawCommandType::DrawText, bounds, font, has_size);
+    cmd.Material = customMaterial;
+    cmd.ExtraStart = _text.Count();
+    cmd.ExtraCount = text.Length();
+    _text.Add(text.Get(), text.Length());
+
+    Write(color);
+    Write(textRange != nullptr ? 1.f : 0.f);
+    Write(textRange != nullptr ? (float)textRange->StartIndex : 0.f);
+    Write(textRange != nullptr ? (float)textRange->EndIndex : 0.f);
+}
+
+void FudgetDrawRecorder::DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const TextLayoutOptions &layout, MaterialBase *customMaterial)
+{
+    // Only wrapped text is measured, because lines that aren't wrapped can have any length.
+    bool fits = false;
+    if (font != nullptr && layout.TextWrapping != TextWrapping::NoWrap)
+    {
+        Int2 size;
+        if (!FudgetTextMeasureCache::TryGet(font, layout, text, size))
+        {
+            size = font->MeasureText(text, layout);
+            FudgetTextMeasureCache::Add(font, layout, text, size);
+        }
+        fits = size.Y <= layout.Bounds.GetHeight();
+    }
+
+    FudgetDrawCommand &cmd = AddCommand(FudgetDrawCommandType::DrawTextLayout, layout.Bounds, font, fits);
+    cmd.Material = customMaterial;
+    cmd.ExtraStart = _text.Count();
+    cmd.ExtraCount = text.Length();
+    _text.Add(text.Get(), text.Length());
+
+    Write(color);
+    Write(textRange != nullptr ? 1.f : 0.f);
+    Write(textRange != nullptr ? (float)textRange->StartIndex : 0.f);
+    Write(textRange != nullptr ? (float)textRange->EndIndex : 0.f);
+    Write((float)(int)layout.HorizontalAlignment);
+    Write((float)(int)layout.VerticalAlignment);
+    Write((float)(int)layout.TextWrapping);
+    Write(layout.Scale);
+    Write(layout.BaseLinesGapScale);
+    AddDrawnArea(layout.Bounds);
+}
+
+void FudgetDrawRecorder::DrawTexture(GPUTextureView *rt, const Rectangle &rect, const Color &color)
+{
+    AddCommand(FudgetDrawCommandType::DrawTextureView, rect, rt);
+    Write(rect);
+    Write(color);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawTexture(GPUTexture *t, const Rectangle &rect, const Color &color, bool point)
+{
+    AddCommand(FudgetDrawCommandType::DrawGPUTexture, rect, t, point);
+    Write(rect);
+    Write(color);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawTexture(TextureBase *t, const Rectangle &rect, const Color &color)
+{
+    AddCommand(FudgetDrawCommandType::DrawTexture, rect, t);
+    Write(rect);
+    Write(color);
+    AddDrawnArea(rect);
+}
+
+void FudgetDrawRecorder::DrawTexturedTriangles(GPUTexture *t, const Span<uint16> &indices, const Span<Float2> &vertices, const Span<Float2> &uvs, const Span<Color> &colors)
+{
+    Rectangle bounds = PointBounds(vertices);
+    FudgetDrawCommand &cmd = AddCommand(FudgetDrawCommandType::DrawTexturedTriangles, bounds, t);
+    cmd.ExtraStart = _indices.Count();
+    cmd.ExtraCount = indices.Length();
+    _indices.Add(indices.Get(), indices.Length());
+
+    Write((float)vertices.Length());
+    Write((float)uvs.Length());
+    Write((float)colors.Length());
+    for (int ix = 0, siz = vertices.Length(); ix < siz; ++ix)
+        Write(vertices[ix]);
+    for (int ix = 0, siz = uvs.Length(); ix < siz; ++ix)
+        Write(uvs[ix]);
+    for (int ix = 0, siz = colors.Length(); ix < siz; ++ix)
+        Write(colors[ix]);
+    AddDrawnArea(bounds);
+}
+
+void FudgetDrawRecorder::FillTriangles(const Span<Float2> &vertices, const Span<Color> &colors, bool useAlpha)
+{
+    Rectangle bounds = PointBounds(vertices);
+    AddCommand(FudgetDrawCommandType::FillTriangles, bounds, nullptr, useAlpha);
+
+    Write((float)vertices.Length());
+    Write((float)colors.Length());
+    for (int ix = 0, siz = vertices.Length(); ix < siz; ++ix)
+        Write(vertices[ix]);
+    for (int ix = 0, siz = colors.Length(); ix < siz; ++ix)
+        Write(colors[ix]);
+    AddDrawnArea(bounds);
+}
+
+void FudgetDrawRecorder::FillTriangle(const Float2 &p0, const Float2 &p1, const Float2 &p2, const Color &color)
+{
+    Float2 points[3] = { p0, p1, p2 };
+    Rectangle bounds = PointBounds(Span<Float2>(points, 3));
+    AddCommand(FudgetDrawCommandType::FillTriangle, bounds);
+    Write(p0);
+    Write(p1);
+    Write(p2);
+    Write(color);
+    AddDrawnArea(bounds);
+}
+
+void FudgetDrawRecorder::PushClip(const Rectangle &rect)
+{
+    AddCommand(FudgetDrawCommandType::PushClip, rect);
+    _clip_stack.Add(Rectangle::Shared(_clip_stack.Last(), rect));
+}
+
+void FudgetDrawRecorder::PopClip()
+{
+    AddCommand(FudgetDrawCommandType::PopClip, Rectangle::Empty);
+    if (_clip_stack.Count() > 1)
+        _clip_stack.RemoveLast();
+}
+
+FudgetDrawCommand& FudgetDrawRecorder::AddCommand(FudgetDrawCommandType type, const Rectangle &bounds, void *resource, bool flag)
+{
+    FudgetDrawCommand cmd;
+    cmd.Type = type;
+    cmd.Flag = flag;
+    cmd.Resource = resource;
+    cmd.Material = nullptr;
+    cmd.SpriteIndex = -1;
+    cmd.Bounds = bounds;
+    cmd.DataStart = _data.Count();
+    cmd.DataCount = 0;
+    cmd.ExtraStart = 0;
+    cmd.ExtraCount = 0;
+    _commands.Add(cmd);
+    ++_type_counts[(int)type];
+    return _commands.Last();
+}
+
+void FudgetDrawRecorder::AddDrawnArea(const Rectangle &bounds)
+{
+    Rectangle visible = Rectangle::Shared(_clip_stack.Last(), bounds);
+    if (visible.Size.X > 0.f && visible.Size.Y > 0.f)
+        _drawn_area += visible.Size.X * visible.Size.Y;
+}
+
+void FudgetDrawRecorder::Write(float value)
+{
+    _data.Add(value);
+    ++_commands.Last().DataCount;
+}
+
+void FudgetDrawRecorder::Write(const Float2 &value)
+{
+    Write(value.X);
+    Write(value.Y);
+}
+
+void FudgetDrawRecorder::Write(const Float4 &value)
+{
+    Write(value.X);
+    Write(value.Y);
+    Write(value.Z);
+    Write(value.W);
+}
+
+void FudgetDrawRecorder::Write(const Color &value)
+{
+    Write(value.R);
+    Write(value.G);
+    Write(value.B);
+    Write(value.A);
+}
+
+void FudgetDrawRecorder::Write(const Rectangle &value)
+{
+    Write(value.Location);
+    Write(value.Size);
+}
+
+Rectangle FudgetDrawRecorder::PointBounds(const Span<Float2> &points)
+{
+    if (points.Length() == 0)
+        return Rectangle::Empty;
+
+    Float2 min = points[0];
+    Float2 max = points[0];
+    for (int ix = 1, siz = points.Length(); ix < siz; ++ix)
+    {
+        min = Float2::Min(min, points[ix]);
+        max = Float2::Max(max, points[ix]);
+    }
+    return Rectangle(min, max - min);
+}
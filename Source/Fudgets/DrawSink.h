@@ -0,0 +1,286 @@
+#pragma once
+
+#include "Engine/Core/Types/BaseTypes.h"
+#include "Engine/Core/Types/Span.h"
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Math/Vector4.h"
+#include "Engine/Core/Math/Color.h"
+#include "Engine/Core/Math/Rectangle.h"
+
+class FudgetGUIRoot;
+class TextureBase;
+class MaterialBase;
+class GPUTexture;
+class GPUTextureView;
+class Font;
+struct SpriteHandle;
+struct TextLayoutOptions;
+struct TextRange;
+
+/// <summary>
+/// Receiver of the draw calls of controls. The drawing helpers of FudgetControl don't call Render2D directly, but pass
+/// their calls in global coordinates to the current draw sink. The default sink forwards everything to Render2D. Another
+/// sink can be set while drawing, for example a FudgetDrawRecorder, which makes it possible to draw the UI without a
+/// graphics device.
+/// </summary>
+class FUDGETS_API FudgetDrawSink
+{
+public:
+    virtual ~FudgetDrawSink() = default;
+
+    /// <summary>
+    /// Gets the sink that receives the draw calls of controls. This is never null.
+    /// </summary>
+    static FudgetDrawSink* GetCurrent();
+    /// <summary>
+    /// Sets the sink to receive the draw calls of controls. The sink is not owned and must be reset before it is destroyed.
+    /// </summary>
+    /// <param name="sink">The new sink or null to draw with Render2D</param>
+    /// <returns>The sink that was current before the call</returns>
+    static FudgetDrawSink* SetCurrent(FudgetDrawSink *sink);
+
+    virtual void FillRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4) = 0;
+    virtual void DrawRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4, float thickness) = 0;
+    virtual void Draw9SlicingTexture(TextureBase *t, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point) = 0;
+    virtual void Draw9SlicingSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point) = 0;
+    virtual void DrawBezier(const Float2 &p1, const Float2 &p2, const Float2 &p3, const Float2 &p4, const Color &color, float thickness) = 0;
+    virtual void DrawBlur(const Rectangle &rect, float blurStrength) = 0;
+    virtual void DrawLine(const Float2 &p1, const Float2 &p2, const Color &color1, const Color &color2, float thickness) = 0;
+    virtual void DrawMaterial(MaterialBase *material, const Rectangle &rect, const Color &color) = 0;
+    virtual void DrawSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Color &color, bool point) = 0;
+    // The text range is optional and can be null.
+    virtual void DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const Float2 &location, MaterialBase *customMaterial) = 0;
+    // The text range is optional and can be null.
+    virtual void DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const TextLayoutOptions &layout, MaterialBase *customMaterial) = 0;
+    virtual void DrawTexture(GPUTextureView *rt, const Rectangle &rect, const Color &color) = 0;
+    virtual void DrawTexture(GPUTexture *t, const Rectangle &rect, const Color &color, bool point) = 0;
+    virtual void DrawTexture(TextureBase *t, const Rectangle &rect, const Color &color) = 0;
+    // Indices and colors can be empty to draw non-indexed or untinted triangles.
+    virtual void DrawTexturedTriangles(GPUTexture *t, const Span<uint16> &indices, const Span<Float2> &vertices, const Span<Float2> &uvs, const Span<Color> &colors) = 0;
+    virtual void FillTriangles(const Span<Float2> &vertices, const Span<Color> &colors, bool useAlpha) = 0;
+    virtual void FillTriangle(const Float2 &p0, const Float2 &p1, const Float2 &p2, const Color &color) = 0;
+    virtual void PushClip(const Rectangle &rect) = 0;
+    virtual void PopClip() = 0;
+};
+
+/// <summary>
+/// Draw sink that draws with Render2D. This is the default sink.
+/// </summary>
+class FUDGETS_API FudgetRender2DDrawSink : public FudgetDrawSink
+{
+public:
+    void FillRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4) override;
+    void DrawRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4, float thickness) override;
+    void Draw9SlicingTexture(TextureBase *t, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point) override;
+    void Draw9SlicingSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point) override;
+    void DrawBezier(const Float2 &p1, const Float2 &p2, const Float2 &p3, const Float2 &p4, const Color &color, float thickness) override;
+    void DrawBlur(const Rectangle &rect, float blurStrength) override;
+    void DrawLine(const Float2 &p1, const Float2 &p2, const Color &color1, const Color &color2, float thickness) override;
+    void DrawMaterial(MaterialBase *material, const Rectangle &rect, const Color &color) override;
+    void DrawSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Color &color, bool point) override;
+    void DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const Float2 &location, MaterialBase *customMaterial) override;
+    void DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const TextLayoutOptions &layout, MaterialBase *customMaterial) override;
+    void DrawTexture(GPUTextureView *rt, const Rectangle &rect, const Color &color) override;
+    void DrawTexture(GPUTexture *t, const Rectangle &rect, const Color &color, bool point) override;
+    void DrawTexture(TextureBase *t, const Rectangle &rect, const Color &color) override;
+    void DrawTexturedTriangles(GPUTexture *t, const Span<uint16> &indices, const Span<Float2> &vertices, const Span<Float2> &uvs, const Span<Color> &colors) override;
+    void FillTriangles(const Span<Float2> &vertices, const Span<Color> &colors, bool useAlpha) override;
+    void FillTriangle(const Float2 &p0, const Float2 &p1, const Float2 &p2, const Color &color) override;
+    void PushClip(const Rectangle &rect) override;
+    void PopClip() override;
+};
+
+/// <summary>
+/// Type of a command recorded by FudgetDrawRecorder.
+/// </summary>
+enum class FudgetDrawCommandType : uint8
+{
+    FillRectangle,
+    DrawRectangle,
+    Draw9SlicingTexture,
+    Draw9SlicingSprite,
+    DrawBezier,
+    DrawBlur,
+    DrawLine,
+    DrawMaterial,
+    DrawSprite,
+    DrawText,
+    DrawTextLayout,
+    DrawTextureView,
+    DrawGPUTexture,
+    DrawTexture,
+    DrawTexturedTriangles,
+    FillTriangles,
+    FillTriangle,
+    PushClip,
+    PopClip,
+
+    Count
+};
+
+/// <summary>
+/// A single command recorded by FudgetDrawRecorder. The arguments that don't fit the command are stored in the
+/// buffers of the recorder.
+/// </summary>
+struct FUDGETS_API FudgetDrawCommand
+{
+    FudgetDrawCommandType Type;
+    // Point sampling for textures and sprites, useAlpha for FillTriangles, whether text drawn at a location was
+    // measured, or whether wrapped text was measured to fit in the bounds of its layout.
+    bool Flag;
+    // Texture, texture view, font, material or sprite atlas used by the command. Only compared by address.
+    void *Resource;
+    // Custom material of text commands.
+    void *Material;
+    // Index of the sprite in the atlas of a sprite command.
+    int SpriteIndex;
+    // Area in global coordinates the command can touch. Text drawn at a location has its measured size, or an empty
+    // size if it has line breaks, and text drawn in a layout has the bounds of the layout even if it overflows.
+    Rectangle Bounds;
+    // Range of the arguments in the data buffer of the recorder.
+    int DataStart;
+    int DataCount;
+    // Range of the characters or indices in the text or index buffer of the recorder.
+    int ExtraStart;
+    int ExtraCount;
+};
+
+/// <summary>
+/// Result of FudgetDrawRecorder::ReorderForBatching.
+/// </summary>
+struct FUDGETS_API FudgetDrawBatchStats
+{
+    // Number of batches of the commands before they were reordered.
+    int BatchesBefore = 0;
+    // Number of batches of the commands after they were reordered.
+    int BatchesAfter = 0;
+    // Number of commands that were moved to an earlier batch.
+    int MovedCommands = 0;
+};
+
+/// <summary>
+/// Draw sink that records the draw calls of controls without drawing them. The recorded commands can be compared
+/// with the commands of another recording, counted, or replayed on a different sink. It is meant for testing the
+/// drawing of controls without a graphics device.
+/// </summary>
+class FUDGETS_API FudgetDrawRecorder : public FudgetDrawSink
+{
+public:
+    FudgetDrawRecorder();
+    ~FudgetDrawRecorder();
+
+    /// <summary>
+    /// Lays out and draws a GUI root with the recorder set as the current sink. Commands recorded earlier are cleared.
+    /// </summary>
+    /// <param name="root">The root to draw</param>
+    void Record(FudgetGUIRoot *root);
+
+    /// <summary>
+    /// Removes every recorded command.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Draws the recorded commands on another sink.
+    /// </summary>
+    /// <param name="sink">The sink to draw on</param>
+    void Replay(FudgetDrawSink *sink) const;
+
+    /// <summary>
+    /// The recorded commands in the order they were recorded.
+    /// </summary>
+    const Array<FudgetDrawCommand>& GetCommands() const { return _commands; }
+    /// <summary>
+    /// Number of recorded commands including the clipping commands.
+    /// </summary>
+    int GetCommandCount() const { return _commands.Count(); }
+    /// <summary>
+    /// Number of recorded commands of a type.
+    /// </summary>
+    int GetCommandCount(FudgetDrawCommandType type) const { return _type_counts[(int)type]; }
+    /// <summary>
+    /// Number of recorded commands that draw something. Clipping commands are not counted.
+    /// </summary>
+    int GetDrawCallCount() const;
+    /// <summary>
+    /// Sum of the areas the drawing commands touch, limited to the clipping rectangle that was set for them. Dividing
+    /// it by the size of the drawn area gives the overdraw of the recording.
+    /// </summary>
+    float GetDrawnArea() const { return _drawn_area; }
+
+    /// <summary>
+    /// Checks whether a recorded command is equal to a command of another recording, including their arguments.
+    /// </summary>
+    /// <param name="index">Index of the command in this recording</param>
+    /// <param name="other">The other recording</param>
+    /// <param name="other_index">Index of the command in the other recording</param>
+    /// <returns>Whether the commands are equal</returns>
+    bool CommandEquals(int index, const FudgetDrawRecorder &other, int other_index) const;
+    /// <summary>
+    /// Finds the first command that is different in this and another recording.
+    /// </summary>
+    /// <param name="other">The other recording</param>
+    /// <returns>Index of the first different command, or -1 if the recordings are equal</returns>
+    int FindFirstDifference(const FudgetDrawRecorder &other) const;
+
+    /// <summary>
+    /// Counts the batches the recorded commands would be drawn in. Consecutive commands are in the same batch if they
+    /// use the same texture, atlas, font or material with the same sampling, or if they are all untextured fills.
+    /// Clipping and blur commands always end a batch.
+    /// </summary>
+    /// <returns>Number of batches</returns>
+    int GetBatchCount() const;
+    /// <summary>
+    /// Reorders the recorded commands to reduce the number of batches. A command is moved back next to an earlier
+    /// command of the same batch if it doesn't overlap any command it would be moved before, so the result looks the
+    /// same as drawing in the recorded order. Commands are never moved across clipping or blur commands.
+    /// </summary>
+    /// <param name="max_lookback">Number of batches to look back at for a matching batch for each command</param>
+    /// <returns>Number of batches before and after the reordering</returns>
+    FudgetDrawBatchStats ReorderForBatching(int max_lookback = 32);
+
+    void FillRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4) override;
+    void DrawRectangle(const Rectangle &rect, const Color &color1, const Color &color2, const Color &color3, const Color &color4, float thickness) override;
+    void Draw9SlicingTexture(TextureBase *t, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point) override;
+    void Draw9SlicingSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Color &color, bool point) override;
+    void DrawBezier(const Float2 &p1, const Float2 &p2, const Float2 &p3, const Float2 &p4, const Color &color, float thickness) override;
+    void DrawBlur(const Rectangle &rect, float blurStrength) override;
+    void DrawLine(const Float2 &p1, const Float2 &p2, const Color &color1, const Color &color2, float thickness) override;
+    void DrawMaterial(MaterialBase *material, const Rectangle &rect, const Color &color) override;
+    void DrawSprite(const SpriteHandle &spriteHandle, const Rectangle &rect, const Color &color, bool point) override;
+    void DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const Float2 &location, MaterialBase *customMaterial) override;
+    void DrawText(Font *font, const StringView &text, const TextRange *textRange, const Color &color, const TextLayoutOptions &layout, MaterialBase *customMaterial) override;
+    void DrawTexture(GPUTextureView *rt, const Rectangle &rect, const Color &color) override;
+    void DrawTexture(GPUTexture *t, const Rectangle &rect, const Color &color, bool point) override;
+    void DrawTexture(TextureBase *t, const Rectangle &rect, const Color &color) override;
+    void DrawTexturedTriangles(GPUTexture *t, const Span<uint16> &indices, const Span<Float2> &vertices, const Span<Float2> &uvs, const Span<Color> &colors) override;
+    void FillTriangles(const Span<Float2> &vertices, const Span<Color> &colors, bool useAlpha) override;
+    void FillTriangle(const Float2 &p0, const Float2 &p1, const Float2 &p2, const Color &color) override;
+    void PushClip(const Rectangle &rect) override;
+    void PopClip() override;
+private:
+    // Starts a new command with its data range at the end of the data buffer.
+    FudgetDrawCommand& AddCommand(FudgetDrawCommandType type, const Rectangle &bounds, void *resource = nullptr, bool flag = false);
+    // Adds the area of the bounds of the last command to the drawn area.
+    void AddDrawnArea(const Rectangle &bounds);
+
+    void Write(float value);
+    void Write(const Float2 &value);
+    void Write(const Float4 &value);
+    void Write(const Color &value);
+    void Write(const Rectangle &value);
+
+    static Rectangle PointBounds(const Span<Float2> &points);
+
+    Array<FudgetDrawCommand> _commands;
+    Array<float> _data;
+    Array<Char> _text;
+    Array<uint16> _indices;
+
+    int _type_counts[(int)FudgetDrawCommandType::Count];
+    // Clipping rectangles pushed while recording. The first item is an infinite rectangle.
+    Array<Rectangle> _clip_stack;
+    float _drawn_area;
+};
@@ -1,6 +1,7 @@
 ﻿#include "Fudget.h"
 //#include "RootControl.h"
 #include "GUIRoot.h"
+#include "DrawSink.h"
 
 #include "Engine/Level/Scene/Scene.h"
 #include "Engine/Level/Actors/Camera.h"
@@ -14,6 +15,9 @@
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Engine/Time.h"
 #include "Engine/Engine/Screen.h"
+#include "Engine/Engine/Engine.h"
+#include "Engine/Graphics/GPUDevice.h"
+#include "Engine/Graphics/Textures/GPUTexture.h"
 
 
 bool FudgetRenderer::CanRender() const
@@ -37,9 +41,11 @@ void FudgetRenderer::Render(GPUContext* context, API_PARAM(Ref) RenderContext& r
     if (!Canvas->IsVisible(renderContext.View.RenderLayersMask))
         return;
     auto bounds = Canvas->GetBounds();
+    Vector3 center = bounds.Transformation.Translation;
     bounds.Transformation.Translation -= renderContext.View.Origin;
     if (renderContext.View.Frustum.Contains(bounds.GetBoundingBox()) == ContainmentType::Disjoint)
         return;
+    Canvas->_lastInViewFrame = Engine::FrameCount;
 
     int profilerEvent = ProfilerGPU::BeginEvent(TEXT("UI Canvas"));
 
@@ -66,17 +72,31 @@ void FudgetRenderer::Render(GPUContext* context, API_PARAM(Ref) RenderContext& r
 
     if (context != nullptr && input != nullptr && Canvas->GetGUI() != nullptr)
     {
-        Render2D::Begin(context, input);
-        // TODO: check if we can get around the try/catch, since it's bad for peformance.
-        try
+        double start_time = Platform::GetTimeSeconds();
+
+        // Distant world space canvases are drawn from a texture that is refreshed at a reduced rate.
+        float lod_distance = Canvas->GetLodDistance();
+        if (lod_distance > 0.f && (Canvas->GetRenderMode() == FudgetRenderMode::WorldSpace || Canvas->GetRenderMode() == FudgetRenderMode::WorldSpaceFaceCamera) &&
+            Vector3::Distance(renderContext.View.WorldPosition, center) > lod_distance)
         {
-            Canvas->DrawGUI();
+            Canvas->DrawCachedGUI(context, input);
         }
-        catch (...)
+        else
         {
-            LOG(Error, "Drawing of the UI failed with an exception.");
+            Render2D::Begin(context, input);
+            // TODO: check if we can get around the try/catch, since it's bad for peformance.
+            try
+            {
+                Canvas->DrawGUI();
+            }
+            catch (...)
+            {
+                LOG(Error, "Drawing of the UI failed with an exception.");
+            }
+            Render2D::End();
         }
-        Render2D::End();
+
+        Canvas->AddCpuTime(Platform::GetTimeSeconds() - start_time);
     }
 
     Render2D::Features = features;
@@ -113,6 +133,7 @@ void FudgetRenderer2D::Render(GPUContext* context, API_PARAM(Ref) RenderContext&
 
     if (context != nullptr && input != nullptr && Canvas->GetGUI() != nullptr)
     {
+        double start_time = Platform::GetTimeSeconds();
         Render2D::Begin(context, input);
         try
         {
@@ -130,6 +151,7 @@ void FudgetRenderer2D::Render(GPUContext* context, API_PARAM(Ref) RenderContext&
             LOG(Error, "Drawing of the 2D UI failed with an exception.");
         }
         Render2D::End();
+        Canvas->AddCpuTime(Platform::GetTimeSeconds() - start_time);
     }
 
     //// Calculate rendering matrix (world*view*projection)
@@ -191,8 +213,15 @@ FudgetInitializer::FudgetInitializer(const SpawnParams &params) : Base(params)
 // Fudget
 
 
+Array<Fudget*> Fudget::_canvases;
+Array<Fudget::MouseRayHit> Fudget::_mouseRayHits;
+Float2 Fudget::_mouseRayPos = Float2::Zero;
+uint64 Fudget::_mouseRayFrame = 0;
+bool Fudget::_mouseRayValid = false;
+
 Fudget::Fudget(const SpawnParams& params) : Actor(params), _guiRoot(New<FudgetGUIRoot>(this))
 {
+    _canvases.Add(this);
     //_guiRoot->SetIsLayoutLocked(false);
     NavigateUp = New<FudgetInputEvent>(TEXT("NavigateUp"));
     NavigateDown = New<FudgetInputEvent>(TEXT("NavigateDown"));
@@ -215,6 +244,9 @@ Fudget::~Fudget()
 
 void Fudget::Dispose()
 {
+    _canvases.Remove(this);
+    _mouseRayValid = false;
+
     if (_isRegisteredForTick)
     {
         // TODO: Figure out how to register to Scripting Events.
@@ -228,6 +260,14 @@ void Fudget::Dispose()
             scene->Ticking.Update.RemoveTick(this);
     }
 
+    ReleaseLodTarget();
+
+    if (_drawRecorder != nullptr)
+    {
+        Delete(_drawRecorder);
+        _drawRecorder = nullptr;
+    }
+
     if (_guiRoot != nullptr)
     {
         // Set to null or 2d UI drawing blows up.
@@ -244,6 +284,8 @@ void Fudget::SetRenderMode(FudgetRenderMode value)
         auto previous = _renderMode;
 
         _renderMode = value;
+        // The size of the root might be changed below, and the cache can't tell, because screen space doesn't use it.
+        _world_matrix_valid = false;
 
         Setup();
 
@@ -294,8 +336,137 @@ void Fudget::SetSize(Float2 value)
 
 void Fudget::DrawGUI() const
 {
-    _guiRoot->DoLayout();
-    _guiRoot->DoDraw();
+    if (!_batchDraws)
+    {
+        _guiRoot->DoLayout();
+        _guiRoot->DoDraw();
+        return;
+    }
+
+    if (_drawRecorder == nullptr)
+        _drawRecorder = New<FudgetDrawRecorder>();
+
+    // Record into the recorder, then draw the reordered commands on the sink that was current before.
+    _drawRecorder->Record(_guiRoot);
+    FudgetDrawBatchStats stats = _drawRecorder->ReorderForBatching();
+    _batchesBeforeReorder = stats.BatchesBefore;
+    _batchesAfterReorder = stats.BatchesAfter;
+    _drawRecorder->Replay(FudgetDrawSink::GetCurrent());
+}
+
+void Fudget::SetBatchDraws(bool value)
+{
+    _batchDraws = value;
+    if (!_batchDraws && _drawRecorder != nullptr)
+    {
+        Delete(_drawRecorder);
+        _drawRecorder = nullptr;
+    }
+}
+
+void Fudget::SetLodDistance(float value)
+{
+    _lodDistance = Math::Max(0.f, value);
+    if (_lodDistance == 0.f)
+        ReleaseLodTarget();
+}
+
+double Fudget::GetLastFrameCpuTime() const
+{
+    // Nothing was counted in the last frame.
+    if (_cpuFrame + 1 < Engine::FrameCount)
+        return 0.0;
+    return _cpuFrame == Engine::FrameCount ? _lastCpuFrameTime : _cpuFrameTime;
+}
+
+void Fudget::ResetCpuCounters()
+{
+    _cpuFrameTime = 0.0;
+    _lastCpuFrameTime = 0.0;
+    _totalCpuTime = 0.0;
+    _cachedFrameCount = 0;
+    _skippedUpdateCount = 0;
+}
+
+bool Fudget::SkipControlUpdates()
+{
+    if (!_cullOutOfView || _renderMode == FudgetRenderMode::ScreenSpace)
+        return false;
+
+    // Updates run before rendering, so the canvas is considered in view if it was rendered in the previous frame.
+    if (_lastInViewFrame + 1 >= Engine::FrameCount)
+        return false;
+
+    ++_skippedUpdateCount;
+    return true;
+}
+
+void Fudget::AddCpuTime(double seconds)
+{
+    if (_cpuFrame != Engine::FrameCount)
+    {
+        _lastCpuFrameTime = _cpuFrame + 1 == Engine::FrameCount ? _cpuFrameTime : 0.0;
+        _cpuFrameTime = 0.0;
+        _cpuFrame = Engine::FrameCount;
+    }
+    _cpuFrameTime += seconds;
+    _totalCpuTime += seconds;
+}
+
+void Fudget::DrawCachedGUI(GPUContext *context, GPUTexture *output)
+{
+    Int2 size = _guiRoot->GetSize();
+    if (size.X <= 0 || size.Y <= 0)
+        return;
+
+    double now = Platform::GetTimeSeconds();
+    bool refresh = !_lodTargetValid || now - _lodLastRefresh >= _lodRefreshInterval;
+
+    if (_lodTarget == nullptr)
+        _lodTarget = GPUDevice::Instance->CreateTexture(TEXT("Fudget.LodTarget"));
+    if (_lodTarget->Width() != size.X || _lodTarget->Height() != size.Y)
+    {
+        auto desc = GPUTextureDescription::New2D(size.X, size.Y, PixelFormat::R8G8B8A8_UNorm, GPUTextureFlags::ShaderResource | GPUTextureFlags::RenderTarget);
+        if (_lodTarget->Init(desc))
+        {
+            LOG(Error, "Failed to create the cached texture of a distant UI canvas.");
+            ReleaseLodTarget();
+            return;
+        }
+        refresh = true;
+    }
+
+    if (refresh)
+    {
+        context->Clear(_lodTarget->View(), Color::Transparent);
+        Render2D::Begin(context, _lodTarget);
+        try
+        {
+            DrawGUI();
+        }
+        catch (...)
+        {
+            LOG(Error, "Drawing of the UI failed with an exception.");
+        }
+        Render2D::End();
+
+        _lodTargetValid = true;
+        _lodLastRefresh = now;
+    }
+    else
+    {
+        ++_cachedFrameCount;
+    }
+
+    Render2D::Begin(context, output);
+    Render2D::DrawTexture(_lodTarget, Rectangle(Float2::Zero, Float2(size)));
+    Render2D::End();
+}
+
+void Fudget::ReleaseLodTarget()
+{
+    SAFE_DELETE_GPU_RESOURCE(_lodTarget);
+    _lodTargetValid = false;
 }
 
 OrientedBoundingBox Fudget::GetBounds() const
@@ -317,14 +488,14 @@ OrientedBoundingBox Fudget::GetBounds() const
 
 void Fudget::GetWorldMatrix(Vector3 viewOrigin, API_PARAM(Out) Matrix& world) const
 {
-    auto transform = Transform();
-    Float3 translation = transform.Translation - viewOrigin;
     // TODO: Remove inline out declarations, and replace them with locals. Uncomment the USE_EDITOR if case.
 
 #if USE_EDITOR
         // Override projection for editor preview
     if (_editorTask)
     {
+        const Transform transform = GetTransform();
+        Float3 translation = transform.Translation - viewOrigin;
         if (_renderMode == FudgetRenderMode::WorldSpace)
         {
             Matrix::Transformation(transform.Scale, transform.Orientation, translation, world);
@@ -378,14 +549,99 @@ void Fudget::GetWorldMatrix(Vector3 viewOrigin, API_PARAM(Out) Matrix& world) co
     // Use default camera is not specified
     Camera *camera = (Camera*)GetRenderCamera() == nullptr ? Camera::GetMainCamera() : (Camera*)GetRenderCamera();
 
+    if (_renderMode == FudgetRenderMode::ScreenSpace || (_renderMode == FudgetRenderMode::CameraSpace && !camera))
+    {
+        // Direct projection
+        world = Matrix::Identity;
+        return;
+    }
+
+    UpdateWorldMatrixCache(camera);
+
+    world = _world_matrix;
+    Float3 offset = _world_matrix_origin - viewOrigin;
+    world.M41 += offset.X;
+    world.M42 += offset.Y;
+    world.M43 += offset.Z;
+}
+
+bool Fudget::CameraProjectionState::operator==(const CameraProjectionState &other) const
+{
+    return RenderCamera == other.RenderCamera && UsePerspective == other.UsePerspective && FieldOfView == other.FieldOfView &&
+        NearPlane == other.NearPlane && FarPlane == other.FarPlane && OrthographicScale == other.OrthographicScale &&
+        CustomAspectRatio == other.CustomAspectRatio && ViewportSize == other.ViewportSize && Distance == other.Distance;
+}
+
+bool Fudget::WorldMatrixState::operator==(const WorldMatrixState &other) const
+{
+    return Mode == other.Mode && Projection == other.Projection && CameraTransform == other.CameraTransform &&
+        ActorTransform == other.ActorTransform && RootSize == other.RootSize;
+}
+
+void Fudget::UpdateWorldMatrixCache(Camera *camera) const
+{
+    WorldMatrixState state;
+    state.Mode = _renderMode;
+    state.ActorTransform = _renderMode != FudgetRenderMode::CameraSpace ? GetTransform() : Transform::Identity;
+
+    // Only the values used by the render mode are filled, so changes to the others don't invalidate the cache.
+    bool face_camera = _renderMode == FudgetRenderMode::WorldSpaceFaceCamera && camera;
+    if (face_camera || _renderMode == FudgetRenderMode::CameraSpace)
+        state.CameraTransform = camera->GetTransform();
+
+    if (_renderMode == FudgetRenderMode::CameraSpace)
+    {
+        CameraProjectionState &proj = state.Projection;
+        proj.RenderCamera = camera;
+        proj.UsePerspective = camera->GetUsePerspective();
+        proj.FieldOfView = camera->GetFieldOfView();
+        proj.NearPlane = camera->GetNearPlane();
+        proj.FarPlane = camera->GetFarPlane();
+        proj.OrthographicScale = camera->GetOrthographicScale();
+        proj.CustomAspectRatio = camera->GetCustomAspectRatio();
+        proj.ViewportSize = camera->GetViewport().Size;
+        proj.Distance = GetDistance();
+
+        // Adjust GUI size to the viewport size at the given distance form the camera. The root only gets a new hint
+        // size when the projection changes, so moving the camera doesn't make the layout check the root's size.
+        if (!_world_matrix_valid || _world_matrix_state.Mode != FudgetRenderMode::CameraSpace || proj != _world_matrix_state.Projection)
+        {
+            auto viewport = camera->GetViewport();
+            if (proj.UsePerspective)
+            {
+                Matrix tmp1, tmp2, tmp3;
+                camera->GetMatrices(tmp1, tmp3, viewport);
+                Matrix::Multiply(tmp1, tmp3, tmp2);
+                auto frustum = BoundingFrustum(tmp2);
+                _guiRoot->SetHintSize(Float2(frustum.GetWidthAtDepth(GetDistance()), frustum.GetHeightAtDepth(GetDistance())));
+            }
+            else
+            {
+                _guiRoot->SetHintSize(viewport.Size * proj.OrthographicScale);
+            }
+        }
+    }
+
+    state.RootSize = Float2(_guiRoot->GetSize());
+
+    if (_world_matrix_valid && state == _world_matrix_state)
+        return;
+
+    _world_matrix_state = state;
+    _world_matrix_valid = true;
+
+    const Transform &transform = state.ActorTransform;
+
     if (_renderMode == FudgetRenderMode::WorldSpace || (_renderMode == FudgetRenderMode::WorldSpaceFaceCamera && !camera))
     {
         // In 3D world
-        Matrix::Transformation(transform.Scale, transform.Orientation, translation, world);
+        _world_matrix_origin = transform.Translation;
+        Matrix::Transformation(transform.Scale, transform.Orientation, Float3::Zero, _world_matrix);
     }
     else if (_renderMode == FudgetRenderMode::WorldSpaceFaceCamera)
     {
         // In 3D world face camera
+        _world_matrix_origin = transform.Translation;
         Matrix m1;
         Matrix::Translation(_guiRoot->GetWidth() * -0.5f, _guiRoot->GetHeight() * -0.5f, 0, m1);
         Matrix m2;
@@ -395,50 +651,29 @@ void Fudget::GetWorldMatrix(Vector3 viewOrigin, API_PARAM(Out) Matrix& world) co
         Quaternion quat = Quaternion::Euler(180, 180, 0);
         Matrix::RotationQuaternion(quat, m2);
         Matrix::Multiply(m3, m2, m1);
-        Matrix::Transformation(Vector3::One, Quaternion::FromDirection(-camera->GetDirection()), translation, m2);
-        Matrix::Multiply(m1, m2, world);
+        Matrix::Transformation(Vector3::One, Quaternion::FromDirection(-camera->GetDirection()), Float3::Zero, m2);
+        Matrix::Multiply(m1, m2, _world_matrix);
     }
-    else if (_renderMode == FudgetRenderMode::CameraSpace && camera)
+    else
     {
+        _world_matrix_origin = camera->GetPosition();
         Matrix tmp1, tmp2;
 
-        // Adjust GUI size to the viewport size at the given distance form the camera
-        auto viewport = camera->GetViewport();
-        if (camera->GetUsePerspective())
-        {
-            Matrix tmp3;
-            camera->GetMatrices(tmp1, tmp3, viewport);
-            Matrix::Multiply(tmp1, tmp3, tmp2);
-            auto frustum = BoundingFrustum(tmp2);
-            _guiRoot->SetHintSize(Float2(frustum.GetWidthAtDepth(GetDistance()), frustum.GetHeightAtDepth(GetDistance())));
-        }
-        else
-        {
-            _guiRoot->SetHintSize(viewport.Size * camera->GetOrthographicScale());
-        }
-
         // Center viewport (and flip)
-        Matrix::Translation(_guiRoot->GetWidth() / -2.0f, _guiRoot->GetHeight() / -2.0f, 0, world);
-        Matrix::RotationYawPitchRoll(PI, PI, 0, tmp2);
-        Matrix::Multiply(world, tmp2, tmp1);
+        Matrix::Translation(_guiRoot->GetWidth() / -2.0f, _guiRoot->GetHeight() / -2.0f, 0, tmp2);
+        Matrix::RotationYawPitchRoll(PI, PI, 0, tmp1);
+        Matrix::Multiply(tmp2, tmp1, _world_matrix);
 
         // In front of the camera
-        Float3 viewPos = camera->GetPosition() - viewOrigin;
+        Float3 viewPos = Float3::Zero;
         auto viewRot = camera->GetOrientation();
         auto viewUp = viewRot * Float3::Up;
         auto viewForward = viewRot * Float3::Forward;
         auto pos = viewPos + viewForward * GetDistance();
         Matrix::Billboard(pos, viewPos, viewUp, viewForward, tmp2);
 
-        Matrix::Multiply(tmp1, tmp2, world);
-    }
-    else
-    {
-        // Direct projection
-        world = Matrix::Identity;
-        
-        //auto viewport = camera->GetViewport();
-        //_guiRoot->SetSize(Float2(500.0, 500.0));
+        Matrix::Multiply(_world_matrix, tmp2, tmp1);
+        _world_matrix = tmp1;
     }
 }
 
@@ -497,11 +732,104 @@ void Fudget::DefaultCalculateRay(Float2 location, API_PARAM(Out) Ray& ray)
     }
 }
 
+bool Fudget::GetMouseRayHit(Float2 screen_pos, API_PARAM(Out) Float2 &canvas_pos, API_PARAM(Out) bool &nearest)
+{
+    if (_renderMode == FudgetRenderMode::ScreenSpace)
+    {
+        canvas_pos = screen_pos;
+        nearest = true;
+        return true;
+    }
+
+    UpdateMouseRayHits(screen_pos);
+
+    bool found_inside = false;
+    for (const MouseRayHit &hit : _mouseRayHits)
+    {
+        if (hit.Canvas == this)
+        {
+            canvas_pos = hit.Position;
+            nearest = hit.Inside && !found_inside;
+            return true;
+        }
+        found_inside |= hit.Inside;
+    }
+
+    nearest = false;
+    return false;
+}
+
+void Fudget::UpdateMouseRayHits(Float2 screen_pos)
+{
+    if (_mouseRayValid && _mouseRayFrame == Engine::FrameCount && _mouseRayPos == screen_pos)
+        return;
+
+    _mouseRayValid = true;
+    _mouseRayFrame = Engine::FrameCount;
+    _mouseRayPos = screen_pos;
+    _mouseRayHits.Clear();
+
+    Ray ray;
+    if (CalculateRay.IsBinded())
+        CalculateRay(screen_pos, ray);
+    else
+        DefaultCalculateRay(screen_pos, ray);
+
+    Float3 dir = ray.Direction;
+    for (Fudget *canvas : _canvases)
+    {
+        if (canvas->_renderMode == FudgetRenderMode::ScreenSpace || !canvas->GetReceivesEvents() || !canvas->IsActiveInHierarchy() ||
+            canvas->_guiRoot == nullptr)
+            continue;
+
+        // Without a camera the canvas is drawn as a screen space canvas, and it has no plane for the ray to hit.
+        if (canvas->_renderMode == FudgetRenderMode::CameraSpace && (Camera*)canvas->GetRenderCamera() == nullptr && Camera::GetMainCamera() == nullptr)
+        {
+#if USE_EDITOR
+            if (canvas->_editorTask == nullptr)
+#endif
+                continue;
+        }
+
+        // The matrix is relative to the ray's origin, so the plane is intersected with a ray starting at zero.
+        Matrix world;
+        canvas->GetWorldMatrix(ray.Position, world);
+        Float3 normal = Float3::Normalize(Float3(world.M31, world.M32, world.M33));
+        Float3 plane_pos = Float3(world.M41, world.M42, world.M43);
+
+        float denom = Float3::Dot(dir, normal);
+        if (Math::IsZero(denom))
+            continue;
+        float distance = Float3::Dot(plane_pos, normal) / denom;
+        if (distance < 0.f)
+            continue;
+
+        Matrix inv_world;
+        Matrix::Invert(world, inv_world);
+        Float3 local;
+        Float3::Transform(dir * distance, inv_world, local);
+
+        MouseRayHit hit;
+        hit.Canvas = canvas;
+        hit.Distance = distance;
+        hit.Position = Float2(local.X, local.Y);
+        Int2 size = canvas->_guiRoot->GetSize();
+        hit.Inside = hit.Position.X >= 0.f && hit.Position.Y >= 0.f && hit.Position.X < size.X && hit.Position.Y < size.Y;
+
+        // There are few 3D canvases, so the hits are kept sorted by insertion.
+        int index = _mouseRayHits.Count();
+        while (index > 0 && _mouseRayHits[index - 1].Distance > distance)
+            --index;
+        _mouseRayHits.Insert(index, hit);
+    }
+}
+
 void Fudget::Setup()
 {
     if (_isLoading)
         return;
 
+    _world_matrix_valid = false;
     _guiRoot->FudgetInit();
 
     switch (_renderMode)
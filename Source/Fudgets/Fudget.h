@@ -17,6 +17,7 @@
 
 class Fudget;
 class FudgetGUIRoot;
+class FudgetDrawRecorder;
 
 /// <summary>
 /// The canvas rendering modes.
@@ -191,6 +192,20 @@ public:
     /// <param name="ray">The output ray in world-space.</param>
     static void DefaultCalculateRay(Float2 location, API_PARAM(Out) Ray& ray);
 
+    /// <summary>
+    /// Intersects the mouse ray at a screen position with the plane of this 3D canvas and converts the hit to the
+    /// coordinates of the canvas GUI. The ray is calculated with CalculateRay, or DefaultCalculateRay if nothing is
+    /// bound to it. Every 3D canvas is tested against the same ray once per frame and mouse position, and the results
+    /// are shared by the mouse events of all canvases in that frame. For screen space canvases the screen position is
+    /// returned unchanged.
+    /// </summary>
+    /// <param name="screen_pos">Position of the mouse on the screen</param>
+    /// <param name="canvas_pos">Receives the position of the hit in the canvas GUI's coordinates</param>
+    /// <param name="nearest">Receives whether the hit is inside the canvas and no other 3D canvas is hit closer to the camera</param>
+    /// <returns>Whether the ray hits the plane of the canvas in front of the camera</returns>
+    API_FUNCTION()
+    bool GetMouseRayHit(Float2 screen_pos, API_PARAM(Out) Float2 &canvas_pos, API_PARAM(Out) bool &nearest);
+
     /// <summary>
     /// Gets the canvas rendering mode.
     /// </summary>
@@ -321,8 +336,142 @@ public:
     FORCE_INLINE void SetDistance(float value)
     {
         _distance = value;
+        _world_matrix_valid = false;
+    }
+
+    /// <summary>
+    /// Gets whether the controls of a 3D canvas stop receiving updates while the canvas is outside the view of every
+    /// camera. Layout and drawing are always skipped for canvases out of view.
+    /// </summary>
+    API_PROPERTY(Attributes = "EditorOrder(70), EditorDisplay(\"Canvas\"), VisibleIf(\"Editor_Is3D\"), Tooltip(\"If checked, the controls of the canvas don't receive updates while the canvas is out of view.\")")
+    FORCE_INLINE bool GetCullOutOfView() const
+    {
+        return _cullOutOfView;
+    }
+
+    /// <summary>
+    /// Sets whether the controls of a 3D canvas stop receiving updates while the canvas is outside the view of every
+    /// camera. Layout and drawing are always skipped for canvases out of view.
+    /// </summary>
+    API_PROPERTY()
+    FORCE_INLINE void SetCullOutOfView(bool value)
+    {
+        _cullOutOfView = value;
+    }
+
+    /// <summary>
+    /// Gets the distance from the view beyond which a world space canvas is drawn into a cached texture, which is only
+    /// refreshed every LodRefreshInterval seconds. Zero disables the cache.
+    /// </summary>
+    API_PROPERTY(Attributes = "EditorOrder(71), Limit(0), EditorDisplay(\"Canvas\"), VisibleIf(\"Editor_IsWorldSpace\"), Tooltip(\"Distance from the view beyond which the canvas is drawn into a cached texture that is refreshed at a reduced rate. Zero disables the cache.\")")
+    FORCE_INLINE float GetLodDistance() const
+    {
+        return _lodDistance;
+    }
+
+    /// <summary>
+    /// Sets the distance from the view beyond which a world space canvas is drawn into a cached texture, which is only
+    /// refreshed every LodRefreshInterval seconds. Zero disables the cache.
+    /// </summary>
+    API_PROPERTY()
+    void SetLodDistance(float value);
+
+    /// <summary>
+    /// Gets the time in seconds between refreshes of the cached texture of a canvas farther than LodDistance.
+    /// </summary>
+    API_PROPERTY(Attributes = "EditorOrder(72), Limit(0), EditorDisplay(\"Canvas\"), VisibleIf(\"Editor_IsWorldSpace\"), Tooltip(\"Time in seconds between refreshes of the cached texture of a distant canvas.\")")
+    FORCE_INLINE float GetLodRefreshInterval() const
+    {
+        return _lodRefreshInterval;
+    }
+
+    /// <summary>
+    /// Sets the time in seconds between refreshes of the cached texture of a canvas farther than LodDistance.
+    /// </summary>
+    API_PROPERTY()
+    FORCE_INLINE void SetLodRefreshInterval(float value)
+    {
+        _lodRefreshInterval = Math::Max(0.f, value);
+    }
+
+    /// <summary>
+    /// Gets whether the draw commands of the canvas are recorded and reordered each frame to be drawn in fewer batches.
+    /// Commands are only reordered if the result looks the same, but recording them has a cost of its own.
+    /// </summary>
+    API_PROPERTY(Attributes = "EditorOrder(73), EditorDisplay(\"Canvas\"), Tooltip(\"If checked, draw commands of the canvas are reordered to be drawn in fewer batches where the result looks the same.\")")
+    FORCE_INLINE bool GetBatchDraws() const
+    {
+        return _batchDraws;
+    }
+
+    /// <summary>
+    /// Sets whether the draw commands of the canvas are recorded and reordered each frame to be drawn in fewer batches.
+    /// Commands are only reordered if the result looks the same, but recording them has a cost of its own.
+    /// </summary>
+    API_PROPERTY()
+    void SetBatchDraws(bool value);
+
+    /// <summary>
+    /// Gets the number of batches the canvas was drawn in the last time BatchDraws reordered its commands, before the
+    /// reordering.
+    /// </summary>
+    API_PROPERTY()
+    FORCE_INLINE int GetBatchesBeforeReorder() const
+    {
+        return _batchesBeforeReorder;
+    }
+
+    /// <summary>
+    /// Gets the number of batches the canvas was drawn in the last time BatchDraws reordered its commands.
+    /// </summary>
+    API_PROPERTY()
+    FORCE_INLINE int GetBatchesAfterReorder() const
+    {
+        return _batchesAfterReorder;
     }
 
+    /// <summary>
+    /// Gets the CPU time in seconds spent on the layout, drawing and control updates of this canvas in the last frame.
+    /// </summary>
+    API_PROPERTY()
+    double GetLastFrameCpuTime() const;
+
+    /// <summary>
+    /// Gets the CPU time in seconds spent on the layout, drawing and control updates of this canvas since the counters
+    /// were last reset.
+    /// </summary>
+    API_PROPERTY()
+    FORCE_INLINE double GetTotalCpuTime() const
+    {
+        return _totalCpuTime;
+    }
+
+    /// <summary>
+    /// Gets the number of times the canvas was drawn from its cached texture instead of being laid out and drawn,
+    /// since the counters were last reset.
+    /// </summary>
+    API_PROPERTY()
+    FORCE_INLINE int64 GetCachedFrameCount() const
+    {
+        return _cachedFrameCount;
+    }
+
+    /// <summary>
+    /// Gets the number of control update ticks skipped because the canvas was out of view, since the counters were
+    /// last reset.
+    /// </summary>
+    API_PROPERTY()
+    FORCE_INLINE int64 GetSkippedUpdateCount() const
+    {
+        return _skippedUpdateCount;
+    }
+
+    /// <summary>
+    /// Resets the CPU time and the cached frame and skipped update counters.
+    /// </summary>
+    API_FUNCTION()
+    void ResetCpuCounters();
+
     /// <summary>
     /// Gets the canvas GUI root control.
     /// </summary>
@@ -454,6 +603,39 @@ private:
 
     /*internal*/ void PostDeserialize();
 
+    // Whether the canvas wasn't in view in the last frames and its controls shouldn't be updated. Counts the skipped
+    // update when it returns true.
+    /*internal*/ bool SkipControlUpdates();
+    // Adds time spent on the canvas to the CPU time counters.
+    /*internal*/ void AddCpuTime(double seconds);
+    // Draws the canvas from the cached texture, refreshing the texture first if its refresh interval passed.
+    /*internal*/ void DrawCachedGUI(GPUContext *context, GPUTexture *output);
+    // Deletes the cached texture used for distant canvases.
+    /*internal*/ void ReleaseLodTarget();
+
+    // Intersection of the mouse ray with the plane of a 3D canvas.
+    struct MouseRayHit
+    {
+        Fudget *Canvas;
+        // Distance along the ray.
+        float Distance;
+        // Position in the canvas GUI's coordinates.
+        Float2 Position;
+        // Whether the position is inside the GUI root.
+        bool Inside;
+    };
+
+    // Intersects the mouse ray with every 3D canvas, unless it was done for the same position in the current frame.
+    static void UpdateMouseRayHits(Float2 screen_pos);
+
+    // Every canvas that was created and not disposed yet.
+    static Array<Fudget*> _canvases;
+    // Results of the last UpdateMouseRayHits sorted by distance.
+    static Array<MouseRayHit> _mouseRayHits;
+    static Float2 _mouseRayPos;
+    static uint64 _mouseRayFrame;
+    static bool _mouseRayValid;
+
 
 #if USE_EDITOR
     SceneRenderTask *_editorTask = nullptr;
@@ -507,8 +689,73 @@ private:
 
     mutable Float2 _saved_size = Float2(500.f);
 
+    bool _cullOutOfView = true;
+    float _lodDistance = 0.f;
+    float _lodRefreshInterval = 0.25f;
+    // Value of Engine::FrameCount when the canvas was last found inside the view frustum of a render.
+    uint64 _lastInViewFrame = 0;
+    // Render target holding the last drawing of a canvas farther than _lodDistance.
+    GPUTexture *_lodTarget = nullptr;
+    bool _lodTargetValid = false;
+    double _lodLastRefresh = 0.0;
+
+    bool _batchDraws = false;
+    // Records the draw commands of the canvas to reorder them when _batchDraws is set.
+    mutable FudgetDrawRecorder *_drawRecorder = nullptr;
+    mutable int _batchesBeforeReorder = 0;
+    mutable int _batchesAfterReorder = 0;
+
+    // Frame the _cpuFrameTime is counted for.
+    uint64 _cpuFrame = 0;
+    double _cpuFrameTime = 0.0;
+    double _lastCpuFrameTime = 0.0;
+    double _totalCpuTime = 0.0;
+    int64 _cachedFrameCount = 0;
+    int64 _skippedUpdateCount = 0;
+
+    // Camera and projection values that decide the size of the canvas in camera space.
+    struct CameraProjectionState
+    {
+        Camera *RenderCamera = nullptr;
+        bool UsePerspective = false;
+        float FieldOfView = 0.f;
+        float NearPlane = 0.f;
+        float FarPlane = 0.f;
+        float OrthographicScale = 0.f;
+        float CustomAspectRatio = 0.f;
+        Float2 ViewportSize = Float2::Zero;
+        float Distance = 0.f;
+
+        bool operator==(const CameraProjectionState &other) const;
+        bool operator!=(const CameraProjectionState &other) const { return !(*this == other); }
+    };
+
+    // Every value the world matrix is computed from. The matrix is only recomputed when one of these changes.
+    struct WorldMatrixState
+    {
+        FudgetRenderMode Mode = FudgetRenderMode::ScreenSpace;
+        CameraProjectionState Projection;
+        Transform CameraTransform = Transform::Identity;
+        Transform ActorTransform = Transform::Identity;
+        Float2 RootSize = Float2::Zero;
+
+        bool operator==(const WorldMatrixState &other) const;
+    };
+
+    // Recomputes the world matrix and the size of the canvas in camera space if the camera, the projection or the
+    // transform of the canvas changed since the last call.
+    void UpdateWorldMatrixCache(Camera *camera) const;
+
+    mutable WorldMatrixState _world_matrix_state;
+    mutable bool _world_matrix_valid = false;
+    // World matrix computed relative to _world_matrix_origin, which is the canvas position in world space or the
+    // camera position in camera space. The translation is kept apart so large world positions keep their precision.
+    mutable Matrix _world_matrix = Matrix::Identity;
+    mutable Vector3 _world_matrix_origin = Vector3::Zero;
+
 
     friend class FudgetInitializer;
+    friend class FudgetGUIRoot;
     friend class FudgetRenderer;
     friend class FudgetRenderer2D;
 
@@ -6,6 +6,7 @@
 
 #include "Engine/Level/Scene/Scene.h"
 #include "Engine/Engine/Time.h"
+#include "Engine/Engine/Engine.h"
 #include "Engine/Input/Input.h"
 #include "Engine/Engine/Screen.h"
 #include "Engine/Scripting/Scripting.h"
@@ -28,16 +29,22 @@ FudgetGUIRoot::FudgetGUIRoot(Fudget* root) : FudgetGUIRoot(SpawnParams(Guid::New
 
 FudgetGUIRoot::FudgetGUIRoot(const SpawnParams &params, Fudget *root) : Base(params),
 	events_initialized(false), _root(root), _window((WindowBase*)Screen::GetMainWindow()), _on_top_count(0),
-	_mouse_capture_control(nullptr), _mouse_capture_button(), _mouse_over_control(nullptr), _auto_mouse_capture(false),
-	_focus_control(nullptr), _processing_updates(false)
+	_mouse_capture_control(nullptr), _mouse_capture_button(), _mouse_over_control(nullptr), _canvas_mouse_pos(Float2::Zero), _mouse_move_pending(false),
+	_hover_bounds(), _hover_cached(false), _hover_version(0), _hit_test_version(0), _auto_mouse_capture(false),
+	_focus_control(nullptr), _update_clock(0.0), _update_ticking(false), _navigation(nullptr), _processing_updates(false),
+	_layout_tree_changes(0), _layout_last_tree_changes(-1), _layout_steady_peak(0), _layout_depth(0)
 {
 	_guiRoot = this;
+	_navigation = New<FudgetNavigationIndex>(this);
 }
 
 FudgetGUIRoot::~FudgetGUIRoot()
 {
 	UninitializeEvents();
 	UnregisterControlUpdates();
+
+	Delete(_navigation);
+	_navigation = nullptr;
 }
 
 void FudgetGUIRoot::FudgetInit()
@@ -120,6 +127,29 @@ bool FudgetGUIRoot::MoveChildToIndex(int from, int to)
 	return Base::MoveChildToIndex(from, to);
 }
 
+void FudgetGUIRoot::ReplaceChildren(const Span<FudgetControl*> &controls, bool delete_removed)
+{
+	Array<FudgetControl*> ordered(controls.Length());
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (int ix = 0, siz = controls.Length(); ix < siz; ++ix)
+		{
+			FudgetControl *control = controls[ix];
+			if (control == nullptr)
+				continue;
+
+			FudgetControlFlag flags = control->_flags;
+			if ((flags & FudgetControlFlag::ResetFlags) == FudgetControlFlag::ResetFlags)
+				flags = control->GetInitFlags();
+			bool on_top = (flags & FudgetControlFlag::AlwaysOnTop) == FudgetControlFlag::AlwaysOnTop;
+			if (on_top == (pass == 1))
+				ordered.Add(control);
+		}
+	}
+
+	Base::ReplaceChildren(Span<FudgetControl*>(ordered.Get(), ordered.Count()), delete_removed);
+}
+
 int FudgetGUIRoot::FudgetGUIRoot::ChangeControlAlwaysOnTop(FudgetControl *control, bool set_always_on_top, int index)
 {
 	if (control == nullptr || control->_parent != this || control->HasAnyFlag(FudgetControlFlag::AlwaysOnTop) == set_always_on_top)
@@ -127,14 +157,14 @@ int FudgetGUIRoot::FudgetGUIRoot::ChangeControlAlwaysOnTop(FudgetControl *contro
 	int cnt = !set_always_on_top ? GetChildCount() - _on_top_count : _on_top_count;
 	if (index < 0 || index > cnt)
 		index = cnt;
-	int from = control->_index;
+	int from = ChildIndex(control);
 	int to;
 	if (!set_always_on_top)
 		to = index;
 	else
 		to = GetChildCount() - 1 - _on_top_count + index;
 
-	int new_index = from != to ? Base::MoveChildToIndex(from, to) : control->_index;
+	int new_index = from != to ? Base::MoveChildToIndex(from, to) : from;
 	if (new_index != -1)
 	{
 		if (set_always_on_top)
@@ -271,6 +301,35 @@ void FudgetGUIRoot::UpdateCursor(FudgetControl *control)
 		_window->SetCursor(cursor);
 }
 
+void FudgetGUIRoot::ReleaseControlInput(FudgetControl *control)
+{
+	if (control == nullptr)
+		return;
+
+	auto is_inside = [control](FudgetControl *c) {
+		for (; c != nullptr; c = c->GetParent())
+		{
+			if (c == control)
+				return true;
+		}
+		return false;
+	};
+
+	if (is_inside(_mouse_capture_control))
+		ReleaseMouseCapture();
+	if (is_inside(_focus_control))
+		SetFocusedControl(nullptr);
+	if (is_inside(_mouse_over_control))
+	{
+		FudgetControl *old_mouse_control = _mouse_over_control;
+		// Make sure the control can check that no control has the mouse
+		_mouse_over_control = nullptr;
+		_hover_cached = false;
+		old_mouse_control->DoMouseLeave();
+		UpdateCursor(_mouse_over_control);
+	}
+}
+
 bool FudgetGUIRoot::RegisterControlUpdate(FudgetControl *control, bool value)
 {
 	if (control == nullptr)
@@ -293,16 +352,19 @@ bool FudgetGUIRoot::RegisterControlUpdate(FudgetControl *control, bool value)
 
 	if (value)
 	{
-		_updating_controls.Add(control);
-		if (_updating_controls.Count() == 1)
-			scene->Ticking.Update.AddTick<FudgetGUIRoot, &FudgetGUIRoot::ControlUpdates>(this);
+		if (control->_update_interval <= 0.0f)
+			_updating_controls.Add(control);
+		else if (control->_update_timer_index == -1)
+			PushUpdateTimer(control, _update_clock + control->_update_interval, _update_clock);
 	}
 	else
 	{
-		_updating_controls.Remove(control);
-		if (_updating_controls.Count() == 0)
-			scene->Ticking.Update.RemoveTick(this);
+		if (control->_update_interval <= 0.0f)
+			_updating_controls.Remove(control);
+		else if (control->_update_timer_index != -1)
+			RemoveUpdateTimer(control->_update_timer_index);
 	}
+	UpdateTickRegistration();
 
 	return true;
 }
@@ -322,20 +384,164 @@ void FudgetGUIRoot::DelayRegisterControlUpdate(FudgetControl *control, bool valu
 		_controls_to_remove_from_updating.Add(control);
 }
 
+bool FudgetGUIRoot::ScheduleControlUpdate(FudgetControl *control, float delay)
+{
+	if (control == nullptr || control->GetGUIRoot() != this || _root == nullptr || _root->GetScene() == nullptr)
+		return false;
+
+	if (control->_update_timer_index != -1)
+		RemoveUpdateTimer(control->_update_timer_index);
+
+	double due_time = _update_clock + Math::Max(delay, 0.0f);
+	// Timers expire in ControlUpdates while their time is not in the future. A control rescheduling itself during updates
+	// with no delay would be updated again in the same tick without this.
+	if (_processing_updates && due_time <= _update_clock)
+		due_time = _update_clock + ZeroTolerance;
+	PushUpdateTimer(control, due_time, _update_clock);
+
+	if (!_processing_updates)
+		UpdateTickRegistration();
+	return true;
+}
+
+void FudgetGUIRoot::CancelControlUpdate(FudgetControl *control)
+{
+	if (control == nullptr || control->_update_timer_index == -1)
+		return;
+	RemoveUpdateTimer(control->_update_timer_index);
+	if (!_processing_updates)
+		UpdateTickRegistration();
+}
+
+void FudgetGUIRoot::MoveControlUpdateGroup(FudgetControl *control, float old_interval)
+{
+	if (control == nullptr || !control->IsUpdateRegistered())
+		return;
+
+	if (!_processing_updates)
+	{
+		DoMoveControlUpdateGroup(control, old_interval);
+		UpdateTickRegistration();
+		return;
+	}
+
+	// The control is still in the group of the interval it had before its first change in this update.
+	for (const UpdateGroupMove &move : _controls_to_move_in_updating)
+	{
+		if (move.Control == control)
+			return;
+	}
+	_controls_to_move_in_updating.Add({ control, old_interval });
+}
+
+void FudgetGUIRoot::DoMoveControlUpdateGroup(FudgetControl *control, float old_interval)
+{
+	if ((old_interval <= 0.0f) == (control->_update_interval <= 0.0f))
+		return;
+
+	if (old_interval <= 0.0f)
+		_updating_controls.Remove(control);
+	else if (control->_update_timer_index != -1)
+		RemoveUpdateTimer(control->_update_timer_index);
+
+	if (control->_update_interval <= 0.0f)
+		_updating_controls.Add(control);
+	else if (control->_update_timer_index == -1)
+		PushUpdateTimer(control, _update_clock + control->_update_interval, _update_clock);
+}
+
+void FudgetGUIRoot::ControlUpdateDestroyed(FudgetControl *control)
+{
+	if (!_processing_updates)
+		return;
+
+	// The list is being iterated, so the control is only cleared from it, and the empty items are removed after the update.
+	for (int ix = 0, siz = _updating_controls.Count(); ix < siz; ++ix)
+	{
+		if (_updating_controls[ix] == control)
+			_updating_controls[ix] = nullptr;
+	}
+	_controls_to_add_to_updating.Remove(control);
+	_controls_to_remove_from_updating.Remove(control);
+	for (int ix = _controls_to_move_in_updating.Count() - 1; ix >= 0; --ix)
+	{
+		if (_controls_to_move_in_updating[ix].Control == control)
+			_controls_to_move_in_updating.RemoveAt(ix);
+	}
+}
+
 void FudgetGUIRoot::UnregisterControlUpdates()
 {
 	_controls_to_add_to_updating.Clear();
 	_controls_to_remove_from_updating.Clear();
+	_controls_to_move_in_updating.Clear();
 	Array<FudgetControl*> tmp = _updating_controls;
 	for (FudgetControl *c : tmp)
 		c->RegisterToUpdate(false);
+
+	for (const UpdateTimer &timer : _update_timers)
+	{
+		timer.Control->_update_timer_index = -1;
+		if (timer.Control->IsUpdateRegistered())
+			timer.Control->SetState(FudgetControlState::Updating, false);
+	}
+	_update_timers.Clear();
+	UpdateTickRegistration();
 }
 
 bool FudgetGUIRoot::IsNavigationKey(KeyboardKeys key) const
+{
+	FudgetNavigationDirection direction;
+	return GetNavigationDirection(key, direction);
+}
+
+bool FudgetGUIRoot::GetNavigationDirection(KeyboardKeys key, API_PARAM(Out) FudgetNavigationDirection &direction) const
 {
 	// TODO: use the current input mapping instead of built in arrow keys
 
-	return key == KeyboardKeys::ArrowLeft || key == KeyboardKeys::ArrowRight || key == KeyboardKeys::ArrowUp || key == KeyboardKeys::ArrowDown || key == KeyboardKeys::Tab;
+	switch (key)
+	{
+		case KeyboardKeys::ArrowLeft:
+			direction = FudgetNavigationDirection::Left;
+			return true;
+		case KeyboardKeys::ArrowRight:
+			direction = FudgetNavigationDirection::Right;
+			return true;
+		case KeyboardKeys::ArrowUp:
+			direction = FudgetNavigationDirection::Up;
+			return true;
+		case KeyboardKeys::ArrowDown:
+			direction = FudgetNavigationDirection::Down;
+			return true;
+		case KeyboardKeys::Tab:
+			direction = Input::GetKey(KeyboardKeys::Shift) ? FudgetNavigationDirection::Previous : FudgetNavigationDirection::Next;
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool FudgetGUIRoot::Navigate(FudgetNavigationDirection direction)
+{
+	FudgetControl *target = FindNavigationTarget(_focus_control, direction);
+	if (target == nullptr || target == _focus_control)
+		return false;
+	target->SetFocused(true);
+	return _focus_control == target;
+}
+
+FudgetControl* FudgetGUIRoot::FindNavigationTarget(FudgetControl *from, FudgetNavigationDirection direction)
+{
+	if (_navigation == nullptr)
+		return nullptr;
+	return _navigation->FindTarget(from, direction);
+}
+
+void FudgetGUIRoot::NavigateWithKey(KeyboardKeys key)
+{
+	FudgetNavigationDirection direction;
+	if (GetNavigationDirection(key, direction))
+		Navigate(direction);
 }
 
 void FudgetGUIRoot::OnResized(Int2 new_size)
@@ -347,7 +553,37 @@ void FudgetGUIRoot::OnResized(Int2 new_size)
 
 void FudgetGUIRoot::DoLayout()
 {
+	// Controls can call DoLayout while a layout is in progress, for example from LocalToGlobal or GetSize. The
+	// outer layouts are still using their scratch memory, so only the outermost call checks and resets it.
+	if (_layout_depth > 0)
+	{
+		++_layout_depth;
+		RequestLayout();
+		--_layout_depth;
+		return;
+	}
+
+#if BUILD_DEBUG
+	int64 tree_changes = _layout_tree_changes;
+	int64 allocations = _layout_arena.GetHeapAllocations();
+#endif
+
+	++_layout_depth;
 	RequestLayout();
+	--_layout_depth;
+
+#if BUILD_DEBUG
+	// In a steady state the tree didn't change since the last pass, so no slot lists were reallocated. The scratch
+	// memory was merged into a block that fits the earlier passes, so a pass that needs no more than those mustn't
+	// allocate new scratch blocks either. Allocations outside the scratch arena are not tracked.
+	bool steady = tree_changes == _layout_last_tree_changes && _layout_tree_changes == tree_changes;
+	int peak = _layout_arena.GetPeakUsage();
+	ASSERT(!steady || peak > _layout_steady_peak || _layout_arena.GetHeapAllocations() == allocations);
+	_layout_steady_peak = steady ? Math::Max(_layout_steady_peak, peak) : peak;
+	_layout_last_tree_changes = _layout_tree_changes;
+#endif
+
+	_layout_arena.Reset();
 }
 
 void FudgetGUIRoot::InitializeEvents()
@@ -358,13 +594,15 @@ void FudgetGUIRoot::InitializeEvents()
 	Input::MouseDoubleClick.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseDoubleClick>(this);
 	Input::MouseDown.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseDown>(this);
 	Input::MouseUp.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseUp>(this);
-	Input::MouseMove.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseMove>(this);
+	Input::MouseMove.Bind<FudgetGUIRoot, &FudgetGUIRoot::QueueMouseMove>(this);
 	Input::MouseLeave.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseLeave>(this);
 
 	Input::CharInput.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleCharInput>(this);
 	Input::KeyDown.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleKeyDown>(this);
 	Input::KeyUp.Bind<FudgetGUIRoot, &FudgetGUIRoot::HandleKeyUp>(this);
 
+	Engine::LateUpdate.Bind<FudgetGUIRoot, &FudgetGUIRoot::FlushMouseMove>(this);
+
 	events_initialized = true;
 }
 
@@ -376,32 +614,158 @@ void FudgetGUIRoot::UninitializeEvents()
 	Input::MouseDoubleClick.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseDoubleClick>(this);
 	Input::MouseDown.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseDown>(this);
 	Input::MouseUp.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseUp>(this);
-	Input::MouseMove.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseMove>(this);
+	Input::MouseMove.Unbind<FudgetGUIRoot, &FudgetGUIRoot::QueueMouseMove>(this);
 	Input::MouseLeave.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleMouseLeave>(this);
 
 	Input::CharInput.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleCharInput>(this);
 	Input::KeyDown.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleKeyDown>(this);
 	Input::KeyUp.Unbind<FudgetGUIRoot, &FudgetGUIRoot::HandleKeyUp>(this);
 
+	Engine::LateUpdate.Unbind<FudgetGUIRoot, &FudgetGUIRoot::FlushMouseMove>(this);
+	_mouse_move_pending = false;
+
 	events_initialized = false;
 }
 
 void FudgetGUIRoot::ControlUpdates()
 {
+	// The timers aren't advanced either, so scheduled updates are delayed until the canvas is back in view.
+	if (_root != nullptr && _root->SkipControlUpdates())
+		return;
+
+	double start_time = Platform::GetTimeSeconds();
 	_processing_updates = true;
 	float time = Time::GetUnscaledDeltaTime();
-	for (FudgetControl *c : _updating_controls)
+	_update_clock += time;
+	for (int ix = 0; ix < _updating_controls.Count(); ++ix)
 	{
-		c->DoUpdate(time);
+		FudgetControl *c = _updating_controls[ix];
+		if (c != nullptr)
+			c->DoUpdate(time);
+	}
+
+	// Only the expired timers are looked at. Controls can schedule their next update from OnUpdate, which always
+	// goes after the current time, so the loop ends once the heap's top is in the future.
+	while (!_update_timers.IsEmpty() && _update_timers[0].DueTime <= _update_clock)
+	{
+		UpdateTimer timer = _update_timers[0];
+		RemoveUpdateTimer(0);
+
+		FudgetControl *c = timer.Control;
+		if (c->IsUpdateRegistered() && c->_update_interval > 0.0f)
+			PushUpdateTimer(c, _update_clock + c->_update_interval, _update_clock);
+		c->DoUpdate((float)(_update_clock - timer.StartTime));
 	}
 	_processing_updates = false;
 
+	for (int ix = _updating_controls.Count() - 1; ix >= 0; --ix)
+	{
+		if (_updating_controls[ix] == nullptr)
+			_updating_controls.RemoveAtKeepOrder(ix);
+	}
+	for (const UpdateGroupMove &move : _controls_to_move_in_updating)
+		DoMoveControlUpdateGroup(move.Control, move.OldInterval);
+	_controls_to_move_in_updating.Clear();
+
 	for (FudgetControl *c : _controls_to_add_to_updating)
 		c->RegisterToUpdate(true);
 	for (FudgetControl *c : _controls_to_remove_from_updating)
 		c->RegisterToUpdate(false);
 	_controls_to_add_to_updating.Clear();
 	_controls_to_remove_from_updating.Clear();
+
+	UpdateTickRegistration();
+
+	if (_root != nullptr)
+		_root->AddCpuTime(Platform::GetTimeSeconds() - start_time);
+}
+
+bool FudgetGUIRoot::UpdateTickRegistration()
+{
+	bool needs_tick = !_updating_controls.IsEmpty() || !_update_timers.IsEmpty();
+	if (needs_tick == _update_ticking)
+		return true;
+
+	if (_root == nullptr)
+		return false;
+	auto scene = _root->GetScene();
+	if (scene == nullptr)
+		return false;
+
+	if (needs_tick)
+		scene->Ticking.Update.AddTick<FudgetGUIRoot, &FudgetGUIRoot::ControlUpdates>(this);
+	else
+		scene->Ticking.Update.RemoveTick(this);
+	_update_ticking = needs_tick;
+	return true;
+}
+
+void FudgetGUIRoot::PushUpdateTimer(FudgetControl *control, double due_time, double start_time)
+{
+	UpdateTimer timer;
+	timer.DueTime = due_time;
+	timer.StartTime = start_time;
+	timer.Control = control;
+	_update_timers.Add(timer);
+	control->_update_timer_index = _update_timers.Count() - 1;
+	SiftUpdateTimerUp(_update_timers.Count() - 1);
+}
+
+void FudgetGUIRoot::RemoveUpdateTimer(int index)
+{
+	_update_timers[index].Control->_update_timer_index = -1;
+	int last = _update_timers.Count() - 1;
+	if (index != last)
+	{
+		SetUpdateTimerAt(index, _update_timers[last]);
+		_update_timers.RemoveLast();
+		// The moved timer can belong both above or below its new position.
+		SiftUpdateTimerUp(index);
+		SiftUpdateTimerDown(_update_timers[index].Control->_update_timer_index);
+	}
+	else
+	{
+		_update_timers.RemoveLast();
+	}
+}
+
+void FudgetGUIRoot::SiftUpdateTimerUp(int index)
+{
+	UpdateTimer timer = _update_timers[index];
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (_update_timers[parent].DueTime <= timer.DueTime)
+			break;
+		SetUpdateTimerAt(index, _update_timers[parent]);
+		index = parent;
+	}
+	SetUpdateTimerAt(index, timer);
+}
+
+void FudgetGUIRoot::SiftUpdateTimerDown(int index)
+{
+	UpdateTimer timer = _update_timers[index];
+	int cnt = _update_timers.Count();
+	while (true)
+	{
+		int child = index * 2 + 1;
+		if (child >= cnt)
+			break;
+		if (child + 1 < cnt && _update_timers[child + 1].DueTime < _update_timers[child].DueTime)
+			++child;
+		if (timer.DueTime <= _update_timers[child].DueTime)
+			break;
+		SetUpdateTimerAt(index, _update_timers[child]);
+		index = child;
+	}
+	SetUpdateTimerAt(index, timer);
+}
+
+void FudgetGUIRoot::SetUpdateTimerAt(int index, const UpdateTimer &timer)
+{
+	_update_timers[index] = timer;
+	timer.Control->_update_timer_index = index;
 }
 
 FudgetMouseHookResult FudgetGUIRoot::ProcessLocalMouseHooks(HookProcessingType type, FudgetControl *control, Float2 pos, Float2 global_pos, MouseButton button, bool double_click)
@@ -433,19 +797,38 @@ FudgetMouseHookResult FudgetGUIRoot::ProcessLocalMouseHooks(HookProcessingType t
 	return result;
 }
 
-void FudgetGUIRoot::HandleMouseDown(const Float2 &__pos, MouseButton button)
+bool FudgetGUIRoot::GetCanvasMousePosition(const Float2 &screen_pos, Float2 &pos)
 {
-	DoHandleMouseDown(__pos, button, false);
+	if (_root == nullptr || _root->GetIs2D())
+	{
+		pos = screen_pos;
+		return true;
+	}
+
+	bool nearest = false;
+	_root->GetMouseRayHit(screen_pos, _canvas_mouse_pos, nearest);
+	pos = _canvas_mouse_pos;
+	return nearest || _mouse_capture_control != nullptr;
+}
+
+void FudgetGUIRoot::HandleMouseDown(const Float2 &screen_pos, MouseButton button)
+{
+	DoHandleMouseDown(screen_pos, button, false);
 }
 
-void FudgetGUIRoot::HandleMouseDoubleClick(const Float2 &__pos, MouseButton button)
+void FudgetGUIRoot::HandleMouseDoubleClick(const Float2 &screen_pos, MouseButton button)
 {
-	DoHandleMouseDown(__pos, button, true);
+	DoHandleMouseDown(screen_pos, button, true);
 }
 
-void FudgetGUIRoot::DoHandleMouseDown(const Float2 &__pos, MouseButton button, bool double_click)
+void FudgetGUIRoot::DoHandleMouseDown(const Float2 &screen_pos, MouseButton button, bool double_click)
 {
-	Float2 pos = Input::GetMousePosition();
+	// Controls must see the latest position before the button event.
+	FlushMouseMove();
+
+	Float2 pos;
+	if (!GetCanvasMousePosition(screen_pos, pos))
+		return;
 
 	if (!_global_mouse_hooks.IsEmpty())
 	{
@@ -516,7 +899,7 @@ void FudgetGUIRoot::DoHandleMouseDown(const Float2 &__pos, MouseButton button, b
 				if (result != FudgetInputResult::PassThrough || _mouse_capture_control != nullptr)
 				{
 					if (double_click)
-						HandleMouseMove(pos);
+						HandleMouseMove(screen_pos);
 					break;
 				}
 			}
@@ -526,9 +909,13 @@ void FudgetGUIRoot::DoHandleMouseDown(const Float2 &__pos, MouseButton button, b
 	}
 }
 
-void FudgetGUIRoot::HandleMouseUp(const Float2 &__pos, MouseButton button)
+void FudgetGUIRoot::HandleMouseUp(const Float2 &screen_pos, MouseButton button)
 {
-	Float2 pos = Input::GetMousePosition();
+	FlushMouseMove();
+
+	Float2 pos;
+	if (!GetCanvasMousePosition(screen_pos, pos))
+		return;
 
 	if (!_global_mouse_hooks.IsEmpty())
 	{
@@ -553,7 +940,7 @@ void FudgetGUIRoot::HandleMouseUp(const Float2 &__pos, MouseButton button)
 					(button == MouseButton::Right && _mouse_capture_control->HasAnyFlag(FudgetControlFlag::CaptureReleaseMouseRight))))
 					ReleaseMouseCapture();
 
-				HandleMouseMove(pos);
+				HandleMouseMove(screen_pos);
 			}
 		}
 		return;
@@ -579,7 +966,7 @@ void FudgetGUIRoot::HandleMouseUp(const Float2 &__pos, MouseButton button)
 
 				if (c->DoMouseUp(cpos, pos, button))
 				{
-					HandleMouseMove(pos);
+					HandleMouseMove(screen_pos);
 					break;
 				}
 			}
@@ -589,9 +976,16 @@ void FudgetGUIRoot::HandleMouseUp(const Float2 &__pos, MouseButton button)
 	}
 }
 
-void FudgetGUIRoot::HandleMouseMove(const Float2 &__pos)
+void FudgetGUIRoot::HandleMouseMove(const Float2 &screen_pos)
 {
-	Float2 pos = Input::GetMousePosition();
+	Float2 pos;
+	if (!GetCanvasMousePosition(screen_pos, pos))
+	{
+		// The mouse moved off this canvas or behind another one.
+		if (_mouse_over_control != nullptr)
+			HandleMouseLeave();
+		return;
+	}
 
 	if (!_global_mouse_hooks.IsEmpty())
 	{
@@ -611,6 +1005,22 @@ void FudgetGUIRoot::HandleMouseMove(const Float2 &__pos)
 		return;
 	}
 
+	// The mouse is still over the area of the hovered control that no other control covers, and nothing moved
+	// since. Local hooks might skip the control, so they need the full lookup.
+	if (_hover_cached && _mouse_over_control != nullptr && _hover_version == _hit_test_version && _local_mouse_hooks.IsEmpty() &&
+		_hover_bounds.Contains(pos))
+	{
+		FudgetControl *c = _mouse_over_control;
+		Float2 cpos = c->GlobalToLocal(pos);
+		if (c->WantsMouseEventAtPos(cpos, pos))
+		{
+			c->DoMouseMove(cpos, pos);
+			UpdateCursor(c);
+			return;
+		}
+	}
+	_hover_cached = false;
+
 	Array<FudgetControl*> controls_for_input;
 
 	ControlsAtPosition(pos, FudgetControlFlag::CanHandleMouseMove | FudgetControlFlag::BlockMouseEvents, FudgetControlFlag::None, FudgetControlFlag::CompoundControl,
@@ -658,6 +1068,12 @@ void FudgetGUIRoot::HandleMouseMove(const Float2 &__pos)
 				if (result == FudgetMouseHookResult::SkipControl)
 					continue;
 
+				if (_mouse_over_control == c)
+				{
+					_hover_cached = GetHoverCacheBounds(c, _hover_bounds);
+					_hover_version = _hit_test_version;
+				}
+
 				c->DoMouseMove(cpos, pos);
 				UpdateCursor(c);
 				return;
@@ -679,8 +1095,53 @@ void FudgetGUIRoot::HandleMouseMove(const Float2 &__pos)
 	UpdateCursor(_mouse_over_control);
 }
 
+void FudgetGUIRoot::QueueMouseMove(const Float2 &pos)
+{
+	FudgetControl *target = _mouse_capture_control != nullptr ? _mouse_capture_control : _mouse_over_control;
+	if (target != nullptr && target->HasAnyFlag(FudgetControlFlag::RawMouseMove))
+	{
+		_mouse_move_pending = false;
+		HandleMouseMove(pos);
+		return;
+	}
+	_mouse_move_pending = true;
+}
+
+void FudgetGUIRoot::FlushMouseMove()
+{
+	if (!_mouse_move_pending)
+		return;
+	_mouse_move_pending = false;
+	HandleMouseMove(Input::GetMousePosition());
+}
+
+bool FudgetGUIRoot::GetHoverCacheBounds(FudgetControl *control, Rectangle &bounds) const
+{
+	if (control->HasAnyFlag(FudgetControlFlag::ContainerControl) && dynamic_cast<FudgetContainer*>(control)->GetChildCount() != 0)
+		return false;
+
+	bounds = control->LocalToGlobal(control->GetBounds());
+	for (FudgetControl *current = control; current->GetParent() != nullptr; current = current->GetParent())
+	{
+		FudgetContainer *parent = current->GetParent();
+		bounds = Rectangle::Shared(bounds, parent->LocalToGlobal(parent->GetBounds()));
+
+		// Controls above the current one in the same parent could cover a part of the bounds.
+		for (int ix = current->GetIndexInParent() + 1, siz = parent->GetChildCount(); ix < siz; ++ix)
+		{
+			FudgetControl *sibling = parent->ChildAt(ix);
+			if (sibling->IsVisible() && sibling->LocalToGlobal(sibling->GetBounds()).Intersects(bounds))
+				return false;
+		}
+	}
+	return bounds.Size.X > 0.f && bounds.Size.Y > 0.f;
+}
+
 void FudgetGUIRoot::HandleMouseLeave()
 {
+	_mouse_move_pending = false;
+	_hover_cached = false;
+
 	if (!_global_mouse_hooks.IsEmpty())
 	{
 		for (int ix = 0, siz = _global_mouse_hooks.Count(); ix < siz; ++ix)
@@ -2,6 +2,8 @@
 
 #include "Container.h"
 #include "IFudgetMouseHook.h"
+#include "Utils/ScratchArena.h"
+#include "Utils/NavigationIndex.h"
 
 class WindowBase;
 
@@ -57,6 +59,14 @@ public:
     /// <returns>Returns whether the control's index was set to the target value</returns>
     bool MoveChildToIndex(int from, int to) override;
 
+    /// <summary>
+    /// Changes the child controls of the root to the passed controls. Controls with the AlwaysOnTop flag are
+    /// placed above the other controls, keeping their order otherwise.
+    /// </summary>
+    /// <param name="controls">The new child controls. Null values and duplicates are skipped</param>
+    /// <param name="delete_removed">Whether the old child controls that are not in the list should be deleted</param>
+    void ReplaceChildren(const Span<FudgetControl*> &controls, bool delete_removed = false) override;
+
     /// <summary>
     /// Changes a top-level control's always on top status, moving it from its old group to the index position
     /// in the new one. Set index to negative to place it above the rest of the group.
@@ -136,6 +146,13 @@ public:
     /// </summary>
     API_PROPERTY() FudgetControl* GetHoveredControl() const { return _mouse_over_control; }
 
+    /// <summary>
+    /// Releases the mouse capture, the keyboard focus and the hover from a control and its descendants, sending the
+    /// usual notifications. Called when a control is reset to be reused.
+    /// </summary>
+    /// <param name="control">The control to release the input from</param>
+    API_FUNCTION() void ReleaseControlInput(FudgetControl *control);
+
     /// <summary>
     /// When called for the hovered control, checks if the displayed cursor needs to be changed,
     /// and then changes it. Has no effect if the control doesn't have the mouse pointer.
@@ -143,6 +160,52 @@ public:
     /// <param name="control">Control to check for updated cursor</param>
     API_FUNCTION() void UpdateCursor(FudgetControl *control);
 
+    /// <summary>
+    /// Discards the cached bounds of the hovered control, so the next mouse move looks up the control under the
+    /// mouse again. Called when controls change position, size, visibility or order.
+    /// </summary>
+    API_FUNCTION() void InvalidateHitTestCache() { ++_hit_test_version; }
+
+    /// <summary>
+    /// Moves the keyboard focus from the focused control to the nearest focusable control in a direction. Controls
+    /// are focusable if they are visible, enabled, handle key events or get the focus on mouse clicks, and are not
+    /// parts of a compound control. If no control has the focus, the first control in reading order is focused.
+    /// </summary>
+    /// <param name="direction">Direction to move the focus in</param>
+    /// <returns>Whether the focus moved to another control</returns>
+    API_FUNCTION() bool Navigate(FudgetNavigationDirection direction);
+
+    /// <summary>
+    /// Finds the focusable control that navigation in a direction would move the focus to from a control, without
+    /// changing the focus.
+    /// </summary>
+    /// <param name="from">The control to start from, or null to get the first control in reading order</param>
+    /// <param name="direction">Direction to look in</param>
+    /// <returns>The control found or null if there's none in that direction</returns>
+    API_FUNCTION() FudgetControl* FindNavigationTarget(FudgetControl *from, FudgetNavigationDirection direction);
+
+    /// <summary>
+    /// Gets the navigation direction a key moves the focus in, if it's a navigation key.
+    /// </summary>
+    /// <param name="key">The key to check</param>
+    /// <param name="direction">Receives the direction</param>
+    /// <returns>Whether the key is used for navigation</returns>
+    API_FUNCTION() bool GetNavigationDirection(KeyboardKeys key, API_PARAM(Out) FudgetNavigationDirection &direction) const;
+
+    /// <summary>
+    /// Marks a control to be updated in the navigation index before the next navigation. Called when a control's
+    /// position, size, visibility, enabled state or parent changes.
+    /// </summary>
+    /// <param name="control">The control that changed</param>
+    void NavigationControlChanged(FudgetControl *control) { if (_navigation != nullptr) _navigation->MarkDirty(control); }
+
+    /// <summary>
+    /// Removes a control from the navigation index. Called when a control leaves the root's tree or is destroyed.
+    /// </summary>
+    /// <param name="control">The control to remove</param>
+    /// <param name="recursive">Whether to remove the control's descendants as well</param>
+    void NavigationControlRemoved(FudgetControl *control, bool recursive) { if (_navigation != nullptr) _navigation->Remove(control, recursive); }
+
     /// <summary>
     /// Registers or unregisters the control to receive the global update tick. Its OnUpdate will be called by the root.
     /// </summary>
@@ -161,7 +224,40 @@ public:
     API_FUNCTION() void DelayRegisterControlUpdate(FudgetControl *control, bool value);
 
     /// <summary>
-    /// Unregisters every control from receiving update ticks and removes self too.
+    /// Requests a single OnUpdate call for the control after the given time passed. Pending requests for the same control
+    /// are replaced. Scheduled updates are kept in a queue ordered by time, and only the controls with an expired timer
+    /// are updated. This function is safe to call during updates, even from the OnUpdate of the same control.
+    /// </summary>
+    /// <param name="control">The control to be updated</param>
+    /// <param name="delay">Time in seconds until the update</param>
+    /// <returns>Whether the update was scheduled</returns>
+    API_FUNCTION() bool ScheduleControlUpdate(FudgetControl *control, float delay);
+
+    /// <summary>
+    /// Removes the pending update of a control that was requested with ScheduleControlUpdate, or the next update of a
+    /// control registered with a non-zero update interval.
+    /// </summary>
+    /// <param name="control">The control with the pending update</param>
+    API_FUNCTION() void CancelControlUpdate(FudgetControl *control);
+
+    /// <summary>
+    /// Moves a registered control between the controls updated on every frame and the controls updated on an interval,
+    /// after its update interval changed. This function is safe to call during updates, as it will only move the
+    /// control when updating is done.
+    /// </summary>
+    /// <param name="control">The registered control with its new update interval already set</param>
+    /// <param name="old_interval">The update interval of the control before the change</param>
+    API_FUNCTION() void MoveControlUpdateGroup(FudgetControl *control, float old_interval);
+
+    /// <summary>
+    /// Removes every reference to a control that is being destroyed from the updated controls, including the changes
+    /// waiting for the current updates to end.
+    /// </summary>
+    /// <param name="control">The destroyed control</param>
+    void ControlUpdateDestroyed(FudgetControl *control);
+
+    /// <summary>
+    /// Unregisters every control from receiving update ticks and removes self too. Scheduled updates are cancelled as well.
     /// </summary>
     API_FUNCTION() void UnregisterControlUpdates();
 
@@ -183,6 +279,25 @@ public:
     /// </summary>
     API_FUNCTION() void DoLayout();
 
+    /// <summary>
+    /// Scratch memory for temporary arrays of layouts in this root's control tree. It is reset after each outermost
+    /// DoLayout call.
+    /// Only valid to use on the main thread.
+    /// </summary>
+    FudgetScratchArena* GetLayoutArena() { return &_layout_arena; }
+
+    /// <summary>
+    /// Number of heap allocations the layout scratch memory made since the root was created. In a steady state this
+    /// shouldn't change between layouts. Allocations made by layouts outside the scratch memory are not counted.
+    /// </summary>
+    API_PROPERTY() int64 GetLayoutHeapAllocations() const { return _layout_arena.GetHeapAllocations(); }
+
+    /// <summary>
+    /// Called by layouts when their slots change because controls were added, removed or moved. Passes after such a
+    /// change are not considered to be in a steady state, which is checked for heap allocations in debug builds.
+    /// </summary>
+    void LayoutTreeChanged() { ++_layout_tree_changes; }
+
     /// <summary>
     /// Callback event when the size of the GUI area changes
     /// </summary>
@@ -228,22 +343,64 @@ private:
 
     void ControlUpdates();
 
+    // Removes the control from the update group of old_interval and adds it to the group of its current interval.
+    void DoMoveControlUpdateGroup(FudgetControl *control, float old_interval);
+
+    // Adds or removes the tick on the scene, depending on whether there are controls to update.
+    bool UpdateTickRegistration();
+
+    // Pending OnUpdate call of a control in _update_timers.
+    struct UpdateTimer
+    {
+        // Value of _update_clock when the control should be updated.
+        double DueTime;
+        // Value of _update_clock when the timer was set. The control's delta time is calculated from this.
+        double StartTime;
+        FudgetControl *Control;
+    };
+
+    // Adds a timer to the _update_timers heap.
+    void PushUpdateTimer(FudgetControl *control, double due_time, double start_time);
+    // Removes the timer at index from the _update_timers heap.
+    void RemoveUpdateTimer(int index);
+    // Moves the timer at index up or down in the _update_timers heap to restore the heap order.
+    void SiftUpdateTimerUp(int index);
+    void SiftUpdateTimerDown(int index);
+    void SetUpdateTimerAt(int index, const UpdateTimer &timer);
+
     // Mouse and Touch input:
 
-    void HandleMouseDown(const Float2 &pos, MouseButton button);
-    void HandleMouseDoubleClick(const Float2 &pos, MouseButton button);
-    void DoHandleMouseDown(const Float2 &pos, MouseButton button, bool double_click);
-    void HandleMouseUp(const Float2 &pos, MouseButton button);
-    void HandleMouseMove(const Float2 &pos);
+    // The mouse handlers take the position of the event in screen coordinates, and map it to the root with
+    // GetCanvasMousePosition.
+    void HandleMouseDown(const Float2 &screen_pos, MouseButton button);
+    void HandleMouseDoubleClick(const Float2 &screen_pos, MouseButton button);
+    void DoHandleMouseDown(const Float2 &screen_pos, MouseButton button, bool double_click);
+    void HandleMouseUp(const Float2 &screen_pos, MouseButton button);
+    void HandleMouseMove(const Float2 &screen_pos);
     void HandleMouseLeave();
 
+    // Bound to the mouse move event. Moves are only noted and handled once per frame in FlushMouseMove, unless the
+    // hovered or capturing control wants raw mouse moves.
+    void QueueMouseMove(const Float2 &pos);
+    // Handles the mouse move queued since the last call at the current mouse position.
+    void FlushMouseMove();
+    // Gets the part of a hovered control's global bounds where mouse moves can't reach any other control. Returns
+    // false if this area can't be determined cheaply, for example because the control has children or overlapping
+    // siblings above it.
+    bool GetHoverCacheBounds(FudgetControl *control, Rectangle &bounds) const;
+
+    // Converts a mouse position on the screen to the coordinates of the root. For 3D canvases it's the hit of the
+    // mouse ray on the canvas. Returns false if the position is not over this canvas, or another 3D canvas is in
+    // front of it, unless a control captures the mouse.
+    bool GetCanvasMousePosition(const Float2 &screen_pos, Float2 &pos);
+
     void HandleKeyDown(KeyboardKeys key);
     void HandleKeyUp(KeyboardKeys key);
     void HandleCharInput(Char ch);
 
     FudgetControl* FindKeyboardInputControl(KeyboardKeys key) const;
 
-    void NavigateWithKey(KeyboardKeys key) const {}
+    void NavigateWithKey(KeyboardKeys key);
 
     // Used for checking if this class has initialized events with Input.
     bool events_initialized;
@@ -266,6 +423,18 @@ private:
     // The control currently (or last time it was checked) under the mouse pointer. It's not updated
     // if something has captured the mouse already.
     FudgetControl *_mouse_over_control;
+    // Last position of the mouse ray's hit on a 3D canvas. Used while the mouse is captured and the ray misses
+    // the plane of the canvas.
+    Float2 _canvas_mouse_pos;
+    // Whether a mouse move was received but not handled yet.
+    bool _mouse_move_pending;
+    // Area in global coordinates where mouse moves go to _mouse_over_control without looking up the controls under
+    // the mouse. Only valid while _hover_cached is true and _hover_version equals _hit_test_version.
+    Rectangle _hover_bounds;
+    bool _hover_cached;
+    uint64 _hover_version;
+    // Incremented whenever a change in the control tree can change the result of hit tests.
+    uint64 _hit_test_version;
     // Whether the _mouse_capture_control started capturing the mouse because it had the auto capture flag.
     // Only call the release automatically when this is true.
     bool _auto_mouse_capture;
@@ -281,12 +450,41 @@ private:
     // The keys that were pressed over the _focus_control but not released yet with OnKeyUp.
     HashSet<KeyboardKeys> _focus_control_keys;
 
-    // Controls whose OnUpdate should be called
+    // Controls whose OnUpdate should be called on every frame
     Array<FudgetControl*> _updating_controls;
+    // Binary min-heap of pending updates ordered by DueTime. Holds controls registered with a non-zero update interval
+    // and controls that requested a single update with ScheduleUpdate. Each control is in the heap at most once, and
+    // knows its position in _update_timer_index.
+    Array<UpdateTimer> _update_timers;
+    // Unscaled time in seconds accumulated in update ticks since the root started updating controls.
+    double _update_clock;
+    // Whether ControlUpdates was added to the scene's update ticks.
+    bool _update_ticking;
+    // Temporary memory used by layouts during DoLayout.
+    FudgetScratchArena _layout_arena;
+    // Number of changes to the slots of layouts in the tree.
+    int64 _layout_tree_changes;
+    // Value of _layout_tree_changes at the end of the last DoLayout.
+    int64 _layout_last_tree_changes;
+    // Largest scratch memory use of the passes since the tree last changed.
+    int _layout_steady_peak;
+    // Number of DoLayout calls in progress. Above 1 when a control started a layout during another.
+    int _layout_depth;
+    // Focusable controls by their global bounds, for finding the control to focus on navigation. Deleted before the
+    // child controls are destroyed, which then don't need to update it.
+    FudgetNavigationIndex *_navigation;
     // Will add these controls to _updating_controls after the update is done.
     Array<FudgetControl*> _controls_to_add_to_updating;
     // Will remove these controls from _updating_controls after the update is done.
     Array<FudgetControl*> _controls_to_remove_from_updating;
+    // Control whose update interval changed during the update, with its interval before the first change.
+    struct UpdateGroupMove
+    {
+        FudgetControl *Control;
+        float OldInterval;
+    };
+    // Will move these controls between _updating_controls and _update_timers after the update is done.
+    Array<UpdateGroupMove> _controls_to_move_in_updating;
     // Forwarding the OnUpdate call to controls. During this call, adding or removing from _updating_controls
     // should be avoided. It will log a warning if it happens.
     bool _processing_updates;
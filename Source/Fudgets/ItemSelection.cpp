@@ -1,8 +1,7 @@
 #include "ItemSelection.h"
-#include <algorithm>
 #include "Engine/Core/Math/Math.h"
 
-FudgetItemSelection::FudgetItemSelection(const SpawnParams &params) : Base(params), _size(0), _count(0)
+FudgetItemSelection::FudgetItemSelection(const SpawnParams &params) : Base(params), _size(0), _count(0), _root(-1), _seed(0x9E3779B9)
 {
 
 }
@@ -19,137 +18,106 @@ void FudgetItemSelection::SetSize(int value)
 
 void FudgetItemSelection::Clear()
 {
-    _blocks.clear();
+    _nodes.Clear();
+    _free.Clear();
+    _root = -1;
     _count = 0;
 }
 
 void FudgetItemSelection::SetSelected(int index, int count, bool select)
 {
-    std::vector<FudgetSelectionBlock>::iterator it;
+    int end = Math::Min(_size, index + count);
+    index = Math::Max(0, index);
+    if (end <= index)
+        return;
+
+    int left;
+    int middle;
+    int right;
     if (select)
     {
-        it = std::lower_bound(_blocks.begin(), _blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
-            return block._end < index;
-            });
+        // Runs touching the new range are merged with it.
+        Split(_root, [index](const Node &node) { return node.End < index; }, left, middle);
+        Split(middle, [end](const Node &node) { return node.Start <= end; }, middle, right);
 
-        if (it == _blocks.end() || it->_start > index + count)
+        int start = index;
+        if (middle != -1)
         {
-            FudgetSelectionBlock new_block;
-            new_block._start = index;
-            new_block._end = Math::Min(_size, index + count);
-            _blocks.insert(it, new_block);
-            _count += count;
-            return;
+            start = Math::Min(start, _nodes[First(middle)].Start);
+            end = Math::Max(end, _nodes[Last(middle)].End);
+            _count -= _nodes[middle].Selected;
+            FreeTree(middle);
         }
-
-        FudgetSelectionBlock &block = *it;
-        _count += (Math::Max(index + count, block._end) - Math::Min(block._start, index)) - (block._end - block._start);
-        block._start = Math::Min(index, block._start);
-        block._end = Math::Max(index + count, block._end);
-
-        ++it;
-        auto it2 = it;
-        while (it2 != _blocks.end())
-        {
-            FudgetSelectionBlock &block2 = *it2;
-            if (block2._end >= index + count)
-            {
-                if (block2._start <= index + count)
-                {
-                    _count -= index + count - block2._start;
-
-                    block._end = Math::Max(block._end, block2._end);
-                    ++it2;
-                }
-                break;
-            }
-            _count -= block2._end - block2._start;
-
-            ++it2;
-        }
-
-        _blocks.erase(it, it2);
+        _count += end - start;
+        _root = Merge(Merge(left, NewNode(start, end)), right);
         return;
     }
 
-    it = std::lower_bound(_blocks.begin(), _blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
-        return block._end <= index;
-        });
-
-    if (it == _blocks.end())
+    Split(_root, [index](const Node &node) { return node.End <= index; }, left, middle);
+    Split(middle, [end](const Node &node) { return node.Start < end; }, middle, right);
+    if (middle == -1)
+    {
+        _root = Merge(left, right);
         return;
+    }
 
-    FudgetSelectionBlock &block = *it;
-    if (block._start < index)
+    // Only the parts of the first and last runs outside the range stay selected.
+    int first_start = _nodes[First(middle)].Start;
+    int last_end = _nodes[Last(middle)].End;
+    _count -= _nodes[middle].Selected;
+    FreeTree(middle);
+
+    middle = -1;
+    if (first_start < index)
     {
-        ++it;
-        if (block._end > index + count)
-        {
-            _count -= count;
-            FudgetSelectionBlock new_block;
-            new_block._start = index + count;
-            new_block._end = block._end;
-            block._end = index;
-            _blocks.insert(it, new_block);
-            return;
-        }
-        _count -= block._end - index;
-        block._end = index;
+        middle = NewNode(first_start, index);
+        _count += index - first_start;
     }
-
-    auto it2 = it;
-    while (it2 < _blocks.end())
+    if (last_end > end)
     {
-        FudgetSelectionBlock &block2 = *it2;
-        if (block2._end > index + count)
-        {
-            if (block2._start < index + count)
-            {
-                _count -= index + count - block2._start;
-                block2._start = index + count;
-            }
-            break;
-        }
-        _count -= block2._end - block2._start;
-        ++it2;
+        middle = Merge(middle, NewNode(end, last_end));
+        _count += last_end - end;
     }
-
-    _blocks.erase(it, it2);
-
+    _root = Merge(Merge(left, middle), right);
 }
 
 bool FudgetItemSelection::IsSelected(int index) const
 {
-    auto it = std::lower_bound(_blocks.cbegin(), _blocks.cend(), index, [](const FudgetSelectionBlock &block, int index) {
-        return block._end <= index;
-        });
-
-    return it != _blocks.end() && it->_start <= index;
+    int offset = 0;
+    int node = _root;
+    while (node != -1)
+    {
+        const Node &n = _nodes[node];
+        if (index < n.Start + offset)
+            node = n.Left;
+        else if (index >= n.End + offset)
+            node = n.Right;
+        else
+            return true;
+        offset += n.Shift;
+    }
+    return false;
 }
 
 void FudgetItemSelection::ItemsInserted(int index, int count)
 {
     _size = Math::Max(_size + count, index + count);
-    auto it = std::lower_bound(_blocks.begin(), _blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
-        return block._end <= index;
-        });
-    if (it == _blocks.end())
+    if (count <= 0 || _root == -1)
         return;
 
-    FudgetSelectionBlock &block = *it;
-    for (auto it2 = block._start >= index ? it : std::next(it); it2 != _blocks.end(); ++it2)
+    int left;
+    int right;
+    Split(_root, [index](const Node &node) { return node.Start < index; }, left, right);
+    AddShift(right, count);
+
+    // A run containing the insertion point is cut in two, because the inserted items are not selected.
+    if (left != -1 && _nodes[Last(left)].End > index)
     {
-        it2->_start += count;
-        it2->_end += count;
+        FudgetSelectionBlock block = PopLast(left);
+        left = Merge(left, NewNode(block._start, index));
+        right = Merge(NewNode(index + count, block._end + count), right);
     }
-
-    if (block._start >= index)
-        return;
-    FudgetSelectionBlock new_block;
-    new_block._start = index + count;
-    new_block._end = block._end + count;
-    block._end = index;
-    _blocks.insert(std::next(it), new_block);
+    _root = Merge(left, right);
 }
 
 void FudgetItemSelection::ItemsRemoved(int index, int count)
@@ -166,38 +134,239 @@ void FudgetItemSelection::ItemsRemoved(int index, int count)
 
     _size = Math::Max(_size - count, index);
 
-    auto it = std::lower_bound(_blocks.begin(), _blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
-        return block._end < index;
-        });
-    if (it == _blocks.end())
+    int left;
+    int right;
+    Split(_root, [index](const Node &node) { return node.Start < index; }, left, right);
+    AddShift(right, -count);
+
+    // Runs on the two sides of the removed items are merged if they touch now.
+    if (left != -1 && right != -1 && _nodes[Last(left)].End == _nodes[First(right)].Start)
+    {
+        FudgetSelectionBlock before = PopLast(left);
+        FudgetSelectionBlock after = PopFirst(right);
+        left = Merge(left, NewNode(before._start, after._end));
+    }
+    _root = Merge(left, right);
+}
+
+Array<Int2> FudgetItemSelection::GetSelectedRanges() const
+{
+    Array<Int2> result;
+    for (RangeIterator it = IterateRanges(); it.IsValid(); it.Next())
+        result.Add(Int2(it.Get()._start, it.Get()._end));
+    return result;
+}
+
+int FudgetItemSelection::NewNode(int start, int end)
+{
+    // Xorshift random priorities keep the tree balanced.
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+
+    int index;
+    if (!_free.IsEmpty())
+        index = _free.Pop();
+    else
+    {
+        index = _nodes.Count();
+        _nodes.AddUninitialized(1);
+    }
+
+    Node &node = _nodes[index];
+    node.Start = start;
+    node.End = end;
+    node.Shift = 0;
+    node.Left = -1;
+    node.Right = -1;
+    node.Priority = _seed;
+    node.Selected = end - start;
+    return index;
+}
+
+void FudgetItemSelection::FreeTree(int node)
+{
+    if (node == -1)
+        return;
+    FreeTree(_nodes[node].Left);
+    FreeTree(_nodes[node].Right);
+    _free.Add(node);
+}
+
+void FudgetItemSelection::AddShift(int node, int delta)
+{
+    if (node == -1 || delta == 0)
+        return;
+    Node &n = _nodes[node];
+    n.Start += delta;
+    n.End += delta;
+    n.Shift += delta;
+}
+
+void FudgetItemSelection::Push(int node)
+{
+    Node &n = _nodes[node];
+    if (n.Shift == 0)
+        return;
+    AddShift(n.Left, n.Shift);
+    AddShift(n.Right, n.Shift);
+    n.Shift = 0;
+}
+
+void FudgetItemSelection::Update(int node)
+{
+    Node &n = _nodes[node];
+    n.Selected = n.End - n.Start;
+    if (n.Left != -1)
+        n.Selected += _nodes[n.Left].Selected;
+    if (n.Right != -1)
+        n.Selected += _nodes[n.Right].Selected;
+}
+
+int FudgetItemSelection::Merge(int left, int right)
+{
+    if (left == -1)
+        return right;
+    if (right == -1)
+        return left;
+
+    if (_nodes[left].Priority > _nodes[right].Priority)
+    {
+        Push(left);
+        int merged = Merge(_nodes[left].Right, right);
+        _nodes[left].Right = merged;
+        Update(left);
+        return left;
+    }
+
+    Push(right);
+    int merged = Merge(left, _nodes[right].Left);
+    _nodes[right].Left = merged;
+    Update(right);
+    return right;
+}
+
+template<typename Pred>
+void FudgetItemSelection::Split(int node, const Pred &in_left, int &left, int &right)
+{
+    if (node == -1)
+    {
+        left = -1;
+        right = -1;
         return;
+    }
 
-    FudgetSelectionBlock &block = *it;
-    bool remove_block = false;
+    Push(node);
+    if (in_left(_nodes[node]))
+    {
+        int split_left;
+        Split(_nodes[node].Right, in_left, split_left, right);
+        _nodes[node].Right = split_left;
+        left = node;
+    }
+    else
+    {
+        int split_right;
+        Split(_nodes[node].Left, in_left, left, split_right);
+        _nodes[node].Left = split_right;
+        right = node;
+    }
+    Update(node);
+}
 
-    if (block._end == index)
+int FudgetItemSelection::First(int node)
+{
+    Push(node);
+    while (_nodes[node].Left != -1)
     {
-        ++it;
-        if (it != _blocks.end())
-        {
-            const FudgetSelectionBlock &block2 = *it;
-            if (block2._start == index + count)
-            {
-                block._end = block2._end - count;
-                remove_block = true;
-            }
-        }
+        node = _nodes[node].Left;
+        Push(node);
+    }
+    return node;
+}
+
+int FudgetItemSelection::Last(int node)
+{
+    Push(node);
+    while (_nodes[node].Right != -1)
+    {
+        node = _nodes[node].Right;
+        Push(node);
     }
+    return node;
+}
 
-    auto it2 = it;
-    while (it2 != _blocks.end())
+FudgetSelectionBlock FudgetItemSelection::PopFirst(int &node)
+{
+    Push(node);
+    Node &n = _nodes[node];
+    if (n.Left == -1)
     {
-        it2->_start -= count;
-        it2->_end -= count;
-        ++it2;
+        FudgetSelectionBlock result = { n.Start, n.End };
+        _free.Add(node);
+        node = n.Right;
+        return result;
     }
+    int child = n.Left;
+    FudgetSelectionBlock result = PopFirst(child);
+    _nodes[node].Left = child;
+    Update(node);
+    return result;
+}
 
-    if (remove_block)
-        _blocks.erase(it);
+FudgetSelectionBlock FudgetItemSelection::PopLast(int &node)
+{
+    Push(node);
+    Node &n = _nodes[node];
+    if (n.Right == -1)
+    {
+        FudgetSelectionBlock result = { n.Start, n.End };
+        _free.Add(node);
+        node = n.Left;
+        return result;
+    }
+    int child = n.Right;
+    FudgetSelectionBlock result = PopLast(child);
+    _nodes[node].Right = child;
+    Update(node);
+    return result;
 }
 
+
+// FudgetItemSelection::RangeIterator
+
+
+FudgetItemSelection::RangeIterator::RangeIterator(const FudgetItemSelection *owner) : _owner(owner), _valid(false)
+{
+    _current._start = 0;
+    _current._end = 0;
+    PushLeft(_owner->_root, 0);
+    Next();
+}
+
+void FudgetItemSelection::RangeIterator::Next()
+{
+    if (_stack.IsEmpty())
+    {
+        _valid = false;
+        return;
+    }
+
+    StackItem item = _stack.Pop();
+    const Node &node = _owner->_nodes[item.Node];
+    _current._start = node.Start + item.Offset;
+    _current._end = node.End + item.Offset;
+    _valid = true;
+    PushLeft(node.Right, item.Offset + node.Shift);
+}
+
+void FudgetItemSelection::RangeIterator::PushLeft(int node, int offset)
+{
+    while (node != -1)
+    {
+        _stack.Add({ node, offset });
+        const Node &n = _owner->_nodes[node];
+        offset += n.Shift;
+        node = n.Left;
+    }
+}
@@ -1,7 +1,8 @@
 #pragma once
 
-#include <vector>
 #include "Engine/Scripting/ScriptingObject.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Math/Vector2.h"
 
 
 // Structure for a single selection block. The block has a start index and a length.
@@ -14,7 +15,10 @@ struct FudgetSelectionBlock
 };
 
 /// <summary>
-/// Helper class that keeps track of selected items in controls.
+/// Helper class that keeps track of selected items in controls. Runs of selected items are stored in a balanced
+/// tree, so checking and changing the selection, and shifting it when items are inserted or removed, take time
+/// proportional to the logarithm of the number of runs. Shifting the runs after an insertion or removal point is
+/// done lazily.
 /// </summary>
 API_CLASS()
 class FUDGETS_API FudgetItemSelection : public ScriptingObject
@@ -22,6 +26,47 @@ class FUDGETS_API FudgetItemSelection : public ScriptingObject
     using Base = ScriptingObject;
     DECLARE_SCRIPTING_TYPE(FudgetItemSelection);
 public:
+    /// <summary>
+    /// Iterates over the runs of selected items in increasing order.
+    /// </summary>
+    class FUDGETS_API RangeIterator
+    {
+    public:
+        RangeIterator(const FudgetItemSelection *owner);
+
+        /// <summary>
+        /// Whether the iterator points to a run of selected items.
+        /// </summary>
+        FORCE_INLINE bool IsValid() const { return _valid; }
+
+        /// <summary>
+        /// The current run of selected items.
+        /// </summary>
+        FORCE_INLINE const FudgetSelectionBlock& Get() const { return _current; }
+
+        /// <summary>
+        /// Steps to the next run of selected items.
+        /// </summary>
+        void Next();
+    private:
+        struct StackItem
+        {
+            int Node;
+            // Shift of the ancestors that wasn't applied to the node yet.
+            int Offset;
+        };
+
+        void PushLeft(int node, int offset);
+
+        const FudgetItemSelection *_owner;
+        Array<StackItem> _stack;
+        FudgetSelectionBlock _current;
+        bool _valid;
+    };
+
+    /// <summary>
+    /// Gets the number of selected items.
+    /// </summary>
     API_PROPERTY() int Count() const { return _count; }
 
     /// <summary>
@@ -38,7 +83,7 @@ public:
     /// <summary>
     /// Returns whether there is anything selected.
     /// </summary>
-    API_FUNCTION() bool HasSelection() const { return !_blocks.empty(); }
+    API_FUNCTION() bool HasSelection() const { return _root != -1; }
 
     /// <summary>
     /// Clears the selection.
@@ -79,8 +124,57 @@ public:
     /// <param name="index">Indes of the first removed item.</param>
     /// <param name="count">Number of items removed.</param>
     API_FUNCTION() void ItemsRemoved(int index, int count);
+
+    /// <summary>
+    /// Returns the runs of selected items in increasing order. X is the index of the first item in a run and Y is
+    /// the index after the last item. Use RangeIterator from C++ to avoid creating the array.
+    /// </summary>
+    API_FUNCTION() Array<Int2> GetSelectedRanges() const;
+
+    /// <summary>
+    /// Returns an iterator positioned at the first run of selected items.
+    /// </summary>
+    RangeIterator IterateRanges() const { return RangeIterator(this); }
 private:
+    // A run of selected items in the tree. Runs never overlap or touch, they would be merged into one run.
+    struct Node
+    {
+        // Range of the run. These don't include the shift of the ancestors that wasn't pushed down yet.
+        int Start;
+        int End;
+        // Shift to apply to the children, which was already applied to this node.
+        int Shift;
+        int Left;
+        int Right;
+        uint32 Priority;
+        // Number of selected items in the subtree.
+        int Selected;
+    };
+
+    int NewNode(int start, int end);
+    void FreeTree(int node);
+    void AddShift(int node, int delta);
+    void Push(int node);
+    void Update(int node);
+    int Merge(int left, int right);
+    // Splits the tree in two. Runs for which in_left returns true are put in left. The predicate must be true for a
+    // prefix of the runs.
+    template<typename Pred>
+    void Split(int node, const Pred &in_left, int &left, int &right);
+    // Returns the first or last run of a tree, pushing down the shift on the way so its values are final.
+    int First(int node);
+    int Last(int node);
+    // Removes the first or last run of a tree, returning its range.
+    FudgetSelectionBlock PopFirst(int &node);
+    FudgetSelectionBlock PopLast(int &node);
+
     int _size;
     int _count;
-    std::vector<FudgetSelectionBlock> _blocks;
-};
\ No newline at end of file
+
+    Array<Node> _nodes;
+    // Indexes of unused nodes in _nodes.
+    Array<int> _free;
+    int _root;
+    // State of the random generator for node priorities.
+    uint32 _seed;
+};
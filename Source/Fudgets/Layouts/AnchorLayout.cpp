@@ -9,6 +9,19 @@ FudgetAnchorLayoutSlot::FudgetAnchorLayoutSlot(const SpawnParams &params) : Base
 
 }
 
+void FudgetAnchorLayoutSlot::Reset()
+{
+    Base::Reset();
+    leftAnchor = FudgetHorizontalAnchor::Left;
+    rightAnchor = FudgetHorizontalAnchor::None;
+    topAnchor = FudgetVerticalAnchor::Top;
+    bottomAnchor = FudgetVerticalAnchor::None;
+    leftPercent = 0.f;
+    rightPercent = 0.f;
+    topPercent = 0.f;
+    bottomPercent = 0.f;
+}
+
 FudgetAnchorLayout::FudgetAnchorLayout(const SpawnParams &params) : Base(params)
 {
 
@@ -87,6 +87,9 @@ public:
     /// Distance of the control's bottom side from its anchor
     /// </summary>
     API_FIELD() float bottomPercent;
+
+    /// <inheritdoc />
+    void Reset() override;
 };
 
 /// <summary>
@@ -1,6 +1,11 @@
 #include "Layout.h"
 #include "../Container.h"
 #include "../Utils/Utils.h"
+#include "../Utils/ScratchArena.h"
+#include "../GUIRoot.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Threading/JobSystem.h"
+#include "Engine/Threading/Threading.h"
 
 
 FudgetLayoutSlot::FudgetLayoutSlot(const SpawnParams &params) : Base(params), Control(nullptr), OldSizes(), UnrestrictedSizes(), Sizes(), ComputedBounds(0.f, 0.f)
@@ -8,6 +13,15 @@ FudgetLayoutSlot::FudgetLayoutSlot(const SpawnParams &params) : Base(params), Co
 
 }
 
+void FudgetLayoutSlot::Reset()
+{
+    Control = nullptr;
+    OldSizes = FudgetLayoutSizeCache();
+    UnrestrictedSizes = FudgetLayoutSizeCache();
+    Sizes = FudgetLayoutSizeCache();
+    ComputedBounds = Rectangle(0.f, 0.f);
+}
+
 
 FudgetLayout::FudgetLayout(const SpawnParams &params) : Base(params), _owner(nullptr),
         _layout_dirty(false), _sizes(), _unrestricted_sizes(), _flags(FudgetLayoutFlag::ResetFlags), _changing(false)
@@ -19,6 +33,7 @@ FudgetLayout::~FudgetLayout()
 {
     if (_owner != nullptr)
         CleanUp();
+    _free_slots.ClearDelete();
 }
 
 void FudgetLayout::SetOwner(FudgetContainer *value)
@@ -161,6 +176,9 @@ void FudgetLayout::SetControlDimensions(int index, Int2 pos, Int2 size)
 
 FudgetLayoutSlot* FudgetLayout::GetSlot(int index) const
 {
+    // Slots are only synced with the child controls at the end of a bulk update, unless they are accessed before that.
+    if (_owner != nullptr && _owner->_slots_pending)
+        _owner->FlushChildChanges();
     if (!GoodSlotIndex(index))
         return nullptr;
     return _slots[index];
@@ -168,7 +186,9 @@ FudgetLayoutSlot* FudgetLayout::GetSlot(int index) const
 
 void FudgetLayout::CleanUp()
 {
-    _slots.ClearDelete();
+    for (FudgetLayoutSlot *slot : _slots)
+        ReleaseSlot(slot);
+    _slots.Clear();
 }
 
 void FudgetLayout::FillSlots()
@@ -243,6 +263,11 @@ void FudgetLayout::DoLayoutChildren(Int2 available)
     // Exceptions are controls that might resize themselves after the available space changes. For example
     // word wrapping labels.
 
+    // Containers that don't depend on their siblings can be measured in parallel first. Nested layouts
+    // measured on a job thread do this serially.
+    if (IsInMainThread())
+        MeasureIsolatedSlots(count);
+
     // Number of controls that might need to be measured multiple times, because their size depends on the
     // space in their slot.
     int size_from_space_cnt = 0;
@@ -284,8 +309,8 @@ void FudgetLayout::DoLayoutChildren(Int2 available)
     // Keeps track if the layout has controls that need to be measured multiple times for different slot sizes.
     bool need_remeasure = false;
     // Measurements saved for such controls. If this changes after the layout, they will be measured again.
-    Array<FudgetLayoutSizeCache> compare_cache(size_from_space_cnt);
-    compare_cache.AddUninitialized(size_from_space_cnt);
+    FudgetScratchScope scratch(GetScratchArena());
+    Span<FudgetLayoutSizeCache> compare_cache = scratch.Allocate<FudgetLayoutSizeCache>(size_from_space_cnt);
 
     // Limits the number of iterations in case a control keeps changing its size during measurements.
     // TODO: make the maximum iterations customizable
@@ -330,6 +355,50 @@ void FudgetLayout::DoLayoutChildren(Int2 available)
     }
 }
 
+void FudgetLayout::MeasureIsolatedSlots(int count)
+{
+    FudgetScratchScope scratch(GetScratchArena());
+    Span<FudgetLayoutSlot*> slots = scratch.Allocate<FudgetLayoutSlot*>(count);
+    int isolated_count = 0;
+    for (int ix = 0; ix < count; ++ix)
+    {
+        auto slot = GetSlot(ix);
+        if (slot->UnrestrictedSizes.IsValid || slot->Control->IsHiddenInLayout())
+            continue;
+        if (!slot->Control->HasAnyFlag(FudgetControlFlag::LayoutIsolated) || !slot->Control->IsStyleInitialized())
+            continue;
+        slots[isolated_count++] = slot;
+    }
+
+    if (isolated_count < 2)
+        return;
+    Span<FudgetLayoutSlot*> isolated(slots.Get(), isolated_count);
+
+    // Pending slot changes mark layouts dirty up the parent chain when flushed, which must happen on the main
+    // thread and not from inside the jobs.
+    for (int ix = 0; ix < isolated_count; ++ix)
+    {
+        FudgetContainer *container = dynamic_cast<FudgetContainer*>(isolated[ix]->Control);
+        if (container != nullptr)
+            container->FlushChildChangesRecursive();
+    }
+
+    // Each job only writes its own slot, so the results are the same as measuring them one by one.
+    Function<void(int32)> job = [&isolated](int32 index)
+    {
+        FudgetLayoutSlot *slot = isolated[index];
+        slot->UnrestrictedSizes.SizeFromSpace = slot->Control->OnMeasure(Int2(-1), slot->UnrestrictedSizes.Size, slot->UnrestrictedSizes.Min, slot->UnrestrictedSizes.Max);
+    };
+    JobSystem::Wait(JobSystem::Dispatch(job, isolated.Length()));
+
+    for (int ix = 0; ix < isolated_count; ++ix)
+    {
+        FudgetLayoutSlot *slot = isolated[ix];
+        slot->UnrestrictedSizes.IsValid = true;
+        slot->Sizes = slot->UnrestrictedSizes;
+    }
+}
+
 bool FudgetLayout::MeasureSlot(int index, Int2 available, API_PARAM(Out) Int2 &wanted_size, API_PARAM(Out) Int2 &wanted_min, API_PARAM(Out) Int2 &wanted_max)
 {
     auto slot = GetSlot(index);
@@ -428,9 +497,34 @@ FudgetLayoutSlot* FudgetLayout::CreateSlot(FudgetControl *control)
     return slot;
 }
 
+FudgetLayoutSlot* FudgetLayout::AcquireSlot(FudgetControl *control)
+{
+    if (_free_slots.IsEmpty())
+        return CreateSlot(control);
+
+    FudgetLayoutSlot *slot = _free_slots.Last();
+    _free_slots.RemoveLast();
+    slot->Control = control;
+    return slot;
+}
+
+void FudgetLayout::ReleaseSlot(FudgetLayoutSlot *slot)
+{
+    if (slot == nullptr)
+        return;
+    if (_free_slots.Count() >= MaxFreeSlots)
+    {
+        Delete(slot);
+        return;
+    }
+    slot->Reset();
+    _free_slots.Add(slot);
+}
+
 void FudgetLayout::ChildAdded(FudgetControl *control, int index)
 {
-    auto slot = CreateSlot(control);
+    SlotsChanged();
+    auto slot = AcquireSlot(control);
     if (index == -1)
     {
         _slots.Add(slot);
@@ -451,7 +545,8 @@ void FudgetLayout::ChildAdded(FudgetControl *control, int index)
 
 void FudgetLayout::ChildRemoved(int index)
 {
-    Delete(_slots[index]);
+    SlotsChanged();
+    ReleaseSlot(_slots[index]);
     _slots.RemoveAtKeepOrder(index);
 
     if (_owner != nullptr && HasAnyFlag(FudgetLayoutFlag::ResizeOnContentChange))
@@ -467,6 +562,7 @@ void FudgetLayout::ChildMoved(int from, int to)
     if (from == to || from < 0 || to < 0 || from >= _slots.Count() || to >= _slots.Count())
         return;
 
+    SlotsChanged();
     MoveInArray(_slots, from, to);
 
     if (_owner != nullptr && HasAnyFlag(FudgetLayoutFlag::ResizeOnContentIndexChange))
@@ -487,8 +583,9 @@ void FudgetLayout::AllDeleted()
     if (_slots.Count() == 0)
         return;
 
+    SlotsChanged();
     for (int ix = _slots.Count() - 1; ix >= 0; --ix)
-        Delete(_slots[ix]);
+        ReleaseSlot(_slots[ix]);
     _slots.Clear();
     
     if (_owner != nullptr && HasAnyFlag(FudgetLayoutFlag::ResizeOnContentChange))
@@ -497,6 +594,88 @@ void FudgetLayout::AllDeleted()
     //_size_dirty = true;
 }
 
+void FudgetLayout::SyncSlots()
+{
+    if (_owner == nullptr)
+        return;
+
+    SlotsChanged();
+
+    // The controls are only used as keys, because the removed ones might be deleted already.
+    Dictionary<FudgetControl*, FudgetLayoutSlot*> old_slots(_slots.Count());
+    for (FudgetLayoutSlot *slot : _slots)
+        old_slots[slot->Control] = slot;
+
+    int count = _owner->GetChildCount();
+    Array<FudgetLayoutSlot*> slots(count);
+    Array<FudgetContainer*> added;
+    Array<FudgetContainer*> moved;
+    bool changed = count != _slots.Count();
+    for (int ix = 0; ix < count; ++ix)
+    {
+        FudgetControl *control = _owner->ChildAt(ix);
+        FudgetLayoutSlot *slot;
+        if (old_slots.TryGet(control, slot))
+        {
+            old_slots.Remove(control);
+            if (ix >= _slots.Count() || _slots[ix] != slot)
+            {
+                changed = true;
+                FudgetContainer *content = dynamic_cast<FudgetContainer*>(control);
+                if (content != nullptr)
+                    moved.Add(content);
+            }
+        }
+        else
+        {
+            slot = AcquireSlot(control);
+            changed = true;
+            FudgetContainer *content = dynamic_cast<FudgetContainer*>(control);
+            if (content != nullptr)
+                added.Add(content);
+        }
+        slots.Add(slot);
+    }
+
+    for (auto &pair : old_slots)
+        ReleaseSlot(pair.Value);
+
+    if (!changed)
+        return;
+
+    _slots.Swap(slots);
+
+    if (_owner != nullptr && HasAnyFlag(FudgetLayoutFlag::ResizeOnContentChange))
+        _owner->MarkLayoutDirty(FudgetLayoutDirtyReason::Size);
+
+    for (FudgetContainer *content : added)
+        content->MarkLayoutDirty(FudgetLayoutDirtyReason::All | FudgetLayoutDirtyReason::Container);
+    for (FudgetContainer *content : moved)
+        content->MarkLayoutDirty(FudgetLayoutDirtyReason::Index | FudgetLayoutDirtyReason::Container);
+
+    if (_slots.Count() != 0)
+        _layout_dirty |= HasAnyFlag(FudgetLayoutFlag::LayoutOnContentChange);
+    else
+        _layout_dirty = false;
+}
+
+void FudgetLayout::SlotsChanged()
+{
+    FudgetGUIRoot *root = _owner != nullptr ? _owner->GetGUIRoot() : nullptr;
+    if (root != nullptr)
+        root->LayoutTreeChanged();
+}
+
+FudgetScratchArena* FudgetLayout::GetScratchArena() const
+{
+    if (_owner == nullptr || !IsInMainThread())
+        return nullptr;
+    FudgetGUIRoot *root = _owner->GetGUIRoot();
+    if (root == nullptr)
+        return nullptr;
+    return root->GetLayoutArena();
+}
+
 void FudgetLayout::MarkOwnerDirty()
 {
     if (_owner == nullptr)
@@ -136,6 +136,7 @@
 
 class FudgetControl;
 class FudgetContainer;
+class FudgetScratchArena;
 
 enum class FudgetSizeType : uint8;
 enum class FudgetLayoutDirtyReason : uint8;
@@ -506,6 +507,12 @@ public:
     /// </summary>
     API_FIELD(Attributes = "HideInEditor, NoSerialize") Rectangle ComputedBounds;
 
+    /// <summary>
+    /// Restores the values the slot had when it was created. Layouts keep the slots of removed controls and reuse
+    /// them for new controls after calling this function. Derived slots should call the base implementation and
+    /// reset their own fields.
+    /// </summary>
+    API_FUNCTION() virtual void Reset();
 };
 
 
@@ -719,7 +726,9 @@ protected:
 
     /// <summary>
     /// Creates a slot which represents properties of a single child control on the owner container. The function
-    /// in derived classes should return an object of the proper type fitting that layout.
+    /// in derived classes should return an object of the proper type fitting that layout. It must return the same
+    /// type for every control, because slots of removed controls are reset and reused for new controls without
+    /// calling this function.
     /// </summary>
     /// <param name="control">The control that will be inserted into the slot</param>
     /// <returns>The created object holding layouting properties of the control</returns>
@@ -753,6 +762,13 @@ protected:
     /// </summary>
     API_FUNCTION() virtual void AllDeleted();
 
+    /// <summary>
+    /// Called by the owner container at the end of a bulk update, when the slots might not match the child controls
+    /// anymore. Existing slots are kept for controls still in the owner, and moved to the new index of their control.
+    /// Slots are created for new controls, and deleted for controls that were removed.
+    /// </summary>
+    API_FUNCTION() virtual void SyncSlots();
+
     /// <summary>
     /// Call MarkOwnerDirty, if a change in the layout or one of its slots affects the owner container's size. Call
     /// MarkDirty directly if a change only affects the managed controls. For example a control's alignment in its
@@ -810,7 +826,17 @@ protected:
     /// </summary>
     /// <returns>Layout flags that should be set to the layout.</returns>
     API_FUNCTION() virtual FudgetLayoutFlag GetInitFlags() const { return FudgetLayoutFlag::None; }
+
+    /// <summary>
+    /// Scratch memory of the GUI root for temporary arrays during layout calculations. Use with a FudgetScratchScope,
+    /// which falls back to heap allocations if this is null. It's null when the layout is not in a GUI root or it's
+    /// not calculated on the main thread.
+    /// </summary>
+    FudgetScratchArena* GetScratchArena() const;
 private:
+    // Tells the GUI root that the slots changed, so the next layout pass is not in a steady state.
+    void SlotsChanged();
+
     /// <summary>
     /// Sets the container that holds the controls managed by this layout. For internal use, it doesn't
     /// notify the container of the changes. Use SetOwner for normal use.
@@ -818,8 +844,24 @@ private:
     /// <param name="value">The new container this layout will be assined to</param>
     API_PROPERTY(Attributes="HideInEditor") void SetOwnerInternal(FudgetContainer *value);
 
+    /// <summary>
+    /// Measures the unrestricted sizes of slots with a LayoutIsolated container that don't have valid sizes. The
+    /// containers are measured concurrently on the job system if there are at least two of them.
+    /// </summary>
+    /// <param name="count">Number of slots in the layout</param>
+    void MeasureIsolatedSlots(int count);
+
+    // Returns a reset slot from the free slots for the control, or creates a new one with CreateSlot.
+    FudgetLayoutSlot* AcquireSlot(FudgetControl *control);
+    // Resets a slot and keeps it for reuse, or deletes it if enough slots are kept already.
+    void ReleaseSlot(FudgetLayoutSlot *slot);
+
     FudgetContainer *_owner;
     Array<FudgetLayoutSlot*> _slots;
+    // Slots of removed controls kept for new controls. Reusing them avoids creating scripting objects with new ids
+    // when controls are frequently added and removed.
+    Array<FudgetLayoutSlot*> _free_slots;
+    static constexpr int MaxFreeSlots = 64;
 
     /// <summary>
     /// The child control positions and possibly sizes need to be recalculated, due to a change
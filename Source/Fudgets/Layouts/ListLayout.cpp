@@ -1,15 +1,27 @@
 #include "ListLayout.h"
 #include "../Container.h"
 #include "../Utils/Utils.h"
+#include "../Utils/ScratchArena.h"
 
 
 
-FudgetListLayoutSlot::FudgetListLayoutSlot(const SpawnParams &params) : Base(SpawnParams(Guid::New(), TypeInitializer)),
+FudgetListLayoutSlot::FudgetListLayoutSlot(const SpawnParams &params) : Base(params),
     _horz_align(FudgetLayoutHorzAlign::Left), _vert_align(FudgetLayoutVertAlign::Top), _sizing_rule(FudgetDistributedSizingRule::Exact),
     _shrinking_rule(FudgetDistributedShrinkingRule::CanShrink), _weight(1.f)
 {
 }
 
+void FudgetListLayoutSlot::Reset()
+{
+    Base::Reset();
+    _horz_align = FudgetLayoutHorzAlign::Left;
+    _vert_align = FudgetLayoutVertAlign::Top;
+    _padding = FudgetPadding();
+    _sizing_rule = FudgetDistributedSizingRule::Exact;
+    _shrinking_rule = FudgetDistributedShrinkingRule::CanShrink;
+    _weight = Float2(1.f);
+}
+
 FudgetListLayout::FudgetListLayout(const SpawnParams &params) : Base(params), _ori(FudgetOrientation::Horizontal), _no_padding_space(false),
     _has_expanding(false),  _has_grow_expanding(false), _has_grow_exact(false), _has_exact(false), _has_shrink(false), _has_minimal(false), _space_dependent(false)
 {
@@ -242,19 +254,16 @@ bool FudgetListLayout::IsExpandingRule(FudgetDistributedSizingRule rule) const
 
 void FudgetListLayout::LayoutChildren(Int2 space, FudgetContainer *owner, int count)
 {
-    // Will hold the calculated size of each slot based on the ratio, without the leftover space.
-    Array<int> sizes(count);
+    // Temporary arrays are taken from the GUI root's scratch memory, which is released at the end of the function.
+    FudgetScratchScope scratch(GetScratchArena());
 
-    // Will hold the ratio of each control relative to each other.
-    Array<float> ratios(count);
-    // Adding all the ratios up, to be used for the percent calculation
-    float ratio_sum = 0.f;
-    // Calculating the ratios and the ratio sum
+    // Will hold the calculated size of each slot based on the ratio, without the leftover space.
+    Span<int> sizes = scratch.Allocate<int>(count);
 
-    Array<Int2> wanted_sizes(count);
-    Array<Int2> min_sizes(count);
-    Array<Int2> max_sizes(count);
-    Array<Int2> shrink_sizes(count);
+    Span<Int2> wanted_sizes = scratch.Allocate<Int2>(count);
+    Span<Int2> min_sizes = scratch.Allocate<Int2>(count);
+    Span<Int2> max_sizes = scratch.Allocate<Int2>(count);
+    Span<Int2> shrink_sizes = scratch.Allocate<Int2>(count);
 
     Int2 layout_wanted = Int2::Zero;
     Int2 layout_min = Int2::Zero;
@@ -274,10 +283,10 @@ void FudgetListLayout::LayoutChildren(Int2 space, FudgetContainer *owner, int co
 
         if (!unrestricted)
         {
-            wanted_sizes.Add(wanted);
-            min_sizes.Add(min);
-            max_sizes.Add(max);
-            shrink_sizes.Add(Int2(Math::Max(wanted.X - min.X, 0), Math::Max(wanted.Y - min.Y, 0)));
+            wanted_sizes[ix] = wanted;
+            min_sizes[ix] = min;
+            max_sizes[ix] = max;
+            shrink_sizes[ix] = Int2(Math::Max(wanted.X - min.X, 0), Math::Max(wanted.Y - min.Y, 0));
         }
 
         if (slot->Control->IsHiddenInLayout())
@@ -335,7 +344,7 @@ void FudgetListLayout::LayoutChildren(Int2 space, FudgetContainer *owner, int co
     for (int ix = 0; ix < count; ++ix)
     {
         int size = Relevant(wanted_sizes[ix]);
-        sizes.Add(size);
+        sizes[ix] = size;
 
         if (!GetSlot(ix)->Control->IsHiddenInLayout())
             remaining -= size;
@@ -363,23 +372,21 @@ void FudgetListLayout::LayoutChildren(Int2 space, FudgetContainer *owner, int co
         // If some slots have valid weight, stores a multiplier for the available size that they can take up. To avoid
         // gaps caused by floating point calculations, this is filled from the back. Each element only measuring the
         // space not used up yet.
-        Array<float> weight_ratio(count);
+        Span<float> weight_ratio = scratch.Allocate<float>(count);
 
         for (int ix = count - 1; ix >= 0; --ix)
         {
             FudgetListLayoutSlot *slot = GetSlot(ix);
+            weight_ratio[count - ix - 1] = 0.f;
             if (slot->Control->IsHiddenInLayout() || !IsExpandingRule(slot->_sizing_rule))
-            {
-                weight_ratio.Add(0.f);
                 continue;
-            }
 
             if (sizes[ix] != Relevant(max_sizes[ix]))
             {
                 float weight = Math::Max(0.f, Relevant(slot->_weight));
                 weight_sum += weight;
                 ++weighted_cnt;
-                weight_ratio.Add(weight / weight_sum);
+                weight_ratio[count - ix - 1] = weight / weight_sum;
             }
             ++unweighted_cnt;
         }
@@ -436,7 +443,7 @@ void FudgetListLayout::LayoutChildren(Int2 space, FudgetContainer *owner, int co
         remaining *= -1;
 
         int shrink_sum = 0;
-        Array<float> shrink_ratio(count);
+        Span<float> shrink_ratio = scratch.Allocate<float>(count);
         for (int ix = count - 1; ix >= 0; --ix)
         {
             int size = Relevant(shrink_sizes[ix]);
@@ -444,7 +451,7 @@ void FudgetListLayout::LayoutChildren(Int2 space, FudgetContainer *owner, int co
             {
                 // Hidden slots have 0 sizes too.
 
-                shrink_ratio.Add(0.f);
+                shrink_ratio[count - ix - 1] = 0.f;
                 continue;
             }
             auto slot = GetSlot(ix);
@@ -452,11 +459,11 @@ void FudgetListLayout::LayoutChildren(Int2 space, FudgetContainer *owner, int co
             if (slot->_shrinking_rule == FudgetDistributedShrinkingRule::CanShrink || slot->_shrinking_rule == FudgetDistributedShrinkingRule::IgnoreMinimum)
             {
                 shrink_sum += size;
-                shrink_ratio.Add(size / (float)shrink_sum);
+                shrink_ratio[count - ix - 1] = size / (float)shrink_sum;
 
             }
             else
-                shrink_ratio.Add(0.f);
+                shrink_ratio[count - ix - 1] = 0.f;
         }
 
         int unused_space = Math::Min(remaining, shrink_sum);
@@ -542,7 +549,7 @@ FudgetLayoutSlot* FudgetListLayout::CreateSlot(FudgetControl *control)
     // provide their own derived value. To make use easier, you can define a new GetSlot()
     // function that will hide the original call. See below.
 
-    FudgetLayoutSlot *slot = New<FudgetListLayoutSlot>(SpawnParams(Guid::New(), FudgetLayoutSlot::TypeInitializer));
+    FudgetLayoutSlot *slot = New<FudgetListLayoutSlot>(SpawnParams(Guid::New(), FudgetListLayoutSlot::TypeInitializer));
     slot->Control = control;
     return slot;
 }
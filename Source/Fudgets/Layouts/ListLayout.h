@@ -121,6 +121,8 @@ public:
     /// </summary>
     API_FIELD() Float2 _weight;
 
+    /// <inheritdoc />
+    void Reset() override;
 };
 
 /// <summary>
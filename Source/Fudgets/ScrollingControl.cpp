@@ -1,7 +1,8 @@
 #include "ScrollingControl.h"
 
 FudgetScrollingControl::FudgetScrollingControl(const SpawnParams &params) : Base(params), _scrollbars(FudgetScrollBars::None),
-    _h_scrollbar(nullptr), _v_scrollbar(nullptr), _dirty_extents(true)
+    _h_scrollbar(nullptr), _v_scrollbar(nullptr), _dirty_extents(true), _scroll_friction(4.0f), _scroll_animation_speed(14.0f),
+    _min_fling_velocity(20.0f), _smooth_scrolling(false)
 {
 }
 
@@ -59,6 +60,18 @@ void FudgetScrollingControl::DoMouseLeave()
     Base::DoMouseLeave();
 }
 
+void FudgetScrollingControl::DoUpdate(float delta_time)
+{
+    if (IsScrollInMotion())
+    {
+        bool h_moving = StepMotion(_h_scrollbar, _h_motion, delta_time);
+        bool v_moving = StepMotion(_v_scrollbar, _v_motion, delta_time);
+        if (h_moving || v_moving)
+            RequestMotionUpdate();
+    }
+    Base::DoUpdate(delta_time);
+}
+
 void FudgetScrollingControl::DrawBackground()
 {
     Base::DrawBackground();
@@ -84,11 +97,13 @@ void FudgetScrollingControl::SetScrollBars(FudgetScrollBars value)
     {
         Delete(_v_scrollbar);
         _v_scrollbar = nullptr;
+        _v_motion = ScrollMotion();
     }
     if (_h_scrollbar != nullptr && value != FudgetScrollBars::Horizontal && value != FudgetScrollBars::Both)
     {
         Delete(_h_scrollbar);
         _h_scrollbar = nullptr;
+        _h_motion = ScrollMotion();
     }
     _scrollbars = value;
     ClearStyleCache();
@@ -142,6 +157,11 @@ void FudgetScrollingControl::OnScrollBarTrackReleased(FudgetScrollBarComponent *
 
 void FudgetScrollingControl::OnScrollBarThumbPressed(FudgetScrollBarComponent *scrollbar, bool double_click)
 {
+    // Dragging the thumb takes over from any running motion.
+    if (scrollbar == _h_scrollbar)
+        _h_motion = ScrollMotion();
+    else if (scrollbar == _v_scrollbar)
+        _v_motion = ScrollMotion();
 }
 
 void FudgetScrollingControl::OnScrollBarThumbReleased(FudgetScrollBarComponent *scrollbar)
@@ -151,7 +171,7 @@ void FudgetScrollingControl::OnScrollBarThumbReleased(FudgetScrollBarComponent *
 
 bool FudgetScrollingControl::OnRole(FudgetScrollBarComponent *scrollbar, int role)
 {
-    return false;
+    return _smooth_scrolling && SmoothScrollRole(scrollbar, role);
 }
 
 void FudgetScrollingControl::OnScrollBarShown(FudgetScrollBarComponent *scrollbar)
@@ -208,3 +228,174 @@ void FudgetScrollingControl::RequestLayout()
     _dirty_extents = false;
     Base::RequestLayout();
 }
+
+void FudgetScrollingControl::FlingScroll(Float2 velocity)
+{
+    if (_h_scrollbar != nullptr && velocity.X != 0.f)
+    {
+        BeginMotion(_h_scrollbar, _h_motion);
+        _h_motion.Animating = false;
+        _h_motion.Flinging = true;
+        _h_motion.Velocity = velocity.X;
+    }
+    if (_v_scrollbar != nullptr && velocity.Y != 0.f)
+    {
+        BeginMotion(_v_scrollbar, _v_motion);
+        _v_motion.Animating = false;
+        _v_motion.Flinging = true;
+        _v_motion.Velocity = velocity.Y;
+    }
+    if (IsScrollInMotion())
+        RequestMotionUpdate();
+}
+
+void FudgetScrollingControl::SmoothScrollTo(Double2 position)
+{
+    if (_h_scrollbar != nullptr)
+    {
+        BeginMotion(_h_scrollbar, _h_motion);
+        _h_motion.Flinging = false;
+        _h_motion.Animating = true;
+        _h_motion.Target = Math::Clamp(position.X, (double)_h_scrollbar->GetMinScrollRange(), (double)_h_scrollbar->GetMaxScrollPos());
+    }
+    if (_v_scrollbar != nullptr)
+    {
+        BeginMotion(_v_scrollbar, _v_motion);
+        _v_motion.Flinging = false;
+        _v_motion.Animating = true;
+        _v_motion.Target = Math::Clamp(position.Y, (double)_v_scrollbar->GetMinScrollRange(), (double)_v_scrollbar->GetMaxScrollPos());
+    }
+    if (IsScrollInMotion())
+        RequestMotionUpdate();
+}
+
+void FudgetScrollingControl::SmoothScrollBy(Double2 delta)
+{
+    Double2 target = Double2::Zero;
+    if (_h_scrollbar != nullptr)
+        target.X = (_h_motion.Animating && _h_motion.Applied == _h_scrollbar->GetScrollPos() ? _h_motion.Target : (double)_h_scrollbar->GetScrollPos()) + delta.X;
+    if (_v_scrollbar != nullptr)
+        target.Y = (_v_motion.Animating && _v_motion.Applied == _v_scrollbar->GetScrollPos() ? _v_motion.Target : (double)_v_scrollbar->GetScrollPos()) + delta.Y;
+    SmoothScrollTo(target);
+}
+
+void FudgetScrollingControl::StopScrollMotion()
+{
+    _h_motion = ScrollMotion();
+    _v_motion = ScrollMotion();
+}
+
+void FudgetScrollingControl::BeginMotion(FudgetScrollBarComponent *scrollbar, ScrollMotion &motion)
+{
+    if (motion.IsMoving() && motion.Applied == scrollbar->GetScrollPos())
+        return;
+    motion.Position = (double)scrollbar->GetScrollPos();
+    motion.Applied = scrollbar->GetScrollPos();
+    motion.Velocity = 0.0;
+}
+
+bool FudgetScrollingControl::StepMotion(FudgetScrollBarComponent *scrollbar, ScrollMotion &motion, float delta_time)
+{
+    if (!motion.IsMoving())
+        return false;
+
+    // The scrollbar was moved by something else since the last step, or it can't be used anymore.
+    if (scrollbar == nullptr || scrollbar->GetScrollPos() != motion.Applied)
+    {
+        motion = ScrollMotion();
+        return false;
+    }
+
+    double min_pos = (double)scrollbar->GetMinScrollRange();
+    double max_pos = (double)scrollbar->GetMaxScrollPos();
+
+    if (motion.Flinging)
+    {
+        // Exponential decay of the velocity, integrated exactly over the step so the distance doesn't depend on the frame rate.
+        double decay = Math::Exp(-(double)_scroll_friction * delta_time);
+        motion.Position += motion.Velocity * (1.0 - decay) / _scroll_friction;
+        motion.Velocity *= decay;
+
+        if (motion.Position <= min_pos || motion.Position >= max_pos)
+        {
+            // No overscroll. The fling stops at the ends of the range.
+            motion.Position = Math::Clamp(motion.Position, min_pos, max_pos);
+            motion.Flinging = false;
+            motion.Velocity = 0.0;
+        }
+        else if (Math::Abs(motion.Velocity) < _min_fling_velocity)
+        {
+            motion.Flinging = false;
+            motion.Velocity = 0.0;
+            int64 rest_pos = (int64)Math::Round(motion.Position);
+            int64 snap_pos = GetScrollSnapPosition(scrollbar, rest_pos);
+            if (snap_pos != rest_pos)
+            {
+                motion.Target = Math::Clamp((double)snap_pos, min_pos, max_pos);
+                motion.Animating = true;
+            }
+        }
+    }
+    else if (motion.Animating)
+    {
+        double target = Math::Clamp(motion.Target, min_pos, max_pos);
+        motion.Position += (target - motion.Position) * (1.0 - Math::Exp(-(double)_scroll_animation_speed * delta_time));
+        if (Math::Abs(target - motion.Position) < 0.5)
+        {
+            motion.Position = target;
+            motion.Animating = false;
+        }
+    }
+
+    scrollbar->SetScrollPos((int64)Math::Round(motion.Position));
+    motion.Applied = scrollbar->GetScrollPos();
+    return motion.IsMoving();
+}
+
+void FudgetScrollingControl::RequestMotionUpdate()
+{
+    // Controls updated on every frame step the motion in their regular update.
+    if (IsUpdateRegistered() && GetUpdateInterval() == 0.f)
+        return;
+    ScheduleUpdate(0.f);
+}
+
+bool FudgetScrollingControl::SmoothScrollRole(FudgetScrollBarComponent *scrollbar, int role)
+{
+    if (scrollbar != _h_scrollbar && scrollbar != _v_scrollbar)
+        return false;
+
+    double delta;
+    switch (role)
+    {
+        case (int)FudgetScrollBarButtonRole::LineUp:
+            delta = -(double)scrollbar->GetLineSize();
+            break;
+        case (int)FudgetScrollBarButtonRole::LineDown:
+            delta = (double)scrollbar->GetLineSize();
+            break;
+        case (int)FudgetScrollBarButtonRole::PageUp:
+            delta = -(double)scrollbar->GetPageSize();
+            break;
+        case (int)FudgetScrollBarButtonRole::PageDown:
+            delta = (double)scrollbar->GetPageSize();
+            break;
+        case (int)FudgetScrollBarButtonRole::PageUpLine:
+            delta = -(double)Math::Max(0LL, scrollbar->GetPageSize() - scrollbar->GetLineSize());
+            break;
+        case (int)FudgetScrollBarButtonRole::PageDownLine:
+            delta = (double)Math::Max(0LL, scrollbar->GetPageSize() - scrollbar->GetLineSize());
+            break;
+        default:
+            return false;
+    }
+
+    ScrollMotion &motion = scrollbar == _h_scrollbar ? _h_motion : _v_motion;
+    double from = motion.Animating && motion.Applied == scrollbar->GetScrollPos() ? motion.Target : (double)scrollbar->GetScrollPos();
+    BeginMotion(scrollbar, motion);
+    motion.Flinging = false;
+    motion.Animating = true;
+    motion.Target = Math::Clamp(from + delta, (double)scrollbar->GetMinScrollRange(), (double)scrollbar->GetMaxScrollPos());
+    RequestMotionUpdate();
+    return true;
+}
@@ -40,6 +40,8 @@ enum class FudgetScrollBars
 /// calculate the size of the scrollbars if the control could determine their visibility. This version still
 /// won't return a value greater than 0 if a scrollbar was never created or is hidden. While it always includes
 /// the size of the scrollbar that is visible and not automatic.
+/// Scrolling can be animated with FlingScroll, SmoothScrollTo and SmoothScrollBy. The motion is stepped in the update
+/// tick, which is only requested while something is moving.
 /// </summary>
 API_CLASS()
 class FUDGETS_API FudgetScrollingControl : public FudgetControl, public IFudgetScollBarOwner
@@ -61,6 +63,9 @@ public:
     /// <inheritdoc />
     void DoMouseLeave() override;
 
+    /// <inheritdoc />
+    void DoUpdate(float delta_time) override;
+
     /// <inheritdoc />
     void DrawBackground() override;
     /// <inheritdoc />
@@ -135,6 +140,78 @@ public:
     /// </summary>
     /// <returns>Padding of contents by the frame and scrollbars.</returns>
     FudgetPadding GetFramePadding() const override;
+
+    /// <summary>
+    /// Starts scrolling with a velocity that slows down with the scroll friction until it stops or reaches the end
+    /// of the scroll range. Axes without a scrollbar are ignored.
+    /// </summary>
+    /// <param name="velocity">Horizontal and vertical scroll speed in scroll units per second</param>
+    API_FUNCTION() void FlingScroll(Float2 velocity);
+
+    /// <summary>
+    /// Animates the scrollbars to a position. Axes without a scrollbar are ignored.
+    /// </summary>
+    /// <param name="position">Horizontal and vertical scroll position to move to. It's clamped to the scroll range.
+    /// Doubles keep every position of large scroll ranges exact.</param>
+    API_FUNCTION() void SmoothScrollTo(Double2 position);
+
+    /// <summary>
+    /// Animates the scrollbars by a distance. If an animation is already running, the distance is added to its target,
+    /// so repeated calls accumulate instead of restarting from the current position.
+    /// </summary>
+    /// <param name="delta">Horizontal and vertical distance to scroll</param>
+    API_FUNCTION() void SmoothScrollBy(Double2 delta);
+
+    /// <summary>
+    /// Stops any fling or scroll animation at the current position.
+    /// </summary>
+    API_FUNCTION() void StopScrollMotion();
+
+    /// <summary>
+    /// Whether a fling or scroll animation is running.
+    /// </summary>
+    API_PROPERTY() bool IsScrollInMotion() const { return _h_motion.IsMoving() || _v_motion.IsMoving(); }
+
+    /// <summary>
+    /// Gets how quickly a fling slows down. The velocity decreases exponentially, by this factor per second.
+    /// </summary>
+    API_PROPERTY() float GetScrollFriction() const { return _scroll_friction; }
+    /// <summary>
+    /// Sets how quickly a fling slows down. The velocity decreases exponentially, by this factor per second.
+    /// </summary>
+    /// <param name="value">The new friction. Values are limited to be at least 0.1</param>
+    API_PROPERTY() void SetScrollFriction(float value) { _scroll_friction = Math::Max(0.1f, value); }
+
+    /// <summary>
+    /// Gets the speed of scroll animations. Higher values reach the target faster.
+    /// </summary>
+    API_PROPERTY() float GetScrollAnimationSpeed() const { return _scroll_animation_speed; }
+    /// <summary>
+    /// Sets the speed of scroll animations. Higher values reach the target faster.
+    /// </summary>
+    /// <param name="value">The new speed. Values are limited to be at least 1</param>
+    API_PROPERTY() void SetScrollAnimationSpeed(float value) { _scroll_animation_speed = Math::Max(1.0f, value); }
+
+    /// <summary>
+    /// Gets the velocity in scroll units per second below which a fling stops.
+    /// </summary>
+    API_PROPERTY() float GetMinFlingVelocity() const { return _min_fling_velocity; }
+    /// <summary>
+    /// Sets the velocity in scroll units per second below which a fling stops.
+    /// </summary>
+    /// <param name="value">The new minimum velocity</param>
+    API_PROPERTY() void SetMinFlingVelocity(float value) { _min_fling_velocity = Math::Max(0.0f, value); }
+
+    /// <summary>
+    /// Whether the line and page roles of the scrollbar buttons and track animate the scrolling instead of jumping.
+    /// Off by default.
+    /// </summary>
+    API_PROPERTY() bool GetSmoothScrolling() const { return _smooth_scrolling; }
+    /// <summary>
+    /// Sets whether the line and page roles of the scrollbar buttons and track animate the scrolling instead of jumping.
+    /// </summary>
+    /// <param name="value">Whether to animate scrolling</param>
+    API_PROPERTY() void SetSmoothScrolling(bool value) { _smooth_scrolling = value; }
 protected:
     /// <inheritdoc />
     void RequestLayout() override;
@@ -145,7 +222,43 @@ protected:
     /// the scrollbars should be directly updated with SetRange or SetPageSize.
     /// </summary>
     API_FUNCTION() virtual void RequestScrollExtents() {}
+
+    /// <summary>
+    /// Called when a fling slows down, to get the position where scrolling should come to rest. Override to snap the
+    /// position to the edge of items. The returned position is reached with a scroll animation.
+    /// </summary>
+    /// <param name="scrollbar">The scrollbar that was flung</param>
+    /// <param name="scroll_pos">The position where the fling would stop</param>
+    /// <returns>The position to stop at</returns>
+    API_FUNCTION() virtual int64 GetScrollSnapPosition(FudgetScrollBarComponent *scrollbar, int64 scroll_pos) { return scroll_pos; }
 private:
+    // Fling or animation state of one scrollbar.
+    struct ScrollMotion
+    {
+        FORCE_INLINE bool IsMoving() const { return Flinging || Animating; }
+
+        // Scroll position including the fraction that can't be set on the scrollbar.
+        double Position = 0.0;
+        // Fling speed in scroll units per second.
+        double Velocity = 0.0;
+        // Position to reach while animating.
+        double Target = 0.0;
+        // The position last set on the scrollbar. If the scrollbar has a different position, something else scrolled
+        // it, and the motion stops.
+        int64 Applied = 0;
+        bool Flinging = false;
+        bool Animating = false;
+    };
+
+    // Starts the motion from the scrollbar's current position unless it's already moving.
+    void BeginMotion(FudgetScrollBarComponent *scrollbar, ScrollMotion &motion);
+    // Advances the motion of a scrollbar and sets its position. Returns whether the motion continues.
+    bool StepMotion(FudgetScrollBarComponent *scrollbar, ScrollMotion &motion, float delta_time);
+    // Makes sure DoUpdate is called in the next update tick.
+    void RequestMotionUpdate();
+    // Handles the line and page roles with an animation when smooth scrolling is on. Returns false if the role is not handled.
+    bool SmoothScrollRole(FudgetScrollBarComponent *scrollbar, int role);
+
     // Which scrollbars need to be created.
     FudgetScrollBars _scrollbars;
 
@@ -154,4 +267,12 @@ private:
 
     // A dirty flag when the contents changed and their size needs to be calculated to be able to show a scrollbar or limit scrolling.
     bool _dirty_extents;
+
+    ScrollMotion _h_motion;
+    ScrollMotion _v_motion;
+
+    float _scroll_friction;
+    float _scroll_animation_speed;
+    float _min_fling_velocity;
+    bool _smooth_scrolling;
 };
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "AtlasBuilder.h"
+#include "DrawableBuilder.h"
+#include "Themes.h"
+#include "../Utils/RectPacker.h"
+
+#include "Engine/Content/Content.h"
+#include "Engine/Core/Math/Color32.h"
+#include "Engine/Graphics/PixelFormat.h"
+#include "Engine/Graphics/Textures/TextureBase.h"
+#include "Engine/Render2D/SpriteAtlas.h"
+
+#include <algorithm>
+#include <vector>
+
+
+// FudgetGPUAtlasTextureFactory
+
+
+SpriteAtlas* FudgetGPUAtlasTextureFactory::CreateAtlas(Int2 size, int padding, const Array<FudgetAtlasPlacement> &placements, Array<bool> &copied)
+{
+    copied.Clear();
+    if (size.X <= 0 || size.Y <= 0)
+        return nullptr;
+    copied.Resize(placements.Count());
+    copied.SetAll(false);
+
+    Array<Color32> page;
+    page.Resize(size.X * size.Y);
+    Platform::MemoryClear(page.Get(), page.Count() * sizeof(Color32));
+
+    Array<Color32> pixels;
+    for (int ix = 0, siz = placements.Count(); ix < siz; ++ix)
+    {
+        const FudgetAtlasPlacement &placement = placements[ix];
+        if (placement.Texture == nullptr || placement.Texture->GetPixels(pixels))
+            continue;
+
+        int w = (int)placement.Area.Size.X;
+        int h = (int)placement.Area.Size.Y;
+        int left = (int)placement.Area.Location.X;
+        int top = (int)placement.Area.Location.Y;
+        if (w <= 0 || h <= 0 || pixels.Count() < w * h)
+            continue;
+
+        // Copy the texture and repeat its edge pixels in the padding around it.
+        for (int y = -padding; y < h + padding; ++y)
+        {
+            int py = top + y;
+            if (py < 0 || py >= size.Y)
+                continue;
+            int sy = Math::Clamp(y, 0, h - 1);
+            for (int x = -padding; x < w + padding; ++x)
+            {
+                int px = left + x;
+                if (px < 0 || px >= size.X)
+                    continue;
+                page[py * size.X + px] = pixels[sy * w + Math::Clamp(x, 0, w - 1)];
+            }
+        }
+        copied[ix] = true;
+    }
+
+    SpriteAtlas *atlas = Content::CreateVirtualAsset<SpriteAtlas>();
+    if (atlas == nullptr)
+        return nullptr;
+
+    auto init_data = New<TextureBase::InitData>();
+    init_data->Format = PixelFormat::R8G8B8A8_UNorm;
+    init_data->Width = size.X;
+    init_data->Height = size.Y;
+    init_data->ArraySize = 1;
+    init_data->Mips.Resize(1);
+    auto &mip = init_data->Mips[0];
+    mip.RowPitch = size.X * sizeof(Color32);
+    mip.SlicePitch = mip.RowPitch * size.Y;
+    mip.Data.Copy((const byte*)page.Get(), mip.SlicePitch);
+
+    // Init takes the ownership of the data.
+    if (atlas->Init(init_data))
+    {
+        atlas->DeleteObject();
+        return nullptr;
+    }
+    return atlas;
+}
+
+
+// FudgetAtlasBuilder
+
+
+FudgetAtlasBuilder::FudgetAtlasBuilder(int page_size, int max_texture_size, int padding) : _page_size(Math::Max(1, page_size)),
+    _max_texture_size(Math::Max(1, max_texture_size)), _padding(Math::Max(0, padding)), _page_count(0)
+{
+}
+
+bool FudgetAtlasBuilder::AddTexture(TextureBase *texture)
+{
+    if (texture == nullptr || !texture->IsLoaded())
+        return false;
+    return AddTexture(texture, Int2(texture->Width(), texture->Height()));
+}
+
+bool FudgetAtlasBuilder::AddTexture(TextureBase *texture, Int2 size)
+{
+    if (texture == nullptr || size.X <= 0 || size.Y <= 0 || size.X > _max_texture_size || size.Y > _max_texture_size ||
+        size.X + _padding * 2 > _page_size || size.Y + _padding * 2 > _page_size)
+        return false;
+
+    for (const Item &item : _items)
+    {
+        if (item.Texture == texture)
+            return false;
+    }
+
+    _items.Add({ texture, size });
+    return true;
+}
+
+void FudgetAtlasBuilder::AddTextures(const FudgetDrawInstructionList *list)
+{
+    if (list == nullptr)
+        return;
+
+    for (const FudgetDrawInstruction *inst : list->_list)
+    {
+        switch (inst->_type)
+        {
+            case FudgetDrawInstructionType::DrawArea:
+                AddTexture(((const FudgetDrawInstructionDrawArea*)inst)->_draw_area.Texture.Get());
+                break;
+            case FudgetDrawInstructionType::DrawBorder:
+                AddTexture(((const FudgetDrawInstructionDrawBorder*)inst)->_draw_border.Texture.Get());
+                break;
+            case FudgetDrawInstructionType::InstructionList:
+                AddTextures((const FudgetDrawInstructionList*)inst);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void FudgetAtlasBuilder::AddThemeTextures()
+{
+    if (FudgetThemes::_data == nullptr)
+        return;
+
+    for (const auto &stated : FudgetThemes::_data->_draw_list)
+    {
+        for (const FudgetDrawInstructionList *list : stated._instructions)
+            AddTextures(list);
+    }
+}
+
+void FudgetAtlasBuilder::Pack()
+{
+    _placements.Clear();
+    _page_count = 0;
+
+    // Packing the tall textures first leaves a flatter skyline for the rest.
+    std::stable_sort(_items.Get(), _items.Get() + _items.Count(), [](const Item &a, const Item &b) {
+        if (a.Size.Y != b.Size.Y)
+            return a.Size.Y > b.Size.Y;
+        return a.Size.X > b.Size.X;
+    });
+
+    std::vector<FudgetRectPacker> pages;
+    for (const Item &item : _items)
+    {
+        Int2 pos;
+        int page = -1;
+        for (int ix = 0, siz = (int)pages.size(); ix < siz && page < 0; ++ix)
+        {
+            if (pages[ix].Insert(item.Size, pos))
+                page = ix;
+        }
+
+        if (page < 0)
+        {
+            pages.push_back(FudgetRectPacker(Int2(_page_size, _page_size), _padding));
+            if (!pages.back().Insert(item.Size, pos))
+            {
+                pages.pop_back();
+                continue;
+            }
+            page = (int)pages.size() - 1;
+        }
+
+        _placements.Add({ item.Texture, page, Rectangle(Float2((float)pos.X, (float)pos.Y), Float2((float)item.Size.X, (float)item.Size.Y)) });
+    }
+    _page_count = (int)pages.size();
+}
+
+Rectangle FudgetAtlasBuilder::GetPlacementUV(int placement_index) const
+{
+    if (placement_index < 0 || placement_index >= _placements.Count())
+        return Rectangle::Empty;
+    return FudgetRectPacker::ToUV(_placements[placement_index].Area, Int2(_page_size, _page_size));
+}
+
+bool FudgetAtlasBuilder::Build(FudgetAtlasTextureFactory *factory, Array<SpriteAtlas*> &atlases, Dictionary<TextureBase*, SpriteHandle> &sprites)
+{
+    if (factory == nullptr)
+        return false;
+
+    bool success = true;
+    Array<FudgetAtlasPlacement> page_placements;
+    Array<int> page_indexes;
+    Array<bool> copied;
+    for (int page = 0; page < _page_count; ++page)
+    {
+        page_placements.Clear();
+        page_indexes.Clear();
+        for (int ix = 0, siz = _placements.Count(); ix < siz; ++ix)
+        {
+            if (_placements[ix].Page != page)
+                continue;
+            page_placements.Add(_placements[ix]);
+            page_indexes.Add(ix);
+        }
+
+        SpriteAtlas *atlas = factory->CreateAtlas(Int2(_page_size, _page_size), _padding, page_placements, copied);
+        if (atlas == nullptr)
+        {
+            success = false;
+            continue;
+        }
+        atlases.Add(atlas);
+
+        for (int page_ix = 0, siz = page_indexes.Count(); page_ix < siz; ++page_ix)
+        {
+            // The texture couldn't be read, and the drawables should keep drawing it instead of the empty space.
+            if (page_ix >= copied.Count() || !copied[page_ix])
+                continue;
+
+            int ix = page_indexes[page_ix];
+            Sprite sprite;
+            sprite.Area = GetPlacementUV(ix);
+            sprite.Name = String::Format(TEXT("{0}"), ix);
+            sprites[_placements[ix].Texture] = atlas->AddSprite(sprite);
+        }
+    }
+    return success;
+}
+
+int FudgetAtlasBuilder::RewriteInstructions(FudgetDrawInstructionList *list, const Dictionary<TextureBase*, SpriteHandle> &sprites)
+{
+    if (list == nullptr)
+        return 0;
+
+    int result = 0;
+    const SpriteHandle *sprite = nullptr;
+    for (FudgetDrawInstruction *inst : list->_list)
+    {
+        switch (inst->_type)
+        {
+            case FudgetDrawInstructionType::DrawArea:
+            {
+                FudgetDrawArea &area = ((FudgetDrawInstructionDrawArea*)inst)->_draw_area;
+                if (area.Texture == nullptr || (sprite = sprites.TryGet(area.Texture.Get())) == nullptr)
+                    break;
+                area.Texture = nullptr;
+                area.SpriteHandle = FudgetSpriteHandle(*sprite);
+                ++result;
+                break;
+            }
+            case FudgetDrawInstructionType::DrawBorder:
+            {
+                FudgetDrawBorder &border = ((FudgetDrawInstructionDrawBorder*)inst)->_draw_border;
+                if (border.Texture == nullptr || (sprite = sprites.TryGet(border.Texture.Get())) == nullptr)
+                    break;
+                border.Texture = nullptr;
+                border.SpriteHandle = FudgetSpriteHandle(*sprite);
+                ++result;
+                break;
+            }
+            case FudgetDrawInstructionType::InstructionList:
+                result += RewriteInstructions((FudgetDrawInstructionList*)inst, sprites);
+                break;
+            default:
+                break;
+        }
+    }
+    return result;
+}
+
+int FudgetAtlasBuilder::RewriteThemeInstructions(const Dictionary<TextureBase*, SpriteHandle> &sprites)
+{
+    if (FudgetThemes::_data == nullptr)
+        return 0;
+
+    int result = 0;
+    for (auto &stated : FudgetThemes::_data->_draw_list)
+    {
+        for (FudgetDrawInstructionList *list : stated._instructions)
+            result += RewriteInstructions(list, sprites);
+    }
+    return result;
+}
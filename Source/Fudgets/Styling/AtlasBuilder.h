@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Math/Rectangle.h"
+
+class TextureBase;
+class SpriteAtlas;
+struct SpriteHandle;
+struct FudgetDrawInstructionList;
+
+/// <summary>
+/// Place of a texture in a page of an atlas built by FudgetAtlasBuilder.
+/// </summary>
+struct FUDGETS_API FudgetAtlasPlacement
+{
+    // The packed texture.
+    TextureBase *Texture;
+    // Index of the atlas page holding the texture.
+    int Page;
+    // Position and size of the texture in the page in pixels, not including the padding around it.
+    Rectangle Area;
+};
+
+/// <summary>
+/// Creates the textures of atlas pages for FudgetAtlasBuilder. Separating this from the builder keeps the packing
+/// and the rewriting of the drawables free of the graphics device.
+/// </summary>
+class FUDGETS_API FudgetAtlasTextureFactory
+{
+public:
+    virtual ~FudgetAtlasTextureFactory() = default;
+
+    /// <summary>
+    /// Creates an atlas with the textures copied to their places. The padding around the textures should be filled
+    /// with their edge pixels, to avoid colors bleeding in from the neighbors when the atlas is sampled.
+    /// </summary>
+    /// <param name="size">Size of the atlas in pixels</param>
+    /// <param name="padding">Width of the empty space around each texture</param>
+    /// <param name="placements">Textures on the page and their places</param>
+    /// <param name="copied">Receives whether each texture in placements was copied to the atlas. Only copied textures
+    /// get a sprite.</param>
+    /// <returns>The created atlas without sprites, or null on failure</returns>
+    virtual SpriteAtlas* CreateAtlas(Int2 size, int padding, const Array<FudgetAtlasPlacement> &placements, Array<bool> &copied) = 0;
+};
+
+/// <summary>
+/// Atlas texture factory that reads the pixels of the textures on the CPU and creates virtual sprite atlas assets.
+/// Textures that can't be read are left empty in the atlas and are not reported as copied.
+/// </summary>
+class FUDGETS_API FudgetGPUAtlasTextureFactory : public FudgetAtlasTextureFactory
+{
+public:
+    /// <inheritdoc />
+    SpriteAtlas* CreateAtlas(Int2 size, int padding, const Array<FudgetAtlasPlacement> &placements, Array<bool> &copied) override;
+};
+
+/// <summary>
+/// Packs the small textures referenced by drawables into atlas pages, and rewrites the drawables to draw sprites of
+/// the atlases instead. Drawing many controls with different textures then needs fewer texture changes. Textures
+/// that are drawn in a draw area or a draw border are collected. Textures larger than the maximum size are skipped.
+/// </summary>
+class FUDGETS_API FudgetAtlasBuilder
+{
+public:
+    /// <summary>
+    /// Creates a builder.
+    /// </summary>
+    /// <param name="page_size">Width and height of the atlas pages in pixels</param>
+    /// <param name="max_texture_size">Largest width or height of a texture that is packed</param>
+    /// <param name="padding">Empty space around each texture in the pages</param>
+    FudgetAtlasBuilder(int page_size = 1024, int max_texture_size = 256, int padding = 2);
+
+    /// <summary>
+    /// Adds a texture to be packed. Textures added before, missing or too large textures are ignored.
+    /// </summary>
+    /// <param name="texture">The texture</param>
+    /// <returns>Whether the texture was added</returns>
+    bool AddTexture(TextureBase *texture);
+    /// <summary>
+    /// Adds a texture of a size to be packed, without checking the size of the texture itself.
+    /// </summary>
+    /// <param name="texture">The texture or any pointer identifying the item</param>
+    /// <param name="size">Size of the texture in pixels</param>
+    /// <returns>Whether the texture was added</returns>
+    bool AddTexture(TextureBase *texture, Int2 size);
+    /// <summary>
+    /// Adds the textures of the draw areas and draw borders in an instruction list.
+    /// </summary>
+    /// <param name="list">The instruction list</param>
+    void AddTextures(const FudgetDrawInstructionList *list);
+    /// <summary>
+    /// Adds the textures of every drawable registered in the themes.
+    /// </summary>
+    void AddThemeTextures();
+
+    /// <summary>
+    /// Packs the added textures into as few pages as possible. Larger textures are packed first.
+    /// </summary>
+    void Pack();
+
+    /// <summary>
+    /// The places of the packed textures after Pack.
+    /// </summary>
+    const Array<FudgetAtlasPlacement>& GetPlacements() const { return _placements; }
+    /// <summary>
+    /// Number of pages needed for the packed textures.
+    /// </summary>
+    int GetPageCount() const { return _page_count; }
+    /// <summary>
+    /// Width and height of the atlas pages.
+    /// </summary>
+    int GetPageSize() const { return _page_size; }
+    /// <summary>
+    /// Area of a placement in its page in texture coordinates.
+    /// </summary>
+    /// <param name="placement_index">Index of the placement</param>
+    Rectangle GetPlacementUV(int placement_index) const;
+
+    /// <summary>
+    /// Creates the atlas pages of the packed textures and adds a sprite for each placement the factory copied. Textures
+    /// that couldn't be copied get no sprite, so the drawables keep drawing them directly.
+    /// </summary>
+    /// <param name="factory">Factory creating the page textures</param>
+    /// <param name="atlases">Receives the created atlases</param>
+    /// <param name="sprites">Receives the sprite of each copied texture</param>
+    /// <returns>Whether every page was created</returns>
+    bool Build(FudgetAtlasTextureFactory *factory, Array<SpriteAtlas*> &atlases, Dictionary<TextureBase*, SpriteHandle> &sprites);
+
+    /// <summary>
+    /// Changes the draw areas and draw borders in an instruction list to draw sprites instead of the textures found
+    /// in a map.
+    /// </summary>
+    /// <param name="list">The instruction list</param>
+    /// <param name="sprites">Sprites to draw instead of the textures</param>
+    /// <returns>Number of changed instructions</returns>
+    static int RewriteInstructions(FudgetDrawInstructionList *list, const Dictionary<TextureBase*, SpriteHandle> &sprites);
+    /// <summary>
+    /// Changes every drawable registered in the themes to draw sprites instead of the textures found in a map.
+    /// </summary>
+    /// <param name="sprites">Sprites to draw instead of the textures</param>
+    /// <returns>Number of changed instructions</returns>
+    static int RewriteThemeInstructions(const Dictionary<TextureBase*, SpriteHandle> &sprites);
+private:
+    struct Item
+    {
+        TextureBase *Texture;
+        Int2 Size;
+    };
+
+    int _page_size;
+    int _max_texture_size;
+    int _padding;
+
+    Array<Item> _items;
+    Array<FudgetAtlasPlacement> _placements;
+    int _page_count;
+};
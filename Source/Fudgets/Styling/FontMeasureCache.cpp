@@ -0,0 +1,133 @@
+#include "FontMeasureCache.h"
+#include "TextMeasureCache.h"
+#include "StyleStructs.h"
+
+#include "Engine/Render2D/Font.h"
+#include "Engine/Render2D/FontAsset.h"
+
+
+Dictionary<Font*, FudgetFontMeasureCache*> FudgetFontMeasureCache::_caches;
+
+FudgetFontMeasureCache::FudgetFontMeasureCache(Font *font) : _font(font), _asset(font->GetAsset())
+{
+    for (int ix = 0; ix < LatinCount; ++ix)
+        _latin_advances[ix] = NotCached;
+
+    _font->Deleted.Bind<FudgetFontMeasureCache, &FudgetFontMeasureCache::OnFontDeleted>(this);
+    if (_asset != nullptr)
+        _asset->OnReloading.Bind<FudgetFontMeasureCache, &FudgetFontMeasureCache::OnAssetReloading>(this);
+}
+
+FudgetFontMeasureCache::~FudgetFontMeasureCache()
+{
+    if (_asset != nullptr)
+        _asset->OnReloading.Unbind<FudgetFontMeasureCache, &FudgetFontMeasureCache::OnAssetReloading>(this);
+}
+
+FudgetFontMeasureCache* FudgetFontMeasureCache::Get(Font *font)
+{
+    if (font == nullptr)
+        return nullptr;
+
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    FudgetFontMeasureCache *cache;
+    if (_caches.TryGet(font, cache))
+        return cache;
+
+    cache = New<FudgetFontMeasureCache>(font);
+    _caches[font] = cache;
+    return cache;
+}
+
+int FudgetFontMeasureCache::GetAdvance(Char c)
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    if (c < LatinCount)
+    {
+        int &advance = _latin_advances[c];
+        if (advance == NotCached)
+        {
+            FontCharacterEntry entry;
+            _font->GetCharacter(c, entry);
+            advance = entry.AdvanceX;
+        }
+        return advance;
+    }
+
+    int advance;
+    if (_advances.TryGet(c, advance))
+        return advance;
+
+    FontCharacterEntry entry;
+    _font->GetCharacter(c, entry);
+    advance = entry.AdvanceX;
+    _advances[c] = advance;
+    return advance;
+}
+
+int FudgetFontMeasureCache::GetKerning(Char first, Char second)
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    if (first < LatinCount && second < LatinCount)
+    {
+        if (_latin_kerning.IsEmpty())
+        {
+            _latin_kerning.Resize(LatinCount * LatinCount);
+            for (int ix = 0, siz = _latin_kerning.Count(); ix < siz; ++ix)
+                _latin_kerning[ix] = NotCached;
+        }
+
+        int &kerning = _latin_kerning[first * LatinCount + second];
+        if (kerning == NotCached)
+            kerning = _font->GetKerning(first, second);
+        return kerning;
+    }
+
+    uint32 key = ((uint32)first << 16) | (uint32)second;
+    int kerning;
+    if (_kerning.TryGet(key, kerning))
+        return kerning;
+
+    kerning = _font->GetKerning(first, second);
+    _kerning[key] = kerning;
+    return kerning;
+}
+
+float FudgetFontMeasureCache::MeasureWidth(const StringView &text, float scale)
+{
+    // Locked once for the whole text instead of for every character.
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    int width = 0;
+    for (int ix = 0, siz = text.Length(); ix < siz; ++ix)
+    {
+        if (ix > 0)
+            width += GetKerning(text[ix - 1], text[ix]);
+        width += GetAdvance(text[ix]);
+    }
+    return width * scale;
+}
+
+void FudgetFontMeasureCache::Clear()
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    for (int ix = 0; ix < LatinCount; ++ix)
+        _latin_advances[ix] = NotCached;
+    _latin_kerning.Clear();
+    _advances.Clear();
+    _kerning.Clear();
+}
+
+void FudgetFontMeasureCache::OnFontDeleted(ScriptingObject *obj)
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    FudgetTextMeasureCache::RemoveFont(_font);
+    _caches.Remove(_font);
+    Delete(this);
+}
+
+void FudgetFontMeasureCache::OnAssetReloading(Asset *asset)
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    FudgetTextMeasureCache::RemoveFont(_font);
+    Clear();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Types/StringView.h"
+
+class Font;
+class Asset;
+class ScriptingObject;
+
+/// <summary>
+/// Cached character advances and kerning pairs of a font, shared by every text painter using the same font. Latin
+/// characters and pairs of them are looked up in dense tables, other characters in hash maps. The values are in
+/// font units, the same as returned by the font, and callers apply their own scale. The cache is cleared when the
+/// font's asset is reloaded and deleted with the font.
+/// Every lookup takes FudgetFont::MeasureLocker for its own duration, because layouts can measure on the job
+/// system. Callers don't need to hold the lock.
+/// </summary>
+class FUDGETS_API FudgetFontMeasureCache
+{
+public:
+    // Use Get to access the shared cache of a font instead.
+    FudgetFontMeasureCache(Font *font);
+    ~FudgetFontMeasureCache();
+
+    /// <summary>
+    /// Returns the measurement cache of a font, creating it on first use.
+    /// </summary>
+    /// <param name="font">The font to measure with</param>
+    /// <returns>The cache of the font or null if the font is null</returns>
+    static FudgetFontMeasureCache* Get(Font *font);
+
+    /// <summary>
+    /// Horizontal advance of a character in font units.
+    /// </summary>
+    /// <param name="c">The character to look up</param>
+    /// <returns>The advance of the character</returns>
+    int GetAdvance(Char c);
+
+    /// <summary>
+    /// Kerning between two characters in font units.
+    /// </summary>
+    /// <param name="first">The character on the left</param>
+    /// <param name="second">The character on the right</param>
+    /// <returns>The kerning to add between the characters</returns>
+    int GetKerning(Char first, Char second);
+
+    /// <summary>
+    /// Measures the width of a single line of text from the cached advances and kerning.
+    /// </summary>
+    /// <param name="text">The text to measure. It shouldn't contain line breaks</param>
+    /// <param name="scale">The scale to apply to the font units</param>
+    /// <returns>Width of the text with the scale applied</returns>
+    float MeasureWidth(const StringView &text, float scale);
+
+    /// <summary>
+    /// Removes every cached value, so they are looked up from the font again.
+    /// </summary>
+    void Clear();
+private:
+    void OnFontDeleted(ScriptingObject *obj);
+    void OnAssetReloading(Asset *asset);
+
+    // Characters below this value are stored in the dense tables.
+    static constexpr int LatinCount = 256;
+    // Marks a value in the dense tables that wasn't looked up yet.
+    static constexpr int NotCached = MIN_int32;
+
+    Font *_font;
+    Asset *_asset;
+
+    // Advances of the Latin characters.
+    int _latin_advances[LatinCount];
+    // Kerning of Latin character pairs, indexed as first * LatinCount + second. Only allocated when first used.
+    Array<int> _latin_kerning;
+    Dictionary<Char, int> _advances;
+    Dictionary<uint32, int> _kerning;
+
+    static Dictionary<Font*, FudgetFontMeasureCache*> _caches;
+};
@@ -1,6 +1,8 @@
 #include "LineEditTextPainter.h"
 #include "../DrawableBuilder.h"
 #include "../../Control.h"
+#include "../FontMeasureCache.h"
+#include "../TextMeasureCache.h"
 
 #include "Engine/Content/Content.h"
 #include "Engine/Render2D/FontManager.h"
@@ -58,7 +60,9 @@ void FudgetLineEditTextPainter::Draw(FudgetControl *control, const Rectangle &bo
     else
     {
         TextRange range2;
-
+        FudgetFontMeasureCache *glyphs = FudgetFontMeasureCache::Get(_font.Font);
+        // MeasureText was called with the default layout options here before.
+        float measure_scale = 1.0f / FontManager::FontScale;
 
         Rectangle r = bounds;
         opt.Bounds = r;
@@ -73,12 +77,12 @@ void FudgetLineEditTextPainter::Draw(FudgetControl *control, const Rectangle &bo
         {
             control->DrawText(_font.Font, text, range2, text_color, opt);
 
-            r.Location = Int2(int(r.Location.X + _font.Font->MeasureText(text, range2).X), (int)r.Location.Y);
+            r.Location = Int2(int(r.Location.X + glyphs->MeasureWidth(text.Substring(range2.StartIndex, range2.Length()), measure_scale)), (int)r.Location.Y);
             if (range2.EndIndex < range.EndIndex)
             {
                 Char prev_char = text[range2.EndIndex - 1];
                 Char next_char = text[range2.EndIndex];
-                r.Location.X += _font.Font->GetKerning(prev_char, next_char) * scale;
+                r.Location.X += glyphs->GetKerning(prev_char, next_char) * scale;
             }
             opt.Bounds = r;
         }
@@ -88,7 +92,7 @@ void FudgetLineEditTextPainter::Draw(FudgetControl *control, const Rectangle &bo
 
         if (range2.StartIndex < range2.EndIndex)
         {
-            Float2 selRectSize = _font.Font->MeasureText(text, range2);
+            Float2 selRectSize(glyphs->MeasureWidth(text.Substring(range2.StartIndex, range2.Length()), measure_scale), 0.0f);
             control->DrawDrawable(sel_bg, sel_bg->FindMatchingState(states | (uint64)FudgetVisualControlState::Selected), Rectangle(opt.Bounds.Location, Float2(selRectSize.X, opt.Bounds.Size.Y)), sel_bg_tint);
             control->DrawText(_font.Font, text, range2, sel_text_color, opt);
 
@@ -96,9 +100,9 @@ void FudgetLineEditTextPainter::Draw(FudgetControl *control, const Rectangle &bo
             {
                 Char prev_char = text[range2.EndIndex - 1];
                 Char next_char = text[range2.EndIndex];
-                r.Location.X += _font.Font->GetKerning(prev_char, next_char) * scale;
+                r.Location.X += glyphs->GetKerning(prev_char, next_char) * scale;
 
-                r.Location = Float2(r.Location.X + _font.Font->MeasureText(text, range2).X, r.Location.Y);
+                r.Location = Float2(r.Location.X + selRectSize.X, r.Location.Y);
                 opt.Bounds = r;
             }
         }
@@ -125,7 +129,18 @@ Int2 FudgetLineEditTextPainter::Measure(FudgetControl *control, const StringView
     opt.TextWrapping = TextWrapping::NoWrap;
     opt.Bounds = Rectangle(Float2::Zero, Float2::Zero);
 
-    return _font.Font->MeasureText(text, range, opt);
+    StringView measured(text.Get() + range.StartIndex, range.EndIndex - range.StartIndex);
+    Int2 result;
+    if (FudgetTextMeasureCache::TryGet(_font.Font, options.Scale, measured, result))
+        return result;
+
+    {
+        // The font caches its characters while measuring, so only one thread can measure with fonts at a time.
+        ScopeLock lock(FudgetFont::MeasureLocker());
+        result = _font.Font->MeasureText(text, range, opt);
+    }
+    FudgetTextMeasureCache::Add(_font.Font, options.Scale, measured, result);
+    return result;
 }
 
 int FudgetLineEditTextPainter::GetKerning(Char a, Char b, float scale) const
@@ -134,7 +149,7 @@ int FudgetLineEditTextPainter::GetKerning(Char a, Char b, float scale) const
         return 0;
 
     scale = scale / FontManager::FontScale;
-    return int(_font.Font->GetKerning(a, b) * scale);
+    return int(FudgetFontMeasureCache::Get(_font.Font)->GetKerning(a, b) * scale);
 }
 
 int FudgetLineEditTextPainter::HitTest(FudgetControl *control, const Rectangle &bounds, const StringView &text, const FudgetTextRange &range, uint64 state, const FudgetSingleLineTextOptions &options, const Int2 &point)
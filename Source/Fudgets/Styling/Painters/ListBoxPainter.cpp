@@ -35,7 +35,8 @@ void FudgetListBoxItemPainter::Draw(FudgetControl *control, const Rectangle &bou
     if (!_bg_draw->IsEmpty())
         control->DrawDrawable(_bg_draw, _bg_draw->FindMatchingState(states), bounds, _bg_tint.FindMatchingColor(states));
 
-    String text = data->GetText(item_index);
+    String storage;
+    const String &text = GetItemText(item_index, data, storage);
 
     FudgetTextRange full_range;
     full_range.StartIndex = 0;
@@ -50,13 +51,23 @@ Int2 FudgetListBoxItemPainter::Measure(FudgetControl *control, int item_index, I
     if (_text_painter == nullptr || data == nullptr || item_index < 0 || item_index >= data->GetCount())
         return Int2::Zero;
 
-    String text = data->GetText(item_index);
+    String storage;
+    const String &text = GetItemText(item_index, data, storage);
 
     FudgetTextRange full_range;
     full_range.StartIndex = 0;
     full_range.EndIndex = text.Length();
 
     FudgetSingleLineTextOptions opt;
-    return _text_painter->Measure(control, data->GetText(item_index), full_range, state, opt);
+    return _text_painter->Measure(control, text, full_range, state, opt);
 }
 
+const String& FudgetListBoxItemPainter::GetItemText(int item_index, IFudgetDataProvider *data, String &storage)
+{
+    FudgetColumnarDataProvider *columnar = ScriptingObject::Cast<FudgetColumnarDataProvider>(FromInterface(data, IFudgetDataProvider::TypeInitializer));
+    if (columnar != nullptr)
+        return _text_cache.GetText(columnar, item_index, columnar->GetTextColumn());
+
+    storage = data->GetText(item_index);
+    return storage;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PartPainters.h"
+#include "../../ColumnarData.h"
 
 /// <summary>
 /// Mapping for FudgetListBoxItemPainter. Mapping is used to tell a part painter what Ids to look up
@@ -46,8 +47,13 @@ public:
     /// <inheritdoc />
     Int2 Measure(FudgetControl *control, int item_index, IFudgetDataProvider *data, uint64 state) override;
 private:
+    // Returns the text of an item. Columnar data is formatted through the cache, other providers copy the text to storage.
+    const String& GetItemText(int item_index, IFudgetDataProvider *data, String &storage);
+
     FudgetDrawable *_bg_draw;
     FudgetDrawColors _bg_tint;
 
     FudgetSingleLineTextPainter *_text_painter;
+
+    FudgetCellTextCache _text_cache;
 };
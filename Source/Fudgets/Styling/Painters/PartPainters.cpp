@@ -230,3 +230,21 @@ FudgetListItemPainter::FudgetListItemPainter(const SpawnParams &params) : Base(p
 
 }
 
+
+// FudgetTableCellPainter
+
+
+FudgetTableCellPainter::FudgetTableCellPainter(const SpawnParams &params) : Base(params)
+{
+
+}
+
+
+// FudgetTreeItemPainter
+
+
+FudgetTreeItemPainter::FudgetTreeItemPainter(const SpawnParams &params) : Base(params)
+{
+
+}
+
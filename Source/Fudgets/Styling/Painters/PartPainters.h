@@ -545,3 +545,91 @@ public:
     API_FUNCTION() virtual Int2 Measure(FudgetControl *control, int item_index, IFudgetDataProvider *data, uint64 state) { return Int2::Zero; }
 };
 
+
+class FudgetColumnarDataProvider;
+
+/// <summary>
+/// Base class for painter objects that paint the cells and column headers of table controls
+/// </summary>
+API_CLASS(Abstract)
+class FUDGETS_API FudgetTableCellPainter : public FudgetPartPainter
+{
+    using Base = FudgetPartPainter;
+    DECLARE_SCRIPTING_TYPE(FudgetTableCellPainter);
+public:
+    /// <summary>
+    /// Draws a single cell.
+    /// </summary>
+    /// <param name="control">Control used for drawing</param>
+    /// <param name="bounds">Bounds of the cell</param>
+    /// <param name="row">Index of the row in data</param>
+    /// <param name="column">Index of the column in data</param>
+    /// <param name="data">Source of cell data</param>
+    /// <param name="state">State of control and the row</param>
+    API_FUNCTION() virtual void Draw(FudgetControl *control, const Rectangle &bounds, int row, int column, FudgetColumnarDataProvider *data, uint64 state) {}
+
+    /// <summary>
+    /// Measures a single cell.
+    /// </summary>
+    /// <param name="control">Control used for measuring</param>
+    /// <param name="row">Index of the row in data</param>
+    /// <param name="column">Index of the column in data</param>
+    /// <param name="data">Source of cell data</param>
+    /// <param name="state">State of control and the row</param>
+    /// <returns>Dimensions of the cell</returns>
+    API_FUNCTION() virtual Int2 Measure(FudgetControl *control, int row, int column, FudgetColumnarDataProvider *data, uint64 state) { return Int2::Zero; }
+
+    /// <summary>
+    /// Draws the header of a column.
+    /// </summary>
+    /// <param name="control">Control used for drawing</param>
+    /// <param name="bounds">Bounds of the header</param>
+    /// <param name="title">Title of the column</param>
+    /// <param name="state">State of control</param>
+    API_FUNCTION() virtual void DrawHeader(FudgetControl *control, const Rectangle &bounds, const StringView &title, uint64 state) {}
+
+    /// <summary>
+    /// Measures the header of a column.
+    /// </summary>
+    /// <param name="control">Control used for measuring</param>
+    /// <param name="title">Title of the column</param>
+    /// <param name="state">State of control</param>
+    /// <returns>Dimensions of the header</returns>
+    API_FUNCTION() virtual Int2 MeasureHeader(FudgetControl *control, const StringView &title, uint64 state) { return Int2::Zero; }
+};
+
+
+class FudgetTreeDataProvider;
+
+/// <summary>
+/// Base class for painter objects that paint the nodes of tree controls
+/// </summary>
+API_CLASS(Abstract)
+class FUDGETS_API FudgetTreeItemPainter : public FudgetPartPainter
+{
+    using Base = FudgetPartPainter;
+    DECLARE_SCRIPTING_TYPE(FudgetTreeItemPainter);
+public:
+    /// <summary>
+    /// Draws a single node.
+    /// </summary>
+    /// <param name="control">Control used for drawing</param>
+    /// <param name="bounds">Bounds of the whole row of the node</param>
+    /// <param name="expander">Bounds of the button that expands or collapses the node. The content of the node is drawn
+    /// to its right. When the node has no children, the width is zero and the rectangle is where the content starts</param>
+    /// <param name="node">Id of the node in data</param>
+    /// <param name="data">Source of node data</param>
+    /// <param name="state">State of control and the node</param>
+    API_FUNCTION() virtual void Draw(FudgetControl *control, const Rectangle &bounds, const Rectangle &expander, int node, FudgetTreeDataProvider *data, uint64 state) {}
+
+    /// <summary>
+    /// Measures the content of a node without its indentation and expander button.
+    /// </summary>
+    /// <param name="control">Control used for measuring</param>
+    /// <param name="node">Id of the node in data</param>
+    /// <param name="data">Source of node data</param>
+    /// <param name="state">State of control and the node</param>
+    /// <returns>Dimensions of the node</returns>
+    API_FUNCTION() virtual Int2 Measure(FudgetControl *control, int node, FudgetTreeDataProvider *data, uint64 state) { return Int2::Zero; }
+};
+
@@ -89,15 +89,26 @@ void FudgetScrollBarPainter::GetPartBounds(FudgetControl *control, const Rectang
     GetPartBounds(control, bounds, range, page_size, thumb_pos, track, before_track, after_track, thumb_button, buttons.Get());
 }
 
-#pragma warning(disable:6385)
 void FudgetScrollBarPainter::GetPartBounds(FudgetControl *control, const Rectangle &bounds, int64 range, int64 page_size, int64 thumb_pos,
     Rectangle &track, Rectangle &before_track, Rectangle &after_track, Rectangle &thumb_button, Rectangle *buttons) const
 {
-    thumb_pos = Math::Clamp(thumb_pos, (int64)0, Math::Max(0LL, range - page_size));
+    int thumb_size;
+    GetTrackBounds(control, bounds, range, page_size, track, thumb_size, buttons);
+    GetThumbBounds(control, track, thumb_size, range, page_size, thumb_pos, before_track, after_track, thumb_button);
+}
 
-    before_track = Rectangle::Empty;
-    after_track = Rectangle::Empty; 
-    thumb_button = Rectangle::Empty;
+void FudgetScrollBarPainter::GetTrackBounds(FudgetControl *control, const Rectangle &bounds, int64 range, int64 page_size,
+    API_PARAM(Out) Rectangle &track, API_PARAM(Out) int &thumb_size, API_PARAM(Out) Array<Rectangle> &buttons) const
+{
+    if (buttons.Count() < _before_btn_count + _after_btn_count)
+        buttons.Resize(_before_btn_count + _after_btn_count);
+    GetTrackBounds(control, bounds, range, page_size, track, thumb_size, buttons.Get());
+}
+
+#pragma warning(disable:6385)
+void FudgetScrollBarPainter::GetTrackBounds(FudgetControl *control, const Rectangle &bounds, int64 range, int64 page_size, Rectangle &track,
+    int &thumb_size, Rectangle *buttons) const
+{
     int btn_cnt = _before_btn_count + _after_btn_count;
     for (int ix = 0; ix < btn_cnt; ++ix)
         buttons[ix] = Rectangle::Empty;
@@ -105,7 +116,9 @@ void FudgetScrollBarPainter::GetPartBounds(FudgetControl *control, const Rectang
 
     if ((!_thumb_size_fixed && size <= _min_thumb_size) || (_thumb_size_fixed && size <= _thumb_size))
     {
-        thumb_button = bounds;
+        // The thumb button fills the whole scrollbar.
+        track = bounds;
+        thumb_size = size;
         return;
     }
 
@@ -167,21 +180,33 @@ void FudgetScrollBarPainter::GetPartBounds(FudgetControl *control, const Rectang
     }
 
     size -= siz_before + siz_after;
-    int thumb_siz = Math::Min(size, _thumb_size_fixed ? Math::Min(size, _thumb_size) :
+    thumb_size = Math::Min(size, _thumb_size_fixed ? Math::Min(size, _thumb_size) :
         range * size == 0 ? Math::Max(_min_thumb_size, int(page_size)) : Math::Max(_min_thumb_size, int(page_size / (float)range * size)));
 
     bpos = bounds.GetUpperLeft();
     RelevantRef(bpos) += siz_before;
     RelevantRef(bsize) = (float)size;
     track = Rectangle(bpos, bsize);
-    int before_siz = range <= page_size ? 0 : int((size - thumb_siz) * (thumb_pos / float(range - page_size)));
+}
+
+void FudgetScrollBarPainter::GetThumbBounds(FudgetControl *control, const Rectangle &track, int thumb_size, int64 range, int64 page_size, int64 thumb_pos,
+    API_PARAM(Out) Rectangle &before_track, API_PARAM(Out) Rectangle &after_track, API_PARAM(Out) Rectangle &thumb_button) const
+{
+    thumb_pos = Math::Clamp(thumb_pos, (int64)0, Math::Max(0LL, range - page_size));
+
+    int size = (int)Relevant(track.Size);
+    Float2 bpos = track.GetUpperLeft();
+    Float2 bsize;
+    OppositeRef(bsize) = Opposite(track.Size);
+
+    int before_siz = range <= page_size ? 0 : int((size - thumb_size) * (thumb_pos / float(range - page_size)));
     RelevantRef(bsize) = (float)before_siz;
     before_track = Rectangle(bpos, bsize);
     RelevantRef(bpos) += before_siz;
-    RelevantRef(bsize) = (float)thumb_siz;
+    RelevantRef(bsize) = (float)thumb_size;
     thumb_button = Rectangle(bpos, bsize);
-    RelevantRef(bpos) += thumb_siz;
-    RelevantRef(bsize) = (float)(size - (thumb_siz + before_siz));
+    RelevantRef(bpos) += thumb_size;
+    RelevantRef(bsize) = (float)(size - (thumb_size + before_siz));
     after_track = Rectangle(bpos, bsize);
 }
 
@@ -188,6 +188,42 @@ public:
     void GetPartBounds(FudgetControl *control, const Rectangle &bounds, int64 range, int64 page_size, int64 thumb_pos, Rectangle &track,
         Rectangle &before_track, Rectangle &after_track, Rectangle &thumb_button, Rectangle *buttons) const;
 
+    /// <summary>
+    /// Returns the position and size of the parts of the scrollbar that don't depend on the scroll position. The results can be
+    /// kept until the bounds, range or page size change, and passed to GetThumbBounds to get the remaining parts.
+    /// </summary>
+    /// <param name="control">The control to draw the scrollbar in.</param>
+    /// <param name="bounds">The bounding rectangle where the scrollbar would be drawn.</param>
+    /// <param name="range">Maximum value of the scrollbar if the page size is ignored.</param>
+    /// <param name="page_size">Size of the visible page that is represented by the thumb button's size when it is not fixed sized.</param>
+    /// <param name="track">Receives the bounding rectangle of the whole painted track where the thumb button is dragged.</param>
+    /// <param name="thumb_size">Receives the size of the thumb button along the track.</param>
+    /// <param name="buttons">Receives the bounding rectangle of the buttons before and after the track. If the array is large enough to receive the values, no allocation will take place.</param>
+    API_FUNCTION() virtual void GetTrackBounds(FudgetControl *control, const Rectangle &bounds, int64 range, int64 page_size,
+        API_PARAM(Out) Rectangle &track, API_PARAM(Out) int &thumb_size, API_PARAM(Out) Array<Rectangle> &buttons) const;
+
+    /// <summary>
+    /// Same as the overloaded GetTrackBounds, but the buttons array is instead a pointer to an array. Make sure it has enough space for at least ButtonCount number of rectangles.
+    /// </summary>
+    void GetTrackBounds(FudgetControl *control, const Rectangle &bounds, int64 range, int64 page_size, Rectangle &track, int &thumb_size,
+        Rectangle *buttons) const;
+
+    /// <summary>
+    /// Returns the position and size of the thumb button and the parts of the track before and after it. These are the only parts
+    /// that change when the scroll position changes.
+    /// </summary>
+    /// <param name="control">The control to draw the scrollbar in.</param>
+    /// <param name="track">The bounding rectangle of the track returned by GetTrackBounds.</param>
+    /// <param name="thumb_size">The size of the thumb button returned by GetTrackBounds.</param>
+    /// <param name="range">Maximum value of the scrollbar if the page size is ignored.</param>
+    /// <param name="page_size">Size of the visible page.</param>
+    /// <param name="thumb_pos">The current scroll position.</param>
+    /// <param name="before_track">Receives the part of the track before the thumb button.</param>
+    /// <param name="after_track">Receives the part of the track after the thumb button.</param>
+    /// <param name="thumb_button">Receives the bounding rectangle of the thumb button that shows the current position.</param>
+    API_FUNCTION() virtual void GetThumbBounds(FudgetControl *control, const Rectangle &track, int thumb_size, int64 range, int64 page_size, int64 thumb_pos,
+        API_PARAM(Out) Rectangle &before_track, API_PARAM(Out) Rectangle &after_track, API_PARAM(Out) Rectangle &thumb_button) const;
+
     /// <summary>
     /// Draws the frame and the full track of the scrollbar. The bounds should be the bounds of the scrollbar.
     /// </summary>
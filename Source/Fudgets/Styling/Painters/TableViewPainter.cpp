@@ -0,0 +1,90 @@
+#include "TableViewPainter.h"
+#include "LineEditTextPainter.h"
+#include "../DrawableBuilder.h"
+
+#include "../../Control.h"
+
+
+FudgetTableTextCellPainter::FudgetTableTextCellPainter(const SpawnParams &params) : Base(params), _bg_draw(nullptr),
+    _header_bg_draw(nullptr), _text_painter(nullptr)
+{
+}
+
+void FudgetTableTextCellPainter::Initialize(FudgetControl *control, const Variant &mapping)
+{
+    Mapping res = *mapping.AsStructure<Mapping>();
+
+    if (!CreateMappedDrawable(control, res.BgDraw, _bg_draw))
+        _bg_draw = FudgetDrawable::Empty;
+    if (!GetMappedDrawColors(control, res.BgTint, _bg_tint))
+        _bg_tint = FudgetDrawColors();
+    if (!CreateMappedDrawable(control, res.HeaderBgDraw, _header_bg_draw))
+        _header_bg_draw = FudgetDrawable::Empty;
+    if (!GetMappedDrawColors(control, res.HeaderBgTint, _header_bg_tint))
+        _header_bg_tint = FudgetDrawColors();
+
+    _text_painter = control->CreateStylePainter<FudgetSingleLineTextPainter>(_text_painter, res.TextPainter);
+    _text_cache.Clear();
+}
+
+void FudgetTableTextCellPainter::Draw(FudgetControl *control, const Rectangle &bounds, int row, int column, FudgetColumnarDataProvider *data, uint64 state)
+{
+    if (_text_painter == nullptr || data == nullptr || row < 0 || row >= data->GetCount() || column < 0 || column >= data->GetColumnCount())
+        return;
+
+    if (!_bg_draw->IsEmpty())
+        control->DrawDrawable(_bg_draw, _bg_draw->FindMatchingState(state), bounds, _bg_tint.FindMatchingColor(state));
+
+    const String &text = _text_cache.GetText(data, row, column);
+
+    FudgetTextRange full_range;
+    full_range.StartIndex = 0;
+    full_range.EndIndex = text.Length();
+
+    FudgetSingleLineTextOptions opt;
+    _text_painter->Draw(control, bounds, text, full_range, state, opt);
+}
+
+Int2 FudgetTableTextCellPainter::Measure(FudgetControl *control, int row, int column, FudgetColumnarDataProvider *data, uint64 state)
+{
+    if (_text_painter == nullptr || data == nullptr || row < 0 || row >= data->GetCount() || column < 0 || column >= data->GetColumnCount())
+        return Int2::Zero;
+
+    const String &text = _text_cache.GetText(data, row, column);
+
+    FudgetTextRange full_range;
+    full_range.StartIndex = 0;
+    full_range.EndIndex = text.Length();
+
+    FudgetSingleLineTextOptions opt;
+    return _text_painter->Measure(control, text, full_range, state, opt);
+}
+
+void FudgetTableTextCellPainter::DrawHeader(FudgetControl *control, const Rectangle &bounds, const StringView &title, uint64 state)
+{
+    if (_text_painter == nullptr)
+        return;
+
+    if (!_header_bg_draw->IsEmpty())
+        control->DrawDrawable(_header_bg_draw, _header_bg_draw->FindMatchingState(state), bounds, _header_bg_tint.FindMatchingColor(state));
+
+    FudgetTextRange full_range;
+    full_range.StartIndex = 0;
+    full_range.EndIndex = title.Length();
+
+    FudgetSingleLineTextOptions opt;
+    _text_painter->Draw(control, bounds, title, full_range, state, opt);
+}
+
+Int2 FudgetTableTextCellPainter::MeasureHeader(FudgetControl *control, const StringView &title, uint64 state)
+{
+    if (_text_painter == nullptr)
+        return Int2::Zero;
+
+    FudgetTextRange full_range;
+    full_range.StartIndex = 0;
+    full_range.EndIndex = title.Length();
+
+    FudgetSingleLineTextOptions opt;
+    return _text_painter->Measure(control, title, full_range, state, opt);
+}
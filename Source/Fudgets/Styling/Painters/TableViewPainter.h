@@ -0,0 +1,70 @@
+#pragma once
+
+#include "PartPainters.h"
+#include "../../ColumnarData.h"
+
+/// <summary>
+/// Mapping for FudgetTableTextCellPainter. Mapping is used to tell a part painter what Ids to look up
+/// in its owner control's style.
+/// </summary>
+API_STRUCT()
+struct FUDGETS_API FudgetTableTextCellPainterMapping
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(FudgetTableTextCellPainterMapping);
+
+    /// <summary>
+    /// The id for a background drawable of cells.
+    /// </summary>
+    API_FIELD() int BgDraw = 0;
+    /// <summary>
+    /// The id for a tint color or FudgetDrawColors to multiply every pixel of the
+    /// cell background drawable when drawing.
+    /// </summary>
+    API_FIELD() int BgTint = 0;
+    /// <summary>
+    /// The id for a background drawable of column headers.
+    /// </summary>
+    API_FIELD() int HeaderBgDraw = 0;
+    /// <summary>
+    /// The id for a tint color or FudgetDrawColors to multiply every pixel of the
+    /// header background drawable when drawing.
+    /// </summary>
+    API_FIELD() int HeaderBgTint = 0;
+    /// <summary>
+    /// The id for a textpainter's painter mapping.
+    /// </summary>
+    API_FIELD() int TextPainter = 0;
+};
+
+/// <summary>
+/// Painter for table cells and headers that shows the value of the cell as text. Numbers are only formatted to text
+/// when they change.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetTableTextCellPainter : public FudgetTableCellPainter
+{
+    using Base = FudgetTableCellPainter;
+    DECLARE_SCRIPTING_TYPE(FudgetTableTextCellPainter);
+public:
+    using Mapping = FudgetTableTextCellPainterMapping;
+
+    /// <inheritdoc />
+    void Initialize(FudgetControl *control, const Variant &mapping) override;
+    /// <inheritdoc />
+    void Draw(FudgetControl *control, const Rectangle &bounds, int row, int column, FudgetColumnarDataProvider *data, uint64 state) override;
+    /// <inheritdoc />
+    Int2 Measure(FudgetControl *control, int row, int column, FudgetColumnarDataProvider *data, uint64 state) override;
+    /// <inheritdoc />
+    void DrawHeader(FudgetControl *control, const Rectangle &bounds, const StringView &title, uint64 state) override;
+    /// <inheritdoc />
+    Int2 MeasureHeader(FudgetControl *control, const StringView &title, uint64 state) override;
+private:
+    FudgetDrawable *_bg_draw;
+    FudgetDrawColors _bg_tint;
+    FudgetDrawable *_header_bg_draw;
+    FudgetDrawColors _header_bg_tint;
+
+    FudgetSingleLineTextPainter *_text_painter;
+
+    FudgetCellTextCache _text_cache;
+};
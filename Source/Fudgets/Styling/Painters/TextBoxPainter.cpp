@@ -4,6 +4,8 @@
 #include "../Style.h"
 #include "../Themes.h"
 #include "../StyleStructs.h"
+#include "../FontMeasureCache.h"
+#include "../TextMeasureCache.h"
 #include "../../Control.h"
 
 #include "Engine/Render2D/FontManager.h"
@@ -87,6 +89,7 @@ void FudgetTextBoxPainter::Draw(FudgetControl *control, const Rectangle &bounds,
     int text_len = measurements.Text.Length();
 
     float scale = measurements.Scale / FontManager::FontScale;
+    FudgetFontMeasureCache *glyphs = FudgetFontMeasureCache::Get(_font.Font);
 
     Color text_color = _text_color.FindMatchingColor(states);
     Color sel_text_color = _text_color.FindMatchingColor(states | (uint64)FudgetVisualControlState::Selected);
@@ -126,10 +129,10 @@ void FudgetTextBoxPainter::Draw(FudgetControl *control, const Rectangle &bounds,
             int len = sel_min - line.StartIndex;
             opt.Bounds = Rectangle(line.Location + bounds.Location + offset, line.Size);
 
-            skip_width = Math::CeilToInt(_font.Font->MeasureText(StringView(measurements.Text.Get() + line.StartIndex, len), opt).X);
+            skip_width = Math::CeilToInt(glyphs->MeasureWidth(StringView(measurements.Text.Get() + line.StartIndex, len), scale));
 
             if (line.EndIndex < sel_max)
-                skip_width += Math::CeilToInt(_font.Font->GetKerning(measurements.Text[sel_min - 1], measurements.Text[sel_min]) * scale);
+                skip_width += Math::CeilToInt(glyphs->GetKerning(measurements.Text[sel_min - 1], measurements.Text[sel_min]) * scale);
 
             control->DrawText(_font.Font, StringView(measurements.Text.Get() + line.StartIndex, len), text_color, opt);
         }
@@ -142,12 +145,12 @@ void FudgetTextBoxPainter::Draw(FudgetControl *control, const Rectangle &bounds,
             opt.Bounds = Rectangle(line.Location + bounds.Location + offset + Int2(skip_width, 0), line.Size - Int2(skip_width, 0));
 
             bool full_line = sel_min == line.StartIndex && sel_end == line.EndIndex;
-            int width = full_line ? line.Size.X : Math::CeilToInt(_font.Font->MeasureText(StringView(measurements.Text.Get() + sel_pos, sel_len), opt).X);
+            int width = full_line ? line.Size.X : Math::CeilToInt(glyphs->MeasureWidth(StringView(measurements.Text.Get() + sel_pos, sel_len), scale));
             opt.Bounds.Size.X = (float)width;
 
             skip_width += width;
             if (line.EndIndex > sel_max)
-                skip_width += Math::CeilToInt(_font.Font->GetKerning(measurements.Text[sel_end - 1], measurements.Text[sel_end]) * scale);
+                skip_width += Math::CeilToInt(glyphs->GetKerning(measurements.Text[sel_end - 1], measurements.Text[sel_end]) * scale);
 
             control->DrawDrawable(_draw, sel_bg_index, opt.Bounds, sel_draw_tint);
             control->DrawText(_font.Font, StringView(measurements.Text.Get() + sel_pos, sel_len), sel_text_color, opt);
@@ -170,7 +173,7 @@ int FudgetTextBoxPainter::GetKerning(Char a, Char b, float scale) const
         return 0;
 
     scale = scale / FontManager::FontScale;
-    return Math::CeilToInt(_font.Font->GetKerning(a, b) * scale);
+    return Math::CeilToInt(FudgetFontMeasureCache::Get(_font.Font)->GetKerning(a, b) * scale);
 }
 
 int FudgetTextBoxPainter::HitTest(FudgetControl *control, const FudgetMultilineTextMeasurements &measurements, const Int2 &point)
@@ -261,12 +264,6 @@ Int2 FudgetTextBoxPainter::GetCharacterPosition(FudgetControl *control, const Fu
 
     int last_endindex = 0;
 
-    TextLayoutOptions opt;
-    opt.TextWrapping = TextWrapping::NoWrap;
-    opt.HorizontalAlignment = TextAlignment::Near;
-    opt.VerticalAlignment = TextAlignment::Center;
-    opt.Scale = measurements.Scale;
-
     for (int ix = 0, siz = measurements.Lines.Count(); ix < siz; ++ix)
     {
         const FudgetLineMeasurements &line = measurements.Lines[ix];
@@ -285,8 +282,7 @@ Int2 FudgetTextBoxPainter::GetCharacterPosition(FudgetControl *control, const Fu
         if (char_index < line.StartIndex)
             return line.Location;
 
-        opt.Bounds = Rectangle(Float2(line.Location), Float2(line.Size));
-        int measured = Math::CeilToInt(_font.Font->MeasureText(StringView(measurements.Text.Get() + line.StartIndex, char_index - line.StartIndex), opt).X);
+        int measured = Math::CeilToInt(FudgetFontMeasureCache::Get(_font.Font)->MeasureWidth(StringView(measurements.Text.Get() + line.StartIndex, char_index - line.StartIndex), scale));
 
         return line.Location + Int2(measured, 0);
     }
@@ -307,7 +303,17 @@ Int2 FudgetTextBoxPainter::Measure(FudgetControl *control, const StringView &tex
     opt.TextWrapping = TextWrapping::NoWrap;
     opt.Bounds = Rectangle(Float2::Zero, Float2::Zero);
 
-    return _font.Font->MeasureText(text, opt);
+    Int2 result;
+    if (FudgetTextMeasureCache::TryGet(_font.Font, scale, text, result))
+        return result;
+
+    {
+        // The font caches its characters while measuring, so only one thread can measure with fonts at a time.
+        ScopeLock lock(FudgetFont::MeasureLocker());
+        result = _font.Font->MeasureText(text, opt);
+    }
+    FudgetTextMeasureCache::Add(_font.Font, scale, text, result);
+    return result;
 }
 
 void FudgetTextBoxPainter::MeasureLines(FudgetControl *control, int bounds_width, const StringView &text, float scale, const FudgetMultiLineTextOptions &options, API_PARAM(Ref) FudgetMultilineTextMeasurements &result)
@@ -325,8 +331,12 @@ void FudgetTextBoxPainter::MeasureLines(FudgetControl *control, int bounds_width
 
     Int2 pos = Int2::Zero;
 
-    FontCharacterEntry current;
-    FontCharacterEntry prev;
+    FudgetFontMeasureCache *glyphs = FudgetFontMeasureCache::Get(_font.Font);
+
+    Char current;
+    Char prev;
+    // Whether prev is a character on the same line, which needs kerning with the current one.
+    bool has_prev = false;
 
     bool word_wrap = options.Wrapping && (options.WrapMode == FudgetLineWrapMode::Whitespace || options.WrapMode == FudgetLineWrapMode::WhitespaceLongWord);
 
@@ -386,18 +396,18 @@ void FudgetTextBoxPainter::MeasureLines(FudgetControl *control, int bounds_width
             kerning_width = 0;
             third_width = 0;
 
-            prev.IsValid = false;
+            has_prev = false;
 
             continue;
         }
 
-        _font.Font->GetCharacter(text[ix], current);
+        current = text[ix];
 
         if (options.Wrapping && options.WrapMode != FudgetLineWrapMode::Anywhere && options.WrapMode != FudgetLineWrapMode::Custom)
         {
             // We only care about whitespace in one of the word wrap modes.
 
-            if (StringUtils::IsWhitespace(current.Character))
+            if (StringUtils::IsWhitespace(current))
             {
                 if (charbreak == -1)
                 {
@@ -437,26 +447,28 @@ void FudgetTextBoxPainter::MeasureLines(FudgetControl *control, int bounds_width
             }
         }
 
-        int kerning = prev.IsValid ? _font.Font->GetKerning(prev.Character, current.Character) : 0;
+        int advance = glyphs->GetAdvance(current);
+        int kerning = has_prev ? glyphs->GetKerning(prev, current) : 0;
         int next_width = 0;
         if (ix == last_whitespace)
         {
-            space_width = Math::CeilToInt((current.AdvanceX + kerning) * scale);
+            space_width = Math::CeilToInt((advance + kerning) * scale);
             kerning = 0;
         }
         else if (last_whitespace != -1 && ix == last_whitespace + 1)
         {
             space_width += Math::CeilToInt(kerning * scale);
             kerning = 0;
-            next_width = Math::CeilToInt(current.AdvanceX * scale);
+            next_width = Math::CeilToInt(advance * scale);
         }
         else
         {
-            next_width = Math::CeilToInt(current.AdvanceX * scale);
+            next_width = Math::CeilToInt(advance * scale);
             kerning = Math::CeilToInt(kerning * scale);
         }
 
         prev = current;
+        has_prev = true;
 
         if (charbreak != -1)
         {
@@ -489,7 +501,7 @@ void FudgetTextBoxPainter::MeasureLines(FudgetControl *control, int bounds_width
                     kerning_width = 0;
                     third_width = 0;
 
-                    prev.IsValid = false;
+                    has_prev = false;
                 }
             }
             else
@@ -525,7 +537,7 @@ void FudgetTextBoxPainter::MeasureLines(FudgetControl *control, int bounds_width
                 kerning_width = 0;
                 third_width = 0;
 
-                prev.IsValid = false;
+                has_prev = false;
 
                 continue;
             }
@@ -542,7 +554,7 @@ void FudgetTextBoxPainter::MeasureLines(FudgetControl *control, int bounds_width
                 kerning_width = 0;
                 third_width = 0;
 
-                prev.IsValid = false;
+                has_prev = false;
 
                 continue;
             }
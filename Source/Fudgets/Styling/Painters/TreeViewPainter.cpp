@@ -0,0 +1,67 @@
+#include "TreeViewPainter.h"
+#include "LineEditTextPainter.h"
+#include "../DrawableBuilder.h"
+
+#include "../../Control.h"
+#include "../../TreeData.h"
+
+
+FudgetTreeViewItemPainter::FudgetTreeViewItemPainter(const SpawnParams &params) : Base(params), _bg_draw(nullptr),
+    _expander_draw(nullptr), _text_painter(nullptr)
+{
+}
+
+void FudgetTreeViewItemPainter::Initialize(FudgetControl *control, const Variant &mapping)
+{
+    Mapping res = *mapping.AsStructure<Mapping>();
+
+    if (!CreateMappedDrawable(control, res.BgDraw, _bg_draw))
+        _bg_draw = FudgetDrawable::Empty;
+    if (!GetMappedDrawColors(control, res.BgTint, _bg_tint))
+        _bg_tint = FudgetDrawColors();
+    if (!CreateMappedDrawable(control, res.ExpanderDraw, _expander_draw))
+        _expander_draw = FudgetDrawable::Empty;
+    if (!GetMappedDrawColors(control, res.ExpanderTint, _expander_tint))
+        _expander_tint = FudgetDrawColors();
+
+    _text_painter = control->CreateStylePainter<FudgetSingleLineTextPainter>(_text_painter, res.TextPainter);
+}
+
+void FudgetTreeViewItemPainter::Draw(FudgetControl *control, const Rectangle &bounds, const Rectangle &expander, int node, FudgetTreeDataProvider *data, uint64 state)
+{
+    if (_text_painter == nullptr || data == nullptr || node < 0)
+        return;
+
+    if (!_bg_draw->IsEmpty())
+        control->DrawDrawable(_bg_draw, _bg_draw->FindMatchingState(state), bounds, _bg_tint.FindMatchingColor(state));
+
+    if (!_expander_draw->IsEmpty() && expander.Size.X > 0.f)
+        control->DrawDrawable(_expander_draw, _expander_draw->FindMatchingState(state), expander, _expander_tint.FindMatchingColor(state));
+
+    const String &text = data->GetNodeText(node);
+
+    FudgetTextRange full_range;
+    full_range.StartIndex = 0;
+    full_range.EndIndex = text.Length();
+
+    float left = expander.GetRight();
+    Rectangle text_bounds = Rectangle(Float2(left, bounds.GetTop()), Float2(Math::Max(0.f, bounds.GetRight() - left), bounds.Size.Y));
+
+    FudgetSingleLineTextOptions opt;
+    _text_painter->Draw(control, text_bounds, text, full_range, state, opt);
+}
+
+Int2 FudgetTreeViewItemPainter::Measure(FudgetControl *control, int node, FudgetTreeDataProvider *data, uint64 state)
+{
+    if (_text_painter == nullptr || data == nullptr || node < 0)
+        return Int2::Zero;
+
+    const String &text = data->GetNodeText(node);
+
+    FudgetTextRange full_range;
+    full_range.StartIndex = 0;
+    full_range.EndIndex = text.Length();
+
+    FudgetSingleLineTextOptions opt;
+    return _text_painter->Measure(control, text, full_range, state, opt);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "PartPainters.h"
+
+/// <summary>
+/// Mapping for FudgetTreeViewItemPainter. Mapping is used to tell a part painter what Ids to look up
+/// in its owner control's style.
+/// </summary>
+API_STRUCT()
+struct FUDGETS_API FudgetTreeViewItemPainterMapping
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(FudgetTreeViewItemPainterMapping);
+
+    /// <summary>
+    /// The id for a background drawable of rows.
+    /// </summary>
+    API_FIELD() int BgDraw = 0;
+    /// <summary>
+    /// The id for a tint color or FudgetDrawColors to multiply every pixel of the
+    /// row background drawable when drawing.
+    /// </summary>
+    API_FIELD() int BgTint = 0;
+    /// <summary>
+    /// The id for a drawable of the button that expands or collapses nodes. The button is drawn with the Expanded
+    /// state when the node is expanded.
+    /// </summary>
+    API_FIELD() int ExpanderDraw = 0;
+    /// <summary>
+    /// The id for a tint color or FudgetDrawColors to multiply every pixel of the
+    /// expander drawable when drawing.
+    /// </summary>
+    API_FIELD() int ExpanderTint = 0;
+    /// <summary>
+    /// The id for a textpainter's painter mapping.
+    /// </summary>
+    API_FIELD() int TextPainter = 0;
+};
+
+/// <summary>
+/// Painter for nodes of a tree view that shows the text of the node next to its expander button.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetTreeViewItemPainter : public FudgetTreeItemPainter
+{
+    using Base = FudgetTreeItemPainter;
+    DECLARE_SCRIPTING_TYPE(FudgetTreeViewItemPainter);
+public:
+    using Mapping = FudgetTreeViewItemPainterMapping;
+
+    /// <inheritdoc />
+    void Initialize(FudgetControl *control, const Variant &mapping) override;
+    /// <inheritdoc />
+    void Draw(FudgetControl *control, const Rectangle &bounds, const Rectangle &expander, int node, FudgetTreeDataProvider *data, uint64 state) override;
+    /// <inheritdoc />
+    Int2 Measure(FudgetControl *control, int node, FudgetTreeDataProvider *data, uint64 state) override;
+private:
+    FudgetDrawable *_bg_draw;
+    FudgetDrawColors _bg_tint;
+    FudgetDrawable *_expander_draw;
+    FudgetDrawColors _expander_tint;
+
+    FudgetSingleLineTextPainter *_text_painter;
+};
@@ -400,6 +400,36 @@ enum class FudgetThemePartIds
     /// Painter information for controls with a list of items
     /// </summary>
     ListItemPainter,
+    /// <summary>
+    /// Painter information for cells and column headers of table controls
+    /// </summary>
+    TableCellPainter,
+
+    /// <summary>
+    /// Background for column headers in table controls
+    /// </summary>
+    TableHeaderBackground,
+    /// <summary>
+    /// Tint for column header backgrounds in table controls
+    /// </summary>
+    TableHeaderBackgroundTint,
+
+    /// <summary>
+    /// Painter information for nodes of tree controls
+    /// </summary>
+    TreeItemPainter,
+    /// <summary>
+    /// Button that expands or collapses nodes in tree controls
+    /// </summary>
+    TreeExpander,
+    /// <summary>
+    /// Tint for the expander buttons in tree controls
+    /// </summary>
+    TreeExpanderTint,
+    /// <summary>
+    /// Width of one level of indentation in tree controls
+    /// </summary>
+    TreeIndentation,
 };
 
 API_ENUM()
@@ -557,3 +587,35 @@ enum class FudgetListBoxPartIds
 
     BackgroundTint,
 };
+
+API_ENUM()
+enum class FudgetTableViewPartIds
+{
+    First = 7000,
+
+    CellPainter = First,
+    TextPainter,
+
+    CellBackground,
+    CellBackgroundTint,
+
+    HeaderBackground,
+    HeaderBackgroundTint,
+};
+
+API_ENUM()
+enum class FudgetTreeViewPartIds
+{
+    First = 8000,
+
+    ItemPainter = First,
+    TextPainter,
+
+    Background,
+    BackgroundTint,
+
+    Expander,
+    ExpanderTint,
+
+    Indentation,
+};
@@ -8,6 +8,7 @@
 #include "Engine/Render2D/FontAsset.h"
 #include "Engine/Render2D/TextLayoutOptions.h"
 #include "Engine/Core/Types/Variant.h"
+#include "Engine/Threading/Threading.h"
 
 struct FudgetDrawArea;
 
@@ -723,6 +724,16 @@ struct FUDGETS_API FudgetFont
 	/// Settings that were used to generate the font
 	/// </summary>
 	API_FIELD() FudgetFontSettings Settings;
+
+	/// <summary>
+	/// Lock to hold while measuring text with a font. Fonts cache their characters on first use, which is not
+	/// thread-safe, and layout-isolated containers can be measured on the job system.
+	/// </summary>
+	static CriticalSection& MeasureLocker()
+	{
+		static CriticalSection locker;
+		return locker;
+	}
 };
 
 
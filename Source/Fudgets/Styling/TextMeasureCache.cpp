@@ -0,0 +1,220 @@
+#include "TextMeasureCache.h"
+#include "FontMeasureCache.h"
+#include "StyleStructs.h"
+
+#include "Engine/Core/Types/StringUtils.h"
+
+
+Array<FudgetTextMeasureCache::Entry> FudgetTextMeasureCache::_entries;
+Dictionary<uint64, int> FudgetTextMeasureCache::_lookup;
+Array<int> FudgetTextMeasureCache::_free;
+int FudgetTextMeasureCache::_head = -1;
+int FudgetTextMeasureCache::_tail = -1;
+int FudgetTextMeasureCache::_capacity = 4096;
+int64 FudgetTextMeasureCache::_hits = 0;
+int64 FudgetTextMeasureCache::_misses = 0;
+
+bool FudgetTextMeasureCache::TryGet(Font *font, float scale, const StringView &text, Int2 &size)
+{
+    return Find(font, scale, SingleLine(), text, size);
+}
+
+void FudgetTextMeasureCache::Insert(Font *font, float scale, const LayoutKey &layout, const StringView &text, Int2 size)
+{
+    Insert(font, scale, SingleLine(), text, size);
+}
+
+bool FudgetTextMeasureCache::TryGet(Font *font, const TextLayoutOptions &layout, const StringView &text, Int2 &size)
+{
+    return Find(font, layout.Scale, MakeLayoutKey(layout), text, size);
+}
+
+void FudgetTextMeasureCache::Add(Font *font, const TextLayoutOptions &layout, const StringView &text, Int2 size)
+{
+    Insert(font, layout.Scale, MakeLayoutKey(layout), text, size);
+}
+
+bool FudgetTextMeasureCache::Find(Font *font, float scale, const LayoutKey &layout, const StringView &text, Int2 &size)
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    int index;
+    if (!_lookup.TryGet(MakeKey(font, scale, layout, text), index))
+    {
+        ++_misses;
+        return false;
+    }
+
+    const Entry &entry = _entries[index];
+    if (entry.TextFont != font || entry.Scale != scale || !(entry.Layout == layout) || StringView(entry.Text) != text)
+    {
+        ++_misses;
+        return false;
+    }
+
+    ++_hits;
+    size = entry.Size;
+    if (index != _head)
+    {
+        Unlink(index);
+        LinkFront(index);
+    }
+    return true;
+}
+
+void FudgetTextMeasureCache::Insert(Font *font, float scale, const LayoutKey &layout, const StringView &text, Int2 size)
+{
+    if (font == nullptr)
+        return;
+
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    if (_capacity < 1)
+        return;
+
+    // The font's measure cache removes the entries of the font when it's deleted or reloaded.
+    FudgetFontMeasureCache::Get(font);
+
+    uint64 key = MakeKey(font, scale, layout, text);
+    int index;
+    if (_lookup.TryGet(key, index))
+    {
+        // Same text or a colliding key. Either way the entry is replaced.
+        Unlink(index);
+    }
+    else if (!_free.IsEmpty())
+    {
+        index = _free.Pop();
+    }
+    else if (_entries.Count() < _capacity)
+    {
+        index = _entries.Count();
+        _entries.AddDefault(1);
+    }
+    else
+    {
+        index = _tail;
+        Unlink(index);
+        _lookup.Remove(_entries[index].Key);
+    }
+
+    Entry &entry = _entries[index];
+    entry.TextFont = font;
+    entry.Scale = scale;
+    entry.Layout = layout;
+    entry.Key = key;
+    entry.Text = text;
+    entry.Size = size;
+    _lookup[key] = index;
+    LinkFront(index);
+}
+
+void FudgetTextMeasureCache::RemoveFont(Font *font)
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    for (int ix = _head; ix != -1;)
+    {
+        Entry &entry = _entries[ix];
+        int next = entry.Next;
+        if (entry.TextFont == font)
+        {
+            Unlink(ix);
+            _lookup.Remove(entry.Key);
+            entry.TextFont = nullptr;
+            entry.Text.Clear();
+            _free.Add(ix);
+        }
+        ix = next;
+    }
+}
+
+void FudgetTextMeasureCache::Clear()
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    _entries.Clear();
+    _lookup.Clear();
+    _free.Clear();
+    _head = -1;
+    _tail = -1;
+}
+
+void FudgetTextMeasureCache::SetCapacity(int value)
+{
+    value = Math::Max(0, value);
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    if (_capacity == value)
+        return;
+    _capacity = value;
+    Clear();
+}
+
+float FudgetTextMeasureCache::GetHitRate()
+{
+    int64 total = _hits + _misses;
+    if (total == 0)
+        return 0.0f;
+    return (float)((double)_hits / (double)total);
+}
+
+void FudgetTextMeasureCache::ResetCounters()
+{
+    ScopeLock lock(FudgetFont::MeasureLocker());
+    _hits = 0;
+    _misses = 0;
+}
+
+FudgetTextMeasureCache::LayoutKey FudgetTextMeasureCache::SingleLine()
+{
+    LayoutKey result;
+    result.Wrapping = TextWrapping::NoWrap;
+    result.WrapWidth = 0.f;
+    result.LineGapScale = 1.f;
+    return result;
+}
+
+FudgetTextMeasureCache::LayoutKey FudgetTextMeasureCache::MakeLayoutKey(const TextLayoutOptions &layout)
+{
+    LayoutKey result;
+    result.Wrapping = layout.TextWrapping;
+    result.WrapWidth = layout.TextWrapping != TextWrapping::NoWrap ? layout.Bounds.GetWidth() : 0.f;
+    result.LineGapScale = layout.BaseLinesGapScale;
+    return result;
+}
+
+uint64 FudgetTextMeasureCache::MakeKey(Font *font, float scale, const LayoutKey &layout, const StringView &text)
+{
+    uint32 font_hash = GetHash(font);
+    CombineHash(font_hash, GetHash(scale));
+    if (!(layout == SingleLine()))
+    {
+        CombineHash(font_hash, GetHash((int)layout.Wrapping));
+        CombineHash(font_hash, GetHash(layout.WrapWidth));
+        CombineHash(font_hash, GetHash(layout.LineGapScale));
+    }
+    return ((uint64)StringUtils::GetHash(text.Get(), text.Length()) << 32) | (uint64)font_hash;
+}
+
+void FudgetTextMeasureCache::Unlink(int index)
+{
+    Entry &entry = _entries[index];
+    if (entry.Prev != -1)
+        _entries[entry.Prev].Next = entry.Next;
+    else
+        _head = entry.Next;
+    if (entry.Next != -1)
+        _entries[entry.Next].Prev = entry.Prev;
+    else
+        _tail = entry.Prev;
+    entry.Prev = -1;
+    entry.Next = -1;
+}
+
+void FudgetTextMeasureCache::LinkFront(int index)
+{
+    Entry &entry = _entries[index];
+    entry.Prev = -1;
+    entry.Next = _head;
+    if (_head != -1)
+        _entries[_head].Prev = index;
+    _head = index;
+    if (_tail == -1)
+        _tail = index;
+}
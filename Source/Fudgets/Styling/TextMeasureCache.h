@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Engine/Scripting/ScriptingType.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Types/String.h"
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Core/Math/Vector2.h"
+#include "Engine/Render2D/TextLayoutOptions.h"
+
+class Font;
+
+/// <summary>
+/// Bounded cache of measured text sizes, shared by every control and painter. Entries are looked up by font, scale
+/// and text, and for wrapped text also by the wrapping and the layout width. The least recently used entry is
+/// replaced when the cache is full. Lists of repeated labels only pay for measuring with the font once.
+/// Lookups and inserts take FudgetFont::MeasureLocker themselves, so layouts measuring on the job system only
+/// wait on each other while the cache is accessed.
+/// </summary>
+API_CLASS(Static)
+class FUDGETS_API FudgetTextMeasureCache
+{
+    DECLARE_SCRIPTING_TYPE_NO_SPAWN(FudgetTextMeasureCache);
+public:
+    /// <summary>
+    /// Looks up the size of a text measured earlier with the same font and scale.
+    /// </summary>
+    /// <param name="font">Font used for measuring</param>
+    /// <param name="scale">Scale of the text</param>
+    /// <param name="text">The measured text</param>
+    /// <param name="size">Receives the measured size if it was found</param>
+    /// <returns>Whether the text was found in the cache</returns>
+    static bool TryGet(Font *font, float scale, const StringView &text, Int2 &size);
+
+    /// <summary>
+    /// Stores the measured size of a text, replacing the least recently used entry if the cache is full.
+    /// </summary>
+    /// <param name="font">Font used for measuring</param>
+    /// <param name="scale">Scale of the text</param>
+    /// <param name="text">The measured text</param>
+    /// <param name="size">The measured size</param>
+    static void Add(Font *font, float scale, const StringView &text, Int2 size);
+
+    /// <summary>
+    /// Looks up the size of a text measured earlier in a layout with the same font, scale, wrapping, line gap and
+    /// width of the bounds. The width is ignored if the text is not wrapped.
+    /// </summary>
+    /// <param name="font">Font used for measuring</param>
+    /// <param name="layout">The layout the text was measured in</param>
+    /// <param name="text">The measured text</param>
+    /// <param name="size">Receives the measured size if it was found</param>
+    /// <returns>Whether the text was found in the cache</returns>
+    static bool TryGet(Font *font, const TextLayoutOptions &layout, const StringView &text, Int2 &size);
+
+    /// <summary>
+    /// Stores the size of a text measured in a layout, replacing the least recently used entry if the cache is full.
+    /// </summary>
+    /// <param name="font">Font used for measuring</param>
+    /// <param name="layout">The layout the text was measured in</param>
+    /// <param name="text">The measured text</param>
+    /// <param name="size">The measured size</param>
+    static void Add(Font *font, const TextLayoutOptions &layout, const StringView &text, Int2 size);
+
+    /// <summary>
+    /// Removes every entry measured with a font. Called when the font is deleted or its asset is reloaded.
+    /// </summary>
+    /// <param name="font">The font to forget</param>
+    static void RemoveFont(Font *font);
+
+    /// <summary>
+    /// Removes every entry from the cache. The hit counters are not reset.
+    /// </summary>
+    API_FUNCTION() static void Clear();
+
+    /// <summary>
+    /// The maximum number of measurements kept in the cache.
+    /// </summary>
+    API_PROPERTY() static int GetCapacity() { return _capacity; }
+
+    /// <summary>
+    /// Sets the maximum number of measurements kept in the cache. Changing the capacity clears the cache.
+    /// </summary>
+    /// <param name="value">The new capacity. Values below 1 disable caching</param>
+    API_PROPERTY() static void SetCapacity(int value);
+
+    /// <summary>
+    /// Number of measurements currently in the cache.
+    /// </summary>
+    API_PROPERTY() static int GetCount() { return _lookup.Count(); }
+
+    /// <summary>
+    /// Number of lookups that found the measured text in the cache since the last ResetCounters call.
+    /// </summary>
+    API_PROPERTY() static int64 GetHits() { return _hits; }
+
+    /// <summary>
+    /// Number of lookups that didn't find the measured text in the cache since the last ResetCounters call.
+    /// </summary>
+    API_PROPERTY() static int64 GetMisses() { return _misses; }
+
+    /// <summary>
+    /// The ratio of hits to all lookups between 0 and 1, or 0 if there were no lookups.
+    /// </summary>
+    API_PROPERTY() static float GetHitRate();
+
+    /// <summary>
+    /// Sets the hit and miss counters to zero.
+    /// </summary>
+    API_FUNCTION() static void ResetCounters();
+private:
+    // The parts of a layout that change the measured size. Single line text has no wrapping and a line gap of 1.
+    struct LayoutKey
+    {
+        TextWrapping Wrapping;
+        float WrapWidth;
+        float LineGapScale;
+
+        bool operator==(const LayoutKey &other) const
+        {
+            return Wrapping == other.Wrapping && WrapWidth == other.WrapWidth && LineGapScale == other.LineGapScale;
+        }
+    };
+
+    struct Entry
+    {
+        Font *TextFont;
+        float Scale;
+        LayoutKey Layout;
+        uint64 Key;
+        String Text;
+        Int2 Size;
+        // Neighbors in the recently used list. The head is the most recently used entry.
+        int Prev;
+        int Next;
+    };
+
+    static bool Find(Font *font, float scale, const LayoutKey &layout, const StringView &text, Int2 &size);
+    static void Insert(Font *font, float scale, const LayoutKey &layout, const StringView &text, Int2 size);
+    static LayoutKey SingleLine();
+    static LayoutKey MakeLayoutKey(const TextLayoutOptions &layout);
+    static uint64 MakeKey(Font *font, float scale, const LayoutKey &layout, const StringView &text);
+    static void Unlink(int index);
+    static void LinkFront(int index);
+
+    static Array<Entry> _entries;
+    // Maps keys to entry indexes. Keys can collide, so the found entry is checked before use.
+    static Dictionary<uint64, int> _lookup;
+    // Indexes of entries that were freed by RemoveFont.
+    static Array<int> _free;
+    static int _head;
+    static int _tail;
+    static int _capacity;
+    static int64 _hits;
+    static int64 _misses;
+};
@@ -4,6 +4,7 @@
 #include "DrawableBuilder.h"
 
 #include "DrawableBuilder.h"
+#include "AtlasBuilder.h"
 
 #include "PartPainterIds.h"
 
@@ -11,6 +12,8 @@
 #include "Painters/LineEditTextPainter.h"
 #include "Painters/TextBoxPainter.h"
 #include "Painters/ListBoxPainter.h"
+#include "Painters/TableViewPainter.h"
+#include "Painters/TreeViewPainter.h"
 #include "Painters/DrawablePainter.h"
 #include "Painters/ContentPainter.h"
 #include "Painters/ScrollBarPainter.h"
@@ -18,6 +21,7 @@
 #include "Engine/Core/Math/Color.h"
 #include "Engine/Content/Content.h"
 #include "Engine/Content/Assets/Texture.h"
+#include "Engine/Render2D/SpriteAtlas.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Scripting/Scripting.h"
 #include "Engine/Scripting/ScriptingObject.h"
@@ -50,6 +54,8 @@ const String FudgetThemes::COMBOBOX_EDITOR_STYLE = TEXT("Fudgets_ComboboxEditorS
 const String FudgetThemes::COMBOBOX_BUTTON_STYLE = TEXT("Fudgets_ComboboxButtonStyle");
 const String FudgetThemes::COMBOBOX_LIST_STYLE = TEXT("Fudgets_ComboboxListStyle");
 const String FudgetThemes::LISTBOX_STYLE = TEXT("Fudgets_ListboxStyle");
+const String FudgetThemes::TABLEVIEW_STYLE = TEXT("Fudgets_TableViewStyle");
+const String FudgetThemes::TREEVIEW_STYLE = TEXT("Fudgets_TreeViewStyle");
 const String FudgetThemes::SCROLLBAR_DEFAULT_STYLE = TEXT("Fudgets_NotClass_ScrollBarDefaultStyle");
 const String FudgetThemes::SCROLLBAR_WINDOWS_BUTTONS_STYLE = TEXT("Fudgets_NotClass_ScrollBarWindowsButtonsStyle");
 const String FudgetThemes::SCROLLBAR_OLDMAC_BUTTONS_STYLE = TEXT("Fudgets_NotClass_ScrollBarOldMacButtonsStyle");
@@ -300,6 +306,8 @@ void FudgetThemes::CreateDefaultThemesAndStyles()
     main_theme->SetClassStyleName(TEXT("Fudgets.FudgetLineEdit"), FRAMED_SINGLELINE_TEXT_INPUT_STYLE);
     main_theme->SetClassStyleName(TEXT("Fudgets.FudgetComboBox"), COMBOBOX_STYLE);
     main_theme->SetClassStyleName(TEXT("Fudgets.FudgetListBox"), LISTBOX_STYLE);
+    main_theme->SetClassStyleName(TEXT("Fudgets.FudgetTableView"), TABLEVIEW_STYLE);
+    main_theme->SetClassStyleName(TEXT("Fudgets.FudgetTreeView"), TREEVIEW_STYLE);
 
     // Painter resource mappings
 
@@ -346,6 +354,42 @@ void FudgetThemes::CreateDefaultThemesAndStyles()
     lb_item_map.BgTint = (int)FudgetListBoxPartIds::BackgroundTint;
     main_theme->SetResource(FudgetThemePartIds::ListItemPainter, FudgetPartPainter::InitializeMapping<FudgetListBoxItemPainter>(lb_item_map));
 
+    FudgetTableTextCellPainterMapping table_cell_map;
+    table_cell_map.TextPainter = (int)FudgetTableViewPartIds::TextPainter;
+    table_cell_map.BgDraw = (int)FudgetTableViewPartIds::CellBackground;
+    table_cell_map.BgTint = (int)FudgetTableViewPartIds::CellBackgroundTint;
+    table_cell_map.HeaderBgDraw = (int)FudgetTableViewPartIds::HeaderBackground;
+    table_cell_map.HeaderBgTint = (int)FudgetTableViewPartIds::HeaderBackgroundTint;
+    main_theme->SetResource(FudgetThemePartIds::TableCellPainter, FudgetPartPainter::InitializeMapping<FudgetTableTextCellPainter>(table_cell_map));
+
+    FudgetDrawableBuilder::Begin();
+    FudgetDrawableBuilder::AddColor(Color(.85f, .85f, .85f, 1.f));
+    FudgetDrawableBuilder::AddDrawBorder(FudgetDrawBorder(Color(.6f, .6f, .6f, 1.f), FudgetBorder(1), FudgetBorderPlacement::Inside));
+    main_theme->SetResource(FudgetThemePartIds::TableHeaderBackground, FudgetDrawableBuilder::End());
+    FudgetDrawableBuilder::MakeDrawColors(Color::White);
+    main_theme->SetResource(FudgetThemePartIds::TableHeaderBackgroundTint, FudgetDrawableBuilder::EndDrawColors());
+
+    FudgetTreeViewItemPainterMapping tree_item_map;
+    tree_item_map.TextPainter = (int)FudgetTreeViewPartIds::TextPainter;
+    tree_item_map.BgDraw = (int)FudgetTreeViewPartIds::Background;
+    tree_item_map.BgTint = (int)FudgetTreeViewPartIds::BackgroundTint;
+    tree_item_map.ExpanderDraw = (int)FudgetTreeViewPartIds::Expander;
+    tree_item_map.ExpanderTint = (int)FudgetTreeViewPartIds::ExpanderTint;
+    main_theme->SetResource(FudgetThemePartIds::TreeItemPainter, FudgetPartPainter::InitializeMapping<FudgetTreeViewItemPainter>(tree_item_map));
+
+    FudgetDrawableBuilder::Begin(FudgetVisualControlState::Expanded);
+    FudgetDrawableBuilder::BeginSubData();
+    FudgetDrawableBuilder::AddPadding(FudgetPadding(4));
+    FudgetDrawableBuilder::AddColor(Color(.3f, .3f, .3f, 1.f));
+    FudgetDrawableBuilder::EndSubData();
+    FudgetDrawableBuilder::Begin(0);
+    FudgetDrawableBuilder::BeginSubData();
+    FudgetDrawableBuilder::AddPadding(FudgetPadding(4));
+    FudgetDrawableBuilder::AddDrawBorder(FudgetDrawBorder(Color(.3f, .3f, .3f, 1.f), FudgetBorder(1), FudgetBorderPlacement::Inside));
+    FudgetDrawableBuilder::EndSubData();
+    main_theme->SetResource(FudgetThemePartIds::TreeExpander, FudgetDrawableBuilder::End());
+    main_theme->SetResource(FudgetThemePartIds::TreeIndentation, 16);
+
 
     FudgetScrollBarPainterMapping sb_map;
     sb_map.Orientation = FudgetScrollBarOrientation::Horizontal;
@@ -513,6 +557,23 @@ void FudgetThemes::CreateDefaultThemesAndStyles()
     listbox_style->SetResourceOverride(FudgetListBoxPartIds::TextPainter, FudgetThemePartIds::SingleLineInputTextPainter);
     listbox_style->SetResourceOverride(FudgetListBoxPartIds::Background, FudgetThemePartIds::ListItemBackground);
     listbox_style->SetResourceOverride(FudgetListBoxPartIds::BackgroundTint, FudgetThemePartIds::ListItemBackgroundTint);
+
+    FudgetStyle *tableview_style = field_style->CreateInheritedStyle(TABLEVIEW_STYLE);
+    tableview_style->SetResourceOverride(FudgetTableViewPartIds::CellPainter, FudgetThemePartIds::TableCellPainter);
+    tableview_style->SetResourceOverride(FudgetTableViewPartIds::TextPainter, FudgetThemePartIds::SingleLineInputTextPainter);
+    tableview_style->SetResourceOverride(FudgetTableViewPartIds::CellBackground, FudgetThemePartIds::ListItemBackground);
+    tableview_style->SetResourceOverride(FudgetTableViewPartIds::CellBackgroundTint, FudgetThemePartIds::ListItemBackgroundTint);
+    tableview_style->SetResourceOverride(FudgetTableViewPartIds::HeaderBackground, FudgetThemePartIds::TableHeaderBackground);
+    tableview_style->SetResourceOverride(FudgetTableViewPartIds::HeaderBackgroundTint, FudgetThemePartIds::TableHeaderBackgroundTint);
+
+    FudgetStyle *treeview_style = field_style->CreateInheritedStyle(TREEVIEW_STYLE);
+    treeview_style->SetResourceOverride(FudgetTreeViewPartIds::ItemPainter, FudgetThemePartIds::TreeItemPainter);
+    treeview_style->SetResourceOverride(FudgetTreeViewPartIds::TextPainter, FudgetThemePartIds::SingleLineInputTextPainter);
+    treeview_style->SetResourceOverride(FudgetTreeViewPartIds::Background, FudgetThemePartIds::ListItemBackground);
+    treeview_style->SetResourceOverride(FudgetTreeViewPartIds::BackgroundTint, FudgetThemePartIds::ListItemBackgroundTint);
+    treeview_style->SetResourceOverride(FudgetTreeViewPartIds::Expander, FudgetThemePartIds::TreeExpander);
+    treeview_style->SetResourceOverride(FudgetTreeViewPartIds::ExpanderTint, FudgetThemePartIds::TreeExpanderTint);
+    treeview_style->SetResourceOverride(FudgetTreeViewPartIds::Indentation, FudgetThemePartIds::TreeIndentation);
 }
 
 void FudgetThemes::Uninitialize(bool in_game)
@@ -565,6 +626,10 @@ void FudgetThemes::Uninitialize(bool in_game)
 
     _data->_draw_list.clear();
 
+    for (SpriteAtlas *atlas : _data->_atlases)
+        atlas->DeleteObject();
+    _data->_atlases.Clear();
+
 #if USE_EDITOR
     if (!in_game)
     {
@@ -698,6 +763,22 @@ FudgetPartPainter* FudgetThemes::CreatePainter(const StringAnsi &painter_name)
     return (FudgetPartPainter*)type.GetType().Script.Spawn(ScriptingObjectSpawnParams(Guid::New(), type));
 }
 
+int FudgetThemes::BuildDrawableAtlas(int page_size, int max_texture_size)
+{
+    FudgetAtlasBuilder builder(page_size, max_texture_size);
+    builder.AddThemeTextures();
+    builder.Pack();
+    if (builder.GetPlacements().IsEmpty())
+        return 0;
+
+    FudgetGPUAtlasTextureFactory factory;
+    Dictionary<TextureBase*, SpriteHandle> sprites;
+    if (!builder.Build(&factory, _data->_atlases, sprites))
+        LOG(Warning, "Failed to create every texture atlas page for the drawables.");
+
+    return FudgetAtlasBuilder::RewriteThemeInstructions(sprites);
+}
+
 int FudgetThemes::RegisterDrawInstructionList(const Array<uint64> &statelist, const std::vector<FudgetDrawInstructionList*> &drawlist)
 {
     if (drawlist.empty() || statelist.Count() != drawlist.size())
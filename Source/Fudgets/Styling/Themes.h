@@ -15,6 +15,7 @@
 class FudgetPartPainter;
 struct FudgetDrawInstructionList;
 class FudgetDrawable;
+class SpriteAtlas;
 
 /// <summary>
 /// Simple struct used as a theme resource that acts like a pointer to a different resource. If a requested resource
@@ -263,6 +264,16 @@ public:
     /// </summary>
     API_FIELD(ReadOnly) static const String LISTBOX_STYLE;
 
+    /// <summary>
+    /// Style for table controls with a header and rows of cells
+    /// </summary>
+    API_FIELD(ReadOnly) static const String TABLEVIEW_STYLE;
+
+    /// <summary>
+    /// Style for tree controls with expandable nodes
+    /// </summary>
+    API_FIELD(ReadOnly) static const String TREEVIEW_STYLE;
+
     /// <summary>
     /// Style holding values for scrollbars that should be referenced by other styles.
     /// This is a default scrollbar with no extra buttons and the page up and page down
@@ -390,6 +401,16 @@ public:
     /// </summary>
     API_FUNCTION() static FudgetPartPainter* CreatePainter(const StringAnsi &painter_name);
 
+    /// <summary>
+    /// Packs the small textures drawn by the registered drawables into atlas textures, and changes the drawables to
+    /// draw sprites of the atlases instead. Drawables registered after the call are not changed, but calling the
+    /// function again packs their textures into new atlases. The atlases are destroyed with the themes.
+    /// </summary>
+    /// <param name="page_size">Width and height of the atlas textures in pixels</param>
+    /// <param name="max_texture_size">Largest width or height of a texture that is packed</param>
+    /// <returns>Number of draw instructions changed to draw a sprite</returns>
+    API_FUNCTION() static int BuildDrawableAtlas(int page_size = 1024, int max_texture_size = 256);
+
     /// <summary>
     /// Checks if there's a class by the passed name that was inherited from the template argument type. Both classes must
     /// have been declared with API_CLASS and have their type initializer set up in generated code.
@@ -456,6 +477,9 @@ private:
         Dictionary<int, FontAsset*> _font_asset_map;
 
         std::vector<StatedDrawInstructions> _draw_list;
+
+        // Atlases created by BuildDrawableAtlas from the textures of drawables.
+        Array<SpriteAtlas*> _atlases;
     };
 
 #if USE_EDITOR
@@ -478,5 +502,6 @@ private:
     static int _initialized_count;
 
     friend class FudgetDrawableBuilder;
+    friend class FudgetAtlasBuilder;
     friend class FudgetStyle;
 };
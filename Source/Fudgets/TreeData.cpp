@@ -0,0 +1,411 @@
+#include "TreeData.h"
+
+#include "Engine/Core/Types/Variant.h"
+#include "Engine/Core/Math/Math.h"
+
+
+FudgetTreeDataProvider::FudgetTreeDataProvider(const SpawnParams &params) : Base(params)
+{
+    _consumers = New<FudgetDataConsumerRegistry>(SpawnParams(Guid::New(), FudgetDataConsumerRegistry::TypeInitializer));
+
+    Node &root = _nodes.AddOne();
+    root.Parent = -1;
+    root.IndexInParent = -1;
+    root.Rows = 1;
+    root.ChildRows = 0;
+    root.Expanded = true;
+    root.Used = true;
+    root.ChildTreeValid = true;
+}
+
+FudgetTreeDataProvider::~FudgetTreeDataProvider()
+{
+    Delete(_consumers);
+}
+
+int FudgetTreeDataProvider::AddNode(int parent, const StringView &text)
+{
+    int p = parent < 0 ? 0 : parent;
+    if (p != 0 && !IsNode(p))
+        return -1;
+    return InsertNode(parent, _nodes[p].Children.Count(), text);
+}
+
+int FudgetTreeDataProvider::InsertNode(int parent, int index, const StringView &text)
+{
+    int p = parent < 0 ? 0 : parent;
+    if (p != 0 && !IsNode(p))
+        return -1;
+
+    int count = _nodes[p].Children.Count();
+    index = Math::Clamp(index, 0, count);
+
+    int row = GetChildRow(p, index);
+    bool at_end = row == GetCount();
+    if (row != -1 && !(at_end ? _consumers->AddBegin(1) : _consumers->InsertBegin(row, 1)))
+        return -1;
+
+    int id = AllocateNode(p, text);
+    Node &pn = _nodes[p];
+    if (index == count && pn.ChildTreeValid)
+    {
+        // Appending to a valid Fenwick tree only needs the sum of the range the new entry covers.
+        int k = count + 1;
+        pn.ChildTree.Add(1 + ChildRowsBefore(pn, k - 1) - ChildRowsBefore(pn, k - (k & -k)));
+        pn.Children.Add(id);
+        _nodes[id].IndexInParent = count;
+    }
+    else
+    {
+        pn.Children.Insert(index, id);
+        pn.ChildTreeValid = false;
+    }
+    pn.ChildRows += 1;
+    if (pn.Expanded)
+        PropagateRows(p, 1);
+
+    if (row != -1)
+    {
+        if (at_end)
+            _consumers->AddEnd(1);
+        else
+            _consumers->InsertEnd(row, 1);
+    }
+    return id;
+}
+
+void FudgetTreeDataProvider::RemoveNode(int node)
+{
+    if (!IsNode(node))
+        return;
+
+    int p = _nodes[node].Parent;
+    EnsureChildTree(p);
+    int index = _nodes[node].IndexInParent;
+    int rows = _nodes[node].Rows;
+
+    int row = GetChildRow(p, index);
+    if (row != -1 && !_consumers->RemoveBegin(row, rows))
+        return;
+
+    Node &pn = _nodes[p];
+    pn.Children.RemoveAtKeepOrder(index);
+    // Entries of a Fenwick tree don't cover later indexes, so removing the last child keeps the tree valid.
+    if (index == pn.Children.Count())
+        pn.ChildTree.RemoveLast();
+    else
+        pn.ChildTreeValid = false;
+    pn.ChildRows -= rows;
+    if (pn.Expanded)
+        PropagateRows(p, -rows);
+
+    FreeNode(node);
+
+    if (row != -1)
+        _consumers->RemoveEnd(row, rows);
+}
+
+void FudgetTreeDataProvider::SetNodeText(int node, const StringView &value)
+{
+    if (!IsNode(node))
+        return;
+
+    int row = GetRowOfNode(node);
+    if (row != -1 && !_consumers->SetBegin(row))
+        return;
+
+    _nodes[node].Text = value;
+
+    if (row != -1)
+        _consumers->SetEnd(row);
+}
+
+int FudgetTreeDataProvider::GetDepth(int node) const
+{
+    int depth = -1;
+    for (int n = node; n > 0; n = _nodes[n].Parent)
+        ++depth;
+    return depth;
+}
+
+void FudgetTreeDataProvider::SetExpanded(int node, bool value)
+{
+    if (!IsNode(node) || _nodes[node].Expanded == value)
+        return;
+
+    int count = _nodes[node].ChildRows;
+    int row = count > 0 ? GetRowOfNode(node) : -1;
+    bool at_end = row != -1 && row + 1 == GetCount();
+    if (row != -1)
+    {
+        bool ok;
+        if (!value)
+            ok = _consumers->RemoveBegin(row + 1, count);
+        else if (at_end)
+            ok = _consumers->AddBegin(count);
+        else
+            ok = _consumers->InsertBegin(row + 1, count);
+        if (!ok)
+            return;
+    }
+
+    _nodes[node].Expanded = value;
+    PropagateRows(node, value ? count : -count);
+
+    if (row != -1)
+    {
+        if (!value)
+            _consumers->RemoveEnd(row + 1, count);
+        else if (at_end)
+            _consumers->AddEnd(count);
+        else
+            _consumers->InsertEnd(row + 1, count);
+    }
+}
+
+bool FudgetTreeDataProvider::IsVisible(int node) const
+{
+    if (!IsNode(node))
+        return false;
+    for (int n = _nodes[node].Parent; n != 0; n = _nodes[n].Parent)
+    {
+        if (!_nodes[n].Expanded)
+            return false;
+    }
+    return true;
+}
+
+int FudgetTreeDataProvider::GetNodeAtRow(int row)
+{
+    if (row < 0 || row >= GetCount())
+        return -1;
+
+    int node = 0;
+    while (true)
+    {
+        EnsureChildTree(node);
+        const Node &n = _nodes[node];
+
+        // Finds the child holding the row by descending the Fenwick tree, subtracting the rows of the children before it.
+        int count = n.ChildTree.Count();
+        int step = 1;
+        while (step * 2 <= count)
+            step *= 2;
+        int pos = 0;
+        for (; step > 0; step >>= 1)
+        {
+            if (pos + step <= count && n.ChildTree[pos + step - 1] <= row)
+            {
+                pos += step;
+                row -= n.ChildTree[pos - 1];
+            }
+        }
+
+        int child = n.Children[pos];
+        if (row == 0)
+            return child;
+        row -= 1;
+        node = child;
+    }
+}
+
+int FudgetTreeDataProvider::GetRowOfNode(int node)
+{
+    if (!IsVisible(node))
+        return -1;
+
+    int row = 0;
+    for (int n = node; n != 0; n = _nodes[n].Parent)
+    {
+        int p = _nodes[n].Parent;
+        EnsureChildTree(p);
+        row += ChildRowsBefore(_nodes[p], _nodes[n].IndexInParent);
+        if (p != 0)
+            row += 1;
+    }
+    return row;
+}
+
+int FudgetTreeDataProvider::GetNextVisibleNode(int node, API_PARAM(Ref) int &depth)
+{
+    if (!IsNode(node))
+        return -1;
+
+    const Node &n = _nodes[node];
+    if (n.Expanded && n.Children.Count() > 0)
+    {
+        ++depth;
+        return n.Children[0];
+    }
+
+    for (int c = node; c != 0; c = _nodes[c].Parent, --depth)
+    {
+        int p = _nodes[c].Parent;
+        EnsureChildTree(p);
+        int next = _nodes[c].IndexInParent + 1;
+        if (next < _nodes[p].Children.Count())
+            return _nodes[p].Children[next];
+    }
+    return -1;
+}
+
+void FudgetTreeDataProvider::Clear()
+{
+    if (_nodes.Count() == 1)
+        return;
+
+    _consumers->ClearBegin();
+    _nodes.Resize(1);
+    Node &root = _nodes[0];
+    root.Rows = 1;
+    root.ChildRows = 0;
+    root.Children.Clear();
+    root.ChildTree.Clear();
+    root.ChildTreeValid = true;
+    _free.Clear();
+    _consumers->ClearEnd();
+}
+
+Variant FudgetTreeDataProvider::GetValue(int index)
+{
+    int node = GetNodeAtRow(index);
+    if (node == -1)
+        return Variant::Null;
+    return Variant(_nodes[node].Text);
+}
+
+void FudgetTreeDataProvider::SetValue(int index, Variant value)
+{
+    SetNodeText(GetNodeAtRow(index), value.ToString());
+}
+
+String FudgetTreeDataProvider::GetText(int index)
+{
+    int node = GetNodeAtRow(index);
+    if (node == -1)
+        return String::Empty;
+    return _nodes[node].Text;
+}
+
+void FudgetTreeDataProvider::SetText(int index, const StringView &value)
+{
+    SetNodeText(GetNodeAtRow(index), value);
+}
+
+int FudgetTreeDataProvider::AllocateNode(int parent, const StringView &text)
+{
+    int id;
+    if (_free.HasItems())
+    {
+        id = _free.Last();
+        _free.RemoveLast();
+    }
+    else
+    {
+        id = _nodes.Count();
+        _nodes.AddOne();
+    }
+
+    Node &n = _nodes[id];
+    n.Text = text;
+    n.Parent = parent;
+    n.IndexInParent = -1;
+    n.Rows = 1;
+    n.ChildRows = 0;
+    n.Expanded = false;
+    n.Used = true;
+    n.Children.Clear();
+    n.ChildTree.Clear();
+    n.ChildTreeValid = true;
+    return id;
+}
+
+void FudgetTreeDataProvider::FreeNode(int node)
+{
+    Array<int> stack;
+    stack.Add(node);
+    while (stack.HasItems())
+    {
+        int id = stack.Last();
+        stack.RemoveLast();
+
+        Node &n = _nodes[id];
+        stack.Add(n.Children.Get(), n.Children.Count());
+        n.Used = false;
+        n.Text.Clear();
+        n.Children.Clear();
+        n.ChildTree.Clear();
+        _free.Add(id);
+    }
+}
+
+void FudgetTreeDataProvider::EnsureChildTree(int node)
+{
+    Node &n = _nodes[node];
+    if (n.ChildTreeValid)
+        return;
+
+    int count = n.Children.Count();
+    n.ChildTree.Resize(count, false);
+    for (int ix = 0; ix < count; ++ix)
+    {
+        Node &child = _nodes[n.Children[ix]];
+        child.IndexInParent = ix;
+        n.ChildTree[ix] = child.Rows;
+    }
+
+    // Linear construction: each entry adds its sum to the next entry that covers it.
+    for (int ix = 1; ix <= count; ++ix)
+    {
+        int next = ix + (ix & -ix);
+        if (next <= count)
+            n.ChildTree[next - 1] += n.ChildTree[ix - 1];
+    }
+    n.ChildTreeValid = true;
+}
+
+int FudgetTreeDataProvider::ChildRowsBefore(const Node &node, int index) const
+{
+    int sum = 0;
+    for (int ix = index; ix > 0; ix -= ix & -ix)
+        sum += node.ChildTree[ix - 1];
+    return sum;
+}
+
+void FudgetTreeDataProvider::PropagateRows(int node, int delta)
+{
+    while (delta != 0)
+    {
+        Node &n = _nodes[node];
+        n.Rows += delta;
+        if (node == 0)
+            break;
+
+        Node &p = _nodes[n.Parent];
+        p.ChildRows += delta;
+        if (p.ChildTreeValid)
+        {
+            for (int ix = n.IndexInParent + 1; ix <= p.ChildTree.Count(); ix += ix & -ix)
+                p.ChildTree[ix - 1] += delta;
+        }
+        if (!p.Expanded)
+            break;
+        node = n.Parent;
+    }
+}
+
+int FudgetTreeDataProvider::GetChildRow(int parent, int index)
+{
+    int row = 0;
+    if (parent != 0)
+    {
+        if (!_nodes[parent].Expanded)
+            return -1;
+        row = GetRowOfNode(parent);
+        if (row == -1)
+            return -1;
+        row += 1;
+    }
+    EnsureChildTree(parent);
+    return row + ChildRowsBefore(_nodes[parent], index);
+}
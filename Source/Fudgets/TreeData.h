@@ -0,0 +1,214 @@
+#pragma once
+
+#include "DataInterfaces.h"
+
+#include "Engine/Core/Types/String.h"
+
+
+/// <summary>
+/// Data provider that stores text nodes in a hierarchy. Nodes can be expanded or collapsed, and the nodes visible with
+/// the current expansion are provided as a flat list of rows through the IFudgetDataProvider functions, so consumers
+/// are notified with row insertions and removals when nodes are expanded or collapsed. Views sharing the provider also
+/// share the expanded state of the nodes.
+/// Every node keeps the number of rows shown by itself and its expanded descendants, and a Fenwick tree over its
+/// children's row counts. Finding the node in a row or the row of a node takes O(depth * log n) time, and expanding or
+/// collapsing a node only updates its ancestors, not its siblings.
+/// </summary>
+API_CLASS()
+class FUDGETS_API FudgetTreeDataProvider : public ScriptingObject, public IFudgetDataProvider
+{
+    using Base = ScriptingObject;
+    DECLARE_SCRIPTING_TYPE(FudgetTreeDataProvider);
+public:
+    ~FudgetTreeDataProvider();
+
+    /// <summary>
+    /// Adds a node as the last child of a parent node. Nodes are collapsed when added.
+    /// </summary>
+    /// <param name="parent">Id of the parent node or -1 to add a top level node</param>
+    /// <param name="text">Text of the node</param>
+    /// <returns>Id of the new node or -1 if it couldn't be added. Ids of removed nodes are reused</returns>
+    API_FUNCTION() int AddNode(int parent, const StringView &text);
+    /// <summary>
+    /// Inserts a node between the children of a parent node. Nodes are collapsed when added.
+    /// </summary>
+    /// <param name="parent">Id of the parent node or -1 to insert a top level node</param>
+    /// <param name="index">Position between the children. It will be clamped between 0 and the child count</param>
+    /// <param name="text">Text of the node</param>
+    /// <returns>Id of the new node or -1 if it couldn't be inserted. Ids of removed nodes are reused</returns>
+    API_FUNCTION() int InsertNode(int parent, int index, const StringView &text);
+    /// <summary>
+    /// Removes a node with all its descendants.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    API_FUNCTION() void RemoveNode(int node);
+
+    /// <summary>
+    /// Returns the text of a node.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <returns>Text of the node</returns>
+    API_FUNCTION() const String& GetNodeText(int node) const { return _nodes[node].Text; }
+    /// <summary>
+    /// Changes the text of a node.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <param name="value">The new text</param>
+    API_FUNCTION() void SetNodeText(int node, const StringView &value);
+
+    /// <summary>
+    /// Returns the parent of a node.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <returns>Id of the parent or -1 for top level nodes</returns>
+    API_FUNCTION() int GetParent(int node) const { return _nodes[node].Parent == 0 ? -1 : _nodes[node].Parent; }
+    /// <summary>
+    /// Returns the number of children of a node.
+    /// </summary>
+    /// <param name="node">Id of the node or -1 for the number of top level nodes</param>
+    /// <returns>Number of child nodes</returns>
+    API_FUNCTION() int GetChildCount(int node) const { return _nodes[node < 0 ? 0 : node].Children.Count(); }
+    /// <summary>
+    /// Returns a child of a node.
+    /// </summary>
+    /// <param name="node">Id of the node or -1 for top level nodes</param>
+    /// <param name="index">Index of the child</param>
+    /// <returns>Id of the child node</returns>
+    API_FUNCTION() int GetChild(int node, int index) const { return _nodes[node < 0 ? 0 : node].Children[index]; }
+    /// <summary>
+    /// Returns the number of parents above a node. Top level nodes have a depth of 0.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <returns>Depth of the node</returns>
+    API_FUNCTION() int GetDepth(int node) const;
+
+    /// <summary>
+    /// Returns whether the children of a node are shown.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <returns>Whether the node is expanded</returns>
+    API_FUNCTION() bool IsExpanded(int node) const { return _nodes[node].Expanded; }
+    /// <summary>
+    /// Shows or hides the children of a node. When the node is visible, consumers are notified about the rows of the
+    /// children being inserted or removed. The change must be made between BeginChange and EndChange in that case.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <param name="value">Whether to expand the node</param>
+    API_FUNCTION() void SetExpanded(int node, bool value);
+
+    /// <summary>
+    /// Returns whether a node is shown in a row, which is when all its parents are expanded.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <returns>Whether the node is visible</returns>
+    API_FUNCTION() bool IsVisible(int node) const;
+    /// <summary>
+    /// Returns the node shown in a row.
+    /// </summary>
+    /// <param name="row">Index of the row</param>
+    /// <returns>Id of the node or -1 if row is out of range</returns>
+    API_FUNCTION() int GetNodeAtRow(int row);
+    /// <summary>
+    /// Returns the row where a node is shown.
+    /// </summary>
+    /// <param name="node">Id of the node</param>
+    /// <returns>Index of the row or -1 if the node is not visible</returns>
+    API_FUNCTION() int GetRowOfNode(int node);
+    /// <summary>
+    /// Returns the node in the row below a visible node, without looking it up from the root.
+    /// </summary>
+    /// <param name="node">Id of a visible node</param>
+    /// <param name="depth">Depth of node. It's updated to the depth of the returned node</param>
+    /// <returns>Id of the node in the next row or -1 if node is in the last row</returns>
+    API_FUNCTION() int GetNextVisibleNode(int node, API_PARAM(Ref) int &depth);
+
+    // IFudgetDataProvider
+
+    /// <inheritdoc />
+    void BeginChange() override { _consumers->BeginChange(); }
+    /// <inheritdoc />
+    void EndChange() override { _consumers->EndChange(); }
+    /// <inheritdoc />
+    void BeginDataReset() override { _consumers->BeginDataReset(); }
+    /// <inheritdoc />
+    void EndDataReset() override { _consumers->EndDataReset(); }
+    /// <summary>
+    /// Returns the number of visible rows.
+    /// </summary>
+    int GetCount() const override { return _nodes[0].ChildRows; }
+    /// <summary>
+    /// Removes every node.
+    /// </summary>
+    void Clear() override;
+    /// <summary>
+    /// Returns the text of the node in a row.
+    /// </summary>
+    Variant GetValue(int index) override;
+    /// <summary>
+    /// Sets the text of the node in a row.
+    /// </summary>
+    void SetValue(int index, Variant value) override;
+    /// <summary>
+    /// Returns the text of the node in a row.
+    /// </summary>
+    String GetText(int index) override;
+    /// <summary>
+    /// Sets the text of the node in a row.
+    /// </summary>
+    void SetText(int index, const StringView &value) override;
+    /// <summary>
+    /// Returns the id of the node in a row.
+    /// </summary>
+    int GetInt(int index) override { return GetNodeAtRow(index); }
+    /// <summary>
+    /// Does nothing, node ids can't be changed.
+    /// </summary>
+    void SetInt(int index, int value) override {}
+    /// <inheritdoc />
+    void RegisterDataConsumer(IFudgetDataConsumer *consumer) override { _consumers->RegisterDataConsumer(consumer); }
+    /// <inheritdoc />
+    void UnregisterDataConsumer(IFudgetDataConsumer *consumer) override { _consumers->UnregisterDataConsumer(consumer); }
+private:
+    struct Node
+    {
+        String Text;
+        // Internal id of the parent. Top level nodes have the hidden root node 0 as their parent.
+        int Parent;
+        // Position in the parent's children. Only valid while the parent's child tree is valid.
+        int IndexInParent;
+        // Rows shown by the node and its expanded descendants, including the row of the node itself.
+        int Rows;
+        // Sum of the Rows of the children, whether the node is expanded or not.
+        int ChildRows;
+        bool Expanded;
+        bool Used;
+        Array<int> Children;
+        // Fenwick tree over the Rows of the children, stored from index 0 for the 1-based tree.
+        Array<int> ChildTree;
+        // Set to false when children are inserted or removed in the middle. The tree and the children's
+        // IndexInParent are rebuilt on the next lookup.
+        bool ChildTreeValid;
+    };
+
+    // Returns an unused node slot, reusing removed nodes.
+    int AllocateNode(int parent, const StringView &text);
+    // Marks a node and its descendants unused.
+    void FreeNode(int node);
+    // Rebuilds the child tree and IndexInParent of the children of a node if they are not valid.
+    void EnsureChildTree(int node);
+    // Sum of the Rows of the children before index. The child tree must be valid.
+    int ChildRowsBefore(const Node &node, int index) const;
+    // Changes the Rows of a node by delta and updates its parents up to the first collapsed one.
+    void PropagateRows(int node, int delta);
+    // Row of the child of parent at index, or -1 if the children of parent are not visible. The index can be the
+    // child count for the row after the last child.
+    int GetChildRow(int parent, int index);
+    // Whether node is the id of a node that was not removed. The hidden root is not a valid node.
+    bool IsNode(int node) const { return node > 0 && node < _nodes.Count() && _nodes[node].Used; }
+
+    // Node 0 is the hidden root, which is always expanded and holds the top level nodes.
+    Array<Node> _nodes;
+    Array<int> _free;
+
+    FudgetDataConsumerRegistry *_consumers;
+};
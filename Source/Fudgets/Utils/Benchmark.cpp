@@ -0,0 +1,389 @@
+#include "Benchmark.h"
+#include "../GUIRoot.h"
+#include "../AssetRoot.h"
+#include "../ColumnarData.h"
+#include "../DrawSink.h"
+#include "../Controls/FilledBox.h"
+#include "../Controls/ListBox.h"
+#include "../Controls/TextBox.h"
+#include "../Controls/TableView.h"
+#include "../Layouts/ListLayout.h"
+#include "../Styling/Style.h"
+#include "../Styling/Themes.h"
+#include "../Styling/PartPainterIds.h"
+#include "../Styling/Painters/TextBoxPainter.h"
+
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Core/Types/StringBuilder.h"
+#include "Engine/Platform/File.h"
+#include "Engine/Serialization/Json.h"
+#include "Engine/Serialization/JsonWriters.h"
+#include "Engine/Serialization/ISerializeModifier.h"
+
+
+namespace
+{
+	// Size of the synthetic control trees. Every column is a container holding a list of boxes.
+	const int TreeColumns = 100;
+	const int TreeRows = 100;
+	const Int2 RootSize = Int2(1920, 1080);
+
+	const int HitTestQueries = 10000;
+	const int StyleLookupControls = 100;
+	const int MeasuredTextLines = 20000;
+	const int MeasureWrapWidth = 400;
+	const int ListBoxItems = 1000000;
+	const int ListBoxScrolls = 1000;
+	// The table view is sized so at least this many columns and rows are visible at once.
+	const int TableColumns = 100;
+	const int TableRows = 100;
+
+	struct Result
+	{
+		String Name;
+		// Number of items processed in one iteration, like controls laid out or queries made.
+		int Count;
+		int Iterations;
+		double Min;
+		double Mean;
+		double Max;
+		bool Skipped;
+	};
+
+	// Deterministic numbers, so every run queries the same positions and items.
+	struct Random
+	{
+		uint32 State = 0x12345678;
+
+		int Next(int max)
+		{
+			State = State * 1664525u + 1013904223u;
+			return max <= 0 ? 0 : (int)((State >> 8) % (uint32)max);
+		}
+	};
+
+	template<typename F>
+	void Measure(Array<Result> &results, const Char *name, int count, int iterations, F func)
+	{
+		Result result = { name, count, iterations, 0.0, 0.0, 0.0, false };
+		double total = 0.0;
+		for (int ix = 0; ix < iterations; ++ix)
+		{
+			double start = Platform::GetTimeSeconds();
+			func(ix);
+			double time = (Platform::GetTimeSeconds() - start) * 1000.0;
+
+			total += time;
+			result.Min = ix == 0 ? time : Math::Min(result.Min, time);
+			result.Max = Math::Max(result.Max, time);
+		}
+		result.Mean = iterations > 0 ? total / iterations : 0.0;
+		results.Add(result);
+	}
+
+	void Skip(Array<Result> &results, const Char *name, int count)
+	{
+		results.Add({ name, count, 0, 0.0, 0.0, 0.0, true });
+	}
+
+	void BuildControlTree(FudgetContainer *parent)
+	{
+		parent->CreateLayout<FudgetListLayout>()->SetOrientation(FudgetOrientation::Horizontal);
+		for (int x = 0; x < TreeColumns; ++x)
+		{
+			FudgetContainer *column = parent->CreateChild<FudgetContainer>();
+			column->CreateLayout<FudgetListLayout>()->SetOrientation(FudgetOrientation::Vertical);
+			for (int y = 0; y < TreeRows; ++y)
+				column->CreateChild<FudgetFilledBox>()->SetHintSize(Int2(16, 8));
+		}
+	}
+
+	FudgetGUIRoot* CreateRoot()
+	{
+		FudgetGUIRoot *root = New<FudgetGUIRoot>((Fudget*)nullptr);
+		root->SetHintSize(RootSize);
+		return root;
+	}
+
+	void RunTreeBenchmarks(Array<Result> &results, int iterations)
+	{
+		FudgetGUIRoot *root = CreateRoot();
+		BuildControlTree(root);
+		root->FudgetInit();
+		root->DoLayout();
+
+		Array<FudgetControl*> controls;
+		root->GetAllControls(controls);
+
+		// Changing the root size makes every column and box dirty, so each iteration lays out the whole tree.
+		Measure(results, TEXT("Layout"), controls.Count(), iterations, [root](int ix) {
+			root->SetHintSize(RootSize + Int2(ix % 2 == 0 ? 1 : 0, 0));
+			root->DoLayout();
+		});
+
+		Array<FudgetControl*> found;
+		Random random;
+		Measure(results, TEXT("ControlsAtPosition"), HitTestQueries, iterations, [root, &found, &random](int ix) {
+			for (int q = 0; q < HitTestQueries; ++q)
+			{
+				found.Clear();
+				root->ControlsAtPosition(Int2(random.Next(RootSize.X), random.Next(RootSize.Y)), FudgetControlFlag::None, FudgetControlFlag::None,
+					FudgetControlFlag::CompoundControl, FudgetControlState::None, FudgetControlState::Hidden | FudgetControlState::Invisible,
+					FudgetControlState::Hidden | FudgetControlState::Invisible, found);
+			}
+		});
+
+		// Looks up every theme resource id in the styles of some boxes, which includes misses that walk up to the theme.
+		const int first_id = (int)FudgetThemePartIds::First;
+		const int last_id = (int)FudgetThemePartIds::TreeIndentation;
+		int lookup_controls = Math::Min(StyleLookupControls, controls.Count());
+		Variant value;
+		Measure(results, TEXT("StyleResourceLookup"), lookup_controls * (last_id - first_id + 1), iterations, [&controls, lookup_controls, first_id, last_id, &value](int ix) {
+			for (int c = 0; c < lookup_controls; ++c)
+			{
+				FudgetControl *control = controls[c * controls.Count() / lookup_controls];
+				FudgetStyle *style = control->GetStyle();
+				FudgetTheme *theme = control->GetActiveTheme();
+				for (int id = first_id; id <= last_id; ++id)
+					FudgetStyle::GetResourceValue(style, theme, id, true, value);
+			}
+		});
+
+		Delete(root);
+	}
+
+	void RunMeasureBenchmarks(Array<Result> &results, int iterations)
+	{
+		StringBuilder builder;
+		for (int ix = 0; ix < MeasuredTextLines; ++ix)
+			builder.Append(String::Format(TEXT("Line {0} of the measured text with enough words to be wrapped a few times.\n"), ix));
+		String text = builder.ToString();
+
+		FudgetGUIRoot *root = CreateRoot();
+		FudgetTextBox *text_box = root->CreateChild<FudgetTextBox>();
+		root->FudgetInit();
+
+		FudgetPartPainterMapping mapping;
+		if (!FudgetStyle::GetPainterMappingResource(text_box->GetStyle(), text_box->GetActiveTheme(), (int)FudgetMultilineTextFieldPartIds::TextPainter, false, mapping))
+			mapping = FudgetPartPainter::InitializeMapping<FudgetTextBoxPainter>(FudgetTextBoxPainter::Mapping());
+
+		FudgetTextBoxPainter *painter = New<FudgetTextBoxPainter>(SpawnParams(Guid::New(), FudgetTextBoxPainter::TypeInitializer));
+		painter->Initialize(text_box, mapping.Mapping);
+
+		if (painter->GetFontHeight() <= 0)
+		{
+			Skip(results, TEXT("MeasureLines"), text.Length());
+			Skip(results, TEXT("MeasureLinesWrapped"), text.Length());
+		}
+		else
+		{
+			FudgetMultilineTextMeasurements measurements;
+			FudgetMultiLineTextOptions options;
+			Measure(results, TEXT("MeasureLines"), text.Length(), iterations, [painter, text_box, &text, &options, &measurements](int ix) {
+				painter->MeasureLines(text_box, MAX_int32, text, 1.f, options, measurements);
+			});
+
+			options.Wrapping = true;
+			Measure(results, TEXT("MeasureLinesWrapped"), text.Length(), iterations, [painter, text_box, &text, &options, &measurements](int ix) {
+				painter->MeasureLines(text_box, MeasureWrapWidth, text, 1.f, options, measurements);
+			});
+		}
+
+		// The drawables of the painter are owned by the text box, so the painter is deleted after it.
+		Delete(root);
+		Delete(painter);
+	}
+
+	void RunListBoxBenchmarks(Array<Result> &results, int iterations)
+	{
+		FudgetGUIRoot *root = CreateRoot();
+		FudgetListBox *list_box = root->CreateChild<FudgetListBox>();
+		list_box->SetHintSize(Int2(400, 600));
+		list_box->SetDefaultItemSize(Int2(400, 20));
+		root->FudgetInit();
+		root->DoLayout();
+
+		// Checking for duplicates would make filling the list quadratic. Items can only be added during a change.
+		FudgetStringListProvider *data = list_box->GetDataProvider();
+		data->SetAllowDuplicates(true);
+		Measure(results, TEXT("ListBoxFill"), ListBoxItems, 1, [data](int ix) {
+			data->BeginChange();
+			for (int item = 0; item < ListBoxItems; ++item)
+				data->AddItem(String::Format(TEXT("Item {0}"), item));
+			data->EndChange();
+		});
+
+		// The timing means nothing if the items weren't added, and scrolling an incomplete list neither.
+		if (data->GetCount() != ListBoxItems)
+		{
+			LOG(Warning, "ListBoxFill added {0} items instead of {1}", data->GetCount(), ListBoxItems);
+			results.RemoveLast();
+			Skip(results, TEXT("ListBoxFill"), ListBoxItems);
+			Skip(results, TEXT("ListBoxScrollToItem"), ListBoxScrolls);
+			Delete(root);
+			return;
+		}
+		root->DoLayout();
+
+		Random random;
+		Measure(results, TEXT("ListBoxScrollToItem"), ListBoxScrolls, iterations, [list_box, &random](int ix) {
+			list_box->ScrollToItem(ListBoxItems - 1);
+			list_box->ScrollToItem(0);
+			for (int s = 2; s < ListBoxScrolls; ++s)
+				list_box->ScrollToItem(random.Next(ListBoxItems));
+		});
+
+		Delete(root);
+	}
+
+	void RunTableViewBenchmarks(Array<Result> &results, int iterations)
+	{
+		FudgetGUIRoot *root = CreateRoot();
+		FudgetTableView *table = root->CreateChild<FudgetTableView>();
+		table->SetHintSize(RootSize);
+		table->SetShowHeader(false);
+		table->SetRowHeight(RootSize.Y / TableRows - 1);
+
+		// Every other column holds doubles, to format both integers and floating point values.
+		FudgetColumnarDataProvider *data = table->GetDataProvider();
+		for (int c = 0; c < TableColumns; ++c)
+		{
+			data->AddColumn(c % 2 == 0 ? FudgetColumnType::Int32 : FudgetColumnType::Double);
+			FudgetTableColumn column;
+			column.DataColumn = c;
+			column.Width = RootSize.X / TableColumns - 1;
+			table->AddColumn(column);
+		}
+
+		// Twice as many rows as visible, so the table can scroll.
+		data->BeginChange();
+		data->AddRows(TableRows * 2);
+		for (int r = 0; r < TableRows * 2; ++r)
+		{
+			for (int c = 0; c < TableColumns; ++c)
+			{
+				if (c % 2 == 0)
+					data->SetInt32(r, c, r * TableColumns + c);
+				else
+					data->SetDouble(r, c, (r * TableColumns + c) * 0.25);
+			}
+		}
+		data->EndChange();
+		root->FudgetInit();
+
+		// Without painters nothing is drawn, and the timing would only measure the layout.
+		FudgetDrawRecorder recorder;
+		recorder.Record(root);
+		if (recorder.GetDrawCallCount() < TableColumns * TableRows)
+		{
+			LOG(Warning, "TableViewDraw recorded {0} draw calls for {1} cells", recorder.GetDrawCallCount(), TableColumns * TableRows);
+			Skip(results, TEXT("TableViewDraw"), TableColumns * TableRows);
+			Delete(root);
+			return;
+		}
+
+		Measure(results, TEXT("TableViewDraw"), TableColumns * TableRows, iterations, [root, &recorder](int ix) {
+			recorder.Record(root);
+		});
+
+		Delete(root);
+	}
+
+	void RunJsonBenchmarks(Array<Result> &results, int iterations)
+	{
+		FudgetAssetRoot *source = New<FudgetAssetRoot>();
+		BuildControlTree(source);
+
+		Array<FudgetControl*> controls;
+		source->GetAllControls(controls);
+
+		rapidjson_flax::StringBuffer buffer;
+		CompactJsonWriter writerObj(buffer);
+		JsonWriter &writer = writerObj;
+		writer.StartObject();
+		source->Serialize(writer, nullptr);
+		writer.EndObject();
+
+		// The loaded controls get the ids of the serialized ones, which can't exist at the same time.
+		Delete(source);
+
+		// A result measured without deserializing anything would look like a fast load.
+		{
+			rapidjson_flax::Document document;
+			document.Parse(buffer.GetString(), buffer.GetSize());
+			if (document.HasParseError())
+			{
+				Skip(results, TEXT("JsonDeserialize"), controls.Count());
+				return;
+			}
+		}
+
+		// Parses and deserializes the tree like a FudgetJsonAsset does. Reading the file is not included.
+		Measure(results, TEXT("JsonDeserialize"), controls.Count(), iterations, [&buffer](int ix) {
+			rapidjson_flax::Document document;
+			document.Parse(buffer.GetString(), buffer.GetSize());
+
+			ISerializeModifier modifier;
+			FudgetAssetRoot *loaded = New<FudgetAssetRoot>();
+			loaded->Deserialize(document, &modifier);
+			Delete(loaded);
+		});
+	}
+}
+
+
+String FudgetBenchmark::Run(int iterations)
+{
+	iterations = Math::Max(1, iterations);
+
+	Array<Result> results;
+	RunTreeBenchmarks(results, iterations);
+	RunMeasureBenchmarks(results, iterations);
+	RunListBoxBenchmarks(results, iterations);
+	RunTableViewBenchmarks(results, iterations);
+	RunJsonBenchmarks(results, iterations);
+
+	rapidjson_flax::StringBuffer buffer;
+	PrettyJsonWriter writerObj(buffer);
+	JsonWriter &writer = writerObj;
+	writer.StartObject();
+	writer.JKEY("Iterations");
+	writer.Int(iterations);
+	writer.JKEY("Benchmarks");
+	writer.StartArray();
+	for (const Result &result : results)
+	{
+		writer.StartObject();
+		writer.JKEY("Name");
+		writer.String(result.Name);
+		writer.JKEY("Count");
+		writer.Int(result.Count);
+		writer.JKEY("Iterations");
+		writer.Int(result.Iterations);
+		writer.JKEY("Skipped");
+		writer.Bool(result.Skipped);
+		writer.JKEY("MinMs");
+		writer.Double(result.Min);
+		writer.JKEY("MeanMs");
+		writer.Double(result.Mean);
+		writer.JKEY("MaxMs");
+		writer.Double(result.Max);
+		writer.EndObject();
+	}
+	writer.EndArray();
+	writer.EndObject();
+
+	return String(buffer.GetString());
+}
+
+bool FudgetBenchmark::RunToFile(const StringView &path, int iterations)
+{
+	String results = Run(iterations);
+	if (File::WriteAllText(path, results, Encoding::UTF8))
+	{
+		LOG(Warning, "Couldn't write the benchmark results to {0}", path);
+		return false;
+	}
+	return true;
+}
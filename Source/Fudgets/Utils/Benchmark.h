@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Engine/Scripting/ScriptingType.h"
+#include "Engine/Core/Types/String.h"
+#include "Engine/Core/Types/StringView.h"
+
+/// <summary>
+/// Times the hot paths of the plugin on synthetic control trees that are not attached to a Fudget actor, so no
+/// window or graphics device is needed. Can be called from a game started with -headless to track regressions
+/// between releases. The results are written as JSON with the minimum, mean and maximum time of each benchmark
+/// in milliseconds.
+/// Benchmarks that need a font are reported as skipped when no font could be loaded, the list box benchmarks
+/// when the list couldn't be filled, and the table view benchmark when its cells draw nothing.
+/// </summary>
+API_CLASS(Static)
+class FUDGETS_API FudgetBenchmark
+{
+	DECLARE_SCRIPTING_TYPE_NO_SPAWN(FudgetBenchmark);
+public:
+	/// <summary>
+	/// Runs every benchmark and returns the results.
+	/// </summary>
+	/// <param name="iterations">Number of times each benchmark is timed</param>
+	/// <returns>The results as a JSON object</returns>
+	API_FUNCTION() static String Run(int iterations = 10);
+
+	/// <summary>
+	/// Runs every benchmark and writes the results to a file.
+	/// </summary>
+	/// <param name="path">Path of the JSON file to write</param>
+	/// <param name="iterations">Number of times each benchmark is timed</param>
+	/// <returns>Whether the file was written</returns>
+	API_FUNCTION() static bool RunToFile(const StringView &path, int iterations = 10);
+};
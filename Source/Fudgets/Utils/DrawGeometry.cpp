@@ -0,0 +1,162 @@
+#include "DrawGeometry.h"
+
+#include "Engine/Core/Math/Math.h"
+
+
+// FudgetDrawGeometry
+
+
+void FudgetDrawGeometry::NineSlice(const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Rectangle &uv_area, Array<Float2> &vertices, Array<Float2> &uvs)
+{
+	vertices.Clear();
+	uvs.Clear();
+
+	// Edges of the slices along each axis, in the same layout as Render2D's nine slicing.
+	float xs[4] = { rect.GetLeft(), rect.GetLeft() + border.X, rect.GetRight() - border.Y, rect.GetRight() };
+	float ys[4] = { rect.GetTop(), rect.GetTop() + border.Z, rect.GetBottom() - border.W, rect.GetBottom() };
+	float us[4] = { 0.f, borderUVs.X, 1.f - borderUVs.Y, 1.f };
+	float vs[4] = { 0.f, borderUVs.Z, 1.f - borderUVs.W, 1.f };
+
+	vertices.EnsureCapacity(9 * 6);
+	uvs.EnsureCapacity(9 * 6);
+	for (int y = 0; y < 3; ++y)
+	{
+		for (int x = 0; x < 3; ++x)
+		{
+			Rectangle part(Float2(xs[x], ys[y]), Float2(xs[x + 1] - xs[x], ys[y + 1] - ys[y]));
+			if (part.Size.X <= 0.f || part.Size.Y <= 0.f)
+				continue;
+			Rectangle uv_part(uv_area.Location + Float2(us[x], vs[y]) * uv_area.Size, Float2(us[x + 1] - us[x], vs[y + 1] - vs[y]) * uv_area.Size);
+			AddQuad(part, uv_part, vertices, uvs);
+		}
+	}
+}
+
+void FudgetDrawGeometry::Tiled(const Rectangle &rect, Float2 tile_size, const Rectangle &uv_area, Array<Float2> &vertices, Array<Float2> &uvs)
+{
+	vertices.Clear();
+	uvs.Clear();
+
+	if (tile_size.X <= 0.f || tile_size.Y <= 0.f || rect.Size.X <= 0.f || rect.Size.Y <= 0.f)
+		return;
+
+	int cnt_x = (int)Math::Ceil(rect.Size.X / tile_size.X);
+	int cnt_y = (int)Math::Ceil(rect.Size.Y / tile_size.Y);
+	vertices.EnsureCapacity(cnt_x * cnt_y * 6);
+	uvs.EnsureCapacity(cnt_x * cnt_y * 6);
+
+	for (int iy = 0; iy < cnt_y; ++iy)
+	{
+		float top = rect.GetTop() + tile_size.Y * iy;
+		float h = Math::Min(tile_size.Y, rect.GetBottom() - top);
+		for (int ix = 0; ix < cnt_x; ++ix)
+		{
+			float left = rect.GetLeft() + tile_size.X * ix;
+			float w = Math::Min(tile_size.X, rect.GetRight() - left);
+
+			// Cut tiles only show the part of the texture they cover.
+			Float2 uv_size = uv_area.Size * Float2(w / tile_size.X, h / tile_size.Y);
+			AddQuad(Rectangle(Float2(left, top), Float2(w, h)), Rectangle(uv_area.Location, uv_size), vertices, uvs);
+		}
+	}
+}
+
+void FudgetDrawGeometry::AddQuad(const Rectangle &rect, const Rectangle &uv_rect, Array<Float2> &vertices, Array<Float2> &uvs)
+{
+	Float2 ul = rect.GetUpperLeft();
+	Float2 ur = rect.GetUpperRight();
+	Float2 br = rect.GetBottomRight();
+	Float2 bl = rect.GetBottomLeft();
+	Float2 uv_ul = uv_rect.GetUpperLeft();
+	Float2 uv_ur = uv_rect.GetUpperRight();
+	Float2 uv_br = uv_rect.GetBottomRight();
+	Float2 uv_bl = uv_rect.GetBottomLeft();
+
+	vertices.Add(ul);
+	vertices.Add(ur);
+	vertices.Add(br);
+	vertices.Add(ul);
+	vertices.Add(br);
+	vertices.Add(bl);
+
+	uvs.Add(uv_ul);
+	uvs.Add(uv_ur);
+	uvs.Add(uv_br);
+	uvs.Add(uv_ul);
+	uvs.Add(uv_br);
+	uvs.Add(uv_bl);
+}
+
+
+// FudgetDrawGeometryCache
+
+
+bool FudgetDrawGeometryCache::Key::operator==(const Key &other) const
+{
+	return Tiled == other.Tiled && Rect == other.Rect && Border == other.Border && BorderUVs == other.BorderUVs && UVArea == other.UVArea && Tint == other.Tint;
+}
+
+uint32 GetHash(const FudgetDrawGeometryCache::Key &key)
+{
+	uint32 hash = GetHash(key.Tiled ? 1 : 0);
+	const float values[] = { key.Rect.Location.X, key.Rect.Location.Y, key.Rect.Size.X, key.Rect.Size.Y, key.Border.X, key.Border.Y,
+		key.Border.Z, key.Border.W, key.BorderUVs.X, key.BorderUVs.Y, key.BorderUVs.Z, key.BorderUVs.W, key.UVArea.Location.X,
+		key.UVArea.Location.Y, key.UVArea.Size.X, key.UVArea.Size.Y, key.Tint.R, key.Tint.G, key.Tint.B, key.Tint.A };
+	for (float value : values)
+		CombineHash(hash, GetHash(value));
+	return hash;
+}
+
+FudgetDrawGeometryCache::FudgetDrawGeometryCache() : _frame(0)
+{
+}
+
+const FudgetDrawGeometryCache::Entry& FudgetDrawGeometryCache::Get(const Key &key, uint64 frame)
+{
+	if (frame != _frame)
+	{
+		// Draws that were skipped for a whole frame are not expected to come back soon.
+		for (auto it = _entries.Begin(); it.IsNotEnd(); ++it)
+		{
+			if (it->Value.LastFrame < _frame)
+				_entries.Remove(it);
+		}
+		_frame = frame;
+	}
+
+	Entry *found = _entries.TryGet(key);
+	if (found != nullptr)
+	{
+		found->LastFrame = frame;
+		return *found;
+	}
+
+	Entry &entry = _entries[key];
+	entry.LastFrame = frame;
+	if (key.Tiled)
+		FudgetDrawGeometry::Tiled(key.Rect, Float2(key.Border.X, key.Border.Y), key.UVArea, entry.Vertices, entry.UVs);
+	else
+		FudgetDrawGeometry::NineSlice(key.Rect, key.Border, key.BorderUVs, key.UVArea, entry.Vertices, entry.UVs);
+
+	entry.Colors.Clear();
+	entry.Colors.EnsureCapacity(entry.Vertices.Count());
+	for (int ix = 0, siz = entry.Vertices.Count(); ix < siz; ++ix)
+		entry.Colors.Add(key.Tint);
+	return entry;
+}
+
+Span<Float2> FudgetDrawGeometryCache::GetTranslatedVertices(const Entry &entry, Float2 offset)
+{
+	if (offset == Float2::Zero)
+		return Span<Float2>((Float2*)entry.Vertices.Get(), entry.Vertices.Count());
+
+	_translated.Resize(entry.Vertices.Count(), false);
+	for (int ix = 0, siz = entry.Vertices.Count(); ix < siz; ++ix)
+		_translated[ix] = entry.Vertices[ix] + offset;
+	return Span<Float2>(_translated.Get(), _translated.Count());
+}
+
+void FudgetDrawGeometryCache::Clear()
+{
+	_entries.Clear();
+}
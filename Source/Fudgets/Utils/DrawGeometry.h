@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Types/Span.h"
+#include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Math/Vector4.h"
+#include "Engine/Core/Math/Color.h"
+#include "Engine/Core/Math/Rectangle.h"
+
+/// <summary>
+/// Generates triangle lists for drawing textures nine-sliced or tiled with a single textured triangles draw. Each
+/// quad is written as two triangles of three vertices, in the order of the vertices of Render2D's rectangles.
+/// </summary>
+class FUDGETS_API FudgetDrawGeometry
+{
+public:
+	/// <summary>
+	/// Generates the nine quads of a nine-sliced texture. The slices match Render2D's nine slicing.
+	/// </summary>
+	/// <param name="rect">Rectangle to fill</param>
+	/// <param name="border">Width of the left, right, top and bottom slices in pixels</param>
+	/// <param name="borderUVs">Width of the left, right, top and bottom slices in texture coordinates of the area</param>
+	/// <param name="uv_area">Area of the texture that is sliced in texture coordinates, like the area of a sprite</param>
+	/// <param name="vertices">Receives the vertices</param>
+	/// <param name="uvs">Receives the texture coordinates of the vertices</param>
+	static void NineSlice(const Rectangle &rect, const Float4 &border, const Float4 &borderUVs, const Rectangle &uv_area, Array<Float2> &vertices, Array<Float2> &uvs);
+
+	/// <summary>
+	/// Generates a quad for each tile covering a rectangle, starting from its top left corner. Tiles at the right
+	/// and bottom edges are cut with their texture coordinates, so no clipping is needed to draw them.
+	/// </summary>
+	/// <param name="rect">Rectangle to fill</param>
+	/// <param name="tile_size">Size of a tile in pixels</param>
+	/// <param name="uv_area">Area of the texture drawn in a tile in texture coordinates, like the area of a sprite</param>
+	/// <param name="vertices">Receives the vertices</param>
+	/// <param name="uvs">Receives the texture coordinates of the vertices</param>
+	static void Tiled(const Rectangle &rect, Float2 tile_size, const Rectangle &uv_area, Array<Float2> &vertices, Array<Float2> &uvs);
+
+	/// <summary>
+	/// Adds the two triangles of a quad.
+	/// </summary>
+	static void AddQuad(const Rectangle &rect, const Rectangle &uv_rect, Array<Float2> &vertices, Array<Float2> &uvs);
+};
+
+/// <summary>
+/// Holds the geometry of the nine-sliced and tiled draws of a control, so drawing the same thing again doesn't
+/// generate the vertices again. The geometry is made in local coordinates, and the translation to global coordinates
+/// is added when it's drawn, which keeps entries valid when the control moves or scrolls. Entries not used for a whole
+/// frame are removed.
+/// </summary>
+class FUDGETS_API FudgetDrawGeometryCache
+{
+public:
+	/// <summary>
+	/// Values the geometry of a draw is generated from.
+	/// </summary>
+	struct Key
+	{
+		// Whether this is a tiled draw. Nine-sliced otherwise.
+		bool Tiled;
+		// Rectangle of the draw in local coordinates.
+		Rectangle Rect;
+		// Borders and their texture coordinates for nine slicing, or the tile size in XY for tiling.
+		Float4 Border;
+		Float4 BorderUVs;
+		Rectangle UVArea;
+		Color Tint;
+
+		bool operator==(const Key &other) const;
+	};
+
+	/// <summary>
+	/// Cached geometry of a draw.
+	/// </summary>
+	struct Entry
+	{
+		Array<Float2> Vertices;
+		Array<Float2> UVs;
+		// Tint for every vertex.
+		Array<Color> Colors;
+		uint64 LastFrame;
+	};
+
+	FudgetDrawGeometryCache();
+
+	/// <summary>
+	/// Finds the geometry for a draw, generating it when it's not cached. The first call in a new frame removes the
+	/// entries that were not used in the previous frame.
+	/// </summary>
+	/// <param name="key">Values to generate the geometry from</param>
+	/// <param name="frame">Number of the current frame</param>
+	/// <returns>The cached geometry. It's valid until the next call</returns>
+	const Entry& Get(const Key &key, uint64 frame);
+
+	/// <summary>
+	/// Gets the vertices of an entry moved by an offset.
+	/// </summary>
+	/// <param name="entry">Entry returned by Get</param>
+	/// <param name="offset">Offset added to every vertex</param>
+	/// <returns>The moved vertices. They are valid until the next call</returns>
+	Span<Float2> GetTranslatedVertices(const Entry &entry, Float2 offset);
+
+	/// <summary>
+	/// Number of cached draws.
+	/// </summary>
+	int GetCount() const { return _entries.Count(); }
+
+	/// <summary>
+	/// Removes every cached entry.
+	/// </summary>
+	void Clear();
+private:
+	Dictionary<Key, Entry> _entries;
+	// Frame of the last call to Get.
+	uint64 _frame;
+	// Vertices of the last GetTranslatedVertices call.
+	Array<Float2> _translated;
+};
+
+uint32 GetHash(const FudgetDrawGeometryCache::Key &key);
@@ -0,0 +1,351 @@
+#include "NavigationIndex.h"
+#include "../Control.h"
+#include "../Container.h"
+#include "../GUIRoot.h"
+
+#include "Engine/Core/Math/Math.h"
+
+
+FudgetNavigationIndex::FudgetNavigationIndex(FudgetGUIRoot *root) : _root(root), _min_cell(MAX_int32), _max_cell(MIN_int32), _extent_dirty(false)
+{
+}
+
+FudgetNavigationIndex::~FudgetNavigationIndex()
+{
+	Clear();
+}
+
+void FudgetNavigationIndex::MarkDirty(FudgetControl *control)
+{
+	if (control->_navigation_dirty_index != -1)
+		return;
+	control->_navigation_dirty_index = _dirty.Count();
+	_dirty.Add(control);
+}
+
+void FudgetNavigationIndex::Remove(FudgetControl *control, bool recursive)
+{
+	// The control can be deleted after this, so its place in the dirty list is cleared and skipped by Update.
+	if (control->_navigation_dirty_index != -1)
+	{
+		_dirty[control->_navigation_dirty_index] = nullptr;
+		control->_navigation_dirty_index = -1;
+	}
+	if (control->_navigation_index != -1)
+		RemoveEntry(control->_navigation_index);
+
+	if (!recursive || !control->HasAnyFlag(FudgetControlFlag::ContainerControl))
+		return;
+
+	FudgetContainer *container = dynamic_cast<FudgetContainer*>(control);
+	for (int ix = 0, siz = container->GetChildCount(); ix < siz; ++ix)
+		Remove(container->ChildAt(ix), true);
+}
+
+void FudgetNavigationIndex::Clear()
+{
+	for (const Entry &entry : _entries)
+		entry.Control->_navigation_index = -1;
+	for (FudgetControl *control : _dirty)
+	{
+		if (control != nullptr)
+			control->_navigation_dirty_index = -1;
+	}
+	_entries.Clear();
+	_dirty.Clear();
+	_cells.Clear();
+	_min_cell = Int2(MAX_int32);
+	_max_cell = Int2(MIN_int32);
+	_extent_dirty = false;
+}
+
+int FudgetNavigationIndex::GetCount()
+{
+	Update();
+	return _entries.Count();
+}
+
+void FudgetNavigationIndex::Update()
+{
+	if (!_dirty.IsEmpty())
+		UpdateDirty();
+	if (_extent_dirty)
+		UpdateExtent();
+}
+
+void FudgetNavigationIndex::UpdateDirty()
+{
+	// Global positions are only valid after the layout is done. The layout can mark more controls dirty.
+	_root->DoLayout();
+
+	Array<FudgetControl*> dirty;
+	dirty.Swap(_dirty);
+	for (FudgetControl *control : dirty)
+	{
+		if (control != nullptr)
+			control->_navigation_dirty_index = -1;
+	}
+
+	for (FudgetControl *control : dirty)
+	{
+		// Removed from the index after it was marked dirty.
+		if (control == nullptr)
+			continue;
+
+		// Find out once whether the control is in the tree and in a compound control. Its descendants are updated
+		// with the same information.
+		bool attached = false;
+		bool in_compound = false;
+		for (FudgetContainer *parent = control->GetParent(); parent != nullptr; parent = parent->GetParent())
+		{
+			in_compound |= parent->HasAnyFlag(FudgetControlFlag::CompoundControl);
+			if (parent == _root)
+				attached = true;
+		}
+		UpdateControl(control, attached || control == _root, in_compound);
+	}
+}
+
+void FudgetNavigationIndex::UpdateControl(FudgetControl *control, bool attached, bool in_compound)
+{
+	bool focusable = attached && !in_compound && control != _root && control->IsVisible() && control->VirtuallyEnabled() &&
+		control->HasAnyFlag(FudgetControlFlag::CanHandleKeyEvents | FudgetControlFlag::FocusOnMouseLeft | FudgetControlFlag::FocusOnMouseRight);
+
+	if (focusable)
+		SetEntry(control, control->LocalToGlobal(control->GetBounds()));
+	else if (control->_navigation_index != -1)
+		RemoveEntry(control->_navigation_index);
+
+	if (!control->HasAnyFlag(FudgetControlFlag::ContainerControl))
+		return;
+
+	in_compound |= control->HasAnyFlag(FudgetControlFlag::CompoundControl);
+	FudgetContainer *container = dynamic_cast<FudgetContainer*>(control);
+	for (int ix = 0, siz = container->GetChildCount(); ix < siz; ++ix)
+		UpdateControl(container->ChildAt(ix), attached, in_compound);
+}
+
+void FudgetNavigationIndex::UpdateExtent()
+{
+	_extent_dirty = false;
+	_min_cell = Int2(MAX_int32);
+	_max_cell = Int2(MIN_int32);
+	for (const Entry &entry : _entries)
+	{
+		_min_cell = Int2::Min(_min_cell, entry.MinCell);
+		_max_cell = Int2::Max(_max_cell, entry.MaxCell);
+	}
+}
+
+void FudgetNavigationIndex::SetEntry(FudgetControl *control, const Rectangle &bounds)
+{
+	if (control->_navigation_index != -1)
+	{
+		Entry &entry = _entries[control->_navigation_index];
+		if (entry.Bounds == bounds)
+			return;
+		RemoveFromCells(entry);
+		entry.Bounds = bounds;
+		entry.MinCell = CellAt(bounds.GetUpperLeft());
+		entry.MaxCell = CellAt(bounds.GetBottomRight());
+		AddToCells(entry);
+		return;
+	}
+
+	Entry entry;
+	entry.Control = control;
+	entry.Bounds = bounds;
+	entry.MinCell = CellAt(bounds.GetUpperLeft());
+	entry.MaxCell = CellAt(bounds.GetBottomRight());
+	control->_navigation_index = _entries.Count();
+	_entries.Add(entry);
+	AddToCells(entry);
+}
+
+void FudgetNavigationIndex::RemoveEntry(int index)
+{
+	RemoveFromCells(_entries[index]);
+	_entries[index].Control->_navigation_index = -1;
+
+	int last = _entries.Count() - 1;
+	if (index != last)
+	{
+		_entries[index] = _entries[last];
+		_entries[index].Control->_navigation_index = index;
+	}
+	_entries.RemoveLast();
+}
+
+void FudgetNavigationIndex::AddToCells(const Entry &entry)
+{
+	for (int y = entry.MinCell.Y; y <= entry.MaxCell.Y; ++y)
+	{
+		for (int x = entry.MinCell.X; x <= entry.MaxCell.X; ++x)
+			_cells[Int2(x, y)].Add(entry.Control);
+	}
+	_min_cell = Int2::Min(_min_cell, entry.MinCell);
+	_max_cell = Int2::Max(_max_cell, entry.MaxCell);
+}
+
+void FudgetNavigationIndex::RemoveFromCells(const Entry &entry)
+{
+	for (int y = entry.MinCell.Y; y <= entry.MaxCell.Y; ++y)
+	{
+		for (int x = entry.MinCell.X; x <= entry.MaxCell.X; ++x)
+		{
+			Array<FudgetControl*> *cell = _cells.TryGet(Int2(x, y));
+			if (cell == nullptr)
+				continue;
+			cell->Remove(entry.Control);
+			if (cell->IsEmpty())
+				_cells.Remove(Int2(x, y));
+		}
+	}
+
+	// The extent only shrinks if the entry was on its edge.
+	if (entry.MinCell.X == _min_cell.X || entry.MinCell.Y == _min_cell.Y || entry.MaxCell.X == _max_cell.X || entry.MaxCell.Y == _max_cell.Y)
+		_extent_dirty = true;
+}
+
+Int2 FudgetNavigationIndex::CellAt(Float2 pos)
+{
+	return Int2((int)Math::Floor(pos.X / CellSize), (int)Math::Floor(pos.Y / CellSize));
+}
+
+float FudgetNavigationIndex::Score(const Rectangle &from, const Rectangle &to, FudgetNavigationDirection direction)
+{
+	bool horizontal = direction == FudgetNavigationDirection::Left || direction == FudgetNavigationDirection::Right;
+	bool forward = direction == FudgetNavigationDirection::Right || direction == FudgetNavigationDirection::Down;
+
+	// Positions along the direction (p) and across it (o).
+	float from_p_min = horizontal ? from.GetLeft() : from.GetTop();
+	float from_p_max = horizontal ? from.GetRight() : from.GetBottom();
+	float from_o_min = horizontal ? from.GetTop() : from.GetLeft();
+	float from_o_max = horizontal ? from.GetBottom() : from.GetRight();
+	float to_p_min = horizontal ? to.GetLeft() : to.GetTop();
+	float to_p_max = horizontal ? to.GetRight() : to.GetBottom();
+	float to_o_min = horizontal ? to.GetTop() : to.GetLeft();
+	float to_o_max = horizontal ? to.GetBottom() : to.GetRight();
+
+	float center_diff = ((to_p_min + to_p_max) - (from_p_min + from_p_max)) * 0.5f;
+	if (forward ? center_diff <= 0.f : center_diff >= 0.f)
+		return -1.f;
+
+	float distance = Math::Max(0.f, forward ? to_p_min - from_p_max : from_p_min - to_p_max);
+	// Gap between the two rectangles across the direction. Zero if they overlap.
+	float gap = Math::Max(0.f, Math::Max(to_o_min - from_o_max, from_o_min - to_o_max));
+	float misalignment = Math::Abs((to_o_min + to_o_max) - (from_o_min + from_o_max)) * 0.5f;
+
+	// Controls that are not in line with the focused control are penalized, and among controls in line the one with
+	// the closest center is preferred.
+	return distance + gap * 2.f + misalignment * 0.1f;
+}
+
+bool FudgetNavigationIndex::ReadingOrderLess(const Rectangle &a, const Rectangle &b)
+{
+	if (a.GetTop() != b.GetTop())
+		return a.GetTop() < b.GetTop();
+	return a.GetLeft() < b.GetLeft();
+}
+
+FudgetControl* FudgetNavigationIndex::FindTarget(FudgetControl *from, FudgetNavigationDirection direction)
+{
+	Update();
+	if (_entries.IsEmpty())
+		return nullptr;
+
+	Rectangle from_bounds;
+	if (from == nullptr)
+		return FindInReadingOrder(nullptr, from_bounds, true);
+
+	from_bounds = from->_navigation_index != -1 ? _entries[from->_navigation_index].Bounds : from->LocalToGlobal(from->GetBounds());
+
+	if (direction == FudgetNavigationDirection::Next || direction == FudgetNavigationDirection::Previous)
+		return FindInReadingOrder(from, from_bounds, direction == FudgetNavigationDirection::Next);
+
+	Int2 center = CellAt(from_bounds.GetCenter());
+	int dir_x = direction == FudgetNavigationDirection::Left ? -1 : direction == FudgetNavigationDirection::Right ? 1 : 0;
+	int dir_y = direction == FudgetNavigationDirection::Up ? -1 : direction == FudgetNavigationDirection::Down ? 1 : 0;
+
+	int max_ring = Math::Max(Math::Max(Math::Abs(_min_cell.X - center.X), Math::Abs(_max_cell.X - center.X)),
+		Math::Max(Math::Abs(_min_cell.Y - center.Y), Math::Abs(_max_cell.Y - center.Y)));
+	float half_size = Math::Max(from_bounds.GetWidth(), from_bounds.GetHeight()) * 0.5f;
+
+	FudgetControl *best = nullptr;
+	float best_score = MAX_float;
+
+	auto visit = [&](int x, int y)
+	{
+		// Cells behind the focused control only hold controls that also overlap cells in front of it, if any.
+		if ((x - center.X) * dir_x < 0 || (y - center.Y) * dir_y < 0)
+			return;
+		const Array<FudgetControl*> *cell = _cells.TryGet(Int2(x, y));
+		if (cell == nullptr)
+			return;
+		for (FudgetControl *control : *cell)
+		{
+			if (control == from)
+				continue;
+			float score = Score(from_bounds, _entries[control->_navigation_index].Bounds, direction);
+			if (score >= 0.f && score < best_score)
+			{
+				best_score = score;
+				best = control;
+			}
+		}
+	};
+
+	for (int ring = 0; ring <= max_ring; ++ring)
+	{
+		// Every control in this ring or farther is at least this far from the edge of the focused control, both
+		// along and across the direction, and the score can't be lower than that.
+		if (best != nullptr && (ring - 1) * CellSize - half_size > best_score)
+			break;
+
+		if (ring == 0)
+		{
+			visit(center.X, center.Y);
+			continue;
+		}
+		for (int x = center.X - ring; x <= center.X + ring; ++x)
+		{
+			visit(x, center.Y - ring);
+			visit(x, center.Y + ring);
+		}
+		for (int y = center.Y - ring + 1; y <= center.Y + ring - 1; ++y)
+		{
+			visit(center.X - ring, y);
+			visit(center.X + ring, y);
+		}
+	}
+
+	return best;
+}
+
+FudgetControl* FudgetNavigationIndex::FindInReadingOrder(FudgetControl *from, const Rectangle &from_bounds, bool forward) const
+{
+	// The closest entry after (or before) the focused control in reading order, wrapping around to the first (or
+	// last) entry if there is none.
+	const Entry *best = nullptr;
+	const Entry *wrap = nullptr;
+	for (const Entry &entry : _entries)
+	{
+		if (entry.Control == from)
+			continue;
+
+		if (wrap == nullptr || (forward ? ReadingOrderLess(entry.Bounds, wrap->Bounds) : ReadingOrderLess(wrap->Bounds, entry.Bounds)))
+			wrap = &entry;
+
+		if (from == nullptr)
+			continue;
+		bool after = forward ? ReadingOrderLess(from_bounds, entry.Bounds) : ReadingOrderLess(entry.Bounds, from_bounds);
+		if (!after)
+			continue;
+		if (best == nullptr || (forward ? ReadingOrderLess(entry.Bounds, best->Bounds) : ReadingOrderLess(best->Bounds, entry.Bounds)))
+			best = &entry;
+	}
+
+	if (best == nullptr)
+		best = wrap;
+	return best != nullptr ? best->Control : nullptr;
+}
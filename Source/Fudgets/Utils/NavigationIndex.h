@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Math/Rectangle.h"
+#include "Engine/Core/Math/Vector2.h"
+
+class FudgetControl;
+class FudgetGUIRoot;
+
+/// <summary>
+/// Directions for moving the keyboard focus between controls.
+/// </summary>
+API_ENUM()
+enum class FudgetNavigationDirection
+{
+	/// <summary>
+	/// The nearest control above the focused control.
+	/// </summary>
+	Up,
+	/// <summary>
+	/// The nearest control below the focused control.
+	/// </summary>
+	Down,
+	/// <summary>
+	/// The nearest control on the left of the focused control.
+	/// </summary>
+	Left,
+	/// <summary>
+	/// The nearest control on the right of the focused control.
+	/// </summary>
+	Right,
+	/// <summary>
+	/// The control after the focused control in reading order, left to right and top to bottom.
+	/// </summary>
+	Next,
+	/// <summary>
+	/// The control before the focused control in reading order.
+	/// </summary>
+	Previous,
+};
+
+// Spatial index of the global rectangles of the focusable controls in a gui root, used to find the control to move the
+// focus to with directional navigation. Rectangles are stored in a uniform grid. Controls are marked dirty when their
+// layout, visibility or parent changes, and only the dirty controls and their descendants are updated before the next
+// query. A directional query visits the grid cells in rings around the focused control, and stops when the cells are
+// farther than the best match found.
+class FUDGETS_API FudgetNavigationIndex
+{
+public:
+	FudgetNavigationIndex(FudgetGUIRoot *root);
+	~FudgetNavigationIndex();
+
+	// Marks a control to be updated in the index with its descendants before the next query.
+	void MarkDirty(FudgetControl *control);
+
+	// Removes a control from the index right away. Descendants are removed too if recursive is true.
+	void Remove(FudgetControl *control, bool recursive);
+
+	// Removes every control from the index.
+	void Clear();
+
+	// Finds the control the focus should move to from a control in a direction. If from is null, the first control in
+	// reading order is returned. Returns null if there's no control in that direction.
+	FudgetControl* FindTarget(FudgetControl *from, FudgetNavigationDirection direction);
+
+	// Number of focusable controls in the index. Updates the dirty controls first.
+	int GetCount();
+private:
+	struct Entry
+	{
+		FudgetControl *Control;
+		// Global bounds of the control.
+		Rectangle Bounds;
+		// First and last cells of the grid that the bounds overlap.
+		Int2 MinCell;
+		Int2 MaxCell;
+	};
+
+	// Updates the entries of the dirty controls and the range of used cells.
+	void Update();
+	void UpdateDirty();
+	// Recalculates the range of cells used by the entries.
+	void UpdateExtent();
+	// Adds, updates or removes the entry of a control and its descendants. attached is whether the control is in the
+	// root's tree, and in_compound whether a parent is a compound control.
+	void UpdateControl(FudgetControl *control, bool attached, bool in_compound);
+
+	void SetEntry(FudgetControl *control, const Rectangle &bounds);
+	void RemoveEntry(int index);
+	void AddToCells(const Entry &entry);
+	void RemoveFromCells(const Entry &entry);
+
+	// Grid cell that contains a point.
+	static Int2 CellAt(Float2 pos);
+	// Score of moving from one rectangle to another in a direction. Lower is better. Negative if the target is not in
+	// that direction.
+	static float Score(const Rectangle &from, const Rectangle &to, FudgetNavigationDirection direction);
+	// Whether a comes before b in reading order.
+	static bool ReadingOrderLess(const Rectangle &a, const Rectangle &b);
+
+	FudgetControl* FindInReadingOrder(FudgetControl *from, const Rectangle &from_bounds, bool forward) const;
+
+	FudgetGUIRoot *_root;
+
+	Array<Entry> _entries;
+	// Controls with an entry overlapping the cell. Cells without controls are removed.
+	Dictionary<Int2, Array<FudgetControl*>> _cells;
+	// Range of cells used by the entries. Used to limit the search.
+	Int2 _min_cell;
+	Int2 _max_cell;
+	// An entry on the edge of the range was removed or moved, and the range might be smaller.
+	bool _extent_dirty;
+
+	// Controls to update. Controls removed from the index before the update are set to null.
+	Array<FudgetControl*> _dirty;
+
+	static constexpr float CellSize = 128.f;
+};
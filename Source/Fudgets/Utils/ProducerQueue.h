@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include "Engine/Core/Memory/Memory.h"
+#include "Engine/Core/Templates.h"
+
+
+// Lock-free queue with any number of producer threads and a single consumer thread. Items are returned in the order
+// they were pushed. Pushing allocates a node which is freed when the item is popped. Push can be called from any
+// thread, while Pop, IsEmpty and the destructor must only be called from the consumer thread.
+template<typename T>
+class FudgetProducerQueue
+{
+public:
+	FudgetProducerQueue() : _count(0)
+	{
+		_tail = New<Node>();
+		_head.store(_tail, std::memory_order_relaxed);
+	}
+
+	~FudgetProducerQueue()
+	{
+		while (_tail != nullptr)
+		{
+			Node *next = _tail->Next.load(std::memory_order_relaxed);
+			Delete(_tail);
+			_tail = next;
+		}
+	}
+
+	FudgetProducerQueue(const FudgetProducerQueue&) = delete;
+	FudgetProducerQueue& operator=(const FudgetProducerQueue&) = delete;
+
+	// Adds an item at the end of the queue. Safe to call from any thread.
+	void Push(T &&item)
+	{
+		Node *node = New<Node>();
+		node->Value = MoveTemp(item);
+		_count.fetch_add(1, std::memory_order_relaxed);
+
+		// The node becomes visible to the consumer when the previous node links to it. Until then the queue appears to
+		// end at the previous node.
+		Node *prev = _head.exchange(node, std::memory_order_acq_rel);
+		prev->Next.store(node, std::memory_order_release);
+	}
+
+	// Takes the first item from the queue. Returns false if the queue is empty, or the next item is still being pushed.
+	bool Pop(T &result)
+	{
+		Node *next = _tail->Next.load(std::memory_order_acquire);
+		if (next == nullptr)
+			return false;
+
+		// The popped node becomes the new stub and its moved-from value is never read again.
+		result = MoveTemp(next->Value);
+		Delete(_tail);
+		_tail = next;
+		_count.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Whether the consumer would find no items in the queue.
+	bool IsEmpty() const { return _tail->Next.load(std::memory_order_acquire) == nullptr; }
+
+	// Number of items in the queue. Only an estimate while producers are pushing items.
+	int Count() const { return _count.load(std::memory_order_relaxed); }
+private:
+	struct Node
+	{
+		Node() : Next(nullptr) {}
+
+		std::atomic<Node*> Next;
+		T Value;
+	};
+
+	// Last node pushed by the producers.
+	std::atomic<Node*> _head;
+	// Node before the first item. Only accessed by the consumer.
+	Node *_tail;
+	std::atomic<int> _count;
+};
@@ -0,0 +1,114 @@
+#include "RectPacker.h"
+
+#include "Engine/Core/Math/Math.h"
+
+
+FudgetRectPacker::FudgetRectPacker(Int2 size, int padding) : _size(Math::Max(0, size.X), Math::Max(0, size.Y)), _padding(Math::Max(0, padding)), _used_area(0)
+{
+	Reset();
+}
+
+void FudgetRectPacker::Reset()
+{
+	_skyline.Clear();
+	_skyline.Add({ 0, 0, _size.X });
+	_used_area = 0;
+}
+
+bool FudgetRectPacker::Insert(Int2 size, Int2 &result)
+{
+	if (size.X <= 0 || size.Y <= 0)
+		return false;
+
+	int width = size.X + _padding * 2;
+	int height = size.Y + _padding * 2;
+
+	int best_index = -1;
+	int best_bottom = MAX_int32;
+	int best_width = MAX_int32;
+	int best_y = 0;
+	for (int ix = 0, siz = _skyline.Count(); ix < siz; ++ix)
+	{
+		int y = FitAt(ix, width, height);
+		if (y < 0)
+			continue;
+		// Prefer the lowest bottom, then the narrowest segment to leave wider ones for later rectangles.
+		if (y + height < best_bottom || (y + height == best_bottom && _skyline[ix].Width < best_width))
+		{
+			best_index = ix;
+			best_bottom = y + height;
+			best_width = _skyline[ix].Width;
+			best_y = y;
+		}
+	}
+
+	if (best_index < 0)
+		return false;
+
+	int x = _skyline[best_index].X;
+	AddNode(best_index, x, best_y, width, height);
+	_used_area += (int64)width * height;
+	result = Int2(x + _padding, best_y + _padding);
+	return true;
+}
+
+Rectangle FudgetRectPacker::ToUV(const Rectangle &pixel_rect, Int2 area_size)
+{
+	if (area_size.X <= 0 || area_size.Y <= 0)
+		return Rectangle::Empty;
+	Float2 scale(1.f / area_size.X, 1.f / area_size.Y);
+	return Rectangle(pixel_rect.Location * scale, pixel_rect.Size * scale);
+}
+
+int FudgetRectPacker::FitAt(int index, int width, int height) const
+{
+	int x = _skyline[index].X;
+	if (x + width > _size.X)
+		return -1;
+
+	int y = _skyline[index].Y;
+	int width_left = width;
+	for (int ix = index; width_left > 0; ++ix)
+	{
+		// The nodes cover the full width, so the loop stays inside the list when the rectangle fits horizontally.
+		y = Math::Max(y, _skyline[ix].Y);
+		if (y + height > _size.Y)
+			return -1;
+		width_left -= _skyline[ix].Width;
+	}
+	return y;
+}
+
+void FudgetRectPacker::AddNode(int index, int x, int y, int width, int height)
+{
+	_skyline.Insert(index, { x, y + height, width });
+
+	// Cut the nodes that are now under the new node.
+	for (int ix = index + 1; ix < _skyline.Count(); )
+	{
+		SkylineNode &prev = _skyline[ix - 1];
+		SkylineNode &node = _skyline[ix];
+		int prev_right = prev.X + prev.Width;
+		if (node.X >= prev_right)
+			break;
+
+		int shrink = prev_right - node.X;
+		node.X += shrink;
+		node.Width -= shrink;
+		if (node.Width > 0)
+			break;
+		_skyline.RemoveAt(ix);
+	}
+
+	// Merge neighboring nodes at the same height.
+	for (int ix = 0; ix < _skyline.Count() - 1; )
+	{
+		if (_skyline[ix].Y == _skyline[ix + 1].Y)
+		{
+			_skyline[ix].Width += _skyline[ix + 1].Width;
+			_skyline.RemoveAt(ix + 1);
+		}
+		else
+			++ix;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Math/Rectangle.h"
+
+/// <summary>
+/// Packs rectangles into a fixed size area with the skyline bottom-left method. The packer keeps the top edge of the
+/// placed rectangles as a list of horizontal segments, and puts each new rectangle where its bottom ends up the lowest.
+/// Rectangles are not rotated.
+/// </summary>
+class FUDGETS_API FudgetRectPacker
+{
+public:
+	/// <summary>
+	/// Creates a packer for an area of a size.
+	/// </summary>
+	/// <param name="size">Size of the area to pack into</param>
+	/// <param name="padding">Empty space to keep around every packed rectangle</param>
+	FudgetRectPacker(Int2 size, int padding = 0);
+
+	/// <summary>
+	/// Removes every packed rectangle.
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// Finds a place for a rectangle and marks it as used.
+	/// </summary>
+	/// <param name="size">Size of the rectangle without the padding</param>
+	/// <param name="result">Receives the position of the rectangle, which is already inside the padding</param>
+	/// <returns>Whether the rectangle fit in the remaining space</returns>
+	bool Insert(Int2 size, Int2 &result);
+
+	/// <summary>
+	/// Size of the area to pack into.
+	/// </summary>
+	Int2 GetSize() const { return _size; }
+	/// <summary>
+	/// Empty space kept around every packed rectangle.
+	/// </summary>
+	int GetPadding() const { return _padding; }
+	/// <summary>
+	/// Area of the packed rectangles including their padding.
+	/// </summary>
+	int64 GetUsedArea() const { return _used_area; }
+
+	/// <summary>
+	/// Converts a rectangle in pixels to texture coordinates in the 0 to 1 range of an area.
+	/// </summary>
+	/// <param name="pixel_rect">Rectangle in pixels</param>
+	/// <param name="area_size">Size of the area in pixels</param>
+	/// <returns>The rectangle in texture coordinates</returns>
+	static Rectangle ToUV(const Rectangle &pixel_rect, Int2 area_size);
+private:
+	// A segment of the top edge of the packed rectangles.
+	struct SkylineNode
+	{
+		int X;
+		int Y;
+		int Width;
+	};
+
+	// Returns the top of a rectangle placed at the left of a skyline node, or -1 if it doesn't fit there.
+	int FitAt(int index, int width, int height) const;
+	// Adds a node for a rectangle placed at the left of a skyline node and cuts the nodes covered by it.
+	void AddNode(int index, int x, int y, int width, int height);
+
+	Int2 _size;
+	int _padding;
+	int64 _used_area;
+	Array<SkylineNode> _skyline;
+};
@@ -0,0 +1,120 @@
+#include "ScratchArena.h"
+
+#include "Engine/Core/Memory/Allocation.h"
+#include "Engine/Core/Math/Math.h"
+
+
+FudgetScratchArena::FudgetScratchArena() : _block(0), _offset(0), _block_start(0), _peak(0), _heap_allocations(0)
+{
+}
+
+FudgetScratchArena::~FudgetScratchArena()
+{
+	for (const Block &block : _blocks)
+		Allocator::Free(block.Data);
+}
+
+void* FudgetScratchArena::Allocate(int size, int alignment)
+{
+	while (true)
+	{
+		if (_block < _blocks.Count())
+		{
+			const Block &block = _blocks[_block];
+			int start = (_offset + alignment - 1) & ~(alignment - 1);
+			if (start + size <= block.Size)
+			{
+				_offset = start + size;
+				_peak = Math::Max(_peak, _block_start + _offset);
+				return block.Data + start;
+			}
+
+			if (_block + 1 < _blocks.Count() && _blocks[_block + 1].Size >= size + alignment)
+			{
+				_block_start += block.Size;
+				++_block;
+				_offset = 0;
+				continue;
+			}
+		}
+
+		// Blocks after the current one are too small. They are freed and replaced by a large enough block.
+		for (int ix = _blocks.Count() - 1; ix > _block; --ix)
+		{
+			Allocator::Free(_blocks[ix].Data);
+			_blocks.RemoveAt(ix);
+		}
+		int block_start = GetCapacity();
+		AddBlock(size + alignment);
+		_block = _blocks.Count() - 1;
+		_block_start = block_start;
+		_offset = 0;
+	}
+}
+
+void FudgetScratchArena::Release(const Marker &marker)
+{
+	_block = marker.Block;
+	_offset = marker.Offset;
+	_block_start = marker.BlockStart;
+}
+
+void FudgetScratchArena::Reset()
+{
+	_block = 0;
+	_offset = 0;
+	_block_start = 0;
+	_peak = 0;
+	if (_blocks.Count() <= 1)
+		return;
+
+	int capacity = GetCapacity();
+	for (const Block &block : _blocks)
+		Allocator::Free(block.Data);
+	_blocks.Clear();
+	AddBlock(capacity);
+}
+
+int FudgetScratchArena::GetCapacity() const
+{
+	int result = 0;
+	for (const Block &block : _blocks)
+		result += block.Size;
+	return result;
+}
+
+void FudgetScratchArena::AddBlock(int min_size)
+{
+	// Blocks grow geometrically to reach the needed capacity in few steps.
+	int size = Math::Max(Math::Max(min_size, 16 * 1024), _blocks.IsEmpty() ? 0 : _blocks.Last().Size * 2);
+	Block block;
+	block.Data = (byte*)Allocator::Allocate(size, 16);
+	block.Size = size;
+	_blocks.Add(block);
+	++_heap_allocations;
+}
+
+
+FudgetScratchScope::FudgetScratchScope(FudgetScratchArena *arena) : _arena(arena), _marker()
+{
+	if (_arena != nullptr)
+		_marker = _arena->GetMarker();
+}
+
+FudgetScratchScope::~FudgetScratchScope()
+{
+	if (_arena != nullptr)
+		_arena->Release(_marker);
+	for (void *data : _heap)
+		Allocator::Free(data);
+}
+
+void* FudgetScratchScope::AllocateBytes(int size, int alignment)
+{
+	if (_arena != nullptr)
+		return _arena->Allocate(size, alignment);
+
+	void *data = Allocator::Allocate(size, Math::Max(alignment, 16));
+	_heap.Add(data);
+	return data;
+}
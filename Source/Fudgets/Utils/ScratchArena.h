@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Types/Span.h"
+
+
+// Linear allocator for temporary data used during a layout pass. Memory is taken from blocks in order and given
+// back in bulk by releasing to a marker or calling Reset. Reset merges the blocks into one, so after a few passes
+// with the same needs the arena doesn't allocate from the heap anymore. Not thread-safe.
+class FUDGETS_API FudgetScratchArena
+{
+public:
+	// Position in the arena that can be released back to.
+	struct Marker
+	{
+		int Block;
+		int Offset;
+		// Size of the blocks before Block.
+		int BlockStart;
+	};
+
+	FudgetScratchArena();
+	~FudgetScratchArena();
+
+	// Returns uninitialized memory for size bytes with the given alignment, valid until released.
+	void* Allocate(int size, int alignment);
+
+	// Current position to pass to Release later.
+	Marker GetMarker() const { return { _block, _offset, _block_start }; }
+
+	// Gives back every allocation made since the marker was taken.
+	void Release(const Marker &marker);
+
+	// Gives back all memory, merging the blocks into one large enough for everything used since the last reset.
+	void Reset();
+
+	// Number of blocks allocated from the heap since the arena was created.
+	int64 GetHeapAllocations() const { return _heap_allocations; }
+
+	// Number of bytes available in all blocks.
+	int GetCapacity() const;
+
+	// Most bytes in use at the same time since the last reset, including the unused ends of blocks that were skipped.
+	int GetPeakUsage() const { return _peak; }
+private:
+	struct Block
+	{
+		byte *Data;
+		int Size;
+	};
+
+	void AddBlock(int min_size);
+
+	Array<Block> _blocks;
+	// Index of the block allocations are currently made from.
+	int _block;
+	// Number of bytes used in the current block.
+	int _offset;
+	// Size of the blocks before the current one.
+	int _block_start;
+	int _peak;
+	int64 _heap_allocations;
+};
+
+// Allocates temporary arrays from a scratch arena and releases them when going out of scope. Falls back to heap
+// allocations when no arena is available, for example when a layout is measured on a job thread.
+class FUDGETS_API FudgetScratchScope
+{
+public:
+	FudgetScratchScope(FudgetScratchArena *arena);
+	~FudgetScratchScope();
+
+	FudgetScratchScope(const FudgetScratchScope&) = delete;
+	FudgetScratchScope& operator=(const FudgetScratchScope&) = delete;
+
+	// Returns an uninitialized span of count items. Only use for trivially copyable types.
+	template<typename T>
+	Span<T> Allocate(int count)
+	{
+		if (count <= 0)
+			return Span<T>();
+		return Span<T>((T*)AllocateBytes(count * (int)sizeof(T), (int)alignof(T)), count);
+	}
+private:
+	void* AllocateBytes(int size, int alignment);
+
+	FudgetScratchArena *_arena;
+	FudgetScratchArena::Marker _marker;
+	// Allocations made without an arena, freed in the destructor.
+	Array<void*> _heap;
+};
@@ -0,0 +1,711 @@
+#include "SelfTest.h"
+#include "DrawGeometry.h"
+#include "NavigationIndex.h"
+#include "../GUIRoot.h"
+#include "../Controls/Button.h"
+#include "../ItemSelection.h"
+#include "../DrawSink.h"
+#include "../Styling/AtlasBuilder.h"
+#include "RectPacker.h"
+
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Content/Content.h"
+#include "Engine/Render2D/SpriteAtlas.h"
+
+#include <vector>
+#include <algorithm>
+
+
+// Records a failure with the checked expression when the condition is false.
+#define FUDGET_CHECK(tester, condition) (tester).Check((condition), TEXT(#condition), __LINE__)
+
+
+namespace
+{
+	struct Tester
+	{
+		const Char *Test = TEXT("");
+		int Checks = 0;
+		int Failures = 0;
+
+		bool Check(bool condition, const Char *expression, int line)
+		{
+			++Checks;
+			if (!condition)
+			{
+				++Failures;
+				LOG(Error, "Test {0} failed at line {1}: {2}", Test, line, expression);
+			}
+			return condition;
+		}
+	};
+
+	// Deterministic numbers, so a failed test can be repeated.
+	struct Random
+	{
+		uint32 State = 0x12345678;
+
+		int Next(int max)
+		{
+			State = State * 1664525u + 1013904223u;
+			return max <= 0 ? 0 : (int)((State >> 8) % (uint32)max);
+		}
+	};
+
+	bool NearEqual(const Float2 &a, const Float2 &b)
+	{
+		return Math::NearEqual(a.X, b.X) && Math::NearEqual(a.Y, b.Y);
+	}
+
+	void TestNineSlice(Tester &t)
+	{
+		Array<Float2> vertices;
+		Array<Float2> uvs;
+		Rectangle rect(10.f, 20.f, 100.f, 50.f);
+		Rectangle uv_area(0.5f, 0.5f, 0.5f, 0.5f);
+		FudgetDrawGeometry::NineSlice(rect, Float4(4.f, 6.f, 8.f, 10.f), Float4(0.1f, 0.2f, 0.3f, 0.4f), uv_area, vertices, uvs);
+
+		FUDGET_CHECK(t, vertices.Count() == 9 * 6);
+		FUDGET_CHECK(t, uvs.Count() == vertices.Count());
+		if (vertices.Count() != 9 * 6 || uvs.Count() != vertices.Count())
+			return;
+
+		// Quads are written row by row as upper left, upper right, bottom right, upper left, bottom right, bottom left.
+		FUDGET_CHECK(t, vertices[0] == Float2(10.f, 20.f));
+		FUDGET_CHECK(t, vertices[2] == Float2(14.f, 28.f));
+		FUDGET_CHECK(t, NearEqual(uvs[0], Float2(0.5f, 0.5f)));
+		FUDGET_CHECK(t, NearEqual(uvs[2], Float2(0.55f, 0.65f)));
+
+		// Center quad.
+		FUDGET_CHECK(t, vertices[4 * 6] == Float2(14.f, 28.f));
+		FUDGET_CHECK(t, vertices[4 * 6 + 2] == Float2(104.f, 60.f));
+		FUDGET_CHECK(t, NearEqual(uvs[4 * 6 + 2], Float2(0.5f + 0.8f * 0.5f, 0.5f + 0.6f * 0.5f)));
+
+		// Bottom right quad ends at the bottom left vertex.
+		FUDGET_CHECK(t, vertices[8 * 6 + 2] == Float2(110.f, 70.f));
+		FUDGET_CHECK(t, vertices[8 * 6 + 5] == Float2(104.f, 70.f));
+		FUDGET_CHECK(t, NearEqual(uvs[8 * 6 + 2], Float2(1.f, 1.f)));
+
+		// Slices without area are left out.
+		FudgetDrawGeometry::NineSlice(rect, Float4::Zero, Float4::Zero, Rectangle(0.f, 0.f, 1.f, 1.f), vertices, uvs);
+		FUDGET_CHECK(t, vertices.Count() == 6);
+		if (vertices.Count() == 6)
+		{
+			FUDGET_CHECK(t, vertices[2] == rect.GetBottomRight());
+			FUDGET_CHECK(t, NearEqual(uvs[2], Float2::One));
+		}
+	}
+
+	void TestTiled(Tester &t)
+	{
+		Array<Float2> vertices;
+		Array<Float2> uvs;
+		FudgetDrawGeometry::Tiled(Rectangle(0.f, 0.f, 100.f, 50.f), Float2(32.f, 32.f), Rectangle(0.f, 0.f, 1.f, 1.f), vertices, uvs);
+
+		// 4 columns and 2 rows, with cut tiles at the right and bottom.
+		FUDGET_CHECK(t, vertices.Count() == 8 * 6);
+		FUDGET_CHECK(t, uvs.Count() == vertices.Count());
+		if (vertices.Count() != 8 * 6 || uvs.Count() != vertices.Count())
+			return;
+
+		FUDGET_CHECK(t, vertices[2] == Float2(32.f, 32.f));
+		FUDGET_CHECK(t, NearEqual(uvs[2], Float2::One));
+
+		const int last = 7 * 6;
+		FUDGET_CHECK(t, vertices[last] == Float2(96.f, 32.f));
+		FUDGET_CHECK(t, vertices[last + 2] == Float2(100.f, 50.f));
+		FUDGET_CHECK(t, NearEqual(uvs[last], Float2::Zero));
+		FUDGET_CHECK(t, NearEqual(uvs[last + 2], Float2(4.f / 32.f, 18.f / 32.f)));
+
+		// Tiles of a sprite use the area of the sprite.
+		FudgetDrawGeometry::Tiled(Rectangle(0.f, 0.f, 16.f, 16.f), Float2(16.f, 16.f), Rectangle(0.25f, 0.5f, 0.25f, 0.5f), vertices, uvs);
+		FUDGET_CHECK(t, vertices.Count() == 6);
+		if (vertices.Count() == 6)
+		{
+			FUDGET_CHECK(t, NearEqual(uvs[0], Float2(0.25f, 0.5f)));
+			FUDGET_CHECK(t, NearEqual(uvs[2], Float2(0.5f, 1.f)));
+		}
+
+		FudgetDrawGeometry::Tiled(Rectangle(0.f, 0.f, 100.f, 50.f), Float2::Zero, Rectangle(0.f, 0.f, 1.f, 1.f), vertices, uvs);
+		FUDGET_CHECK(t, vertices.IsEmpty());
+	}
+
+	void TestDrawGeometryCache(Tester &t)
+	{
+		FudgetDrawGeometryCache cache;
+		auto make_key = [](int index) {
+			FudgetDrawGeometryCache::Key key = { false, Rectangle(0.f, index * 20.f, 100.f, 20.f), Float4(2.f), Float4(0.1f), Rectangle(0.f, 0.f, 1.f, 1.f), Color::White };
+			return key;
+		};
+
+		// More draws than a few, like the item backgrounds of a list, are all kept between frames.
+		for (int ix = 0; ix < 30; ++ix)
+			cache.Get(make_key(ix), 1);
+		FUDGET_CHECK(t, cache.GetCount() == 30);
+		for (int ix = 0; ix < 30; ++ix)
+			cache.Get(make_key(ix), 2);
+		FUDGET_CHECK(t, cache.GetCount() == 30);
+
+		// Draws skipped for a frame are dropped.
+		for (int ix = 0; ix < 10; ++ix)
+			cache.Get(make_key(ix), 3);
+		cache.Get(make_key(0), 4);
+		FUDGET_CHECK(t, cache.GetCount() == 10);
+
+		const FudgetDrawGeometryCache::Entry &entry = cache.Get(make_key(1), 4);
+		FUDGET_CHECK(t, entry.Vertices.Count() == 9 * 6);
+		FUDGET_CHECK(t, entry.Colors.Count() == entry.Vertices.Count());
+		if (entry.Vertices.IsEmpty())
+			return;
+
+		// The geometry is local, and the translation is only added when it's drawn.
+		Float2 first = entry.Vertices[0];
+		Span<Float2> moved = cache.GetTranslatedVertices(entry, Float2(100.f, 200.f));
+		FUDGET_CHECK(t, moved.Length() == entry.Vertices.Count());
+		FUDGET_CHECK(t, moved.Length() > 0 && moved[0] == first + Float2(100.f, 200.f));
+		FUDGET_CHECK(t, entry.Vertices[0] == first);
+	}
+
+	bool RectsOverlap(const Rectangle &a, const Rectangle &b)
+	{
+		return a.GetLeft() < b.GetRight() && b.GetLeft() < a.GetRight() && a.GetTop() < b.GetBottom() && b.GetTop() < a.GetBottom();
+	}
+
+	// Rectangle of a packed item including its padding.
+	Rectangle PaddedRect(Int2 pos, Int2 size, int padding)
+	{
+		return Rectangle((float)(pos.X - padding), (float)(pos.Y - padding), (float)(size.X + padding * 2), (float)(size.Y + padding * 2));
+	}
+
+	void TestRectPacker(Tester &t)
+	{
+		FudgetRectPacker packer(Int2(64, 64));
+		Int2 pos[5];
+		for (int ix = 0; ix < 4; ++ix)
+			FUDGET_CHECK(t, packer.Insert(Int2(32, 32), pos[ix]));
+		FUDGET_CHECK(t, !packer.Insert(Int2(32, 32), pos[4]));
+		FUDGET_CHECK(t, !packer.Insert(Int2(0, 10), pos[4]));
+		FUDGET_CHECK(t, packer.GetUsedArea() == 64 * 64);
+		for (int ix = 0; ix < 4; ++ix)
+		{
+			for (int iy = ix + 1; iy < 4; ++iy)
+				FUDGET_CHECK(t, !RectsOverlap(PaddedRect(pos[ix], Int2(32, 32), 0), PaddedRect(pos[iy], Int2(32, 32), 0)));
+		}
+
+		packer.Reset();
+		FUDGET_CHECK(t, packer.GetUsedArea() == 0);
+		FUDGET_CHECK(t, packer.Insert(Int2(64, 64), pos[0]) && pos[0] == Int2::Zero);
+
+		// The position is inside the padding, and the padding must fit in the area too.
+		FudgetRectPacker padded(Int2(20, 20), 2);
+		FUDGET_CHECK(t, padded.Insert(Int2(16, 16), pos[0]) && pos[0] == Int2(2, 2));
+		FUDGET_CHECK(t, !padded.Insert(Int2(1, 1), pos[1]));
+		FUDGET_CHECK(t, !FudgetRectPacker(Int2(20, 20), 2).Insert(Int2(17, 16), pos[1]));
+
+		// Random sizes never overlap with their padding and stay inside the area.
+		const int padding = 1;
+		const Int2 area(256, 256);
+		FudgetRectPacker random_packer(area, padding);
+		Array<Rectangle> placed;
+		int64 used = 0;
+		Random random;
+		for (int ix = 0; ix < 200; ++ix)
+		{
+			Int2 size(1 + random.Next(40), 1 + random.Next(40));
+			Int2 p;
+			if (!random_packer.Insert(size, p))
+				continue;
+			Rectangle rect = PaddedRect(p, size, padding);
+			FUDGET_CHECK(t, rect.GetLeft() >= 0.f && rect.GetTop() >= 0.f && rect.GetRight() <= area.X && rect.GetBottom() <= area.Y);
+			for (const Rectangle &other : placed)
+			{
+				if (!FUDGET_CHECK(t, !RectsOverlap(rect, other)))
+					return;
+			}
+			placed.Add(rect);
+			used += (int64)(size.X + padding * 2) * (size.Y + padding * 2);
+		}
+		FUDGET_CHECK(t, placed.Count() > 10);
+		FUDGET_CHECK(t, random_packer.GetUsedArea() == used);
+
+		Rectangle uv = FudgetRectPacker::ToUV(Rectangle(16.f, 32.f, 16.f, 8.f), Int2(64, 64));
+		FUDGET_CHECK(t, NearEqual(uv.Location, Float2(0.25f, 0.5f)) && NearEqual(uv.Size, Float2(0.25f, 0.125f)));
+		FUDGET_CHECK(t, FudgetRectPacker::ToUV(Rectangle(0.f, 0.f, 1.f, 1.f), Int2::Zero) == Rectangle::Empty);
+	}
+
+	// Creates empty atlases without a graphics device and reports every other placement as copied.
+	class TestAtlasFactory : public FudgetAtlasTextureFactory
+	{
+	public:
+		SpriteAtlas* CreateAtlas(Int2 size, int padding, const Array<FudgetAtlasPlacement> &placements, Array<bool> &copied) override
+		{
+			copied.Resize(placements.Count());
+			for (int ix = 0; ix < placements.Count(); ++ix)
+				copied[ix] = ix % 2 == 0;
+			return Content::CreateVirtualAsset<SpriteAtlas>();
+		}
+	};
+
+	// The builder only compares texture pointers, so items are identified by made up addresses.
+	TextureBase* TestTexture(int index)
+	{
+		return reinterpret_cast<TextureBase*>((intptr)(index + 1) * 64);
+	}
+
+	void TestAtlasBuilder(Tester &t)
+	{
+		const int page_size = 128;
+		const int padding = 2;
+		FudgetAtlasBuilder builder(page_size, 64, padding);
+
+		// Too large, empty and repeated textures are not added.
+		FUDGET_CHECK(t, !builder.AddTexture(TestTexture(100), Int2(65, 8)));
+		FUDGET_CHECK(t, !builder.AddTexture(TestTexture(100), Int2(0, 8)));
+		FUDGET_CHECK(t, !builder.AddTexture(nullptr, Int2(8, 8)));
+
+		// More textures than fit on a page.
+		const int count = 40;
+		Random random;
+		Int2 sizes[count];
+		for (int ix = 0; ix < count; ++ix)
+		{
+			sizes[ix] = Int2(4 + random.Next(60), 4 + random.Next(60));
+			FUDGET_CHECK(t, builder.AddTexture(TestTexture(ix), sizes[ix]));
+		}
+		FUDGET_CHECK(t, !builder.AddTexture(TestTexture(0), Int2(8, 8)));
+
+		builder.Pack();
+		const Array<FudgetAtlasPlacement> &placements = builder.GetPlacements();
+		FUDGET_CHECK(t, placements.Count() == count);
+		FUDGET_CHECK(t, builder.GetPageCount() > 1);
+
+		for (int ix = 0; ix < placements.Count(); ++ix)
+		{
+			const FudgetAtlasPlacement &a = placements[ix];
+			int index = (int)((intptr)a.Texture / 64) - 1;
+			FUDGET_CHECK(t, index >= 0 && index < count && a.Area.Size == Float2(sizes[index]));
+			FUDGET_CHECK(t, a.Page >= 0 && a.Page < builder.GetPageCount());
+			FUDGET_CHECK(t, a.Area.GetLeft() >= padding && a.Area.GetTop() >= padding && a.Area.GetRight() + padding <= page_size && a.Area.GetBottom() + padding <= page_size);
+
+			Rectangle uv = builder.GetPlacementUV(ix);
+			FUDGET_CHECK(t, NearEqual(uv.Location, a.Area.Location / (float)page_size) && NearEqual(uv.Size, a.Area.Size / (float)page_size));
+
+			for (int iy = ix + 1; iy < placements.Count(); ++iy)
+			{
+				const FudgetAtlasPlacement &b = placements[iy];
+				if (a.Page != b.Page)
+					continue;
+				Rectangle ra(a.Area.Location - Float2((float)padding), a.Area.Size + Float2((float)padding * 2));
+				Rectangle rb(b.Area.Location - Float2((float)padding), b.Area.Size + Float2((float)padding * 2));
+				FUDGET_CHECK(t, !RectsOverlap(ra, rb));
+			}
+		}
+
+		// Only the copied textures get a sprite, with the area of the placement in the atlas.
+		TestAtlasFactory factory;
+		Array<SpriteAtlas*> atlases;
+		Dictionary<TextureBase*, SpriteHandle> sprites;
+		FUDGET_CHECK(t, builder.Build(&factory, atlases, sprites));
+		FUDGET_CHECK(t, atlases.Count() == builder.GetPageCount());
+
+		int expected = 0;
+		for (int page = 0; page < builder.GetPageCount(); ++page)
+		{
+			int on_page = 0;
+			for (const FudgetAtlasPlacement &placement : placements)
+				on_page += placement.Page == page ? 1 : 0;
+			expected += (on_page + 1) / 2;
+		}
+		FUDGET_CHECK(t, sprites.Count() == expected);
+
+		for (int ix = 0; ix < placements.Count(); ++ix)
+		{
+			const SpriteHandle *sprite = sprites.TryGet(placements[ix].Texture);
+			if (sprite == nullptr)
+				continue;
+			FUDGET_CHECK(t, sprite->Atlas.Get() == atlases[placements[ix].Page]);
+			Rectangle area = sprite->Atlas->GetSprite(sprite->Index).Area;
+			Rectangle uv = builder.GetPlacementUV(ix);
+			FUDGET_CHECK(t, NearEqual(area.Location, uv.Location) && NearEqual(area.Size, uv.Size));
+		}
+
+		for (SpriteAtlas *atlas : atlases)
+			atlas->DeleteObject();
+	}
+
+	// Clip, fill, line and text, in this order. The text is not measured, because it has no font.
+	void RecordSample(FudgetDrawRecorder &recorder, const Color &fill, const StringView &text)
+	{
+		recorder.PushClip(Rectangle(0.f, 0.f, 100.f, 100.f));
+		recorder.FillRectangle(Rectangle(10.f, 10.f, 50.f, 50.f), fill, fill, fill, fill);
+		recorder.DrawLine(Float2(0.f, 0.f), Float2(200.f, 0.f), Color::Red, Color::Red, 2.f);
+		recorder.DrawText(nullptr, text, nullptr, Color::White, Float2(5.f, 5.f), nullptr);
+		recorder.PopClip();
+	}
+
+	void TestDrawRecorder(Tester &t)
+	{
+		FudgetDrawRecorder recorded;
+		RecordSample(recorded, Color::Blue, TEXT("abc"));
+		FUDGET_CHECK(t, recorded.GetCommandCount() == 5);
+		FUDGET_CHECK(t, recorded.GetDrawCallCount() == 3);
+		FUDGET_CHECK(t, recorded.GetCommandCount(FudgetDrawCommandType::PushClip) == 1);
+		FUDGET_CHECK(t, recorded.GetCommandCount(FudgetDrawCommandType::FillRectangle) == 1);
+		// Only the fill has an area. The line has no height and the text wasn't measured.
+		FUDGET_CHECK(t, Math::NearEqual(recorded.GetDrawnArea(), 2500.f));
+
+		FudgetDrawRecorder same;
+		RecordSample(same, Color::Blue, TEXT("abc"));
+		FUDGET_CHECK(t, recorded.FindFirstDifference(same) == -1);
+		FUDGET_CHECK(t, recorded.CommandEquals(1, same, 1));
+		FUDGET_CHECK(t, !recorded.CommandEquals(1, same, 2));
+		FUDGET_CHECK(t, !recorded.CommandEquals(5, same, 5));
+
+		// Arguments in the data buffer and characters of the text are compared.
+		FudgetDrawRecorder other_color;
+		RecordSample(other_color, Color::Green, TEXT("abc"));
+		FUDGET_CHECK(t, recorded.FindFirstDifference(other_color) == 1);
+		FudgetDrawRecorder other_text;
+		RecordSample(other_text, Color::Blue, TEXT("abd"));
+		FUDGET_CHECK(t, recorded.FindFirstDifference(other_text) == 3);
+
+		// A recording that continues after the other one ended differs at the end of the shorter one.
+		FudgetDrawRecorder longer;
+		RecordSample(longer, Color::Blue, TEXT("abc"));
+		longer.FillRectangle(Rectangle(0.f, 0.f, 10.f, 10.f), Color::Blue, Color::Blue, Color::Blue, Color::Blue);
+		FUDGET_CHECK(t, recorded.FindFirstDifference(longer) == 5);
+		FUDGET_CHECK(t, longer.FindFirstDifference(recorded) == 5);
+
+		// Replaying on another recorder records the same commands.
+		FudgetDrawRecorder replayed;
+		recorded.Replay(&replayed);
+		FUDGET_CHECK(t, replayed.FindFirstDifference(recorded) == -1);
+
+		replayed.Clear();
+		FUDGET_CHECK(t, replayed.GetCommandCount() == 0);
+		FUDGET_CHECK(t, replayed.GetCommandCount(FudgetDrawCommandType::FillRectangle) == 0);
+		FUDGET_CHECK(t, replayed.GetDrawnArea() == 0.f);
+	}
+
+	// The earlier implementation of FudgetItemSelection with a sorted vector of runs. Every change is linear in the
+	// number of runs, which makes it easy to follow. Only valid for ranges inside the selection size.
+	struct ReferenceSelection
+	{
+		int Size = 0;
+		int Count = 0;
+		std::vector<FudgetSelectionBlock> Blocks;
+
+		void SetSelected(int index, int count, bool select)
+		{
+			std::vector<FudgetSelectionBlock>::iterator it;
+			if (select)
+			{
+				it = std::lower_bound(Blocks.begin(), Blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
+					return block._end < index;
+				});
+
+				if (it == Blocks.end() || it->_start > index + count)
+				{
+					Blocks.insert(it, { index, index + count });
+					Count += count;
+					return;
+				}
+
+				FudgetSelectionBlock &block = *it;
+				Count += (Math::Max(index + count, block._end) - Math::Min(block._start, index)) - (block._end - block._start);
+				block._start = Math::Min(index, block._start);
+				block._end = Math::Max(index + count, block._end);
+
+				++it;
+				auto it2 = it;
+				while (it2 != Blocks.end())
+				{
+					FudgetSelectionBlock &block2 = *it2;
+					if (block2._end >= index + count)
+					{
+						if (block2._start <= index + count)
+						{
+							Count -= index + count - block2._start;
+							block._end = Math::Max(block._end, block2._end);
+							++it2;
+						}
+						break;
+					}
+					Count -= block2._end - block2._start;
+					++it2;
+				}
+				Blocks.erase(it, it2);
+				return;
+			}
+
+			it = std::lower_bound(Blocks.begin(), Blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
+				return block._end <= index;
+			});
+			if (it == Blocks.end())
+				return;
+
+			FudgetSelectionBlock &block = *it;
+			if (block._start < index)
+			{
+				++it;
+				if (block._end > index + count)
+				{
+					Count -= count;
+					FudgetSelectionBlock new_block = { index + count, block._end };
+					block._end = index;
+					Blocks.insert(it, new_block);
+					return;
+				}
+				Count -= block._end - index;
+				block._end = index;
+			}
+
+			auto it2 = it;
+			while (it2 != Blocks.end())
+			{
+				FudgetSelectionBlock &block2 = *it2;
+				if (block2._end > index + count)
+				{
+					if (block2._start < index + count)
+					{
+						Count -= index + count - block2._start;
+						block2._start = index + count;
+					}
+					break;
+				}
+				Count -= block2._end - block2._start;
+				++it2;
+			}
+			Blocks.erase(it, it2);
+		}
+
+		void ItemsInserted(int index, int count)
+		{
+			Size += count;
+			auto it = std::lower_bound(Blocks.begin(), Blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
+				return block._end <= index;
+			});
+			if (it == Blocks.end())
+				return;
+
+			FudgetSelectionBlock &block = *it;
+			for (auto it2 = block._start >= index ? it : std::next(it); it2 != Blocks.end(); ++it2)
+			{
+				it2->_start += count;
+				it2->_end += count;
+			}
+
+			if (block._start >= index)
+				return;
+			FudgetSelectionBlock new_block = { index + count, block._end + count };
+			block._end = index;
+			Blocks.insert(std::next(it), new_block);
+		}
+
+		void ItemsRemoved(int index, int count)
+		{
+			SetSelected(index, count, false);
+			Size -= count;
+
+			auto it = std::lower_bound(Blocks.begin(), Blocks.end(), index, [](const FudgetSelectionBlock &block, int index) {
+				return block._end < index;
+			});
+			if (it == Blocks.end())
+				return;
+
+			FudgetSelectionBlock &block = *it;
+			bool remove_block = false;
+			if (block._end == index)
+			{
+				++it;
+				if (it != Blocks.end() && it->_start == index + count)
+				{
+					block._end = it->_end - count;
+					remove_block = true;
+				}
+			}
+
+			for (auto it2 = it; it2 != Blocks.end(); ++it2)
+			{
+				it2->_start -= count;
+				it2->_end -= count;
+			}
+
+			if (remove_block)
+				Blocks.erase(it);
+		}
+	};
+
+	bool SameSelection(const FudgetItemSelection *selection, const ReferenceSelection &reference)
+	{
+		if (selection->GetSize() != reference.Size || selection->Count() != reference.Count)
+			return false;
+
+		size_t block = 0;
+		for (auto it = selection->IterateRanges(); it.IsValid(); it.Next(), ++block)
+		{
+			if (block >= reference.Blocks.size() || it.Get()._start != reference.Blocks[block]._start || it.Get()._end != reference.Blocks[block]._end)
+				return false;
+		}
+		if (block != reference.Blocks.size())
+			return false;
+
+		for (const FudgetSelectionBlock &b : reference.Blocks)
+		{
+			if (!selection->IsSelected(b._start) || !selection->IsSelected(b._end - 1) || (b._start > 0 && selection->IsSelected(b._start - 1)) || selection->IsSelected(b._end))
+				return false;
+		}
+		return true;
+	}
+
+	// Runs random selections, insertions and removals on the selection and the reference, and compares them after
+	// every step.
+	void TestItemSelection(Tester &t)
+	{
+		const int Runs = 20;
+		const int Steps = 500;
+		const int MaxSize = 400;
+
+		Random random;
+		FudgetItemSelection *selection = New<FudgetItemSelection>(SpawnParams(Guid::New(), FudgetItemSelection::TypeInitializer));
+		for (int run = 0; run < Runs; ++run)
+		{
+			ReferenceSelection reference;
+			selection->Clear();
+			selection->SetSize(0);
+			int size = 1 + random.Next(MaxSize);
+			selection->SetSize(size);
+			reference.ItemsInserted(0, size);
+
+			for (int step = 0; step < Steps; ++step)
+			{
+				size = reference.Size;
+				int op = random.Next(10);
+				// Short ranges make many small runs, and long ranges merge or split them.
+				int max_count = random.Next(4) == 0 ? size : 8;
+				if (op < 6 && size > 0)
+				{
+					int index = random.Next(size);
+					int count = 1 + random.Next(Math::Min(max_count, size - index));
+					bool select = op < 4;
+					selection->SetSelected(index, count, select);
+					reference.SetSelected(index, count, select);
+				}
+				else if (op < 8 && size < MaxSize)
+				{
+					int index = random.Next(size + 1);
+					int count = 1 + random.Next(8);
+					selection->ItemsInserted(index, count);
+					reference.ItemsInserted(index, count);
+				}
+				else if (size > 0)
+				{
+					int index = random.Next(size);
+					int count = 1 + random.Next(Math::Min(max_count, size - index));
+					selection->ItemsRemoved(index, count);
+					reference.ItemsRemoved(index, count);
+				}
+
+				if (!FUDGET_CHECK(t, SameSelection(selection, reference)))
+				{
+					LOG(Error, "Selection differs from the reference in run {0} after step {1}", run, step);
+					Delete(selection);
+					return;
+				}
+			}
+		}
+		Delete(selection);
+	}
+
+	// Buttons in a grid of 5 columns and 5 rows, placed by the default layout of the root. The gaps are large enough
+	// that the control in line is always the nearest.
+	const int NavigationColumns = 5;
+	const int NavigationRows = 5;
+
+	Int2 NavigationCellPos(int x, int y)
+	{
+		return Int2(20 + x * 200, 20 + y * 150);
+	}
+
+	void TestNavigation(Tester &t)
+	{
+		FudgetGUIRoot *root = New<FudgetGUIRoot>((Fudget*)nullptr);
+		root->SetHintSize(Int2(1000, 1000));
+		FudgetButton *grid[NavigationColumns][NavigationRows];
+		for (int y = 0; y < NavigationRows; ++y)
+		{
+			for (int x = 0; x < NavigationColumns; ++x)
+			{
+				FudgetButton *button = root->CreateChild<FudgetButton>();
+				button->SetHintSize(Int2(40, 20));
+				button->SetPosition(NavigationCellPos(x, y));
+				grid[x][y] = button;
+			}
+		}
+		root->FudgetInit();
+		root->DoLayout();
+
+		FudgetControl *center = grid[2][2];
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Right) == grid[3][2]);
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Left) == grid[1][2]);
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Up) == grid[2][1]);
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Down) == grid[2][3]);
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Next) == grid[3][2]);
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Previous) == grid[1][2]);
+		FUDGET_CHECK(t, root->FindNavigationTarget(grid[4][2], FudgetNavigationDirection::Right) == nullptr);
+		FUDGET_CHECK(t, root->FindNavigationTarget(nullptr, FudgetNavigationDirection::Next) == grid[0][0]);
+
+		// A control moved and then deleted before the next query is skipped.
+		grid[3][2]->SetPosition(Int2(5000, 5000));
+		Delete(grid[3][2]);
+		grid[3][2] = nullptr;
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Right) == grid[4][2]);
+
+		// Controls far away are found, and after they move back the nearest control is found again.
+		grid[4][4]->SetPosition(Int2(20000, 20));
+		FUDGET_CHECK(t, root->FindNavigationTarget(grid[4][0], FudgetNavigationDirection::Right) == grid[4][4]);
+		grid[4][4]->SetPosition(NavigationCellPos(4, 4));
+		FUDGET_CHECK(t, root->FindNavigationTarget(grid[4][0], FudgetNavigationDirection::Right) == nullptr);
+		FUDGET_CHECK(t, root->FindNavigationTarget(grid[4][3], FudgetNavigationDirection::Down) == grid[4][4]);
+
+		// Hidden controls are left out.
+		grid[2][3]->SetVisible(false);
+		FUDGET_CHECK(t, root->FindNavigationTarget(center, FudgetNavigationDirection::Down) == grid[2][4]);
+
+		Delete(root);
+	}
+}
+
+
+int FudgetSelfTest::Run()
+{
+	struct Test
+	{
+		const Char *Name;
+		void (*Func)(Tester&);
+	};
+	const Test tests[] = {
+		{ TEXT("NineSlice"), TestNineSlice },
+		{ TEXT("Tiled"), TestTiled },
+		{ TEXT("DrawGeometryCache"), TestDrawGeometryCache },
+		{ TEXT("DrawRecorder"), TestDrawRecorder },
+		{ TEXT("RectPacker"), TestRectPacker },
+		{ TEXT("AtlasBuilder"), TestAtlasBuilder },
+		{ TEXT("Navigation"), TestNavigation },
+		{ TEXT("ItemSelection"), TestItemSelection },
+	};
+
+	Tester tester;
+	for (const Test &test : tests)
+	{
+		tester.Test = test.Name;
+		test.Func(tester);
+	}
+
+	if (tester.Failures == 0)
+		LOG(Info, "All {0} checks of {1} tests passed", tester.Checks, ARRAY_COUNT(tests));
+	else
+		LOG(Error, "{0} of {1} checks failed", tester.Failures, tester.Checks);
+	return tester.Failures;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Engine/Scripting/ScriptingType.h"
+
+/// <summary>
+/// Runs the CPU tests of the plugin, which need no window or graphics device. Can be called from a game started with
+/// -headless, for example on a build server. Every failed check is logged as an error with the test and the line it
+/// was made on.
+/// </summary>
+API_CLASS(Static)
+class FUDGETS_API FudgetSelfTest
+{
+	DECLARE_SCRIPTING_TYPE_NO_SPAWN(FudgetSelfTest);
+public:
+	/// <summary>
+	/// Runs every test.
+	/// </summary>
+	/// <returns>Number of failed checks</returns>
+	API_FUNCTION() static int Run();
+};